@@ -76,6 +76,61 @@ typedef struct
 LexRec, *LexPtr;
 
 
+/*
+ * The lexer state for one config being parsed.  The parse functions
+ * reach it through xconfigScan, which xconfigScanReadConfig() points at
+ * its scanner for the duration of the parse.
+ */
+
+typedef struct _XConfigScanRec
+{
+    const char *data;    /* config text being parsed */
+    size_t size;         /* length of data, in bytes */
+    size_t offset;       /* start of the next line in data */
+    void *map;           /* mmap(2)ed file backing data, if any */
+    char *copy;          /* heap copy backing data, if any */
+
+    char *configBuf;     /* current line */
+    char *configRBuf;    /* current token */
+    size_t configBufLen; /* allocated size of configBuf and configRBuf */
+    int configPos;       /* current readers position */
+    int pushToken;
+    int eol_seen;        /* private state to handle comments */
+    LexRec val;
+
+    int configLineNo;    /* linenumber */
+    char *configSection; /* name of current section being parsed */
+    char *configPath;    /* path to config file */
+}
+XConfigScanRec;
+
+extern __thread XConfigScanPtr xconfigScan;
+
+
+/*
+ * A hash index over the names of the items in a list; see
+ * xconfigNameIndexInit() in Read.c.  The XCONFIG_NAME_INDEX_INIT() macro
+ * indexes the list '*pList' of 'type' records by their 'field' member.
+ */
+
+typedef struct
+{
+    GenericListPtr *pList;   /* head of the indexed list */
+    size_t nameOffset;       /* offset of the name (char *) in each item */
+    struct {
+        GenericListPtr item;
+        unsigned int hash;
+    } *slots;                /* NULL if the table could not be allocated */
+    unsigned int mask;       /* number of slots - 1 */
+    unsigned int count;      /* number of items in slots */
+}
+XConfigNameIndexRec, *XConfigNameIndexPtr;
+
+#define XCONFIG_NAME_INDEX_INIT(index, pList, type, field) \
+    xconfigNameIndexInit((index), (GenericListPtr *)(pList), \
+                         offsetof(type, field))
+
+
 #include "configProcs.h"
 #include <stdlib.h>
 
@@ -94,15 +149,19 @@ LexRec, *LexPtr;
     memset(ptr, 0, sizeof(typerec));
 
 
-#define HANDLE_LIST(field,func,type)                                    \
+/*
+ * 'tail' is a GenericListPtr local, initially NULL, that tracks the end
+ * of ptr->field; see xconfigAddListItemTail().
+ */
+#define HANDLE_LIST(field,tail,func,type)                               \
 {                                                                       \
     type p = func();                                                    \
     if (p == NULL) {                                                    \
         CLEANUP (&ptr);                                                 \
         return (NULL);                                                  \
     } else {                                                            \
-        xconfigAddListItem((GenericListPtr*)(&ptr->field),              \
-                           (GenericListPtr) p);                         \
+        xconfigAddListItemTail((GenericListPtr*)(&ptr->field), &tail,   \
+                               (GenericListPtr) p);                     \
     }                                                                   \
 }
 
@@ -30,8 +30,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec DRITab[] =
 {
     {ENDSECTION, "endsection"},
@@ -52,17 +50,18 @@ xconfigParseBuffers (void)
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER) {
         Error("Buffers count expected", NULL);
     }
-    ptr->count = val.num;
+    ptr->count = xconfigScan->val.num;
 
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER) {
         Error("Buffers size expected", NULL);
     }
-    ptr->size = val.num;
+    ptr->size = xconfigScan->val.num;
 
     if ((token = xconfigGetSubToken (&(ptr->comment))) == STRING) {
-        ptr->flags = val.str;
+        ptr->flags = xconfigScan->val.str;
         if ((token = xconfigGetToken (NULL)) == COMMENT)
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
         else
             xconfigUnGetToken(token);
     }
@@ -78,6 +77,7 @@ XConfigDRIPtr
 xconfigParseDRISection (void)
 {
     int token;
+    GenericListPtr buffersTail = NULL;
     PARSE_PROLOGUE (XConfigDRIPtr, XConfigDRIRec);
 
     /* Zero is a valid value for this. */
@@ -87,26 +87,26 @@ xconfigParseDRISection (void)
         {
         case GROUP:
         if ((token = xconfigGetSubToken (&(ptr->comment))) == STRING)
-            ptr->group_name = val.str;
+            ptr->group_name = xconfigScan->val.str;
         else if (token == NUMBER)
-            ptr->group = val.num;
+            ptr->group = xconfigScan->val.num;
         else
             Error (GROUP_MSG, NULL);
         break;
         case MODE:
         if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
             Error (NUMBER_MSG, "Mode");
-        ptr->mode = val.num;
+        ptr->mode = xconfigScan->val.num;
         break;
         case BUFFERS:
-        HANDLE_LIST (buffers, xconfigParseBuffers,
+        HANDLE_LIST (buffers, buffersTail, xconfigParseBuffers,
                  XConfigBuffersPtr);
         break;
         case EOF_TOKEN:
         Error (UNEXPECTED_EOF_MSG, NULL);
         break;
         case COMMENT:
-        ptr->comment = xconfigAddComment(ptr->comment, val.str);
+        ptr->comment = xconfigAddComment(ptr->comment, xconfigScan->val.str);
         break;
         default:
         Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
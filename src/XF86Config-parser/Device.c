@@ -61,8 +61,6 @@
 
 #include <ctype.h>
 
-extern LexRec val;
-
 static
 XConfigSymTabRec DeviceTab[] =
 {
@@ -111,45 +109,46 @@ xconfigParseDeviceSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case VENDOR:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Vendor");
-            ptr->vendor = val.str;
+            ptr->vendor = xconfigScan->val.str;
             break;
         case BOARD:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Board");
-            ptr->board = val.str;
+            ptr->board = xconfigScan->val.str;
             break;
         case CHIPSET:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Chipset");
-            ptr->chipset = val.str;
+            ptr->chipset = xconfigScan->val.str;
             break;
         case CARD:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Card");
-            ptr->card = val.str;
+            ptr->card = xconfigScan->val.str;
             break;
         case DRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = xconfigScan->val.str;
             break;
         case RAMDAC:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Ramdac");
-            ptr->ramdac = val.str;
+            ptr->ramdac = xconfigScan->val.str;
             break;
         case DACSPEED:
             for (i = 0; i < CONF_MAXDACSPEEDS; i++)
@@ -160,12 +159,13 @@ xconfigParseDeviceSection (void)
             }
             else
             {
-                ptr->dacSpeeds[0] = (int) (val.realnum * 1000.0 + 0.5);
+                ptr->dacSpeeds[0] =
+                    (int) (xconfigScan->val.realnum * 1000.0 + 0.5);
                 for (i = 1; i < CONF_MAXDACSPEEDS; i++)
                 {
                     if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
                         ptr->dacSpeeds[i] = (int)
-                            (val.realnum * 1000.0 + 0.5);
+                            (xconfigScan->val.realnum * 1000.0 + 0.5);
                     else
                     {
                         xconfigUnGetToken (token);
@@ -177,44 +177,44 @@ xconfigParseDeviceSection (void)
         case VIDEORAM:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "VideoRam");
-            ptr->videoram = val.num;
+            ptr->videoram = xconfigScan->val.num;
             break;
         case BIOSBASE:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "BIOSBase");
-            ptr->bios_base = val.num;
+            ptr->bios_base = xconfigScan->val.num;
             break;
         case MEMBASE:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "MemBase");
-            ptr->mem_base = val.num;
+            ptr->mem_base = xconfigScan->val.num;
             break;
         case IOBASE:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "IOBase");
-            ptr->io_base = val.num;
+            ptr->io_base = xconfigScan->val.num;
             break;
         case CLOCKCHIP:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "ClockChip");
-            ptr->clockchip = val.str;
+            ptr->clockchip = xconfigScan->val.str;
             break;
         case CHIPID:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "ChipID");
-            ptr->chipid = val.num;
+            ptr->chipid = xconfigScan->val.num;
             break;
         case CHIPREV:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "ChipRev");
-            ptr->chiprev = val.num;
+            ptr->chiprev = xconfigScan->val.num;
             break;
 
         case CLOCKS:
             token = xconfigGetSubToken(&(ptr->comment));
             for( i = ptr->clocks;
                 token == NUMBER && i < CONF_MAXCLOCKS; i++ ) {
-                ptr->clock[i] = (int)(val.realnum * 1000.0 + 0.5);
+                ptr->clock[i] = (int)(xconfigScan->val.realnum * 1000.0 + 0.5);
                 token = xconfigGetSubToken(&(ptr->comment));
             }
             ptr->clocks = i;
@@ -223,7 +223,7 @@ xconfigParseDeviceSection (void)
         case TEXTCLOCKFRQ:
             if ((token = xconfigGetSubToken(&(ptr->comment))) != NUMBER)
                 Error (NUMBER_MSG, "TextClockFreq");
-            ptr->textclockfreq = (int)(val.realnum * 1000.0 + 0.5);
+            ptr->textclockfreq = (int)(xconfigScan->val.realnum * 1000.0 + 0.5);
             break;
         case OPTION:
             ptr->options = xconfigParseOption(ptr->options);
@@ -231,17 +231,17 @@ xconfigParseDeviceSection (void)
         case BUSID:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "BusID");
-            ptr->busid = val.str;
+            ptr->busid = xconfigScan->val.str;
             break;
         case IRQ:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (QUOTE_MSG, "IRQ");
-            ptr->irq = val.num;
+            ptr->irq = xconfigScan->val.num;
             break;
         case SCREEN:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Screen");
-            ptr->screen = val.num;
+            ptr->screen = xconfigScan->val.num;
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
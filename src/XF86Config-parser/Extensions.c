@@ -35,8 +35,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec ExtensionsTab[] =
 {
     {ENDSECTION, "endsection"},
@@ -62,7 +60,8 @@ xconfigParseExtensionsSection (void)
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         default:
             Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
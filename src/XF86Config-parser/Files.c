@@ -61,8 +61,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec FilesTab[] =
 {
     {ENDSECTION, "endsection"},
@@ -96,13 +94,14 @@ xconfigParseFilesSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case FONTPATH:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "FontPath");
             j = FALSE;
-            str = prependRoot (val.str);
+            str = prependRoot (xconfigScan->val.str);
             if (ptr->fontpath == NULL)
             {
                 ptr->fontpath = malloc (1);
@@ -123,18 +122,18 @@ xconfigParseFilesSection (void)
                 strcat (ptr->fontpath, ",");
 
             strcat (ptr->fontpath, str);
-            free (val.str);
+            free (xconfigScan->val.str);
             break;
         case RGBPATH:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "RGBPath");
-            ptr->rgbpath = val.str;
+            ptr->rgbpath = xconfigScan->val.str;
             break;
         case MODULEPATH:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "ModulePath");
             l = FALSE;
-            str = prependRoot (val.str);
+            str = prependRoot (xconfigScan->val.str);
             if (ptr->modulepath == NULL)
             {
                 ptr->modulepath = malloc (1);
@@ -155,13 +154,13 @@ xconfigParseFilesSection (void)
                 strcat (ptr->modulepath, ",");
 
             strcat (ptr->modulepath, str);
-            free (val.str);
+            free (xconfigScan->val.str);
             break;
         case INPUTDEVICES:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "InputDevices");
             l = FALSE;
-            str = prependRoot (val.str);
+            str = prependRoot (xconfigScan->val.str);
             if (ptr->inputdevs == NULL)
             {
                 ptr->inputdevs = malloc (1);
@@ -182,12 +181,12 @@ xconfigParseFilesSection (void)
                 strcat (ptr->inputdevs, ",");
 
             strcat (ptr->inputdevs, str);
-            free (val.str);
+            free (xconfigScan->val.str);
             break;
         case LOGFILEPATH:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "LogFile");
-            ptr->logfile = val.str;
+            ptr->logfile = xconfigScan->val.str;
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
@@ -61,8 +61,6 @@
 #include <math.h>
 #include "common-utils.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec ServerFlagsTab[] =
 {
     {ENDSECTION, "endsection"},
@@ -99,7 +97,8 @@ xconfigParseFlagsSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
             /* 
              * these old keywords are turned into standard generic options.
@@ -134,11 +133,11 @@ xconfigParseFlagsSection (void)
                             if (strvalue) {
                                 if (tokentype != STRING)
                                     Error (QUOTE_MSG, ServerFlagsTab[i].name);
-                                valstr = val.str;
+                                valstr = xconfigScan->val.str;
                             } else {
                                 if (tokentype != NUMBER)
                                     Error (NUMBER_MSG, ServerFlagsTab[i].name);
-                                snprintf(buff, 16, "%d", val.num);
+                                snprintf(buff, 16, "%d", xconfigScan->val.num);
                                 valstr = buff;
                             }
                         }
@@ -182,16 +181,46 @@ xconfigPrintServerFlagsSection (FILE * f, XConfigFlagsPtr flags)
     fprintf (f, "EndSection\n\n");
 }
 
+/*
+ * find_option() - xconfigFindOption() that also returns the last option
+ * of the list in *pLast, so that a caller that does not find the name
+ * can append to the list without walking it a second time.
+ */
+
+static XConfigOptionPtr
+find_option (XConfigOptionPtr list, const char *name, XConfigOptionPtr *pLast)
+{
+    *pLast = NULL;
+
+    while (list)
+    {
+        if (xconfigNameCompare (list->name, name) == 0)
+            return (list);
+        *pLast = list;
+        list = list->next;
+    }
+    return (NULL);
+}
+
+static void
+append_option (XConfigOptionPtr *pHead, XConfigOptionPtr last,
+               XConfigOptionPtr new)
+{
+    if (last)
+        last->next = new;
+    else
+        *pHead = new;
+}
+
 void
 xconfigAddNewOption (XConfigOptionPtr *pHead, const char *name,
                      const char *val)
 {
     XConfigOptionPtr new;
-    XConfigOptionPtr old = NULL;
+    XConfigOptionPtr old, last;
 
     /* Don't allow duplicates */
-    if (*pHead != NULL &&
-        ((old = xconfigFindOption(*pHead, name)) != NULL)) {
+    if ((old = find_option(*pHead, name, &last)) != NULL) {
         TEST_FREE(old->name);
         TEST_FREE(old->val);
         new = old;
@@ -203,7 +232,7 @@ xconfigAddNewOption (XConfigOptionPtr *pHead, const char *name,
     new->val = xconfigStrdup(val);
     
     if (old == NULL) {
-        xconfigAddListItem((GenericListPtr *)(pHead), (GenericListPtr)new);
+        append_option(pHead, last, new);
     }
 }
 
@@ -435,7 +464,7 @@ xconfigULongToString(unsigned long i)
 XConfigOptionPtr
 xconfigParseOption(XConfigOptionPtr head)
 {
-    XConfigOptionPtr option, cnew, old;
+    XConfigOptionPtr option, cnew, old, last;
     char *name, *comment = NULL;
     int token;
 
@@ -446,12 +475,13 @@ xconfigParseOption(XConfigOptionPtr head)
         return (head);
     }
 
-    name = val.str;
+    name = xconfigScan->val.str;
     if ((token = xconfigGetSubToken(&comment)) == STRING) {
-        option = xconfigNewOption(name, val.str);
+        option = xconfigNewOption(name, xconfigScan->val.str);
         option->comment = comment;
         if ((token = xconfigGetToken(NULL)) == COMMENT)
-            option->comment = xconfigAddComment(option->comment, val.str);
+            option->comment = xconfigAddComment(option->comment,
+                                                xconfigScan->val.str);
         else
             xconfigUnGetToken(token);
     }
@@ -459,15 +489,14 @@ xconfigParseOption(XConfigOptionPtr head)
         option = xconfigNewOption(name, NULL);
         option->comment = comment;
         if (token == COMMENT)
-            option->comment = xconfigAddComment(option->comment, val.str);
+            option->comment = xconfigAddComment(option->comment,
+                                                xconfigScan->val.str);
         else
             xconfigUnGetToken(token);
     }
 
-    old = NULL;
-
     /* Don't allow duplicates */
-    if (head != NULL && (old = xconfigFindOption(head, name)) != NULL) {
+    if ((old = find_option(head, name, &last)) != NULL) {
         cnew = old;
         free(option->name);
         TEST_FREE(option->val);
@@ -478,7 +507,7 @@ xconfigParseOption(XConfigOptionPtr head)
         cnew = option;
     
     if (old == NULL) {
-        xconfigAddListItem((GenericListPtr *)(&head), (GenericListPtr)cnew);
+        append_option(&head, last, cnew);
     }
 
     return head;
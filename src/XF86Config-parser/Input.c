@@ -59,8 +59,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static
 XConfigSymTabRec InputTab[] =
 {
@@ -108,20 +106,21 @@ xconfigParseInputSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case DRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = xconfigScan->val.str;
             break;
         case OPTION:
             ptr->options = xconfigParseOption(ptr->options);
@@ -157,90 +156,91 @@ xconfigParseInputClassSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case DRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = xconfigScan->val.str;
             break;
         case MATCHDEVICEPATH:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchDevicePath");
-            ptr->match_device_path = val.str;
+            ptr->match_device_path = xconfigScan->val.str;
             break;
         case MATCHISPOINTER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsPointer");
-            ptr->match_is_pointer = val.str;
+            ptr->match_is_pointer = xconfigScan->val.str;
             break;
         case MATCHISTOUCHPAD:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsTouchpad");
-            ptr->match_is_touchpad = val.str;
+            ptr->match_is_touchpad = xconfigScan->val.str;
             break;
         case MATCHISKEYBOARD:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsKeyboard");
-            ptr->match_is_keyboard = val.str;
+            ptr->match_is_keyboard = xconfigScan->val.str;
             break;
         case MATCHISTOUCHSCREEN:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsTouchscreen");
-            ptr->match_is_touchscreen = val.str;
+            ptr->match_is_touchscreen = xconfigScan->val.str;
             break;
         case MATCHISJOYSTICK:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsJoystick");
-            ptr->match_is_joystick = val.str;
+            ptr->match_is_joystick = xconfigScan->val.str;
             break;
         case MATCHISTABLET:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsTablet");
-            ptr->match_is_tablet = val.str;
+            ptr->match_is_tablet = xconfigScan->val.str;
             break;
         case MATCHUSBID:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchUSBID");
-            ptr->match_usb_id = val.str;
+            ptr->match_usb_id = xconfigScan->val.str;
             break;
         case MATCHPNPID:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchPnPID");
-            ptr->match_pnp_id = val.str;
+            ptr->match_pnp_id = xconfigScan->val.str;
             break;
         case MATCHPRODUCT:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchProduct");
-            ptr->match_product = val.str;
+            ptr->match_product = xconfigScan->val.str;
             break;
         case MATCHDRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchDriver");
-            ptr->match_driver = val.str;
+            ptr->match_driver = xconfigScan->val.str;
             break;
         case MATCHOS:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchOS");
-            ptr->match_os = val.str;
+            ptr->match_os = xconfigScan->val.str;
             break;
         case MATCHTAG:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchTag");
-            ptr->match_tag = val.str;
+            ptr->match_tag = xconfigScan->val.str;
             break;
         case MATCHVENDOR:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchVendor");
-            ptr->match_vendor = val.str;
+            ptr->match_vendor = xconfigScan->val.str;
             break;
         case OPTION:
             ptr->options = xconfigParseOption(ptr->options);
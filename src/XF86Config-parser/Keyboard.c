@@ -60,8 +60,6 @@
 #include "Configint.h"
 #include "ctype.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec KeyboardTab[] =
 {
     {ENDSECTION, "endsection"},
@@ -121,20 +119,22 @@ xconfigParseKeyboardSection (void)
             switch (token)
             {
             case COMMENT:
-                ptr->comment = xconfigAddComment(ptr->comment, val.str);
+                ptr->comment = xconfigAddComment(ptr->comment,
+                                                 xconfigScan->val.str);
                 break;
             case KPROTOCOL:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "Protocol");
-                xconfigAddNewOption(&ptr->options, "Protocol", val.str);
+                xconfigAddNewOption(&ptr->options, "Protocol",
+                                    xconfigScan->val.str);
                 break;
             case AUTOREPEAT:
                 if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                     Error (AUTOREPEAT_MSG, NULL);
-                s1 = xconfigULongToString(val.num);
+                s1 = xconfigULongToString(xconfigScan->val.num);
                 if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                     Error (AUTOREPEAT_MSG, NULL);
-                s2 = xconfigULongToString(val.num);
+                s2 = xconfigULongToString(xconfigScan->val.num);
                 l = strlen(s1) + 1 + strlen(s2) + 1;
                 s = malloc(l);
                 sprintf(s, "%s %s", s1, s2);
@@ -145,11 +145,11 @@ xconfigParseKeyboardSection (void)
             case XLEDS:
                 if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                     Error (XLEDS_MSG, NULL);
-                s = xconfigULongToString(val.num);
+                s = xconfigULongToString(xconfigScan->val.num);
                 l = strlen(s) + 1;
                 while ((token = xconfigGetSubToken(&(ptr->comment))) == NUMBER)
                 {
-                    s1 = xconfigULongToString(val.num);
+                    s1 = xconfigULongToString(xconfigScan->val.num);
                     l += (1 + strlen(s1));
                     s = realloc(s, l);
                     strcat(s, " ");
@@ -198,57 +198,68 @@ xconfigParseKeyboardSection (void)
             case XKBKEYMAP:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBKeymap");
-                xconfigAddNewOption(&ptr->options, "XkbKeymap", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbKeymap",
+                                    xconfigScan->val.str);
                 break;
             case XKBCOMPAT:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBCompat");
-                xconfigAddNewOption(&ptr->options, "XkbCompat", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbCompat",
+                                    xconfigScan->val.str);
                 break;
             case XKBTYPES:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBTypes");
-                xconfigAddNewOption(&ptr->options, "XkbTypes", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbTypes",
+                                    xconfigScan->val.str);
                 break;
             case XKBKEYCODES:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBKeycodes");
-                xconfigAddNewOption(&ptr->options, "XkbKeycodes", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbKeycodes",
+                                    xconfigScan->val.str);
                 break;
             case XKBGEOMETRY:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBGeometry");
-                xconfigAddNewOption(&ptr->options, "XkbGeometry", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbGeometry",
+                                    xconfigScan->val.str);
                 break;
             case XKBSYMBOLS:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBSymbols");
-                xconfigAddNewOption(&ptr->options, "XkbSymbols", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbSymbols",
+                                    xconfigScan->val.str);
                 break;
             case XKBRULES:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBRules");
-                xconfigAddNewOption(&ptr->options, "XkbRules", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbRules",
+                                    xconfigScan->val.str);
                 break;
             case XKBMODEL:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBModel");
-                xconfigAddNewOption(&ptr->options, "XkbModel", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbModel",
+                                    xconfigScan->val.str);
                 break;
             case XKBLAYOUT:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBLayout");
-                xconfigAddNewOption(&ptr->options, "XkbLayout", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbLayout",
+                                    xconfigScan->val.str);
                 break;
             case XKBVARIANT:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBVariant");
-                xconfigAddNewOption(&ptr->options, "XkbVariant", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbVariant",
+                                    xconfigScan->val.str);
                 break;
             case XKBOPTIONS:
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBOptions");
-                xconfigAddNewOption(&ptr->options, "XkbOptions", val.str);
+                xconfigAddNewOption(&ptr->options, "XkbOptions",
+                                    xconfigScan->val.str);
                 break;
             case PANIX106:
                 xconfigAddNewOption(&ptr->options, "Panix106", NULL);
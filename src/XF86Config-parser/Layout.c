@@ -60,8 +60,6 @@
 #include "Configint.h"
 #include <string.h>
 
-extern LexRec val;
-
 static XConfigSymTabRec LayoutTab[] =
 {
     {ENDSECTION, "endsection"},
@@ -95,6 +93,9 @@ xconfigParseLayoutSection (void)
 {
     int has_ident = FALSE;
     int token;
+    GenericListPtr inactivesTail = NULL;
+    GenericListPtr adjacenciesTail = NULL;
+    GenericListPtr inputsTail = NULL;
     PARSE_PROLOGUE (XConfigLayoutPtr, XConfigLayoutRec)
 
     while ((token = xconfigGetToken (LayoutTab)) != ENDSECTION)
@@ -102,14 +103,15 @@ xconfigParseLayoutSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case INACTIVE:
@@ -120,9 +122,9 @@ xconfigParseLayoutSection (void)
                 iptr->next = NULL;
                 if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                     Error (INACTIVE_MSG, NULL);
-                iptr->device_name = val.str;
-                xconfigAddListItem((GenericListPtr *)(&ptr->inactives),
-                                   (GenericListPtr) iptr);
+                iptr->device_name = xconfigScan->val.str;
+                xconfigAddListItemTail((GenericListPtr *)(&ptr->inactives),
+                                       &inactivesTail, (GenericListPtr) iptr);
             }
             break;
         case SCREEN:
@@ -138,13 +140,13 @@ xconfigParseLayoutSection (void)
                 aptr->y = 0;
                 aptr->refscreen = NULL;
                 if ((token = xconfigGetSubToken (&(ptr->comment))) == NUMBER)
-                    aptr->scrnum = val.num;
+                    aptr->scrnum = xconfigScan->val.num;
                 else
                     xconfigUnGetToken (token);
                 token = xconfigGetSubToken(&(ptr->comment));
                 if (token != STRING)
                     Error (SCREEN_MSG, NULL);
-                aptr->screen_name = val.str;
+                aptr->screen_name = xconfigScan->val.str;
 
                 token = xconfigGetSubTokenWithTab(&(ptr->comment), AdjTab);
                 switch (token)
@@ -186,11 +188,11 @@ xconfigParseLayoutSection (void)
                         token = xconfigGetSubToken(&(ptr->comment));
                     if (token == NUMBER)
                     {
-                        aptr->x = val.num;
+                        aptr->x = xconfigScan->val.num;
                         token = xconfigGetSubToken(&(ptr->comment));
                         if (token != NUMBER)
                             Error(INVALID_SCR_MSG, NULL);
-                        aptr->y = val.num;
+                        aptr->y = xconfigScan->val.num;
                     } else {
                         if (absKeyword)
                             Error(INVALID_SCR_MSG, NULL);
@@ -206,41 +208,41 @@ xconfigParseLayoutSection (void)
                     token = xconfigGetSubToken(&(ptr->comment));
                     if (token != STRING)
                         Error(INVALID_SCR_MSG, NULL);
-                    aptr->refscreen = val.str;
+                    aptr->refscreen = xconfigScan->val.str;
                     if (aptr->where == CONF_ADJ_RELATIVE)
                     {
                         token = xconfigGetSubToken(&(ptr->comment));
                         if (token != NUMBER)
                             Error(INVALID_SCR_MSG, NULL);
-                        aptr->x = val.num;
+                        aptr->x = xconfigScan->val.num;
                         token = xconfigGetSubToken(&(ptr->comment));
                         if (token != NUMBER)
                             Error(INVALID_SCR_MSG, NULL);
-                        aptr->y = val.num;
+                        aptr->y = xconfigScan->val.num;
                     }
                     break;
                 case CONF_ADJ_OBSOLETE:
                     /* top */
-                    aptr->top_name = val.str;
+                    aptr->top_name = xconfigScan->val.str;
 
                     /* bottom */
                     if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                         Error (SCREEN_MSG, NULL);
-                    aptr->bottom_name = val.str;
+                    aptr->bottom_name = xconfigScan->val.str;
 
                     /* left */
                     if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                         Error (SCREEN_MSG, NULL);
-                    aptr->left_name = val.str;
+                    aptr->left_name = xconfigScan->val.str;
 
                     /* right */
                     if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                         Error (SCREEN_MSG, NULL);
-                    aptr->right_name = val.str;
+                    aptr->right_name = xconfigScan->val.str;
 
                 }
-                xconfigAddListItem((GenericListPtr *)(&ptr->adjacencies),
-                                   (GenericListPtr) aptr);
+                xconfigAddListItemTail((GenericListPtr *)(&ptr->adjacencies),
+                                       &adjacenciesTail, (GenericListPtr) aptr);
             }
             break;
         case INPUTDEVICE:
@@ -252,13 +254,14 @@ xconfigParseLayoutSection (void)
                 iptr->options = NULL;
                 if (xconfigGetSubToken(&(ptr->comment)) != STRING)
                     Error (INPUTDEV_MSG, NULL);
-                iptr->input_name = val.str;
+                iptr->input_name = xconfigScan->val.str;
                 while ((token = xconfigGetSubToken(&(ptr->comment))) == STRING) {
-                    xconfigAddNewOption(&iptr->options, val.str, NULL);
+                    xconfigAddNewOption(&iptr->options, xconfigScan->val.str,
+                                        NULL);
                 }
                 xconfigUnGetToken(token);
-                xconfigAddListItem((GenericListPtr *)(&ptr->inputs),
-                                   (GenericListPtr) iptr);
+                xconfigAddListItemTail((GenericListPtr *)(&ptr->inputs),
+                                       &inputsTail, (GenericListPtr) iptr);
             }
             break;
         case OPTION:
@@ -440,6 +443,8 @@ xconfigValidateLayout (XConfigPtr p)
     XConfigScreenPtr screen;
     XConfigDevicePtr device;
     XConfigInputPtr input;
+    XConfigNameIndexRec screens, devices, inputs;
+    int ret = FALSE;
 
     /*
      * if we do not have a layout, just return TRUE; we'll add a
@@ -448,18 +453,26 @@ xconfigValidateLayout (XConfigPtr p)
 
     if (!layout) return TRUE;
 
+    XCONFIG_NAME_INDEX_INIT(&screens, &p->screens,
+                            XConfigScreenRec, identifier);
+    XCONFIG_NAME_INDEX_INIT(&devices, &p->devices,
+                            XConfigDeviceRec, identifier);
+    XCONFIG_NAME_INDEX_INIT(&inputs, &p->inputs,
+                            XConfigInputRec, identifier);
+
     while (layout)
     {
         adj = layout->adjacencies;
         while (adj)
         {
             /* the first one can't be "" but all others can */
-            screen = xconfigFindScreen (adj->screen_name, p->screens);
+            screen = (XConfigScreenPtr)
+                xconfigNameIndexFind(&screens, adj->screen_name);
             if (!screen)
             {
                 xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_SCREEN_MSG,
                              adj->screen_name, layout->identifier);
-                return (FALSE);
+                goto done;
             }
             else
                 adj->screen = screen;
@@ -479,13 +492,13 @@ xconfigValidateLayout (XConfigPtr p)
         iptr = layout->inactives;
         while (iptr)
         {
-            device = xconfigFindDevice (iptr->device_name,
-                                     p->devices);
+            device = (XConfigDevicePtr)
+                xconfigNameIndexFind(&devices, iptr->device_name);
             if (!device)
             {
                 xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_DEVICE_MSG,
                              iptr->device_name, layout->identifier);
-                return (FALSE);
+                goto done;
             }
             else
                 iptr->device = device;
@@ -501,13 +514,13 @@ xconfigValidateLayout (XConfigPtr p)
         inputRef = layout->inputs;
         while (inputRef)
         {
-            input = xconfigFindInput (inputRef->input_name,
-                                   p->inputs);
+            input = (XConfigInputPtr)
+                xconfigNameIndexFind(&inputs, inputRef->input_name);
             if (!input)
             {
                 xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_INPUT_MSG,
                              inputRef->input_name, layout->identifier);
-                return (FALSE);
+                goto done;
             }
             else {
                 inputRef->input = input;
@@ -516,7 +529,15 @@ xconfigValidateLayout (XConfigPtr p)
         }
         layout = layout->next;
     }
-    return (TRUE);
+
+    ret = TRUE;
+
+ done:
+    xconfigNameIndexFree(&screens);
+    xconfigNameIndexFree(&devices);
+    xconfigNameIndexFree(&inputs);
+
+    return ret;
 }
 
 int
@@ -271,7 +271,11 @@ static int xconfigMergeAllMonitors(XConfigPtr dstConfig, XConfigPtr srcConfig)
 {
     XConfigMonitorPtr dstMonitor;
     XConfigMonitorPtr srcMonitor;
+    XConfigNameIndexRec dstMonitors;
+    GenericListPtr tail = NULL;
 
+    XCONFIG_NAME_INDEX_INIT(&dstMonitors, &dstConfig->monitors,
+                            XConfigMonitorRec, identifier);
 
     /* Make sure all monitors in the src config are also in the dst config */
 
@@ -279,25 +283,31 @@ static int xconfigMergeAllMonitors(XConfigPtr dstConfig, XConfigPtr srcConfig)
          srcMonitor;
          srcMonitor = srcMonitor->next) {
 
-        dstMonitor =
-            xconfigFindMonitor(srcMonitor->identifier, dstConfig->monitors);
+        dstMonitor = (XConfigMonitorPtr)
+            xconfigNameIndexFind(&dstMonitors, srcMonitor->identifier);
 
         /* Monitor section was not found, create a new one and add it */
         if (!dstMonitor) {
             dstMonitor =
                 (XConfigMonitorPtr) calloc(1, sizeof(XConfigMonitorRec));
-            if (!dstMonitor) return 0;
+            if (!dstMonitor) {
+                xconfigNameIndexFree(&dstMonitors);
+                return 0;
+            }
 
             dstMonitor->identifier = xconfigStrdup(srcMonitor->identifier);
 
-            xconfigAddListItem((GenericListPtr *)(&dstConfig->monitors),
-                               (GenericListPtr)dstMonitor);
+            xconfigAddListItemTail((GenericListPtr *)(&dstConfig->monitors),
+                                   &tail, (GenericListPtr)dstMonitor);
+            xconfigNameIndexAdd(&dstMonitors, (GenericListPtr)dstMonitor);
         }
 
         /* Do the merge */
         xconfigMergeMonitors(dstMonitor, srcMonitor);
     }
 
+    xconfigNameIndexFree(&dstMonitors);
+
     return 1;
 
 } /* xconfigMergeAllMonitors() */
@@ -361,7 +371,11 @@ static int xconfigMergeAllDevices(XConfigPtr dstConfig, XConfigPtr srcConfig)
 {
     XConfigDevicePtr dstDevice;
     XConfigDevicePtr srcDevice;
+    XConfigNameIndexRec dstDevices;
+    GenericListPtr tail = NULL;
 
+    XCONFIG_NAME_INDEX_INIT(&dstDevices, &dstConfig->devices,
+                            XConfigDeviceRec, identifier);
 
     /* Make sure all monitors in the src config are also in the dst config */
 
@@ -369,25 +383,31 @@ static int xconfigMergeAllDevices(XConfigPtr dstConfig, XConfigPtr srcConfig)
          srcDevice;
          srcDevice = srcDevice->next) {
 
-        dstDevice =
-            xconfigFindDevice(srcDevice->identifier, dstConfig->devices);
+        dstDevice = (XConfigDevicePtr)
+            xconfigNameIndexFind(&dstDevices, srcDevice->identifier);
         
         /* Device section was not found, create a new one and add it */
         if (!dstDevice) {
             dstDevice =
                 (XConfigDevicePtr) calloc(1, sizeof(XConfigDeviceRec));
-            if (!dstDevice) return 0;
+            if (!dstDevice) {
+                xconfigNameIndexFree(&dstDevices);
+                return 0;
+            }
 
             dstDevice->identifier = xconfigStrdup(srcDevice->identifier);
 
-            xconfigAddListItem((GenericListPtr *)(&dstConfig->devices),
-                               (GenericListPtr)dstDevice);
+            xconfigAddListItemTail((GenericListPtr *)(&dstConfig->devices),
+                                   &tail, (GenericListPtr)dstDevice);
+            xconfigNameIndexAdd(&dstDevices, (GenericListPtr)dstDevice);
         }
 
         /* Do the merge */
         xconfigMergeDevices(dstDevice, srcDevice);
     }
 
+    xconfigNameIndexFree(&dstDevices);
+
     return 1;
 
 } /* xconfigMergeAllDevices() */
@@ -536,31 +556,32 @@ static int xconfigMergeDisplays(XConfigScreenPtr dstScreen,
 
 /*
  * xconfigMergeScreens() - Updates information in the destination screen
- * with that of the source screen.
+ * with that of the source screen.  'dstDevices' and 'dstMonitors' index
+ * the destination config's devices and monitors.
  *
  * NOTE: This assumes the Monitor and Device sections have already been
  *       merged.
  *
  */
 static void xconfigMergeScreens(XConfigScreenPtr dstScreen,
-                                XConfigPtr dstConfig,
-                                XConfigScreenPtr srcScreen,
-                                XConfigPtr srcConfig)
+                                XConfigNameIndexPtr dstDevices,
+                                XConfigNameIndexPtr dstMonitors,
+                                XConfigScreenPtr srcScreen)
 {
     /* Use the right device */
     
     free(dstScreen->device_name);
     dstScreen->device_name = xconfigStrdup(srcScreen->device_name);
-    dstScreen->device =
-        xconfigFindDevice(dstScreen->device_name, dstConfig->devices);
+    dstScreen->device = (XConfigDevicePtr)
+        xconfigNameIndexFind(dstDevices, dstScreen->device_name);
     
 
     /* Use the right monitor */
     
     free(dstScreen->monitor_name);
     dstScreen->monitor_name = xconfigStrdup(srcScreen->monitor_name);
-    dstScreen->monitor =
-        xconfigFindMonitor(dstScreen->monitor_name, dstConfig->monitors);
+    dstScreen->monitor = (XConfigMonitorPtr)
+        xconfigNameIndexFind(dstMonitors, dstScreen->monitor_name);
     
 
     /* Update the right default depth */
@@ -591,7 +612,16 @@ static int xconfigMergeAllScreens(XConfigPtr dstConfig, XConfigPtr srcConfig)
 {
     XConfigScreenPtr srcScreen;
     XConfigScreenPtr dstScreen;
+    XConfigNameIndexRec dstScreens, dstDevices, dstMonitors;
+    GenericListPtr tail = NULL;
+    int ret = 0;
 
+    XCONFIG_NAME_INDEX_INIT(&dstScreens, &dstConfig->screens,
+                            XConfigScreenRec, identifier);
+    XCONFIG_NAME_INDEX_INIT(&dstDevices, &dstConfig->devices,
+                            XConfigDeviceRec, identifier);
+    XCONFIG_NAME_INDEX_INIT(&dstMonitors, &dstConfig->monitors,
+                            XConfigMonitorRec, identifier);
 
     /* Make sure all src screens are in the dst config */
 
@@ -599,26 +629,34 @@ static int xconfigMergeAllScreens(XConfigPtr dstConfig, XConfigPtr srcConfig)
          srcScreen;
          srcScreen = srcScreen->next) {
 
-        dstScreen =
-            xconfigFindScreen(srcScreen->identifier, dstConfig->screens);
+        dstScreen = (XConfigScreenPtr)
+            xconfigNameIndexFind(&dstScreens, srcScreen->identifier);
 
         /* Screen section was not found, create a new one and add it */
         if (!dstScreen) {
             dstScreen =
                 (XConfigScreenPtr) calloc(1, sizeof(XConfigScreenRec));
-            if (!dstScreen) return 0;
+            if (!dstScreen) goto done;
 
             dstScreen->identifier = xconfigStrdup(srcScreen->identifier);
 
-            xconfigAddListItem((GenericListPtr *)(&dstConfig->screens),
-                               (GenericListPtr)dstScreen);
+            xconfigAddListItemTail((GenericListPtr *)(&dstConfig->screens),
+                                   &tail, (GenericListPtr)dstScreen);
+            xconfigNameIndexAdd(&dstScreens, (GenericListPtr)dstScreen);
         }
 
         /* Do the merge */
-        xconfigMergeScreens(dstScreen, dstConfig, srcScreen, srcConfig);
+        xconfigMergeScreens(dstScreen, &dstDevices, &dstMonitors, srcScreen);
     }
 
-    return 1;
+    ret = 1;
+
+ done:
+    xconfigNameIndexFree(&dstScreens);
+    xconfigNameIndexFree(&dstDevices);
+    xconfigNameIndexFree(&dstMonitors);
+
+    return ret;
 
 } /* xconfigMergeAllScreens() */
 
@@ -637,11 +675,15 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
     XConfigAdjacencyPtr srcAdj;
     XConfigAdjacencyPtr dstAdj;
     XConfigAdjacencyPtr lastDstAdj;
+    XConfigNameIndexRec dstScreens;
 
     if (!dstLayout || !srcLayout) {
         return 0;
     }
 
+    XCONFIG_NAME_INDEX_INIT(&dstScreens, &dstConfig->screens,
+                            XConfigScreenRec, identifier);
+
     /* Clear the destination's adjacency list */
 
     xconfigFreeAdjacencyList(&dstLayout->adjacencies);
@@ -668,16 +710,16 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
         dstAdj->y = srcAdj->y;
         dstAdj->refscreen = xconfigStrdup(srcAdj->refscreen);
 
-        dstAdj->screen =
-            xconfigFindScreen(dstAdj->screen_name, dstConfig->screens);
-        dstAdj->top =
-            xconfigFindScreen(dstAdj->top_name, dstConfig->screens);
-        dstAdj->bottom =
-            xconfigFindScreen(dstAdj->bottom_name, dstConfig->screens);
-        dstAdj->left =
-            xconfigFindScreen(dstAdj->left_name, dstConfig->screens);
-        dstAdj->right =
-            xconfigFindScreen(dstAdj->right_name, dstConfig->screens);
+        dstAdj->screen = (XConfigScreenPtr)
+            xconfigNameIndexFind(&dstScreens, dstAdj->screen_name);
+        dstAdj->top = (XConfigScreenPtr)
+            xconfigNameIndexFind(&dstScreens, dstAdj->top_name);
+        dstAdj->bottom = (XConfigScreenPtr)
+            xconfigNameIndexFind(&dstScreens, dstAdj->bottom_name);
+        dstAdj->left = (XConfigScreenPtr)
+            xconfigNameIndexFind(&dstScreens, dstAdj->left_name);
+        dstAdj->right = (XConfigScreenPtr)
+            xconfigNameIndexFind(&dstScreens, dstAdj->right_name);
 
         /* Add adjacency at the end of the list */
         
@@ -691,6 +733,8 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
         srcAdj = srcAdj->next;
     }
 
+    xconfigNameIndexFree(&dstScreens);
+
     /* Merge the options */
     
     if (srcLayout->options) {
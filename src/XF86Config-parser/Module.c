@@ -59,8 +59,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec SubModuleTab[] =
 {
     {ENDSUBSECTION, "endsubsection"},
@@ -96,7 +94,8 @@ xconfigParseModuleSubSection (XConfigLoadPtr head, char *name)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case OPTION:
             ptr->opt = xconfigParseOption(ptr->opt);
@@ -130,31 +129,32 @@ xconfigParseModuleSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case LOAD:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Load");
-            xconfigAddNewLoadDirective (&ptr->loads, val.str,
+            xconfigAddNewLoadDirective (&ptr->loads, xconfigScan->val.str,
                                         XCONFIG_LOAD_MODULE, NULL, TRUE);
             break;
         case LOAD_DRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "LoadDriver");
-            xconfigAddNewLoadDirective (&ptr->loads, val.str,
+            xconfigAddNewLoadDirective (&ptr->loads, xconfigScan->val.str,
                                         XCONFIG_LOAD_DRIVER, NULL, TRUE);
             break;
         case DISABLE:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Disable");
-            xconfigAddNewLoadDirective (&ptr->disables, val.str,
+            xconfigAddNewLoadDirective (&ptr->disables, xconfigScan->val.str,
                                         XCONFIG_DISABLE_MODULE, NULL, TRUE);
             break;
         case SUBSECTION:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                         Error (QUOTE_MSG, "SubSection");
             ptr->loads =
-                xconfigParseModuleSubSection (ptr->loads, val.str);
+                xconfigParseModuleSubSection (ptr->loads, xconfigScan->val.str);
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
@@ -245,7 +245,8 @@ xconfigAddNewLoadDirective (XConfigLoadPtr *pHead, char *name, int type,
 
     if (do_token) {
         if ((token = xconfigGetToken(NULL)) == COMMENT) {
-            new->comment = xconfigAddComment(new->comment, val.str);
+            new->comment = xconfigAddComment(new->comment,
+                                             xconfigScan->val.str);
         } else {
             xconfigUnGetToken(token);
         }
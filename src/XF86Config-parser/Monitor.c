@@ -59,8 +59,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec MonitorTab[] =
 {
     {ENDSECTION, "endsection"},
@@ -129,52 +127,53 @@ xconfigParseModeLine (void)
     /* Identifier */
     if (xconfigGetSubToken (&(ptr->comment)) != STRING)
         Error ("ModeLine identifier expected", NULL);
-    ptr->identifier = val.str;
+    ptr->identifier = xconfigScan->val.str;
 
     /* DotClock */
-    if ((xconfigGetSubToken (&(ptr->comment)) != NUMBER) || !val.str)
+    if ((xconfigGetSubToken (&(ptr->comment)) != NUMBER) ||
+        !xconfigScan->val.str)
         Error ("ModeLine dotclock expected", NULL);
-    ptr->clock = xconfigStrdup(val.str);
+    ptr->clock = xconfigStrdup(xconfigScan->val.str);
 
     /* HDisplay */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine Hdisplay expected", NULL);
-    ptr->hdisplay = val.num;
+    ptr->hdisplay = xconfigScan->val.num;
 
     /* HSyncStart */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine HSyncStart expected", NULL);
-    ptr->hsyncstart = val.num;
+    ptr->hsyncstart = xconfigScan->val.num;
 
     /* HSyncEnd */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine HSyncEnd expected", NULL);
-    ptr->hsyncend = val.num;
+    ptr->hsyncend = xconfigScan->val.num;
 
     /* HTotal */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine HTotal expected", NULL);
-    ptr->htotal = val.num;
+    ptr->htotal = xconfigScan->val.num;
 
     /* VDisplay */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine Vdisplay expected", NULL);
-    ptr->vdisplay = val.num;
+    ptr->vdisplay = xconfigScan->val.num;
 
     /* VSyncStart */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine VSyncStart expected", NULL);
-    ptr->vsyncstart = val.num;
+    ptr->vsyncstart = xconfigScan->val.num;
 
     /* VSyncEnd */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine VSyncEnd expected", NULL);
-    ptr->vsyncend = val.num;
+    ptr->vsyncend = xconfigScan->val.num;
 
     /* VTotal */
     if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
         Error ("ModeLine VTotal expected", NULL);
-    ptr->vtotal = val.num;
+    ptr->vtotal = xconfigScan->val.num;
 
     token = xconfigGetSubTokenWithTab (&(ptr->comment), TimingTab);
     while ((token == TT_INTERLACE) || (token == TT_PHSYNC) ||
@@ -217,7 +216,7 @@ xconfigParseModeLine (void)
         case TT_HSKEW:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Hskew");
-            ptr->hskew = val.num;
+            ptr->hskew = xconfigScan->val.num;
             ptr->flags |= XCONFIG_MODE_HSKEW;
             break;
         case TT_BCAST:
@@ -226,7 +225,7 @@ xconfigParseModeLine (void)
         case TT_VSCAN:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Vscan");
-            ptr->vscan = val.num;
+            ptr->vscan = xconfigScan->val.num;
             ptr->flags |= XCONFIG_MODE_VSCAN;
             break;
         case TT_CUSTOM:
@@ -255,60 +254,62 @@ xconfigParseVerboseMode (void)
 
         if (xconfigGetSubToken (&(ptr->comment)) != STRING)
         Error ("Mode name expected", NULL);
-    ptr->identifier = val.str;
+    ptr->identifier = xconfigScan->val.str;
     while ((token = xconfigGetToken (ModeTab)) != ENDMODE)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case DOTCLOCK:
-            if ((xconfigGetSubToken (&(ptr->comment)) != NUMBER) || !val.str)
+            if ((xconfigGetSubToken (&(ptr->comment)) != NUMBER) ||
+                !xconfigScan->val.str)
                 Error (NUMBER_MSG, "DotClock");
-            ptr->clock = xconfigStrdup(val.str);
+            ptr->clock = xconfigStrdup(xconfigScan->val.str);
             had_dotclock = 1;
             break;
         case HTIMINGS:
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->hdisplay = val.num;
+                ptr->hdisplay = xconfigScan->val.num;
             else
                 Error ("Horizontal display expected", NULL);
 
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->hsyncstart = val.num;
+                ptr->hsyncstart = xconfigScan->val.num;
             else
                 Error ("Horizontal sync start expected", NULL);
 
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->hsyncend = val.num;
+                ptr->hsyncend = xconfigScan->val.num;
             else
                 Error ("Horizontal sync end expected", NULL);
 
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->htotal = val.num;
+                ptr->htotal = xconfigScan->val.num;
             else
                 Error ("Horizontal total expected", NULL);
             had_htimings = 1;
             break;
         case VTIMINGS:
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vdisplay = val.num;
+                ptr->vdisplay = xconfigScan->val.num;
             else
                 Error ("Vertical display expected", NULL);
 
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vsyncstart = val.num;
+                ptr->vsyncstart = xconfigScan->val.num;
             else
                 Error ("Vertical sync start expected", NULL);
 
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vsyncend = val.num;
+                ptr->vsyncend = xconfigScan->val.num;
             else
                 Error ("Vertical sync end expected", NULL);
 
             if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vtotal = val.num;
+                ptr->vtotal = xconfigScan->val.num;
             else
                 Error ("Vertical total expected", NULL);
             had_vtimings = 1;
@@ -367,13 +368,13 @@ xconfigParseVerboseMode (void)
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error ("Horizontal skew expected", NULL);
             ptr->flags |= XCONFIG_MODE_HSKEW;
-            ptr->hskew = val.num;
+            ptr->hskew = xconfigScan->val.num;
             break;
         case VSCAN:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error ("Vertical scan count expected", NULL);
             ptr->flags |= XCONFIG_MODE_VSCAN;
-            ptr->vscan = val.num;
+            ptr->vscan = xconfigScan->val.num;
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
@@ -401,6 +402,8 @@ xconfigParseMonitorSection (void)
 {
     int has_ident = FALSE;
     int token;
+    GenericListPtr modelinesTail = NULL;
+    GenericListPtr modes_sectionsTail = NULL;
     PARSE_PROLOGUE (XConfigMonitorPtr, XConfigMonitorRec)
 
         while ((token = xconfigGetToken (MonitorTab)) != ENDSECTION)
@@ -408,48 +411,49 @@ xconfigParseMonitorSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case VENDOR:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Vendor");
-            ptr->vendor = val.str;
+            ptr->vendor = xconfigScan->val.str;
             break;
         case MODEL:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "ModelName");
-            ptr->modelname = val.str;
+            ptr->modelname = xconfigScan->val.str;
             break;
         case MODE:
-            HANDLE_LIST (modelines, xconfigParseVerboseMode,
+            HANDLE_LIST (modelines, modelinesTail, xconfigParseVerboseMode,
                          XConfigModeLinePtr);
             break;
         case MODELINE:
-            HANDLE_LIST (modelines, xconfigParseModeLine,
+            HANDLE_LIST (modelines, modelinesTail, xconfigParseModeLine,
                          XConfigModeLinePtr);
             break;
         case DISPLAYSIZE:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (DISPLAYSIZE_MSG, NULL);
-            ptr->width = val.realnum;
+            ptr->width = xconfigScan->val.realnum;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (DISPLAYSIZE_MSG, NULL);
-            ptr->height = val.realnum;
+            ptr->height = xconfigScan->val.realnum;
             break;
 
         case HORIZSYNC:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (HORIZSYNC_MSG, NULL);
             do {
-                ptr->hsync[ptr->n_hsync].lo = val.realnum;
+                ptr->hsync[ptr->n_hsync].lo = xconfigScan->val.realnum;
                 switch (token = xconfigGetSubToken (&(ptr->comment)))
                 {
                     case COMMA:
@@ -458,9 +462,10 @@ xconfigParseMonitorSection (void)
                         break;
                     case DASH:
                         if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
-                            (float)val.realnum < ptr->hsync[ptr->n_hsync].lo)
+                            (float)xconfigScan->val.realnum <
+                            ptr->hsync[ptr->n_hsync].lo)
                             Error (HORIZSYNC_MSG, NULL);
-                        ptr->hsync[ptr->n_hsync].hi = val.realnum;
+                        ptr->hsync[ptr->n_hsync].hi = xconfigScan->val.realnum;
                         if ((token = xconfigGetSubToken (&(ptr->comment))) == COMMA)
                             break;
                         ptr->n_hsync++;
@@ -486,7 +491,7 @@ HorizDone:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (VERTREFRESH_MSG, NULL);
             do {
-                ptr->vrefresh[ptr->n_vrefresh].lo = val.realnum;
+                ptr->vrefresh[ptr->n_vrefresh].lo = xconfigScan->val.realnum;
                 switch (token = xconfigGetSubToken (&(ptr->comment)))
                 {
                     case COMMA:
@@ -495,9 +500,11 @@ HorizDone:
                         break;
                     case DASH:
                         if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
-                            (float)val.realnum < ptr->vrefresh[ptr->n_vrefresh].lo)
+                            (float)xconfigScan->val.realnum <
+                            ptr->vrefresh[ptr->n_vrefresh].lo)
                             Error (VERTREFRESH_MSG, NULL);
-                        ptr->vrefresh[ptr->n_vrefresh].hi = val.realnum;
+                        ptr->vrefresh[ptr->n_vrefresh].hi =
+                            xconfigScan->val.realnum;
                         if ((token = xconfigGetSubToken (&(ptr->comment))) == COMMA)
                             break;
                         ptr->n_vrefresh++;
@@ -527,13 +534,13 @@ VertDone:
             else
             {
                 ptr->gamma_red = ptr->gamma_green =
-                    ptr->gamma_blue = val.realnum;
+                    ptr->gamma_blue = xconfigScan->val.realnum;
                 if( xconfigGetSubToken (&(ptr->comment)) == NUMBER )
                 {
-                    ptr->gamma_green = val.realnum;
+                    ptr->gamma_green = xconfigScan->val.realnum;
                     if( xconfigGetSubToken (&(ptr->comment)) == NUMBER )
                     {
-                        ptr->gamma_blue = val.realnum;
+                        ptr->gamma_blue = xconfigScan->val.realnum;
                     }
                     else
                     {
@@ -558,10 +565,12 @@ VertDone:
                    referenced here */
                 mptr = calloc (1, sizeof (XConfigModesLinkRec));
                 mptr->next = NULL;
-                mptr->modes_name = val.str;
+                mptr->modes_name = xconfigScan->val.str;
                 mptr->modes = NULL;
-                xconfigAddListItem((GenericListPtr *)(&ptr->modes_sections),
-                                   (GenericListPtr)mptr);
+                xconfigAddListItemTail((GenericListPtr *)
+                                       (&ptr->modes_sections),
+                                       &modes_sectionsTail,
+                                       (GenericListPtr)mptr);
             }
             break;
         case EOF_TOKEN:
@@ -590,6 +599,7 @@ xconfigParseModesSection (void)
 {
     int has_ident = FALSE;
     int token;
+    GenericListPtr modelinesTail = NULL;
     PARSE_PROLOGUE (XConfigModesPtr, XConfigModesRec)
 
     while ((token = xconfigGetToken (ModesTab)) != ENDSECTION)
@@ -597,22 +607,23 @@ xconfigParseModesSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case MODE:
-            HANDLE_LIST (modelines, xconfigParseVerboseMode,
+            HANDLE_LIST (modelines, modelinesTail, xconfigParseVerboseMode,
                          XConfigModeLinePtr);
             break;
         case MODELINE:
-            HANDLE_LIST (modelines, xconfigParseModeLine,
+            HANDLE_LIST (modelines, modelinesTail, xconfigParseModeLine,
                          XConfigModeLinePtr);
             break;
         default:
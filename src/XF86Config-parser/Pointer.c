@@ -59,8 +59,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec PointerTab[] =
 {
     {PROTOCOL, "protocol"},
@@ -105,25 +103,28 @@ xconfigParsePointerSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case PROTOCOL:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Protocol");
-            xconfigAddNewOption(&ptr->options, "Protocol", val.str);
+            xconfigAddNewOption(&ptr->options, "Protocol",
+                                xconfigScan->val.str);
             break;
         case PDEVICE:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Device");
-            xconfigAddNewOption(&ptr->options, "Device", val.str);
+            xconfigAddNewOption(&ptr->options, "Device", xconfigScan->val.str);
             break;
         case EMULATE3:
             xconfigAddNewOption(&ptr->options, "Emulate3Buttons", NULL);
             break;
         case EM3TIMEOUT:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
+                xconfigScan->val.num < 0)
                 Error (POSITIVE_INT_MSG, "Emulate3Timeout");
-            s = xconfigULongToString(val.num);
+            s = xconfigULongToString(xconfigScan->val.num);
             xconfigAddNewOption(&ptr->options, "Emulate3Timeout", s);
             TEST_FREE(s);
             break;
@@ -131,30 +132,34 @@ xconfigParsePointerSection (void)
             xconfigAddNewOption(&ptr->options, "ChordMiddle", NULL);
             break;
         case PBUTTONS:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
+                xconfigScan->val.num < 0)
                 Error (POSITIVE_INT_MSG, "Buttons");
-            s = xconfigULongToString(val.num);
+            s = xconfigULongToString(xconfigScan->val.num);
             xconfigAddNewOption(&ptr->options, "Buttons", s);
             TEST_FREE(s);
             break;
         case BAUDRATE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
+                xconfigScan->val.num < 0)
                 Error (POSITIVE_INT_MSG, "BaudRate");
-            s = xconfigULongToString(val.num);
+            s = xconfigULongToString(xconfigScan->val.num);
             xconfigAddNewOption(&ptr->options, "BaudRate", s);
             TEST_FREE(s);
             break;
         case SAMPLERATE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
+                xconfigScan->val.num < 0)
                 Error (POSITIVE_INT_MSG, "SampleRate");
-            s = xconfigULongToString(val.num);
+            s = xconfigULongToString(xconfigScan->val.num);
             xconfigAddNewOption(&ptr->options, "SampleRate", s);
             TEST_FREE(s);
             break;
         case PRESOLUTION:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
+                xconfigScan->val.num < 0)
                 Error (POSITIVE_INT_MSG, "Resolution");
-            s = xconfigULongToString(val.num);
+            s = xconfigULongToString(xconfigScan->val.num);
             xconfigAddNewOption(&ptr->options, "Resolution", s);
             TEST_FREE(s);
             break;
@@ -167,13 +172,13 @@ xconfigParsePointerSection (void)
         case ZAXISMAPPING:
             switch (xconfigGetToken(ZMapTab)) {
             case NUMBER:
-                if (val.num < 0)
+                if (xconfigScan->val.num < 0)
                     Error (ZAXISMAPPING_MSG, NULL);
-                s1 = xconfigULongToString(val.num);
+                s1 = xconfigULongToString(xconfigScan->val.num);
                 if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
-                    val.num < 0)
+                    xconfigScan->val.num < 0)
                     Error (ZAXISMAPPING_MSG, NULL);
-                s2 = xconfigULongToString(val.num);
+                s2 = xconfigULongToString(xconfigScan->val.num);
                 l = strlen(s1) + 1 + strlen(s2) + 1;
                 s = malloc(l);
                 sprintf(s, "%s %s", s1, s2);
@@ -57,8 +57,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec TopLevelTab[] =
 {
     {SECTION, "section"},
@@ -74,6 +72,24 @@ static XConfigSymTabRec TopLevelTab[] =
         return XCONFIG_RETURN_PARSE_ERROR; \
     }
 
+/*
+ * The ends of the lists of the XConfigRec being read, named after the
+ * lists; see xconfigAddListItemTail().
+ */
+typedef struct {
+    GenericListPtr devices;
+    GenericListPtr modes;
+    GenericListPtr monitors;
+    GenericListPtr screens;
+    GenericListPtr inputs;
+    GenericListPtr inputclasses;
+    GenericListPtr layouts;
+    GenericListPtr vendors;
+    GenericListPtr videoadaptors;
+}
+XConfigListTailsRec;
+
+/* tail.field tracks the end of ptr->field */
 #define READ_HANDLE_LIST(field,func,type)                               \
 {                                                                       \
     type p = func();                                                    \
@@ -81,8 +97,8 @@ static XConfigSymTabRec TopLevelTab[] =
         xconfigFreeConfig(&ptr);                                        \
         return XCONFIG_RETURN_PARSE_ERROR;                              \
     } else {                                                            \
-        xconfigAddListItem((GenericListPtr *)(&ptr->field),             \
-                           (GenericListPtr) p);                         \
+        xconfigAddListItemTail((GenericListPtr *)(&ptr->field),         \
+                               &tail.field, (GenericListPtr) p);        \
     }                                                                   \
 }
 
@@ -96,25 +112,28 @@ static XConfigSymTabRec TopLevelTab[] =
 
 
 /*
- * xconfigReadConfigFile() - read the open XConfig file, returning the
- * parsed data as XConfigPtr.
+ * xconfigReadConfig() - parse the config text of the current scanner,
+ * returning the parsed data as XConfigPtr.
  */
 
-XConfigError xconfigReadConfigFile(XConfigPtr *configPtr)
+static XConfigError xconfigReadConfig(XConfigPtr *configPtr)
 {
     int token;
     XConfigPtr ptr = NULL;
+    XConfigListTailsRec tail;
 
     *configPtr = NULL;
 
     ptr = xconfigAlloc(sizeof(XConfigRec));
+    memset(&tail, 0, sizeof(tail));
     
     while ((token = xconfigGetToken(TopLevelTab)) != EOF_TOKEN) {
         
         switch (token) {
             
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
             
         case SECTION:
@@ -124,133 +143,141 @@ XConfigError xconfigReadConfigFile(XConfigPtr *configPtr)
                 return XCONFIG_RETURN_PARSE_ERROR;
             }
             
-            xconfigSetSection(val.str);
+            xconfigSetSection(xconfigScan->val.str);
             
-            if (xconfigNameCompare(val.str, "files") == 0)
+            if (xconfigNameCompare(xconfigScan->val.str, "files") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_RETURN(files, xconfigParseFilesSection());
             }
-            else if (xconfigNameCompare(val.str, "serverflags") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str,
+                                        "serverflags") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_RETURN(flags, xconfigParseFlagsSection());
             }
-            else if (xconfigNameCompare(val.str, "keyboard") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "keyboard") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(inputs, xconfigParseKeyboardSection,
                                  XConfigInputPtr);
             }
-            else if (xconfigNameCompare(val.str, "pointer") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "pointer") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(inputs, xconfigParsePointerSection,
                                  XConfigInputPtr);
             }
-            else if (xconfigNameCompare(val.str, "videoadaptor") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str,
+                                        "videoadaptor") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(videoadaptors,
                             xconfigParseVideoAdaptorSection,
                                  XConfigVideoAdaptorPtr);
             }
-            else if (xconfigNameCompare(val.str, "device") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "device") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(devices, xconfigParseDeviceSection,
                                  XConfigDevicePtr);
             }
-            else if (xconfigNameCompare(val.str, "monitor") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "monitor") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(monitors, xconfigParseMonitorSection,
                                  XConfigMonitorPtr);
             }
-            else if (xconfigNameCompare(val.str, "modes") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "modes") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(modes, xconfigParseModesSection,
                                  XConfigModesPtr);
             }
-            else if (xconfigNameCompare(val.str, "screen") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "screen") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(screens, xconfigParseScreenSection,
                                  XConfigScreenPtr);
             }
-            else if (xconfigNameCompare(val.str, "inputdevice") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str,
+                                        "inputdevice") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(inputs, xconfigParseInputSection,
                                  XConfigInputPtr);
             }
-            else if ((xconfigNameCompare(val.str, "inputclass") == 0))
+            else if ((xconfigNameCompare(xconfigScan->val.str,
+                                         "inputclass") == 0))
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(inputclasses, xconfigParseInputClassSection,
                                  XConfigInputClassPtr);
             }
-            else if (xconfigNameCompare(val.str, "module") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "module") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_RETURN(modules, xconfigParseModuleSection());
             }
-            else if (xconfigNameCompare(val.str, "serverlayout") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str,
+                                        "serverlayout") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(layouts, xconfigParseLayoutSection,
                                  XConfigLayoutPtr);
             }
-            else if (xconfigNameCompare(val.str, "vendor") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "vendor") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_LIST(vendors, xconfigParseVendorSection,
                                  XConfigVendorPtr);
             }
-            else if (xconfigNameCompare(val.str, "dri") == 0)
+            else if (xconfigNameCompare(xconfigScan->val.str, "dri") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_RETURN(dri, xconfigParseDRISection());
             }
-            else if (xconfigNameCompare (val.str, "extensions") == 0)
+            else if (xconfigNameCompare (xconfigScan->val.str,
+                                         "extensions") == 0)
             {
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
                 READ_HANDLE_RETURN(extensions, xconfigParseExtensionsSection());
             }
             else
             {
                 READ_ERROR(INVALID_SECTION_MSG, xconfigTokenString());
-                free(val.str);
-                val.str = NULL;
+                free(xconfigScan->val.str);
+                xconfigScan->val.str = NULL;
             }
             break;
             
         default:
             READ_ERROR(INVALID_KEYWORD_MSG, xconfigTokenString());
-            free(val.str);
-            val.str = NULL;
+            free(xconfigScan->val.str);
+            xconfigScan->val.str = NULL;
         }
     }
 
     if (xconfigValidateConfig(ptr)) {
-        ptr->filename = strdup(xconfigGetConfigFileName());
+        if (xconfigGetConfigFileName()) {
+            ptr->filename = strdup(xconfigGetConfigFileName());
+        }
         *configPtr = ptr;
         return XCONFIG_RETURN_SUCCESS;
     } else {
@@ -262,6 +289,32 @@ XConfigError xconfigReadConfigFile(XConfigPtr *configPtr)
 #undef CLEANUP
 
 
+
+/*
+ * xconfigScanReadConfig() - read the config text of 'scan', returning
+ * the parsed data as XConfigPtr.  The scanner is made current for this
+ * thread while parsing, so that other threads can read their own
+ * scanners at the same time.
+ */
+
+XConfigError xconfigScanReadConfig(XConfigScanPtr scan, XConfigPtr *configPtr)
+{
+    XConfigScanPtr prev = xconfigScan;
+    XConfigError ret;
+
+    if (!scan) {
+        *configPtr = NULL;
+        return XCONFIG_RETURN_NO_XCONFIG_FOUND;
+    }
+
+    xconfigScan = scan;
+    ret = xconfigReadConfig(configPtr);
+    xconfigScan = prev;
+
+    return ret;
+}
+
+
 /* 
  * This function resolves name references and reports errors if the named
  * objects cannot be found.
@@ -350,6 +403,200 @@ void xconfigRemoveListItem (GenericListPtr *pHead, GenericListPtr item)
 }
 
 
+/*
+ * adds an item to the end of the linked list like xconfigAddListItem(),
+ * but starts looking for the end at *pTail (or at *pHead if *pTail is
+ * NULL) and leaves the new end of the list in *pTail.  Code that
+ * appends many items to the same list keeps the tail between calls, so
+ * that each append is O(1) rather than a walk of the whole list.  *pTail
+ * must be an item of the list (or NULL); items appended by other means
+ * since it was set are skipped over.
+ */
+void xconfigAddListItemTail (GenericListPtr *pHead, GenericListPtr *pTail,
+                             GenericListPtr new)
+{
+    GenericListPtr last = *pTail ? *pTail : *pHead;
+
+    if (last) {
+        while (last->next) {
+            last = last->next;
+        }
+        last->next = new;
+    } else {
+        *pHead = new;
+    }
+
+    for (last = new; last && last->next; last = last->next);
+    *pTail = last;
+}
+
+
+
+/*
+ * Name indices: hash tables over the items of a list, keyed by the name
+ * at 'nameOffset' in each item.  The hash folds names the same way
+ * xconfigNameCompare() does, and each candidate is checked with
+ * xconfigNameCompare(), so xconfigNameIndexFind() returns the same item
+ * as a linear xconfigFind*() walk of the list would (the first match).
+ *
+ * An index is a snapshot: it is built for one bulk operation (e.g.,
+ * validating or merging a config) and must be told about items appended
+ * to the list meanwhile; removing items from the list is not supported.
+ * If memory for the table cannot be allocated, lookups fall back to
+ * walking the list.
+ */
+
+#define NAME_INDEX_MIN_SIZE 16
+
+static unsigned int xconfigNameHash(const char *s)
+{
+    unsigned int hash = 2166136261U;
+    char c;
+
+    if (!s) {
+        return hash;
+    }
+
+    for (; *s; s++) {
+        c = *s;
+        if (c == '_' || c == ' ' || c == '\t') {
+            continue;
+        }
+        if ((c >= 'A') && (c <= 'Z')) {
+            c += 'a' - 'A';
+        }
+        hash = (hash ^ (unsigned char) c) * 16777619U;
+    }
+
+    return hash;
+}
+
+static const char *xconfigNameIndexName(XConfigNameIndexPtr index,
+                                        GenericListPtr item)
+{
+    return *(const char **)((char *) item + index->nameOffset);
+}
+
+/*
+ * insert an item; with linear probing, items with the same name keep
+ * their list order along the probe sequence, which is what makes
+ * xconfigNameIndexFind() return the first match
+ */
+static void xconfigNameIndexInsert(XConfigNameIndexPtr index,
+                                   GenericListPtr item)
+{
+    unsigned int hash = xconfigNameHash(xconfigNameIndexName(index, item));
+    unsigned int i = hash & index->mask;
+
+    while (index->slots[i].item) {
+        i = (i + 1) & index->mask;
+    }
+
+    index->slots[i].item = item;
+    index->slots[i].hash = hash;
+    index->count++;
+}
+
+/*
+ * (re)build the table from the list, sized for at least 'count' items
+ * at a load factor of at most one half
+ */
+static void xconfigNameIndexBuild(XConfigNameIndexPtr index,
+                                  unsigned int count)
+{
+    GenericListPtr p;
+    unsigned int size = NAME_INDEX_MIN_SIZE;
+
+    while (size < count * 2) {
+        size *= 2;
+    }
+
+    free(index->slots);
+    index->count = 0;
+    index->mask = size - 1;
+    index->slots = calloc(size, sizeof(*index->slots));
+
+    if (!index->slots) {
+        return;
+    }
+
+    for (p = *index->pList; p; p = p->next) {
+        xconfigNameIndexInsert(index, p);
+    }
+}
+
+void xconfigNameIndexInit(XConfigNameIndexPtr index, GenericListPtr *pList,
+                          size_t nameOffset)
+{
+    GenericListPtr p;
+    unsigned int count = 0;
+
+    for (p = *pList; p; p = p->next) {
+        count++;
+    }
+
+    index->pList = pList;
+    index->nameOffset = nameOffset;
+    index->slots = NULL;
+
+    xconfigNameIndexBuild(index, count);
+}
+
+/*
+ * add an item that was just appended to the indexed list
+ */
+void xconfigNameIndexAdd(XConfigNameIndexPtr index, GenericListPtr item)
+{
+    if (!index->slots) {
+        return;
+    }
+
+    if ((index->count + 1) * 2 > index->mask + 1) {
+        xconfigNameIndexBuild(index, index->count + 1);
+    } else {
+        xconfigNameIndexInsert(index, item);
+    }
+}
+
+GenericListPtr xconfigNameIndexFind(XConfigNameIndexPtr index,
+                                    const char *name)
+{
+    GenericListPtr p;
+    unsigned int hash, i;
+
+    if (!index->slots) {
+        for (p = *index->pList; p; p = p->next) {
+            if (xconfigNameCompare(name, xconfigNameIndexName(index, p)) == 0) {
+                return p;
+            }
+        }
+        return NULL;
+    }
+
+    hash = xconfigNameHash(name);
+
+    for (i = hash & index->mask;
+         index->slots[i].item;
+         i = (i + 1) & index->mask) {
+
+        p = index->slots[i].item;
+
+        if ((index->slots[i].hash == hash) &&
+            (xconfigNameCompare(name, xconfigNameIndexName(index, p)) == 0)) {
+            return p;
+        }
+    }
+
+    return NULL;
+}
+
+void xconfigNameIndexFree(XConfigNameIndexPtr index)
+{
+    free(index->slots);
+    index->slots = NULL;
+}
+
+
 /* 
  * Test if one chained list contains the other.
  * In this case both list have the same endpoint (provided they don't loop)
@@ -59,6 +59,10 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #if !defined(X_NOT_POSIX)
 #if defined(_POSIX_SOURCE)
@@ -88,18 +92,11 @@
 
 static int StringToToken (char *, XConfigSymTabRec *);
 
-static FILE *configFile = NULL;
-static const char **builtinConfig = NULL;
-static int builtinIndex = 0;
-static int configPos = 0;            /* current readers position */
-static char *configBuf, *configRBuf; /* buffer for lines */
-static int pushToken = LOCK_TOKEN;
-static int eol_seen = 0;             /* private state to handle comments */
-LexRec val;
+/* scanner being read by this thread, see xconfigScanReadConfig() */
+__thread XConfigScanPtr xconfigScan = NULL;
 
-int configLineNo = 0;         /* linenumber */
-char *configSection = NULL;   /* name of current section being parsed */
-char *configPath;             /* path to config file */
+/* scanner behind xconfigOpenConfigFile() and xconfigReadConfigFile() */
+static XConfigScanPtr defaultScan = NULL;
 
 
 
@@ -180,119 +177,64 @@ static unsigned int xconfigStrToUL (char *str)
 /*
  * xconfigGetNextLine --
  *
- *  read from the configFile FILE stream until we encounter a new
- *  line; this is effectively just a big wrapper for fgets(3).
+ *  copy the next line of the config text, including its newline, into
+ *  configBuf; returns NULL at the end of the text.  A last line that
+ *  lacks a newline is given one, as xconfigGetToken() expects.
  *
  *  xconfigGetToken() assumes that we will read up to the next
- *  newline; we need to grow configBuf and configRBuf as needed to
+ *  newline; configBuf and configRBuf are grown (and kept) as needed to
  *  support that.
  */
 
-static char *xconfigGetNextLine(void)
+static char *xconfigGetNextLine(XConfigScanPtr scan)
 {
-    static int configBufLen = CONFIG_BUF_LEN;
-    char *tmpConfigBuf, *tmpConfigRBuf;
-    int c, i, pos = 0, eolFound = 0;
-    char *ret = NULL;
-    
-    /*
-     * reallocate the string if it was grown last time (i.e., is no
-     * longer CONFIG_BUF_LEN); we malloc the new strings first, so
-     * that if either of the mallocs fail, we can fall back on the
-     * existing buffer allocations
-     */
-    
-    if (configBufLen != CONFIG_BUF_LEN) {
-                 
-        tmpConfigBuf = malloc(CONFIG_BUF_LEN);
-        tmpConfigRBuf = malloc(CONFIG_BUF_LEN);
-        
-        if (!tmpConfigBuf || !tmpConfigRBuf) {
-            
-            /*
-             * at least one of the mallocs failed; keep the old buffers
-             * and free any partial allocations
-             */
-            
-            free(tmpConfigBuf);
-            free(tmpConfigRBuf);
-            
-        } else {
-            
-            /*
-             * malloc succeeded; free the old buffers and use the new
-             * buffers
-             */
-            
-            configBufLen = CONFIG_BUF_LEN;
-            
-            free(configBuf);
-            free(configRBuf);
-            
-            configBuf = tmpConfigBuf;
-            configRBuf = tmpConfigRBuf;
-        }
+    const char *start, *eol;
+    size_t len;
+
+    if (scan->offset >= scan->size) {
+        return NULL;
     }
 
-    /* read in another block of chars */
-    
-    do {
-        ret = fgets(configBuf + pos, configBufLen - pos - 1, configFile);
-        
-        if (!ret) break;
-        
-        /* search for EOL in the new block of chars */
-        
-        for (i = pos; i < (configBufLen - 1); i++) {
-            c = configBuf[i];
-            
-            if (c == '\0') break;
-            
-            if ((c == '\n') || (c == '\r')) {
-                eolFound = 1;
-                break;
-            }
+    start = scan->data + scan->offset;
+    eol = memchr(start, '\n', scan->size - scan->offset);
+    len = eol ? (size_t)(eol - start) + 1 : scan->size - scan->offset;
+
+    if (len + 1 >= scan->configBufLen) {
+        size_t newLen = scan->configBufLen;
+        char *tmpConfigBuf, *tmpConfigRBuf;
+
+        while (len + 1 >= newLen) {
+            newLen *= 2;
         }
-        
+
         /*
-         * if we didn't find EOL, then grow the string and
-         * read in more
+         * if only one of the reallocations succeeds, keep it; the
+         * other buffer is still valid at the old size
          */
-        
-        if (!eolFound) {
-            
-            tmpConfigBuf = realloc(configBuf, configBufLen + CONFIG_BUF_LEN);
-            tmpConfigRBuf = realloc(configRBuf, configBufLen + CONFIG_BUF_LEN);
-            
-            if (!tmpConfigBuf || !tmpConfigRBuf) {
-                
-                /*
-                 * at least one of the reallocations failed; use the
-                 * new allocation that succeeded, but we have to
-                 * fallback to the previous configBufLen size and use
-                 * the string we have, even though we don't have an
-                 * EOL
-                 */
-                
-                if (tmpConfigBuf) configBuf = tmpConfigBuf;
-                if (tmpConfigRBuf) configRBuf = tmpConfigRBuf;
-                
-                break;
-                
-            } else {
-                
-                /* reallocation succeeded */
-
-                configBuf = tmpConfigBuf;
-                configRBuf = tmpConfigRBuf;
-                pos = i;
-                configBufLen += CONFIG_BUF_LEN;
-            }
+
+        tmpConfigBuf = realloc(scan->configBuf, newLen);
+        if (tmpConfigBuf) {
+            scan->configBuf = tmpConfigBuf;
+        }
+        tmpConfigRBuf = realloc(scan->configRBuf, newLen);
+        if (tmpConfigRBuf) {
+            scan->configRBuf = tmpConfigRBuf;
         }
-        
-    } while (!eolFound);
-    
-    return ret;
+        if (!tmpConfigBuf || !tmpConfigRBuf) {
+            return NULL;
+        }
+        scan->configBufLen = newLen;
+    }
+
+    memcpy(scan->configBuf, start, len);
+    scan->offset += len;
+
+    if (!eol) {
+        scan->configBuf[len++] = '\n';
+    }
+    scan->configBuf[len] = '\0';
+
+    return scan->configBuf;
 }
 
 
@@ -305,6 +247,7 @@ static char *xconfigGetNextLine(void)
 
 int xconfigGetToken (XConfigSymTabRec * tab)
 {
+    XConfigScanPtr scan = xconfigScan;
     int c, i;
 
     /* 
@@ -312,16 +255,16 @@ int xconfigGetToken (XConfigSymTabRec * tab)
      * In this case rBuf[] contains a valid STRING/TOKEN/NUMBER. But in the
      * oth * case the next token must be read from the input.
      */
-    if (pushToken == EOF_TOKEN)
+    if (scan->pushToken == EOF_TOKEN)
         return (EOF_TOKEN);
-    else if (pushToken == LOCK_TOKEN)
+    else if (scan->pushToken == LOCK_TOKEN)
     {
         /*
          * eol_seen is only set for the first token after a newline.
          */
-        eol_seen = 0;
+        scan->eol_seen = 0;
 
-        c = configBuf[configPos];
+        c = scan->configBuf[scan->configPos];
 
         /* 
          * Get start of next Token. EOF is handled,
@@ -331,31 +274,19 @@ int xconfigGetToken (XConfigSymTabRec * tab)
 again:
         if (!c)
         {
-            char *ret;
-            if (configFile)
-                ret = xconfigGetNextLine();
-            else {
-                if (builtinConfig[builtinIndex] == NULL)
-                    ret = NULL;
-                else {
-                    ret = strncpy(configBuf, builtinConfig[builtinIndex],
-                            CONFIG_BUF_LEN);
-                    builtinIndex++;
-                }
-            }
-            if (ret == NULL)
+            if (xconfigGetNextLine(scan) == NULL)
             {
-                return (pushToken = EOF_TOKEN);
+                return (scan->pushToken = EOF_TOKEN);
             }
-            configLineNo++;
-            configPos = 0;
-            eol_seen = 1;
+            scan->configLineNo++;
+            scan->configPos = 0;
+            scan->eol_seen = 1;
         }
 
         i = 0;
         for (;;) {
-            c = configBuf[configPos++];
-            configRBuf[i++] = c;
+            c = scan->configBuf[scan->configPos++];
+            scan->configRBuf[i++] = c;
             switch (c) {
                 case ' ':
                 case '\t':
@@ -374,23 +305,26 @@ again:
         {
             do
             {
-                configRBuf[i++] = (c = configBuf[configPos++]);
+                c = scan->configBuf[scan->configPos++];
+                scan->configRBuf[i++] = c;
             }
             while ((c != '\n') && (c != '\r') && (c != '\0'));
-            configRBuf[i] = '\0';
+            scan->configRBuf[i] = '\0';
             /* XXX no private copy.
              * Use xconfigAddComment when setting a comment.
              */
-            val.str = configRBuf;
+            scan->val.str = scan->configRBuf;
             return (COMMENT);
         }
 
         /* GJA -- handle '-' and ','  * Be careful: "-hsync" is a keyword. */
-        else if ((c == ',') && !xconfigIsAlpha(configBuf[configPos]))
+        else if ((c == ',') &&
+                 !xconfigIsAlpha(scan->configBuf[scan->configPos]))
         {
             return COMMA;
         }
-        else if ((c == '-') && !xconfigIsAlpha(configBuf[configPos]))
+        else if ((c == '-') &&
+                 !xconfigIsAlpha(scan->configBuf[scan->configPos]))
         {
             return DASH;
         }
@@ -403,26 +337,26 @@ again:
             int base;
 
             if (c == '0')
-                if ((configBuf[configPos] == 'x') ||
-                    (configBuf[configPos] == 'X'))
+                if ((scan->configBuf[scan->configPos] == 'x') ||
+                    (scan->configBuf[scan->configPos] == 'X'))
                     base = 16;
                 else
                     base = 8;
             else
                 base = 10;
 
-            configRBuf[0] = c;
+            scan->configRBuf[0] = c;
             i = 1;
-            while (xconfigIsDigit(c = configBuf[configPos++]) ||
+            while (xconfigIsDigit(c = scan->configBuf[scan->configPos++]) ||
                    (c == '.') || (c == 'x') || (c == 'X') ||
                    ((base == 16) && (((c >= 'a') && (c <= 'f')) ||
                                      ((c >= 'A') && (c <= 'F')))))
-                configRBuf[i++] = c;
-            configPos--;        /* GJA -- one too far */
-            configRBuf[i] = '\0';
-            val.num = xconfigStrToUL (configRBuf);
-            val.realnum = atof (configRBuf);
-            val.str = configRBuf;
+                scan->configRBuf[i++] = c;
+            scan->configPos--;        /* GJA -- one too far */
+            scan->configRBuf[i] = '\0';
+            scan->val.num = xconfigStrToUL (scan->configRBuf);
+            scan->val.realnum = atof (scan->configRBuf);
+            scan->val.str = scan->configRBuf;
             return (NUMBER);
         }
 
@@ -434,12 +368,13 @@ again:
             i = -1;
             do
             {
-                configRBuf[++i] = (c = configBuf[configPos++]);
+                c = scan->configBuf[scan->configPos++];
+                scan->configRBuf[++i] = c;
             }
             while ((c != '\"') && (c != '\n') && (c != '\r') && (c != '\0'));
-            configRBuf[i] = '\0';
-            val.str = malloc (strlen (configRBuf) + 1);
-            strcpy (val.str, configRBuf);    /* private copy ! */
+            scan->configRBuf[i] = '\0';
+            scan->val.str = malloc (strlen (scan->configRBuf) + 1);
+            strcpy (scan->val.str, scan->configRBuf);    /* private copy ! */
             return (STRING);
         }
 
@@ -449,11 +384,12 @@ again:
          */
         else
         {
-            configRBuf[0] = c;
+            scan->configRBuf[0] = c;
             i = 0;
             do
             {
-                configRBuf[++i] = (c = configBuf[configPos++]);;
+                c = scan->configBuf[scan->configPos++];
+                scan->configRBuf[++i] = c;
             }
             while ((c != ' ')  &&
                    (c != '\t') &&
@@ -462,8 +398,8 @@ again:
                    (c != '\0') &&
                    (c != '#'));
             
-            --configPos;
-            configRBuf[i] = '\0';
+            --scan->configPos;
+            scan->configRBuf[i] = '\0';
             i = 0;
         }
 
@@ -475,8 +411,8 @@ again:
          * Here we deal with pushed tokens. Reinitialize pushToken again. If
          * the pushed token was NUMBER || STRING return them again ...
          */
-        int temp = pushToken;
-        pushToken = LOCK_TOKEN;
+        int temp = scan->pushToken;
+        scan->pushToken = LOCK_TOKEN;
 
         if (temp == COMMA || temp == DASH)
             return (temp);
@@ -491,7 +427,7 @@ again:
     {
         i = 0;
         while (tab[i].token != -1)
-            if (xconfigNameCompare (configRBuf, tab[i].name) == 0)
+            if (xconfigNameCompare (scan->configRBuf, tab[i].name) == 0)
                 return (tab[i].token);
             else
                 i++;
@@ -508,7 +444,7 @@ int xconfigGetSubToken (char **comment)
         token = xconfigGetToken(NULL);
         if (token == COMMENT) {
             if (comment)
-                *comment = xconfigAddComment(*comment, val.str);
+                *comment = xconfigAddComment(*comment, xconfigScan->val.str);
         }
         else
             return (token);
@@ -524,7 +460,7 @@ int xconfigGetSubTokenWithTab (char **comment, XConfigSymTabRec *tab)
         token = xconfigGetToken(tab);
         if (token == COMMENT) {
             if (comment)
-                *comment = xconfigAddComment(*comment, val.str);
+                *comment = xconfigAddComment(*comment, xconfigScan->val.str);
         }
         else
             return (token);
@@ -534,12 +470,12 @@ int xconfigGetSubTokenWithTab (char **comment, XConfigSymTabRec *tab)
 
 void xconfigUnGetToken (int token)
 {
-    pushToken = token;
+    xconfigScan->pushToken = token;
 }
 
 char *xconfigTokenString (void)
 {
-    return configRBuf;
+    return xconfigScan->configRBuf;
 }
 
 static int pathIsAbsolute(const char *path)
@@ -760,7 +696,7 @@ static char *DoSubstitution(const char *template,
 }
 
 /* 
- * xconfigOpenConfigFile --
+ * xconfigScanOpenFile --
  *
  * This function takes a config file search path (optional), a
  * command-line specified file name (optional) and the ProjectRoot
@@ -768,8 +704,9 @@ static char *DoSubstitution(const char *template,
  * information.  If a command-line file name is specified, then this
  * function fails if none of the located files.
  *
- * The return value is a pointer to the actual name of the file that
- * was opened.  When no file is found, the return value is NULL.
+ * The return value is a scanner over the contents of the file that
+ * was opened; xconfigScanGetFileName() returns its actual name.  When
+ * no file is found, the return value is NULL.
  *
  * The escape sequences allowed in the search path are defined above.
  *  
@@ -826,17 +763,161 @@ static const char __user_configpath[] =
 
 
 
-const char *xconfigOpenConfigFile(const char *cmdline, const char *projroot)
+/*
+ * xconfigFindConfigFile() - open the first file in the comma separated
+ * 'searchpath' that exists (and, if a command-line file name was
+ * given, whose template used it).  Returns the path of the file, with
+ * its descriptor in 'fd', or NULL if no file was found.
+ */
+
+static char *xconfigFindConfigFile(const char *searchpath,
+                                   const char *cmdline,
+                                   const char *projroot,
+                                   char *XConfigFile, int *fd)
 {
-    const char *searchpath;
-    char *pathcopy;
+    char *pathcopy, *path = NULL, *saveptr = NULL;
     const char *template;
     int cmdlineUsed = 0;
 
-    configFile = NULL;
-    configPos = 0;        /* current readers position */
-    configLineNo = 0;    /* linenumber */
-    pushToken = LOCK_TOKEN;
+    *fd = -1;
+
+    pathcopy = strdup(searchpath);
+    if (!pathcopy) {
+        return NULL;
+    }
+
+    template = strtok_r(pathcopy, ",", &saveptr);
+
+    while (template && *fd < 0) {
+        if ((path = DoSubstitution(template, cmdline, projroot,
+                                   &cmdlineUsed, NULL, XConfigFile))) {
+            if ((*fd = open(path, O_RDONLY)) >= 0) {
+                if (cmdline && !cmdlineUsed) {
+                    close(*fd);
+                    *fd = -1;
+                }
+            }
+        }
+        if (path && *fd < 0) {
+            free(path);
+            path = NULL;
+        }
+        template = strtok_r(NULL, ",", &saveptr);
+    }
+
+    free(pathcopy);
+
+    return path;
+}
+
+
+
+/*
+ * xconfigScanLoadFile() - make the contents of the open file 'fd'
+ * available to 'scan': mmap(2) it when possible, and otherwise (e.g.,
+ * for an empty file or a pipe) read it into a heap buffer.
+ */
+
+static int xconfigScanLoadFile(XConfigScanPtr scan, int fd)
+{
+    struct stat st;
+    size_t len = 0, alloc = CONFIG_BUF_LEN;
+    char *buf, *tmp;
+    ssize_t n;
+
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED) {
+            scan->map = map;
+            scan->data = map;
+            scan->size = st.st_size;
+            return TRUE;
+        }
+    }
+
+    buf = malloc(alloc);
+    if (!buf) {
+        return FALSE;
+    }
+
+    for (;;) {
+        if (len == alloc) {
+            tmp = realloc(buf, alloc * 2);
+            if (!tmp) {
+                free(buf);
+                return FALSE;
+            }
+            buf = tmp;
+            alloc *= 2;
+        }
+
+        n = read(fd, buf + len, alloc - len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buf);
+            return FALSE;
+        }
+        if (n == 0) {
+            break;
+        }
+        len += n;
+    }
+
+    scan->copy = buf;
+    scan->data = buf;
+    scan->size = len;
+
+    return TRUE;
+}
+
+
+
+/*
+ * xconfigScanAlloc() - allocate a scanner over 'size' bytes of config
+ * text at 'data'; the scanner takes ownership of 'path'.
+ */
+
+static XConfigScanPtr xconfigScanAlloc(const char *data, size_t size,
+                                       char *path)
+{
+    XConfigScanPtr scan = calloc(1, sizeof(XConfigScanRec));
+
+    if (!scan) {
+        free(path);
+        return NULL;
+    }
+
+    scan->data = data;
+    scan->size = size;
+    scan->configPath = path;
+    scan->pushToken = LOCK_TOKEN;
+
+    scan->configBufLen = CONFIG_BUF_LEN;
+    scan->configBuf = malloc(CONFIG_BUF_LEN);
+    scan->configRBuf = malloc(CONFIG_BUF_LEN);
+
+    if (!scan->configBuf || !scan->configRBuf) {
+        xconfigScanClose(scan);
+        return NULL;
+    }
+
+    scan->configBuf[0] = '\0';
+    scan->configRBuf[0] = '\0';
+
+    return scan;
+}
+
+
+
+XConfigScanPtr xconfigScanOpenFile(const char *cmdline, const char *projroot)
+{
+    const char *searchpath;
+    XConfigScanPtr scan;
+    char *path;
+    int fd;
 
     /*
      * select the search path: XFree86 uses a slightly different path
@@ -850,98 +931,120 @@ const char *xconfigOpenConfigFile(const char *cmdline, const char *projroot)
     }
 
     if (!projroot) projroot = PROJECTROOT;
-    
-    pathcopy = strdup(searchpath);
-    
-    template = strtok(pathcopy, ",");
-
-    /* First, search for a config file. */
-    while (template && !configFile) {
-        if ((configPath = DoSubstitution(template, cmdline, projroot,
-                                         &cmdlineUsed, NULL, XCONFIGFILE))) {
-            if ((configFile = fopen(configPath, "r")) != 0) {
-                if (cmdline && !cmdlineUsed) {
-                    fclose(configFile);
-                    configFile = NULL;
-                }
-            }
-        }
-        if (configPath && !configFile) {
-            free(configPath);
-            configPath = NULL;
-        }
-        template = strtok(NULL, ",");
+
+    /* First, search for a config file; then search for fallback */
+
+    path = xconfigFindConfigFile(searchpath, cmdline, projroot,
+                                 XCONFIGFILE, &fd);
+    if (!path) {
+        path = xconfigFindConfigFile(searchpath, cmdline, projroot,
+                                     XFREE86CFGFILE, &fd);
     }
 
-    /* Then search for fallback */
-    if (!configFile) {
-        strcpy(pathcopy, searchpath);
-        template = strtok(pathcopy, ",");
-        
-        while (template && !configFile) {
-            if ((configPath = DoSubstitution(template, cmdline, projroot,
-                                             &cmdlineUsed, NULL,
-                                             XFREE86CFGFILE))) {
-                if ((configFile = fopen(configPath, "r")) != 0) {
-                    if (cmdline && !cmdlineUsed) {
-                        fclose(configFile);
-                        configFile = NULL;
-                    }
-                }
-            }
-            if (configPath && !configFile) {
-                free(configPath);
-                configPath = NULL;
-            }
-            template = strtok(NULL, ",");
-        }
+    if (!path) {
+        return NULL;
     }
-    
-    free(pathcopy);
 
-    if (!configFile) {
+    scan = xconfigScanAlloc(NULL, 0, path);
+
+    if (scan && !xconfigScanLoadFile(scan, fd)) {
+        xconfigScanClose(scan);
+        scan = NULL;
+    }
+
+    close(fd);
+
+    return scan;
+}
+
+
+XConfigScanPtr xconfigScanOpenBuffer(const char *data, size_t size,
+                                     const char *name)
+{
+    char *path = NULL;
+
+    if (name && !(path = strdup(name))) {
         return NULL;
     }
 
-    configBuf = malloc(CONFIG_BUF_LEN);
-    configRBuf = malloc(CONFIG_BUF_LEN);
-    configBuf[0] = '\0';
+    return xconfigScanAlloc(data, size, path);
+}
 
-    return configPath;
+
+const char *xconfigScanGetFileName(XConfigScanPtr scan)
+{
+    return scan ? scan->configPath : NULL;
 }
 
-void xconfigCloseConfigFile (void)
+
+void xconfigScanClose(XConfigScanPtr scan)
 {
-    free (configPath);
-    configPath = NULL;
-    free (configRBuf);
-    configRBuf = NULL;
-    free (configBuf);
-    configBuf = NULL;
-
-    if (configFile) {
-        fclose (configFile);
-        configFile = NULL;
-    } else {
-        builtinConfig = NULL;
-        builtinIndex = 0;
+    if (!scan) {
+        return;
     }
+
+    if (scan->map) {
+        munmap(scan->map, scan->size);
+    }
+    free(scan->copy);
+
+    free(scan->configPath);
+    free(scan->configSection);
+    free(scan->configRBuf);
+    free(scan->configBuf);
+    free(scan);
+}
+
+
+
+/*
+ * xconfigOpenConfigFile(), xconfigReadConfigFile() and
+ * xconfigCloseConfigFile() are the non-reentrant interface: they
+ * operate on a single scanner shared by all callers.
+ */
+
+const char *xconfigOpenConfigFile(const char *cmdline, const char *projroot)
+{
+    xconfigScanClose(defaultScan);
+    defaultScan = xconfigScanOpenFile(cmdline, projroot);
+
+    return xconfigScanGetFileName(defaultScan);
+}
+
+
+/*
+ * xconfigReadConfigFile() - read the open XConfig file, returning the
+ * parsed data as XConfigPtr.
+ */
+
+XConfigError xconfigReadConfigFile(XConfigPtr *configPtr)
+{
+    return xconfigScanReadConfig(defaultScan, configPtr);
+}
+
+
+void xconfigCloseConfigFile (void)
+{
+    xconfigScanClose(defaultScan);
+    defaultScan = NULL;
 }
 
 
 char *xconfigGetConfigFileName(void)
 {
-    return configPath;
+    return xconfigScan ? xconfigScan->configPath : NULL;
 }
 
 
 void
 xconfigSetSection (char *section)
 {
-    if (configSection)
-        free(configSection);
-    configSection = malloc(strlen (section) + 1);
-    strcpy (configSection, section);
+    XConfigScanPtr scan = xconfigScan;
+
+    if (scan->configSection)
+        free(scan->configSection);
+    scan->configSection = malloc(strlen (section) + 1);
+    strcpy (scan->configSection, section);
 }
 
 /* 
@@ -953,21 +1056,31 @@ xconfigSetSection (char *section)
 char *
 xconfigAddComment(char *cur, char *add)
 {
+    XConfigScanPtr scan = xconfigScan;
     char *str;
-    int len, curlen, iscomment, hasnewline = 0, endnewline;
+    int len, curlen, iscomment, hasnewline = 0, endnewline, eol_seen = 0;
 
     if (add == NULL || add[0] == '\0')
         return (cur);
 
+    /*
+     * comments may also be added outside of a parse (e.g., when merging
+     * configs), in which case there is no scanner
+     */
+
     if (cur) {
         curlen = strlen(cur);
         if (curlen)
             hasnewline = cur[curlen - 1] == '\n';
-        eol_seen = 0;
+        if (scan)
+            scan->eol_seen = 0;
     }
     else
         curlen = 0;
 
+    if (scan)
+        eol_seen = scan->eol_seen;
+
     str = add;
     iscomment = 0;
     while (*str) {
@@ -1000,7 +1113,7 @@ xconfigAddComment(char *cur, char *add)
 int
 xconfigGetStringToken (XConfigSymTabRec * tab)
 {
-    return StringToToken (val.str, tab);
+    return StringToToken (xconfigScan->val.str, tab);
 }
 
 static int
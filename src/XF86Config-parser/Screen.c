@@ -59,8 +59,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec DisplayTab[] =
 {
     {ENDSUBSECTION, "endsubsection"},
@@ -85,6 +83,7 @@ XConfigDisplayPtr
 xconfigParseDisplaySubSection (void)
 {
     int token;
+    GenericListPtr modesTail = NULL;
     PARSE_PROLOGUE (XConfigDisplayPtr, XConfigDisplayRec)
 
     ptr->black.red = ptr->black.green = ptr->black.blue = -1;
@@ -95,71 +94,72 @@ xconfigParseDisplaySubSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case VIEWPORT:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (VIEWPORT_MSG, NULL);
-            ptr->frameX0 = val.num;
+            ptr->frameX0 = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (VIEWPORT_MSG, NULL);
-            ptr->frameY0 = val.num;
+            ptr->frameY0 = xconfigScan->val.num;
             break;
         case VIRTUAL:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (VIRTUAL_MSG, NULL);
-            ptr->virtualX = val.num;
+            ptr->virtualX = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (VIRTUAL_MSG, NULL);
-            ptr->virtualY = val.num;
+            ptr->virtualY = xconfigScan->val.num;
             break;
         case DEPTH:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Display");
-            ptr->depth = val.num;
+            ptr->depth = xconfigScan->val.num;
             break;
         case BPP:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Display");
-            ptr->bpp = val.num;
+            ptr->bpp = xconfigScan->val.num;
             break;
         case VISUAL:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Display");
-            ptr->visual = val.str;
+            ptr->visual = xconfigScan->val.str;
             break;
         case WEIGHT:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (WEIGHT_MSG, NULL);
-            ptr->weight.red = val.num;
+            ptr->weight.red = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (WEIGHT_MSG, NULL);
-            ptr->weight.green = val.num;
+            ptr->weight.green = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (WEIGHT_MSG, NULL);
-            ptr->weight.blue = val.num;
+            ptr->weight.blue = xconfigScan->val.num;
             break;
         case BLACK_TOK:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (BLACK_MSG, NULL);
-            ptr->black.red = val.num;
+            ptr->black.red = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (BLACK_MSG, NULL);
-            ptr->black.green = val.num;
+            ptr->black.green = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (BLACK_MSG, NULL);
-            ptr->black.blue = val.num;
+            ptr->black.blue = xconfigScan->val.num;
             break;
         case WHITE_TOK:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (WHITE_MSG, NULL);
-            ptr->white.red = val.num;
+            ptr->white.red = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (WHITE_MSG, NULL);
-            ptr->white.green = val.num;
+            ptr->white.green = xconfigScan->val.num;
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (WHITE_MSG, NULL);
-            ptr->white.blue = val.num;
+            ptr->white.blue = xconfigScan->val.num;
             break;
         case MODES:
             {
@@ -170,10 +170,10 @@ xconfigParseDisplaySubSection (void)
                                                   DisplayTab)) == STRING)
                 {
                     mptr = calloc (1, sizeof (XConfigModeRec));
-                    mptr->mode_name = val.str;
+                    mptr->mode_name = xconfigScan->val.str;
                     mptr->next = NULL;
-                    xconfigAddListItem((GenericListPtr *)(&ptr->modes),
-                                       (GenericListPtr) mptr);
+                    xconfigAddListItemTail((GenericListPtr *)(&ptr->modes),
+                                           &modesTail, (GenericListPtr) mptr);
                 }
                 xconfigUnGetToken (token);
             }
@@ -222,6 +222,7 @@ xconfigParseScreenSection (void)
     int has_driver= FALSE;
     int token;
 
+    GenericListPtr displaysTail = NULL;
     PARSE_PROLOGUE (XConfigScreenPtr, XConfigScreenRec)
 
         while ((token = xconfigGetToken (ScreenTab)) != ENDSECTION)
@@ -229,12 +230,13 @@ xconfigParseScreenSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             if (has_ident || has_driver)
                 Error (ONLY_ONE_MSG,"Identifier or Driver");
             has_ident = TRUE;
@@ -242,7 +244,7 @@ xconfigParseScreenSection (void)
         case OBSDRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->obsolete_driver = val.str;
+            ptr->obsolete_driver = xconfigScan->val.str;
             if (has_ident || has_driver)
                 Error (ONLY_ONE_MSG,"Identifier or Driver");
             has_driver = TRUE;
@@ -250,27 +252,27 @@ xconfigParseScreenSection (void)
         case DEFAULTDEPTH:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DefaultDepth");
-            ptr->defaultdepth = val.num;
+            ptr->defaultdepth = xconfigScan->val.num;
             break;
         case DEFAULTBPP:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DefaultBPP");
-            ptr->defaultbpp = val.num;
+            ptr->defaultbpp = xconfigScan->val.num;
             break;
         case DEFAULTFBBPP:
             if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DefaultFbBPP");
-            ptr->defaultfbbpp = val.num;
+            ptr->defaultfbbpp = xconfigScan->val.num;
             break;
         case MDEVICE:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Device");
-            ptr->device_name = val.str;
+            ptr->device_name = xconfigScan->val.str;
             break;
         case MONITOR:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Monitor");
-            ptr->monitor_name = val.str;
+            ptr->monitor_name = xconfigScan->val.str;
             break;
         case VIDEOADAPTOR:
             {
@@ -282,14 +284,15 @@ xconfigParseScreenSection (void)
                 /* Don't allow duplicates */
                 for (aptr = ptr->adaptors; aptr; 
                     aptr = (XConfigAdaptorLinkPtr) aptr->next)
-                    if (xconfigNameCompare (val.str, aptr->adaptor_name) == 0)
+                    if (xconfigNameCompare (xconfigScan->val.str,
+                                            aptr->adaptor_name) == 0)
                         break;
 
                 if (aptr == NULL)
                 {
                     aptr = calloc (1, sizeof (XConfigAdaptorLinkRec));
                     aptr->next = NULL;
-                    aptr->adaptor_name = val.str;
+                    aptr->adaptor_name = xconfigScan->val.str;
                     xconfigAddListItem ((GenericListPtr *)(&ptr->adaptors),
                                         (GenericListPtr) aptr);
                 }
@@ -302,8 +305,9 @@ xconfigParseScreenSection (void)
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "SubSection");
             {
-                free(val.str);
-                HANDLE_LIST (displays, xconfigParseDisplaySubSection,
+                free(xconfigScan->val.str);
+                HANDLE_LIST (displays, displaysTail,
+                             xconfigParseDisplaySubSection,
                              XConfigDisplayPtr);
             }
             break;
@@ -501,6 +505,8 @@ xconfigValidateScreen (XConfigPtr p)
     XConfigMonitorPtr monitor;
     XConfigDevicePtr device;
     XConfigAdaptorLinkPtr adaptor;
+    XConfigNameIndexRec monitors, devices;
+    int ret = FALSE;
 
     /*
      * if we do not have a screen, just return TRUE; we'll add a
@@ -509,34 +515,43 @@ xconfigValidateScreen (XConfigPtr p)
 
     if (!screen) return TRUE;
 
+    /* index the monitors and devices, which every screen looks up */
+
+    XCONFIG_NAME_INDEX_INIT(&monitors, &p->monitors,
+                            XConfigMonitorRec, identifier);
+    XCONFIG_NAME_INDEX_INIT(&devices, &p->devices,
+                            XConfigDeviceRec, identifier);
+
     while (screen)
     {
         if (screen->obsolete_driver && !screen->identifier)
             screen->identifier = screen->obsolete_driver;
 
-        monitor = xconfigFindMonitor (screen->monitor_name, p->monitors);
+        monitor = (XConfigMonitorPtr)
+            xconfigNameIndexFind(&monitors, screen->monitor_name);
         if (screen->monitor_name)
         {
             if (!monitor)
             {
                 xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_MONITOR_MSG,
                              screen->monitor_name, screen->identifier);
-                return (FALSE);
+                goto done;
             }
             else
             {
                 screen->monitor = monitor;
                 if (!xconfigValidateMonitor(p, screen))
-                    return (FALSE);
+                    goto done;
             }
         }
 
-        device = xconfigFindDevice (screen->device_name, p->devices);
+        device = (XConfigDevicePtr)
+            xconfigNameIndexFind(&devices, screen->device_name);
         if (!device)
         {
             xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_DEVICE_MSG,
                          screen->device_name, screen->identifier);
-            return (FALSE);
+            goto done;
         }
         else
             screen->device = device;
@@ -549,12 +564,12 @@ xconfigValidateScreen (XConfigPtr p)
                 xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_ADAPTOR_MSG,
                              adaptor->adaptor_name,
                              screen->identifier);
-                return (FALSE);
+                goto done;
             } else if (adaptor->adaptor->fwdref) {
                 xconfigErrorMsg(ValidationErrorMsg, ADAPTOR_REF_TWICE_MSG,
                              adaptor->adaptor_name,
                              adaptor->adaptor->fwdref);
-                return (FALSE);
+                goto done;
             }
             
             adaptor->adaptor->fwdref = xconfigStrdup(screen->identifier);
@@ -564,7 +579,13 @@ xconfigValidateScreen (XConfigPtr p)
         screen = screen->next;
     }
 
-    return (TRUE);
+    ret = TRUE;
+
+ done:
+    xconfigNameIndexFree(&monitors);
+    xconfigNameIndexFree(&devices);
+
+    return ret;
 }
 
 int xconfigSanitizeScreen(XConfigPtr p)
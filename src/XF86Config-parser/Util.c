@@ -111,16 +111,15 @@ char *xconfigStrcat(const char *str, ...)
 
 #define NV_FMT_BUF_LEN 64
 
-extern int configLineNo;
-extern char *configSection;
-extern char *configPath;
-
 void xconfigErrorMsg(MsgType t, char *fmt, ...)
 {
     va_list ap;
     int len, current_len = NV_FMT_BUF_LEN;
     char *b, *pre = NULL, *msg;
     char scratch[64];
+    int configLineNo = xconfigScan ? xconfigScan->configLineNo : 0;
+    char *configSection = xconfigScan ? xconfigScan->configSection : NULL;
+    char *configPath = xconfigScan ? xconfigScan->configPath : NULL;
 
     b = xconfigAlloc(current_len);
     
@@ -59,8 +59,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec VendorSubTab[] =
 {
     {ENDSUBSECTION, "endsubsection"},
@@ -83,14 +81,15 @@ xconfigParseVendorSubSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)))
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case OPTION:
@@ -127,6 +126,7 @@ xconfigParseVendorSection (void)
 {
     int has_ident = FALSE;
     int token;
+    GenericListPtr subsTail = NULL;
     PARSE_PROLOGUE (XConfigVendorPtr, XConfigVendorRec)
 
     while ((token = xconfigGetToken (VendorTab)) != ENDSECTION)
@@ -134,14 +134,15 @@ xconfigParseVendorSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case OPTION:
@@ -151,7 +152,7 @@ xconfigParseVendorSection (void)
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "SubSection");
             {
-                HANDLE_LIST (subs, xconfigParseVendorSubSection,
+                HANDLE_LIST (subs, subsTail, xconfigParseVendorSubSection,
                             XConfigVendSubPtr);
             }
             break;
@@ -58,8 +58,6 @@
 #include "xf86tokens.h"
 #include "Configint.h"
 
-extern LexRec val;
-
 static XConfigSymTabRec VideoPortTab[] =
 {
     {ENDSUBSECTION, "endsubsection"},
@@ -82,14 +80,15 @@ xconfigParseVideoPortSubSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             has_ident = TRUE;
             break;
         case OPTION:
@@ -131,6 +130,7 @@ xconfigParseVideoAdaptorSection (void)
     int has_ident = FALSE;
     int token;
 
+    GenericListPtr portsTail = NULL;
     PARSE_PROLOGUE (XConfigVideoAdaptorPtr, XConfigVideoAdaptorRec)
 
     while ((token = xconfigGetToken (VideoAdaptorTab)) != ENDSECTION)
@@ -138,12 +138,13 @@ xconfigParseVideoAdaptorSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigAddComment(ptr->comment,
+                                             xconfigScan->val.str);
             break;
         case IDENTIFIER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = xconfigScan->val.str;
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
             has_ident = TRUE;
@@ -151,22 +152,22 @@ xconfigParseVideoAdaptorSection (void)
         case VENDOR:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Vendor");
-            ptr->vendor = val.str;
+            ptr->vendor = xconfigScan->val.str;
             break;
         case BOARD:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Board");
-            ptr->board = val.str;
+            ptr->board = xconfigScan->val.str;
             break;
         case BUSID:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "BusID");
-            ptr->busid = val.str;
+            ptr->busid = xconfigScan->val.str;
             break;
         case DRIVER:
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = xconfigScan->val.str;
             break;
         case OPTION:
             ptr->options = xconfigParseOption(ptr->options);
@@ -175,7 +176,7 @@ xconfigParseVideoAdaptorSection (void)
             if (xconfigGetSubToken (&(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "SubSection");
             {
-                HANDLE_LIST (ports, xconfigParseVideoPortSubSection,
+                HANDLE_LIST (ports, portsTail, xconfigParseVideoPortSubSection,
                              XConfigVideoPortPtr);
             }
             break;
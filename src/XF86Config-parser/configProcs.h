@@ -96,6 +96,12 @@ void xconfigPrintVideoAdaptorSection(FILE *cf, XConfigVideoAdaptorPtr ptr);
 
 /* Read.c */
 int xconfigValidateConfig(XConfigPtr p);
+void xconfigNameIndexInit(XConfigNameIndexPtr index, GenericListPtr *pList,
+                          size_t nameOffset);
+void xconfigNameIndexAdd(XConfigNameIndexPtr index, GenericListPtr item);
+GenericListPtr xconfigNameIndexFind(XConfigNameIndexPtr index,
+                                    const char *name);
+void xconfigNameIndexFree(XConfigNameIndexPtr index);
 
 /* Scan.c */
 int xconfigGetToken(XConfigSymTabRec *tab);
@@ -639,6 +639,25 @@ int xconfigSanitizeConfig(XConfigPtr p, const char *screenName,
 void xconfigCloseConfigFile(void);
 int xconfigWriteConfigFile(const char *, XConfigPtr);
 
+/*
+ * Reentrant variants of the above: each XConfigScanPtr carries its own
+ * lexer state, so separate scanners may be read concurrently (one
+ * scanner per thread at a time).  xconfigOpenConfigFile() and friends
+ * operate on a single shared scanner.
+ *
+ * xconfigScanOpenBuffer() parses 'size' bytes of 'data' in place; the
+ * caller must keep them valid until xconfigScanClose().  'name' is only
+ * used in error messages and for XConfigRec.filename, and may be NULL.
+ */
+typedef struct _XConfigScanRec *XConfigScanPtr;
+
+XConfigScanPtr xconfigScanOpenFile(const char *cmdline, const char *projroot);
+XConfigScanPtr xconfigScanOpenBuffer(const char *data, size_t size,
+                                     const char *name);
+const char *xconfigScanGetFileName(XConfigScanPtr scan);
+XConfigError xconfigScanReadConfig(XConfigScanPtr scan, XConfigPtr *);
+void xconfigScanClose(XConfigScanPtr scan);
+
 void xconfigFreeConfig(XConfigPtr *p);
 
 /*
@@ -697,6 +716,8 @@ void xconfigFreeModesLinkList(XConfigModesLinkPtr *ptr);
  */
 
 void xconfigAddListItem(GenericListPtr *pHead, GenericListPtr c_new);
+void xconfigAddListItemTail(GenericListPtr *pHead, GenericListPtr *pTail,
+                            GenericListPtr c_new);
 void xconfigRemoveListItem(GenericListPtr *pHead, GenericListPtr item);
 int xconfigItemNotSublist(GenericListPtr list_1, GenericListPtr list_2);
 char *xconfigAddComment(char *cur, char *add);
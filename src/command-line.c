@@ -24,12 +24,15 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <float.h>
 
 #include "option-table.h"
 #include "query-assign.h"
 #include "msg.h"
 #include "nvgetopt.h"
 #include "glxinfo.h"
+#include "monitor.h"
+#include "monitor-log.h"
 
 #include "NvCtrlAttributes.h"
 
@@ -224,11 +227,15 @@ Options *parse_command_line(int argc, char *argv[],
     Options *op;
     int n, c;
     char *strval;
-    int boolval;
+    int boolval, intval;
+    double doubleval;
 
     op = nvalloc(sizeof(Options));
     op->config = DEFAULT_RC_FILE;
     op->write_config = NV_TRUE;
+    op->monitor_interval = DEFAULT_MONITOR_INTERVAL;
+    op->monitor_log_size = DEFAULT_MONITOR_LOG_SIZE;
+    op->log_end = DBL_MAX;
 
     /*
      * initialize the controlled display to the gui display name
@@ -238,8 +245,8 @@ Options *parse_command_line(int argc, char *argv[],
     while (1) {
         c = nvgetopt(argc, argv, __options, &strval,
                      &boolval,  /* boolval */
-                     NULL,  /* intval */
-                     NULL,  /* doubleval */
+                     &intval,  /* intval */
+                     &doubleval,  /* doubleval */
                      NULL); /* disable_val */
 
         if (c == -1)
@@ -307,6 +314,68 @@ Options *parse_command_line(int argc, char *argv[],
         case 'w': op->write_config = boolval; break;
         case 'i': op->use_gtk2 = NV_TRUE; break;
         case 'I': op->gtk_lib_path = strval; break;
+        case 'j':
+            if (intval < 1) {
+                nv_error_msg("Invalid number of jobs '%d'.  Please run "
+                             "`%s --help` for usage information.\n",
+                             intval, argv[0]);
+                exit(0);
+            }
+            op->jobs = intval;
+            break;
+        case 'm': op->monitor = strval; break;
+        case MONITOR_INTERVAL_OPTION:
+            if (intval < 1) {
+                nv_error_msg("Invalid monitor interval '%d'.  Please run "
+                             "`%s --help` for usage information.\n",
+                             intval, argv[0]);
+                exit(0);
+            }
+            op->monitor_interval = intval;
+            break;
+        case MONITOR_OUTPUT_OPTION: op->monitor_output = strval; break;
+        case MONITOR_SAMPLES_OPTION:
+            if (intval < 0) {
+                nv_error_msg("Invalid number of monitor samples '%d'.  Please "
+                             "run `%s --help` for usage information.\n",
+                             intval, argv[0]);
+                exit(0);
+            }
+            op->monitor_samples = intval;
+            break;
+        case MONITOR_LOG_OPTION: op->monitor_log = strval; break;
+        case MONITOR_LOG_SIZE_OPTION:
+            if (intval < 1) {
+                nv_error_msg("Invalid monitor log size '%d'.  Please run "
+                             "`%s --help` for usage information.\n",
+                             intval, argv[0]);
+                exit(0);
+            }
+            op->monitor_log_size = intval;
+            break;
+        case READ_LOG_OPTION: op->read_log = strval; break;
+        case LOG_START_OPTION: op->log_start = doubleval; break;
+        case LOG_END_OPTION: op->log_end = doubleval; break;
+        case PROFILE_STARTUP_OPTION:
+            op->profile_startup = NV_TRUE;
+            op->profile_trace = strval;
+            break;
+        case TOPOLOGY_CACHE_OPTION: op->topology_cache = boolval; break;
+        case ATOMIC_OPTION: op->atomic = NV_TRUE; break;
+        case OUTPUT_OPTION:
+            if (nv_strcasecmp(strval, "text")) {
+                op->output_format = OUTPUT_FORMAT_TEXT;
+            } else if (nv_strcasecmp(strval, "json")) {
+                op->output_format = OUTPUT_FORMAT_JSON;
+            } else if (nv_strcasecmp(strval, "ndjson")) {
+                op->output_format = OUTPUT_FORMAT_NDJSON;
+            } else {
+                nv_error_msg("Invalid output format '%s'.  Please run "
+                             "`%s --help` for usage information.\n",
+                             strval, argv[0]);
+                exit(0);
+            }
+            break;
         default:
             nv_error_msg("Invalid commandline, please run `%s --help` "
                          "for usage information.\n", argv[0]);
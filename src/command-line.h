@@ -30,6 +30,23 @@ struct _CtrlSystemList;
 #define DEFAULT_RC_FILE "~/.nvidia-settings-rc"
 #define CONFIG_FILE_OPTION 1
 #define DISPLAY_OPTION 2
+#define MONITOR_INTERVAL_OPTION 3
+#define MONITOR_OUTPUT_OPTION 4
+#define MONITOR_SAMPLES_OPTION 5
+#define MONITOR_LOG_OPTION 6
+#define MONITOR_LOG_SIZE_OPTION 7
+#define READ_LOG_OPTION 8
+#define LOG_START_OPTION 9
+#define LOG_END_OPTION 10
+#define PROFILE_STARTUP_OPTION 11
+#define TOPOLOGY_CACHE_OPTION 12
+#define OUTPUT_OPTION 13
+#define ATOMIC_OPTION 14
+
+/* Formats for the output of queries (--output) */
+#define OUTPUT_FORMAT_TEXT   0
+#define OUTPUT_FORMAT_JSON   1
+#define OUTPUT_FORMAT_NDJSON 2
 
 /*
  * Options structure -- stores the parameters specified on the
@@ -107,6 +124,11 @@ typedef struct {
                           * of display device names instead of a number.
                           */
 
+    int output_format;   /*
+                          * Format of the output of the 'all' and target
+                          * list queries; one of OUTPUT_FORMAT_*.
+                          */
+
     int write_config;    /*
                           * If true, write out the configuration file on exit.
                           */
@@ -115,6 +137,65 @@ typedef struct {
                           * If true, use GTK+ 2 user interface library
                           */
 
+    int jobs;            /*
+                          * Maximum number of X displays to process
+                          * queries and assignments for in parallel.
+                          */
+
+    int atomic;          /*
+                          * If true, make the assignments given on the
+                          * command line all or nothing.
+                          */
+
+    char *monitor;       /*
+                          * Comma-separated list of the integer
+                          * attributes to sample in monitor mode; if
+                          * set, sample these attributes until
+                          * interrupted instead of starting the gui.
+                          */
+
+    int monitor_interval; /*
+                           * Interval between samples in monitor mode,
+                           * in milliseconds.
+                           */
+
+    char *monitor_output; /*
+                           * File to write monitor records to; defaults
+                           * to stdout.
+                           */
+
+    int monitor_samples; /*
+                          * Number of samples to take in monitor mode
+                          * before exiting; 0 means no limit.
+                          */
+
+    char *monitor_log;   /*
+                          * Binary log file to store the samples taken
+                          * in monitor mode in.
+                          */
+
+    int monitor_log_size; /*
+                           * Number of samples held by the monitor log
+                           * before the oldest ones are overwritten.
+                           */
+
+    char *read_log;      /*
+                          * If set, print the samples stored in this
+                          * monitor log and exit.
+                          */
+
+    double log_start;    /*
+                          * Start of the time range, in seconds since
+                          * the Epoch, of the samples printed from the
+                          * monitor log.
+                          */
+
+    double log_end;      /*
+                          * End of the time range, in seconds since the
+                          * Epoch, of the samples printed from the
+                          * monitor log.
+                          */
+
     char *gtk_lib_path;  /*
                           * Path to the user interface library to use or to the
                           * directory containing the library to use. In the
@@ -122,6 +203,23 @@ typedef struct {
                           * ignored.
                           */
 
+
+    int profile_startup; /*
+                          * If true, time the startup phases and report
+                          * them on exit.
+                          */
+
+    char *profile_trace; /*
+                          * If set, write the startup profile to this
+                          * file in the Chrome trace event format
+                          * instead of printing it.
+                          */
+
+    int topology_cache;  /*
+                          * If true, cache the topology of the X
+                          * server's targets on disk and reuse it while
+                          * the X server's configuration is unchanged.
+                          */
 } Options;
 
 
@@ -53,6 +53,21 @@ void nv_set_verbosity(NvVerbosity level)
 }
 
 
+/*
+ * the stream that messages independent of the verbosity level and info
+ * messages are printed to; stdout unless reserved for other output (NULL)
+ */
+
+static FILE *__msg_stream = NULL;
+
+void nv_set_msg_stream(FILE *stream)
+{
+    __msg_stream = stream;
+}
+
+#define MSG_STREAM (__msg_stream ? __msg_stream : stdout)
+
+
 /****************************************************************************/
 /* Formatted I/O functions */
 /****************************************************************************/
@@ -172,7 +187,7 @@ void nv_info_msg(const char *prefix, const char *fmt, ...)
 {
     if (__verbosity < NV_VERBOSITY_ALL) return;
 
-    NV_FORMAT(stdout, prefix, fmt, TRUE);
+    NV_FORMAT(MSG_STREAM, prefix, fmt, TRUE);
 } /* nv_info_msg() */
 
 
@@ -200,7 +215,7 @@ void nv_info_msg_to_file(FILE *stream, const char *prefix, const char *fmt, ...)
 
 void nv_msg(const char *prefix, const char *fmt, ...)
 {
-    NV_FORMAT(stdout, prefix, fmt, TRUE);
+    NV_FORMAT(MSG_STREAM, prefix, fmt, TRUE);
 } /* nv_msg() */
 
 
@@ -212,7 +227,7 @@ void nv_msg(const char *prefix, const char *fmt, ...)
 
 void nv_msg_preserve_whitespace(const char *prefix, const char *fmt, ...)
 {
-    NV_FORMAT(stdout, prefix, fmt, FALSE);
+    NV_FORMAT(MSG_STREAM, prefix, fmt, FALSE);
 } /* nv_msg_preserve_whitespace() */
 
 
@@ -102,6 +102,7 @@ typedef enum {
 
 NvVerbosity nv_get_verbosity(void);
 void        nv_set_verbosity(NvVerbosity level);
+void        nv_set_msg_stream(FILE *stream);
 
 
 /*
@@ -61,7 +61,8 @@ typedef struct {
 static ParsedAttributeWrapper *parse_config_file(char *buf,
                                                  const char *file,
                                                  const int length,
-                                                 ConfigProperties *);
+                                                 ConfigProperties *,
+                                                 ParserArena *);
 
 static int process_config_file_attributes(const Options *op,
                                           const char *file,
@@ -84,6 +85,9 @@ static void write_config_properties(FILE *stream, const ConfigProperties *conf,
 static char *create_display_device_target_string(CtrlTarget *t,
                                                  const ConfigProperties *conf);
 
+static void query_config_attributes(const CtrlTarget *t, int *vals,
+                                    ReturnStatus *statuses);
+
 /*
  * set_dynamic_verbosity() - Sets the __dynamic_verbosity variable which
  * allows temporary toggling of the verbosity level to hide some output
@@ -127,6 +131,7 @@ int nv_read_config_file(const Options *op, const char *file,
     char *buf;
     char *locale;
     ParsedAttributeWrapper *w = NULL;
+    ParserArena *arena = NULL;
 
     if (!file) {
         /*
@@ -179,7 +184,8 @@ int nv_read_config_file(const Options *op, const char *file,
 
     locale = strdup(conf->locale);
 
-    w = parse_config_file(buf, file, length, conf);
+    arena = nv_parser_arena_new();
+    w = parse_config_file(buf, file, length, conf, arena);
 
     setlocale(LC_NUMERIC, locale);
     free(locale);
@@ -209,6 +215,7 @@ int nv_read_config_file(const Options *op, const char *file,
 
  done:
     free(w);
+    nv_parser_arena_free(arena);
     close(fd);
 
     return ret;
@@ -240,6 +247,8 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
     CtrlTarget *t;
     char *prefix, scratch[4];
     char *locale = "C";
+    int *vals;
+    ReturnStatus *statuses;
 
     if (!filename) {
         nv_error_msg("Unable to open configuration file for writing.");
@@ -294,6 +303,9 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
      * followed by attributes for display target types.
      */
 
+    vals = nvalloc(attributeTableLen * sizeof(*vals));
+    statuses = nvalloc(attributeTableLen * sizeof(*statuses));
+
     for (node = system->targets[X_SCREEN_TARGET]; node; node = node->next) {
 
         t = node->t;
@@ -316,6 +328,8 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
             prefix = scratch;
         }
 
+        query_config_attributes(t, vals, statuses);
+
         /* loop over all the entries in the table */
 
         for (entry = 0; entry < attributeTableLen; entry++) {
@@ -374,10 +388,10 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
                 continue;
             }
 
-            status = NvCtrlGetAttribute(t, a->attr, &val);
-            if (status != NvCtrlSuccess) {
+            if (statuses[entry] != NvCtrlSuccess) {
                 continue;
             }
+            val = vals[entry];
 
             if (a->f.int_flags.is_display_id) {
                 const char *name = NvCtrlGetDisplayConfigName(system, val);
@@ -423,6 +437,8 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
 
         prefix = create_display_device_target_string(t, conf);
 
+        query_config_attributes(t, vals, statuses);
+
         /* loop over all the entries in the table */
 
         for (entry = 0; entry < attributeTableLen; entry++) {
@@ -470,15 +486,17 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
                 continue;
             }
 
-            status = NvCtrlGetAttribute(t, a->attr, &val);
-            if (status == NvCtrlSuccess) {
+            if (statuses[entry] == NvCtrlSuccess) {
                 fprintf(stream, "%s%c%s=%d\n", prefix,
-                        DISPLAY_NAME_SEPARATOR, a->name, val);
+                        DISPLAY_NAME_SEPARATOR, a->name, vals[entry]);
             }
         }
 
         free(prefix);
     }
+
+    nvfree(statuses);
+    nvfree(vals);
     
     /*
      * loop the ParsedAttribute list, writing the attributes to file.
@@ -554,18 +572,24 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
  * lines.  Non-comment lines with non-whitespace characters are passed
  * on to nv_parse_attribute_string for parsing.
  *
+ * The buffer is scanned once, and the strings of the ParsedAttributes
+ * are allocated from arena, so that the cost stays proportional to the
+ * size of the file even for files with many thousands of lines.
+ *
  * If an error occurs, an error message is printed and NULL is
  * returned.  If successful, a malloced array of
  * ParsedAttributeWrapper structs is returned.  The last
  * ParsedAttributeWrapper in the array has line == -1.  It is the
- * caller's responsibility to free the array.
+ * caller's responsibility to free the array, and the arena once the
+ * ParsedAttributes are no longer needed.
  */
 
 static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
                                                  const int length,
-                                                 ConfigProperties *conf)
+                                                 ConfigProperties *conf,
+                                                 ParserArena *arena)
 {
-    int line, has_data, current_tmp_len, len, n, ret;
+    int line, has_data, current_tmp_len, len, n, max_n, ret;
     char *cur, *c, *comment, *tmp;
     ParsedAttributeWrapper *w;
     
@@ -573,13 +597,14 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
     line = 1;
     current_tmp_len = 0;
     n = 0;
+    max_n = 0;
     w = NULL;
     tmp = NULL;
 
     while (cur) {
         c = cur;
         comment = NULL;
-        has_data = NV_FALSE;;
+        has_data = NV_FALSE;
         
         while (((c - buf) < length) &&
                (*c != '\n') &&
@@ -597,25 +622,31 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
             /* grow the tmp buffer if it's too small */
             
             if (len >= current_tmp_len) {
-                current_tmp_len = len + 1;
-                if (tmp) {
-                    free(tmp);
-                }
+                current_tmp_len = NV_MAX(2 * current_tmp_len, len + 1);
+                free(tmp);
                 tmp = nvalloc(sizeof(char) * current_tmp_len);
             }
 
-            strncpy (tmp, cur, len);
+            memcpy(tmp, cur, len);
             tmp[len] = '\0';
 
             /* first, see if this line is a config property */
 
             if (!parse_config_property(file, tmp, conf)) {
-                
-                w = nvrealloc(w, sizeof(ParsedAttributeWrapper) * (n+1));
+
+                /*
+                 * grow the array geometrically, keeping room for the
+                 * end marker
+                 */
+
+                if (n + 1 >= max_n) {
+                    max_n = NV_MAX(64, 2 * max_n);
+                    w = nvrealloc(w, sizeof(ParsedAttributeWrapper) * max_n);
+                }
             
                 ret = nv_parse_attribute_string(tmp,
                                                 NV_PARSER_ASSIGNMENT,
-                                                &w[n].a);
+                                                &w[n].a, arena);
                 if (ret != NV_PARSER_STATUS_SUCCESS) {
                     nv_error_msg("Error parsing configuration file '%s' on "
                                  "line %d: '%s' (%s).",
@@ -624,6 +655,7 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
                 }
             
                 w[n].line = line;
+                w[n].system = NULL;
                 n++;
             }
         }
@@ -634,9 +666,12 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
         line++;
     }
     free(tmp);
+
     /* mark the end of the array */
 
-    w = nvrealloc(w, sizeof(ParsedAttributeWrapper) * (n+1));
+    if (!w) {
+        w = nvalloc(sizeof(ParsedAttributeWrapper));
+    }
     w[n].line = -1;
     
     return w;
@@ -689,7 +724,14 @@ static int process_config_file_attributes(const Options *op,
         w[i].system = NvCtrlConnectToSystem(w[i].a.display, systems);
     }
 
-    /* now process each attribute, passing in the correct system */
+    /*
+     * now process each attribute, passing in the correct system; the
+     * integer assignments are collected into a batch, so that the
+     * current state is read in one pass, assignments that would not
+     * change anything are skipped, and the rest go out in one burst
+     */
+
+    nv_assignment_batch_begin(NV_FALSE);
 
     for (i = 0; w[i].line != -1; i++) {
 
@@ -704,6 +746,8 @@ static int process_config_file_attributes(const Options *op,
          * control to force stereo)
          */
     }
+
+    nv_assignment_batch_end(op);
     
     /* Reset the default verbosity */
 
@@ -720,18 +764,25 @@ static int process_config_file_attributes(const Options *op,
 /*
  * save_gui_parsed_attributes() - scan through the parsed attribute
  * wrappers, and save any relevant attributes to the attribute list to
- * be passed to the gui.
+ * be passed to the gui.  Each attribute is added at the end of the
+ * list, which nv_parsed_attribute_add() finds from the node it is
+ * given; start it from the node added last, rather than from the head
+ * of the list.
  */
 
 static void save_gui_parsed_attributes(ParsedAttributeWrapper *w,
                                        ParsedAttribute *p_list)
 {
+    ParsedAttribute *tail = p_list;
     int i;
 
     for (i = 0; w[i].line != -1; i++) {
         ParsedAttribute *p = &(w[i].a);
         if (p->attr_entry->flags.is_gui_attribute) {
-            nv_parsed_attribute_add(p_list, p);
+            nv_parsed_attribute_add(tail, p);
+            while (tail->next) {
+                tail = tail->next;
+            }
         }
     }
 }
@@ -805,6 +856,16 @@ static int parse_config_property(const char *file, const char *line, ConfigPrope
         "ToolTips",
     };
 
+    /*
+     * attribute assignments usually name an X display or a target before
+     * the attribute; property names never contain the separator
+     */
+
+    s = strchr(line, '=');
+    if (!s || memchr(line, DISPLAY_NAME_SEPARATOR, s - line)) {
+        return NV_FALSE;
+    }
+
     no_spaces = remove_spaces(line);
 
     if (!no_spaces) goto done;
@@ -861,6 +922,11 @@ static int parse_config_property(const char *file, const char *line, ConfigPrope
 
         c->next = conf->timers;
         conf->timers = c;
+    } else if (nv_strcasecmp(no_spaces, "EventCoalescingWindow")) {
+        parse_read_integer(++s, &interval);
+        if (interval < 0)
+            goto done;
+        conf->event_coalescing_window = interval;
     } else {
         for (t = configPropertyTable, flag = 0; t->name; t++) {
             if (nv_strcasecmp(no_spaces, t->name)) {
@@ -929,6 +995,16 @@ static void write_config_properties(FILE *stream, const ConfigProperties *conf,
                 c->interval);
         free(description);
     }
+
+    /*
+     * only write the window when it differs from the default, so that
+     * rc files pick up changes to the default
+     */
+
+    if (conf->event_coalescing_window != DEFAULT_EVENT_COALESCING_WINDOW) {
+        fprintf(stream, "EventCoalescingWindow = %u\n",
+                conf->event_coalescing_window);
+    }
 } /* write_config_properties()*/
 
 
@@ -950,9 +1026,64 @@ void init_config_properties(ConfigProperties *conf)
 
     conf->locale = strdup(setlocale(LC_NUMERIC, NULL));
 
+    conf->event_coalescing_window = DEFAULT_EVENT_COALESCING_WINDOW;
+
 } /* init_config_properties() */
 
 
+/*
+ * query_config_attributes() - query the current values of all integer
+ * attributes that may be written to the configuration file for the
+ * given target, with a single batched request.  The value and status
+ * for attributeTable[i] are stored in vals[i] and statuses[i].
+ */
+
+static void query_config_attributes(const CtrlTarget *t, int *vals,
+                                    ReturnStatus *statuses)
+{
+    int *attrs, *entries;
+    int *batch_vals;
+    ReturnStatus *batch_statuses;
+    int entry, i, count = 0;
+
+    attrs = nvalloc(attributeTableLen * sizeof(*attrs));
+    entries = nvalloc(attributeTableLen * sizeof(*entries));
+
+    for (entry = 0; entry < attributeTableLen; entry++) {
+        const AttributeTableEntry *a = &attributeTable[entry];
+
+        statuses[entry] = NvCtrlAttributeNotAvailable;
+
+        if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER ||
+            a->flags.no_config_write) {
+            continue;
+        }
+
+        attrs[count] = a->attr;
+        entries[count] = entry;
+        count++;
+    }
+
+    batch_vals = nvalloc(count * sizeof(*batch_vals));
+    batch_statuses = nvalloc(count * sizeof(*batch_statuses));
+
+    if (count > 0 &&
+        NvCtrlGetAttributes(t, count, attrs, batch_vals,
+                            batch_statuses) == NvCtrlSuccess) {
+        for (i = 0; i < count; i++) {
+            vals[entries[i]] = batch_vals[i];
+            statuses[entries[i]] = batch_statuses[i];
+        }
+    }
+
+    nvfree(batch_statuses);
+    nvfree(batch_vals);
+    nvfree(entries);
+    nvfree(attrs);
+
+} /* query_config_attributes() */
+
+
 /*
  * create_display_device_target_string() - create the string
  * to specify the display device target in the config file.
@@ -44,10 +44,17 @@ typedef struct _TimerConfigProperty {
     struct _TimerConfigProperty *next;
 } TimerConfigProperty;
 
+/*
+ * How long (in milliseconds) the GUI holds NV-CONTROL events so that
+ * repeated events for the same attribute collapse into one.
+ */
+#define DEFAULT_EVENT_COALESCING_WINDOW 20
+
 typedef struct {
     unsigned int booleans;
     char *locale;
     TimerConfigProperty *timers;
+    unsigned int event_coalescing_window;
 } ConfigProperties;
 
 
@@ -119,7 +119,18 @@ GType ctk_config_get_type(
 static void config_finalize(GObject *object)
 {
     CtkConfig *ctk_config = CTK_CONFIG(object);
+    GList *l;
+
     ctk_help_data_list_free_full(ctk_config->help_data);
+
+    if (ctk_config->timer_source) {
+        g_source_remove(ctk_config->timer_source);
+    }
+    for (l = ctk_config->timers; l; l = l->next) {
+        g_free(l->data);
+    }
+    g_list_free(ctk_config->timers);
+    g_timer_destroy(ctk_config->timer_clock);
 }
 
 static void ctk_config_class_init(CtkConfigClass *ctk_config_class)
@@ -267,6 +278,11 @@ GtkWidget* ctk_config_new(ConfigProperties *conf, CtrlSystem *pCtrlSystem)
     
     /* timer list */
     
+    ctk_config->timers = NULL;
+    ctk_config->timer_source = 0;
+    ctk_config->timer_dispatching = FALSE;
+    ctk_config->timer_clock = g_timer_new();
+
     ctk_config->timer_list_box = gtk_hbox_new(FALSE, 0);
     ctk_config->timer_list = create_timer_list(ctk_config);
     g_object_ref(ctk_config->timer_list);
@@ -541,7 +557,14 @@ GtkTextBuffer *ctk_config_create_help(CtkConfig *ctk_config, GtkTextTagTable *ta
                   "describes the function of a timer, the 'Enabled' "
                   "field allows enabling/disabling it, the 'Time "
                   "Interval' field controls the delay between two "
-                  "consecutive polls (in milliseconds).  The Active "
+                  "consecutive polls (in milliseconds), and the 'Cost' "
+                  "field reports how long each poll takes on average "
+                  "and how often it has run.  Polls are skipped while "
+                  "the page they update is not visible (the 'skipped' "
+                  "count), and timers whose values have not changed "
+                  "for several polls in a row are polled less often "
+                  "until they change again (shown as a multiplier "
+                  "after the interval).  The Active "
                   "Timers table is only visible when timers are active.");
 
     ctk_help_heading(b, &i, "Save Current Configuration");
@@ -560,6 +583,38 @@ GtkTextBuffer *ctk_config_create_help(CtkConfig *ctk_config, GtkTextTagTable *ta
 #define MAX_TIME_INTERVAL (60 * 1000)
 #define MIN_TIME_INTERVAL (100)
 
+/*
+ * All timers are driven by a single GLib timeout source owned by the
+ * CtkConfig.  Timers that come due within TIMER_COALESCE_SLACK ms (or a
+ * quarter of their own interval, whichever is smaller) of the earliest
+ * deadline are run from the same wakeup.  Timers whose owner reports
+ * TIMER_BACKOFF_THRESHOLD unchanged polls in a row have their effective
+ * interval doubled, up to TIMER_MAX_BACKOFF times the configured interval.
+ */
+
+#define TIMER_COALESCE_SLACK    (250)
+#define TIMER_BACKOFF_THRESHOLD (3)
+#define TIMER_MAX_BACKOFF       (8)
+
+typedef struct _CtkConfigTimer {
+    TimerConfigProperty *config;
+    GSourceFunc function;
+    gpointer data;
+
+    gboolean owner_enabled;
+    gboolean removed;
+
+    gdouble next_due;   /* in ms, on ctk_config->timer_clock */
+    guint backoff;      /* effective interval multiplier */
+    guint unchanged;    /* consecutive polls reported as unchanged */
+
+    /* statistics shown in the 'Cost' column */
+    guint calls;
+    guint skipped;
+    gdouble total_cost; /* in ms */
+    gdouble last_cost;  /* in ms */
+} CtkConfigTimer;
+
 static void enabled_renderer_func(GtkTreeViewColumn*, GtkCellRenderer*,
                                   GtkTreeModel*, GtkTreeIter*, gpointer);
 
@@ -569,20 +624,21 @@ static void description_renderer_func(GtkTreeViewColumn*, GtkCellRenderer*,
 static void time_interval_renderer_func(GtkTreeViewColumn*, GtkCellRenderer*,
                                         GtkTreeModel*, GtkTreeIter*, gpointer);
 
+static void cost_renderer_func(GtkTreeViewColumn*, GtkCellRenderer*,
+                               GtkTreeModel*, GtkTreeIter*, gpointer);
+
 static void time_interval_edited(GtkCellRendererText*,
                                  const gchar*, const gchar*, gpointer);
 
 static void timer_enable_toggled(GtkCellRendererToggle*, gchar*, gpointer);
 
+static void schedule_timers(CtkConfig *ctk_config);
+
 
 
 enum {
 
-    TIMER_CONFIG_COLUMN = 0,
-    FUNCTION_COLUMN,
-    DATA_COLUMN,
-    HANDLE_COLUMN,
-    OWNER_ENABLE_COLUMN,
+    TIMER_COLUMN = 0,
     NUM_COLUMNS,
 };
 
@@ -604,15 +660,12 @@ static GtkWidget *create_timer_list(CtkConfig *ctk_config)
 
     ctk_config->list_store =
         gtk_list_store_new(NUM_COLUMNS,
-                           G_TYPE_POINTER,  /* TIMER_CONFIG_COLUMN */
-                           G_TYPE_POINTER,  /* FUNCTION_COLUMN */
-                           G_TYPE_POINTER,  /* DATA_COLUMN */
-                           G_TYPE_UINT,     /* HANDLE_COLUMN */
-                           G_TYPE_BOOLEAN); /* OWNER_ENABLE_COLUMN */
+                           G_TYPE_POINTER); /* TIMER_COLUMN */
     
     model = GTK_TREE_MODEL(ctk_config->list_store);
     
     treeview = gtk_tree_view_new_with_model(model);
+    ctk_config->timer_view = treeview;
     
     g_object_unref(ctk_config->list_store);
 
@@ -631,7 +684,7 @@ static GtkWidget *create_timer_list(CtkConfig *ctk_config)
                                             renderer,
                                             enabled_renderer_func,
                                             GINT_TO_POINTER
-                                            (TIMER_CONFIG_COLUMN),
+                                            (TIMER_COLUMN),
                                             NULL);
 
     /* Description */
@@ -648,7 +701,7 @@ static GtkWidget *create_timer_list(CtkConfig *ctk_config)
                                             renderer,
                                             description_renderer_func,
                                             GINT_TO_POINTER
-                                            (TIMER_CONFIG_COLUMN),
+                                            (TIMER_COLUMN),
                                             NULL);
     
     /* Time interval */
@@ -665,12 +718,29 @@ static GtkWidget *create_timer_list(CtkConfig *ctk_config)
                                             renderer,
                                             time_interval_renderer_func,
                                             GINT_TO_POINTER
-                                            (TIMER_CONFIG_COLUMN),
+                                            (TIMER_COLUMN),
                                             NULL);
     
     gtk_tree_view_append_column(GTK_TREE_VIEW(treeview), column);
     gtk_tree_view_column_set_resizable(column, FALSE);
 
+    /* Cost */
+
+    renderer = gtk_cell_renderer_text_new();
+    column = gtk_tree_view_column_new_with_attributes("Cost",
+                                                      renderer,
+                                                      NULL);
+
+    gtk_tree_view_column_set_cell_data_func(column,
+                                            renderer,
+                                            cost_renderer_func,
+                                            GINT_TO_POINTER
+                                            (TIMER_COLUMN),
+                                            NULL);
+
+    gtk_tree_view_append_column(GTK_TREE_VIEW(treeview), column);
+    gtk_tree_view_column_set_resizable(column, TRUE);
+
 
     gtk_container_add(GTK_CONTAINER(sw), treeview);
 
@@ -701,17 +771,17 @@ static void enabled_renderer_func(GtkTreeViewColumn *tree_column,
                                   gpointer           data)
 {
     gint column;
-    TimerConfigProperty *timer_config;
+    CtkConfigTimer *timer;
     gboolean value;
 
     column = GPOINTER_TO_INT(data);
-    gtk_tree_model_get(model, iter, column, &timer_config, -1);
+    gtk_tree_model_get(model, iter, column, &timer, -1);
 
-    if (timer_config == NULL) {
+    if (timer == NULL) {
         return;
     }
 
-    value = timer_config->user_enabled;
+    value = timer->config->user_enabled;
     g_object_set(GTK_CELL_RENDERER(cell), "active", value, NULL);
 }
 
@@ -722,17 +792,17 @@ static void description_renderer_func(GtkTreeViewColumn *tree_column,
                                       gpointer           data)
 {
     gint column;
-    TimerConfigProperty *timer_config;
+    CtkConfigTimer *timer;
     gchar *value;
 
     column = GPOINTER_TO_INT(data);
-    gtk_tree_model_get(model, iter, column, &timer_config, -1);
+    gtk_tree_model_get(model, iter, column, &timer, -1);
 
-    if (timer_config == NULL) {
+    if (timer == NULL) {
         return;
     }
 
-    value = timer_config->description;
+    value = timer->config->description;
     g_object_set(GTK_CELL_RENDERER(cell), "text", value, NULL);
 }
 
@@ -743,24 +813,286 @@ static void time_interval_renderer_func(GtkTreeViewColumn *tree_column,
                                         gpointer           data)
 {
     gint column = GPOINTER_TO_INT(data);
-    TimerConfigProperty *timer_config;
+    CtkConfigTimer *timer;
     guint value;
     gchar str[32];
     
-    gtk_tree_model_get(model, iter, column, &timer_config, -1);
+    gtk_tree_model_get(model, iter, column, &timer, -1);
 
-    if (timer_config == NULL) {
+    if (timer == NULL) {
         return;
     }
 
-    value = timer_config->interval;
+    value = timer->config->interval;
 
-    snprintf(str, 32, "%d ms", value);
+    if (timer->backoff > 1) {
+        snprintf(str, 32, "%d ms (x%d)", value, timer->backoff);
+    } else {
+        snprintf(str, 32, "%d ms", value);
+    }
     
     g_object_set(GTK_CELL_RENDERER(cell), "text", str, NULL);
     g_object_set(GTK_CELL_RENDERER(cell), "editable", TRUE, NULL);
 }
 
+static void cost_renderer_func(GtkTreeViewColumn *tree_column,
+                               GtkCellRenderer   *cell,
+                               GtkTreeModel      *model,
+                               GtkTreeIter       *iter,
+                               gpointer           data)
+{
+    gint column = GPOINTER_TO_INT(data);
+    CtkConfigTimer *timer;
+    gchar str[64];
+
+    gtk_tree_model_get(model, iter, column, &timer, -1);
+
+    if (timer == NULL) {
+        return;
+    }
+
+    if (timer->calls == 0) {
+        snprintf(str, 64, "- (%u skipped)", timer->skipped);
+    } else {
+        snprintf(str, 64, "%.1f ms avg, %.1f ms last (%u runs, %u skipped)",
+                 timer->total_cost / timer->calls, timer->last_cost,
+                 timer->calls, timer->skipped);
+    }
+
+    g_object_set(GTK_CELL_RENDERER(cell), "text", str, NULL);
+}
+
+
+
+/*
+ * timer_clock_ms() - milliseconds elapsed on the scheduler's clock.
+ */
+
+static gdouble timer_clock_ms(CtkConfig *ctk_config)
+{
+    return g_timer_elapsed(ctk_config->timer_clock, NULL) * 1000.0;
+}
+
+
+static gboolean timer_is_running(CtkConfigTimer *timer)
+{
+    return !timer->removed &&
+        timer->owner_enabled &&
+        timer->config->user_enabled;
+}
+
+
+static guint timer_effective_interval(CtkConfigTimer *timer)
+{
+    guint interval = timer->config->interval * timer->backoff;
+
+    if (interval > MAX_TIME_INTERVAL) {
+        interval = MAX_TIME_INTERVAL;
+    }
+
+    return MAX(interval, timer->config->interval);
+}
+
+
+/*
+ * timer_owner_hidden() - returns TRUE if the widget that owns the timer
+ * cannot currently be seen (e.g. the window is iconified), so there is no
+ * point in refreshing it.
+ */
+
+static gboolean timer_owner_hidden(CtkConfigTimer *timer)
+{
+    GtkWidget *widget;
+
+    if (!timer->data || !GTK_IS_WIDGET(timer->data)) {
+        return FALSE;
+    }
+
+    widget = GTK_WIDGET(timer->data);
+
+    return !ctk_widget_get_visible(widget) || !ctk_widget_is_drawable(widget);
+}
+
+
+/*
+ * Restart a timer's period from now, e.g. after it was (re)enabled or its
+ * interval was edited.
+ */
+
+static void reset_timer(CtkConfig *ctk_config, CtkConfigTimer *timer)
+{
+    timer->backoff = 1;
+    timer->unchanged = 0;
+    timer->next_due = timer_clock_ms(ctk_config) + timer->config->interval;
+}
+
+
+static CtkConfigTimer *find_timer(CtkConfig *ctk_config,
+                                  GSourceFunc function, gpointer data)
+{
+    GList *l;
+
+    for (l = ctk_config->timers; l; l = l->next) {
+        CtkConfigTimer *timer = l->data;
+
+        if (!timer->removed &&
+            (timer->function == function) && (timer->data == data)) {
+            return timer;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void free_removed_timers(CtkConfig *ctk_config)
+{
+    GList *l = ctk_config->timers;
+
+    while (l) {
+        GList *next = l->next;
+        CtkConfigTimer *timer = l->data;
+
+        if (timer->removed) {
+            ctk_config->timers = g_list_delete_link(ctk_config->timers, l);
+            g_free(timer);
+        }
+        l = next;
+    }
+}
+
+
+/*
+ * dispatch_timers() - the single timeout callback: run every running timer
+ * that is due (within the coalescing slack), then re-arm for the next
+ * deadline.
+ */
+
+static gboolean dispatch_timers(gpointer user_data)
+{
+    CtkConfig *ctk_config = CTK_CONFIG(user_data);
+    GTimer *cost_timer;
+    gdouble now;
+    GList *l;
+
+    ctk_config->timer_source = 0;
+    ctk_config->timer_dispatching = TRUE;
+
+    cost_timer = g_timer_new();
+    now = timer_clock_ms(ctk_config);
+
+    /*
+     * Callbacks may add, start, stop or remove timers; additions are
+     * appended to the list and removals are deferred until after the loop,
+     * so walking the list here stays safe.
+     */
+
+    for (l = ctk_config->timers; l; l = l->next) {
+        CtkConfigTimer *timer = l->data;
+        gdouble slack;
+        gboolean ret;
+
+        if (!timer_is_running(timer)) {
+            continue;
+        }
+
+        slack = MIN(TIMER_COALESCE_SLACK, timer->config->interval / 4.0);
+
+        if (timer->next_due - now > slack) {
+            continue;
+        }
+
+        if (timer_owner_hidden(timer)) {
+            timer->skipped++;
+            timer->next_due = now + timer->config->interval;
+            continue;
+        }
+
+        g_timer_start(cost_timer);
+        ret = timer->function(timer->data);
+        timer->last_cost = g_timer_elapsed(cost_timer, NULL) * 1000.0;
+        timer->total_cost += timer->last_cost;
+        timer->calls++;
+
+        if (!ret) {
+            /* Same as a GSourceFunc returning FALSE: stop polling */
+            timer->owner_enabled = FALSE;
+            continue;
+        }
+
+        timer->next_due = now + timer_effective_interval(timer);
+    }
+
+    g_timer_destroy(cost_timer);
+
+    ctk_config->timer_dispatching = FALSE;
+
+    free_removed_timers(ctk_config);
+    schedule_timers(ctk_config);
+
+    /* Refresh the statistics in the timer list */
+
+    if (ctk_config->timer_list_visible &&
+        ctk_widget_is_drawable(ctk_config->timer_view)) {
+        gtk_widget_queue_draw(ctk_config->timer_view);
+    }
+
+    return FALSE;
+
+} /* dispatch_timers() */
+
+
+/*
+ * schedule_timers() - (re)arm the scheduler's timeout source for the
+ * earliest deadline among the running timers.  No source is kept when no
+ * timer is running.
+ */
+
+static void schedule_timers(CtkConfig *ctk_config)
+{
+    gboolean found = FALSE;
+    gdouble earliest = 0;
+    gdouble delay;
+    GList *l;
+
+    /* dispatch_timers() re-arms once all callbacks have run */
+
+    if (ctk_config->timer_dispatching) {
+        return;
+    }
+
+    if (ctk_config->timer_source) {
+        g_source_remove(ctk_config->timer_source);
+        ctk_config->timer_source = 0;
+    }
+
+    for (l = ctk_config->timers; l; l = l->next) {
+        CtkConfigTimer *timer = l->data;
+
+        if (!timer_is_running(timer)) {
+            continue;
+        }
+
+        if (!found || timer->next_due < earliest) {
+            earliest = timer->next_due;
+            found = TRUE;
+        }
+    }
+
+    if (!found) {
+        return;
+    }
+
+    delay = earliest - timer_clock_ms(ctk_config);
+    if (delay < 0) {
+        delay = 0;
+    }
+
+    ctk_config->timer_source =
+        g_timeout_add((guint) delay, dispatch_timers, ctk_config);
+
+} /* schedule_timers() */
+
 
 
 static void time_interval_edited(GtkCellRendererText *cell,
@@ -772,12 +1104,8 @@ static void time_interval_edited(GtkCellRendererText *cell,
     GtkTreeModel *model = GTK_TREE_MODEL(ctk_config->list_store);
     GtkTreePath *path;
     GtkTreeIter iter;
-    guint handle;
-    GSourceFunc function;
-    gpointer data;
     guint interval;
-    TimerConfigProperty *timer_config;
-    gboolean owner_enabled;
+    CtkConfigTimer *timer;
 
     interval = strtol(new_text, (char **)NULL, 10);
     
@@ -791,26 +1119,15 @@ static void time_interval_edited(GtkCellRendererText *cell,
     gtk_tree_model_get_iter(model, &iter, path);
     gtk_tree_path_free(path);
 
-    gtk_tree_model_get(model, &iter,
-                       TIMER_CONFIG_COLUMN, &timer_config,
-                       OWNER_ENABLE_COLUMN, &owner_enabled,
-                       HANDLE_COLUMN, &handle,
-                       FUNCTION_COLUMN, &function,
-                       DATA_COLUMN, &data,
-                       -1);
+    gtk_tree_model_get(model, &iter, TIMER_COLUMN, &timer, -1);
 
-    timer_config->interval = interval;
+    timer->config->interval = interval;
     
-    /* Restart the timer if it is already running */
-
-    if (timer_config->user_enabled && owner_enabled) {
-        
-        g_source_remove(handle);
-        
-        handle = g_timeout_add(interval, function, data);
-        
-        gtk_list_store_set(ctk_config->list_store, &iter,
-                           HANDLE_COLUMN, handle, -1);
+    /* Restart the timer period if it is already running */
+
+    if (timer_is_running(timer)) {
+        reset_timer(ctk_config, timer);
+        schedule_timers(ctk_config);
     }
 }
      
@@ -822,41 +1139,28 @@ static void timer_enable_toggled(GtkCellRendererToggle *cell,
     GtkTreeModel *model = GTK_TREE_MODEL(ctk_config->list_store);
     GtkTreePath *path;
     GtkTreeIter iter;
-    guint handle;
-    GSourceFunc function;
-    gpointer data;
-    TimerConfigProperty *timer_config;
-    gboolean owner_enabled;
+    CtkConfigTimer *timer;
     
     path = gtk_tree_path_new_from_string(path_string);
     gtk_tree_model_get_iter(model, &iter, path);
     gtk_tree_path_free(path);
 
-    gtk_tree_model_get(model, &iter,
-                       TIMER_CONFIG_COLUMN, &timer_config,
-                       OWNER_ENABLE_COLUMN, &owner_enabled,
-                       HANDLE_COLUMN, &handle,
-                       FUNCTION_COLUMN, &function,
-                       DATA_COLUMN, &data,
-                       -1);
+    gtk_tree_model_get(model, &iter, TIMER_COLUMN, &timer, -1);
 
-    timer_config->user_enabled ^= 1;
+    timer->config->user_enabled ^= 1;
 
     /* Start/stop the timer only when the owner widget has enabled it */
 
-    if (owner_enabled) {
-        if (timer_config->user_enabled) {
-            handle = g_timeout_add(timer_config->interval, function, data);
-            gtk_list_store_set(ctk_config->list_store, &iter,
-                               HANDLE_COLUMN, handle, -1);
-        } else {
-            g_source_remove(handle);
+    if (timer->owner_enabled) {
+        if (timer->config->user_enabled) {
+            reset_timer(ctk_config, timer);
         }
+        schedule_timers(ctk_config);
     }
 
     ctk_config_statusbar_message(ctk_config, "Timer \"%s\" %s.",
-                                 timer_config->description,
-                                 timer_config->user_enabled ? 
+                                 timer->config->description,
+                                 timer->config->user_enabled ? 
                                      "enabled" : "disabled");
 }
 
@@ -869,6 +1173,7 @@ void ctk_config_add_timer(CtkConfig *ctk_config,
     GtkTreeIter iter;
     ConfigProperties *conf = ctk_config->conf;
     TimerConfigProperty *timer_config;
+    CtkConfigTimer *timer;
 
     if (strchr(descr, '_') || strchr(descr, ','))
         return;
@@ -895,12 +1200,18 @@ void ctk_config_add_timer(CtkConfig *ctk_config,
 
     /* Timer defaults to user enabled/owner disabled */
 
+    timer = g_new0(CtkConfigTimer, 1);
+    timer->config = timer_config;
+    timer->function = function;
+    timer->data = data;
+    timer->owner_enabled = FALSE;
+    timer->backoff = 1;
+
+    ctk_config->timers = g_list_append(ctk_config->timers, timer);
+
     gtk_list_store_append(ctk_config->list_store, &iter);
     gtk_list_store_set(ctk_config->list_store, &iter,
-                       TIMER_CONFIG_COLUMN, timer_config,
-                       OWNER_ENABLE_COLUMN, FALSE,
-                       FUNCTION_COLUMN, function,
-                       DATA_COLUMN, data, -1);
+                       TIMER_COLUMN, timer, -1);
 
     /* make the timer list visible if it is not */
 
@@ -917,35 +1228,33 @@ void ctk_config_remove_timer(CtkConfig *ctk_config, GSourceFunc function)
 {
     GtkTreeModel *model;
     GtkTreeIter iter;
-    GSourceFunc func;
     gboolean valid;
-    guint handle;
-    TimerConfigProperty *timer_config;
-    gboolean owner_enabled;
+    CtkConfigTimer *timer;
     
     model = GTK_TREE_MODEL(ctk_config->list_store);
 
     valid = gtk_tree_model_get_iter_first(model, &iter);
     while (valid) {
-        gtk_tree_model_get(model, &iter,
-                           TIMER_CONFIG_COLUMN, &timer_config,
-                           FUNCTION_COLUMN, &func,
-                           OWNER_ENABLE_COLUMN, &owner_enabled,
-                           HANDLE_COLUMN, &handle, -1);
-        if (func == function) {
+        gtk_tree_model_get(model, &iter, TIMER_COLUMN, &timer, -1);
+        if (timer->function == function) {
 
-            /* Remove the timer if it was running */
-
-            if (timer_config->user_enabled && owner_enabled) {
-                g_source_remove(handle);
-            }
+            /*
+             * The timer is freed once it is safe to do so; this may be
+             * called from within the timer's own callback.
+             */
 
+            timer->removed = TRUE;
             gtk_list_store_remove(ctk_config->list_store, &iter);
             break;
         }
         valid = gtk_tree_model_iter_next(model, &iter);
     }
 
+    if (!ctk_config->timer_dispatching) {
+        free_removed_timers(ctk_config);
+        schedule_timers(ctk_config);
+    }
+
     /* if there are no more entries, hide the timer list */
 
     valid = gtk_tree_model_get_iter_first(model, &iter);
@@ -958,78 +1267,67 @@ void ctk_config_remove_timer(CtkConfig *ctk_config, GSourceFunc function)
 
 void ctk_config_start_timer(CtkConfig *ctk_config, GSourceFunc function, gpointer data)
 {
-    GtkTreeModel *model;
-    GtkTreeIter iter;
-    GSourceFunc func;
-    gboolean valid;
-    guint handle;
-    TimerConfigProperty *timer_config;
-    gboolean owner_enabled;
-    gpointer model_data;
+    CtkConfigTimer *timer = find_timer(ctk_config, function, data);
 
-    model = GTK_TREE_MODEL(ctk_config->list_store);
+    if (!timer) {
+        return;
+    }
 
-    valid = gtk_tree_model_get_iter_first(model, &iter);
-    while (valid) {
-        gtk_tree_model_get(model, &iter,
-                           TIMER_CONFIG_COLUMN, &timer_config,
-                           OWNER_ENABLE_COLUMN, &owner_enabled,
-                           HANDLE_COLUMN, &handle,
-                           FUNCTION_COLUMN, &func,
-                           DATA_COLUMN, &model_data,
-                           -1);
-        if ((func == function) && (model_data == data)) {
-
-            /* Start the timer if is enabled by the user and
-               it is not already running. */
-            
-            if (timer_config->user_enabled && !owner_enabled) {
-                handle = g_timeout_add(timer_config->interval, function, data);
-                gtk_list_store_set(ctk_config->list_store, &iter,
-                                   HANDLE_COLUMN, handle, -1);
-            }
-            gtk_list_store_set(ctk_config->list_store, &iter,
-                               OWNER_ENABLE_COLUMN, TRUE, -1);
-            break;
+    /* Start the timer if is enabled by the user and
+       it is not already running. */
+
+    if (!timer->owner_enabled) {
+        timer->owner_enabled = TRUE;
+        if (timer->config->user_enabled) {
+            reset_timer(ctk_config, timer);
+            schedule_timers(ctk_config);
         }
-        valid = gtk_tree_model_iter_next(model, &iter);
     }
 }
 
 void ctk_config_stop_timer(CtkConfig *ctk_config, GSourceFunc function, gpointer data)
 {
-    GtkTreeModel *model;
-    GtkTreeIter iter;
-    GSourceFunc func;
-    gboolean valid;
-    guint handle;
-    TimerConfigProperty *timer_config;
-    gboolean owner_enabled;
-    gpointer model_data;
+    CtkConfigTimer *timer = find_timer(ctk_config, function, data);
 
-    model = GTK_TREE_MODEL(ctk_config->list_store);
+    if (!timer) {
+        return;
+    }
 
-    valid = gtk_tree_model_get_iter_first(model, &iter);
-    while (valid) {
-        gtk_tree_model_get(model, &iter,
-                           TIMER_CONFIG_COLUMN, &timer_config,
-                           OWNER_ENABLE_COLUMN, &owner_enabled,
-                           HANDLE_COLUMN, &handle,
-                           FUNCTION_COLUMN, &func,
-                           DATA_COLUMN, &model_data,
-                           -1);
-        if ((func == function) && (model_data == data)) {
-
-            /* Remove the timer if was running. */
-
-            if (timer_config->user_enabled && owner_enabled) {
-                g_source_remove(handle);
-            }
-            gtk_list_store_set(ctk_config->list_store, &iter,
-                               OWNER_ENABLE_COLUMN, FALSE, -1);
-            break;
-        }
-        valid = gtk_tree_model_iter_next(model, &iter);
+    /* Remove the timer if was running. */
+
+    if (timer->owner_enabled) {
+        timer->owner_enabled = FALSE;
+        schedule_timers(ctk_config);
+    }
+}
+
+/*
+ * ctk_config_report_timer_result() - lets a timer callback tell the
+ * scheduler whether the values it polled changed since its previous run.
+ * After several unchanged polls in a row the timer's effective interval is
+ * backed off; the first change restores the configured interval.  Timers
+ * that never report keep polling at their configured interval.
+ */
+void ctk_config_report_timer_result(CtkConfig *ctk_config,
+                                    GSourceFunc function, gpointer data,
+                                    gboolean changed)
+{
+    CtkConfigTimer *timer = find_timer(ctk_config, function, data);
+
+    if (!timer) {
+        return;
+    }
+
+    if (changed) {
+        timer->unchanged = 0;
+        timer->backoff = 1;
+        return;
+    }
+
+    if (++timer->unchanged >= TIMER_BACKOFF_THRESHOLD &&
+        timer->backoff < TIMER_MAX_BACKOFF) {
+        timer->backoff *= 2;
+        timer->unchanged = 0;
     }
 }
 
@@ -91,6 +91,11 @@ struct _CtkConfig
     GtkWidget *button_save_rc;
     gchar *rc_filename;
     gboolean timer_list_visible;
+    GtkWidget *timer_view;
+    GList *timers;              /* CtkConfigTimer entries */
+    guint timer_source;         /* single GLib source driving all timers */
+    gboolean timer_dispatching;
+    GTimer *timer_clock;
     CtrlSystem *pCtrlSystem;
     GList *help_data;
 };
@@ -113,6 +118,8 @@ void ctk_config_remove_timer(CtkConfig *, GSourceFunc);
 
 void ctk_config_start_timer(CtkConfig *, GSourceFunc, gpointer);
 void ctk_config_stop_timer(CtkConfig *, GSourceFunc, gpointer);
+void ctk_config_report_timer_result(CtkConfig *, GSourceFunc, gpointer,
+                                    gboolean);
 
 gboolean ctk_config_slider_text_entry_shown(CtkConfig *);
 
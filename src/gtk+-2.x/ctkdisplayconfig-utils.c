@@ -4361,7 +4361,7 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
     if (filename && (stat(filename, &st) == 0)) {
         const char *non_regular_file_type_description =
             get_non_regular_file_type_description(st.st_mode);
-        const char *test_filename;
+        XConfigScanPtr scan;
 
         /* Make sure this is a regular file */
         if (non_regular_file_type_description) {
@@ -4377,16 +4377,16 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
         }
 
         /* Must be able to open the file */
-        test_filename = xconfigOpenConfigFile(filename, NULL);
-        if (!test_filename || strcmp(test_filename, filename)) {
-            xconfigCloseConfigFile();
+        scan = xconfigScanOpenFile(filename, NULL);
+        if (!scan || strcmp(xconfigScanGetFileName(scan), filename)) {
+            xconfigScanClose(scan);
 
         } else {
             GenerateOptions gop;
 
             /* Must be able to parse the file as an X config file */
-            xconfErr = xconfigReadConfigFile(&xconfCur);
-            xconfigCloseConfigFile();
+            xconfErr = xconfigScanReadConfig(scan, &xconfCur);
+            xconfigScanClose(scan);
             if ((xconfErr != XCONFIG_RETURN_SUCCESS) || !xconfCur) {
                 /* If we failed to parse the config file, we should not
                  * allow a merge.
@@ -4751,7 +4751,7 @@ SaveXConfDlg *create_save_xconfig_dialog(GtkWidget *parent,
     GtkWidget *hbox;
     GtkWidget *hbox2;
     gchar *filename;
-    const char *tmp_filename;
+    XConfigScanPtr scan;
 
     dlg = malloc(sizeof(SaveXConfDlg));
     if (!dlg) return NULL;
@@ -4762,13 +4762,13 @@ SaveXConfDlg *create_save_xconfig_dialog(GtkWidget *parent,
     dlg->callback_data = callback_data;
 
     /* Setup the default filename */
-    tmp_filename = xconfigOpenConfigFile(NULL, NULL);
-    if (tmp_filename) {
-        filename = g_strdup(tmp_filename);
+    scan = xconfigScanOpenFile(NULL, NULL);
+    if (scan) {
+        filename = g_strdup(xconfigScanGetFileName(scan));
     } else {
         filename = g_strdup("");
     }
-    xconfigCloseConfigFile();
+    xconfigScanClose(scan);
 
     if (!filename) {
         free(dlg);
@@ -49,8 +49,6 @@ static gboolean ctk_event_dispatch(GSource *, GSourceFunc, gpointer);
 /* List of who to contact on dpy events */
 typedef struct __CtkEventNodeRec {
     CtkEvent *ctk_event;
-    int target_type;
-    int target_id;
     struct __CtkEventNodeRec *next;
 } CtkEventNode;
 
@@ -60,17 +58,76 @@ typedef struct __CtkEventSourceRec {
     NvCtrlEventHandle *event_handle;
     GPollFD event_poll_fd;
 
-    CtkEventNode *ctk_events;
-    struct __CtkEventSourceRec *next;
+    /*
+     * The CtkEvents to contact, indexed by target so that each event only
+     * visits the CtkEvents of its own target: maps CTK_EVENT_TARGET_KEY()
+     * to a list of CtkEventNodes.
+     */
+    GHashTable *receivers;
+    int num_receivers;
+
+    /*
+     * Events read from the event handle but not yet emitted, in order of
+     * their latest arrival, and indexed by coalesce_key(); they are
+     * emitted when the flush timeout fires.  Slots vacated by coalesced
+     * events are NULL.
+     */
+    GPtrArray *pending;
+    GHashTable *pending_index;
+    guint flush_timeout;
+
+    /* Fires once no events have been emitted for CTK_EVENT_SETTLE_TIME */
+    guint settle_timeout;
 } CtkEventSource;
 
+/* An event held for coalescing */
+typedef struct {
+    gint64 key;
+    guint index;                /* slot in CtkEventSource::pending */
+    CtrlEvent event;
+} CtkEventPending;
+
+/*
+ * Milliseconds without new events before the CTK_EVENT_SETTLED signal is
+ * emitted on the CtkEvents that received events.
+ */
+#define CTK_EVENT_SETTLE_TIME 250
+
+/*
+ * NV-CONTROL target ids are 16 bits wide on the wire, so the target type
+ * and id fit together in one hash key.
+ */
+#define CTK_EVENT_TARGET_KEY(target_type, target_id)           \
+    GUINT_TO_POINTER(((guint) (target_type) << 16) |           \
+                     ((guint) (target_id) & 0xFFFF))
+
 static guint binary_signals[NV_CTRL_BINARY_DATA_LAST_ATTRIBUTE + 1];
 static guint string_signals[NV_CTRL_STRING_LAST_ATTRIBUTE + 1];
 static guint signals[NV_CTRL_LAST_ATTRIBUTE + 1];
 static guint signal_RRScreenChangeNotify;
+static guint signal_settled;
+
+/*
+ * How long (in milliseconds) events are held so that repeated events
+ * for the same target and attribute are emitted only once, with the
+ * latest value.  0 emits every event as soon as it is read.
+ */
+static guint coalescing_window = 0;
 
-/* List of event sources to track (one per dpy) */
-CtkEventSource *event_sources = NULL;
+/* Event sources to track (one per dpy), indexed by event handle */
+static GHashTable *event_sources = NULL;
+
+/* A page's interest in the value of one integer attribute */
+struct _CtkEventSubscription {
+    CtkEvent *ctk_event;
+    int attrib;
+
+    gboolean valid;             /* whether 'value' was delivered */
+    int value;
+
+    CtkEventSubscriptionFunc func;
+    gpointer user_data;
+};
 
 
 
@@ -459,6 +516,13 @@ static void ctk_event_class_init(CtkEventClass *ctk_event_class)
                      g_cclosure_marshal_VOID__POINTER,
                      G_TYPE_NONE, 1, G_TYPE_POINTER);
 
+    /* Emitted once a burst of events for the target is over */
+    signal_settled =
+        g_signal_new("CTK_EVENT_SETTLED",
+                     G_OBJECT_CLASS_TYPE(ctk_event_class),
+                     G_SIGNAL_RUN_LAST, 0, NULL, NULL,
+                     g_cclosure_marshal_VOID__VOID,
+                     G_TYPE_NONE, 0);
 
 } /* ctk_event_class_init */
 
@@ -466,14 +530,36 @@ static void ctk_event_class_init(CtkEventClass *ctk_event_class)
 
 static CtkEventSource* find_event_source(NvCtrlEventHandle *event_handle)
 {
-    CtkEventSource *event_source = event_sources;
-    while (event_source) {
-        if (event_source->event_handle == event_handle) {
-            break;
-        }
-        event_source = event_source->next;
+    if (!event_sources) {
+        return NULL;
     }
-    return event_source;
+    return g_hash_table_lookup(event_sources, event_handle);
+}
+
+
+
+/* Returns the list of CtkEvents registered for the given target */
+static CtkEventNode *find_event_receivers(CtkEventSource *event_source,
+                                          int target_type, int target_id)
+{
+    /* the source may have been destroyed by a signal handler */
+    if (!event_source->receivers) {
+        return NULL;
+    }
+    return g_hash_table_lookup(event_source->receivers,
+                               CTK_EVENT_TARGET_KEY(target_type, target_id));
+}
+
+
+
+static void free_pending_events(GPtrArray *pending)
+{
+    guint i;
+
+    for (i = 0; i < pending->len; i++) {
+        g_free(g_ptr_array_index(pending, i));
+    }
+    g_ptr_array_free(pending, TRUE);
 }
 
 
@@ -496,6 +582,7 @@ static void ctk_event_register_source(CtkEvent *ctk_event)
     NvCtrlEventHandle *event_handle = NvCtrlGetEventHandle(ctrl_target);
     CtkEventSource *event_source;
     CtkEventNode *event_node;
+    gpointer key;
 
     if (!event_handle) {
         return;
@@ -528,30 +615,44 @@ static void ctk_event_register_source(CtkEvent *ctk_event)
         event_source->event_handle = event_handle;
         event_source->event_poll_fd.fd = event_fd;
         event_source->event_poll_fd.events = G_IO_IN;
+        event_source->receivers = g_hash_table_new(g_direct_hash,
+                                                   g_direct_equal);
+        event_source->num_receivers = 0;
+        event_source->pending = g_ptr_array_new();
+        event_source->pending_index = g_hash_table_new(g_int64_hash,
+                                                       g_int64_equal);
+        event_source->flush_timeout = 0;
+        event_source->settle_timeout = 0;
         
         /* add the input source to the glib main loop */
         
         g_source_add_poll(source, &event_source->event_poll_fd);
         g_source_attach(source, NULL);
 
-        /* add the source to the global list of sources */
+        /* add the source to the global table of sources */
 
-        event_source->next = event_sources;
-        event_sources = event_source;
+        if (!event_sources) {
+            event_sources = g_hash_table_new(g_direct_hash, g_direct_equal);
+        }
+        g_hash_table_insert(event_sources, event_handle, event_source);
     }
 
 
-    /* Add the ctk_event object to the source's list of event objects */
+    /* Add the ctk_event object to its target's list of event objects */
 
     event_node = (CtkEventNode *)g_malloc(sizeof(CtkEventNode));
     if (!event_node) {
         return;
     }
+
+    key = CTK_EVENT_TARGET_KEY(NvCtrlGetTargetType(ctrl_target),
+                               NvCtrlGetTargetId(ctrl_target));
+
     event_node->ctk_event = ctk_event;
-    event_node->target_type = NvCtrlGetTargetType(ctrl_target);
-    event_node->target_id = NvCtrlGetTargetId(ctrl_target);
-    event_node->next = event_source->ctk_events;
-    event_source->ctk_events = event_node;
+    event_node->next = g_hash_table_lookup(event_source->receivers, key);
+    g_hash_table_insert(event_source->receivers, key, event_node);
+    event_source->num_receivers++;
+    ctk_event->registered = TRUE;
 
 } /* ctk_event_register_source() */
 
@@ -567,7 +668,8 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
     CtrlTarget *ctrl_target = ctk_event->ctrl_target;
     NvCtrlEventHandle *event_handle = NvCtrlGetEventHandle(ctrl_target);
     CtkEventSource *event_source;
-    CtkEventNode *event_node;
+    CtkEventNode *event_node, *prev = NULL;
+    gpointer key;
 
     if (!event_handle) {
         return;
@@ -581,22 +683,16 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
     }
 
 
-    /* Remove the ctk_event object from the source's list of event objects */
+    /* Remove the ctk_event object from its target's list of event objects */
 
-    event_node = event_source->ctk_events;
-    if (event_node->ctk_event == ctk_event) {
-        event_source->ctk_events = event_node->next;
-    }
-    else {
-        CtkEventNode *prev = event_node;
-        event_node = event_node->next;
-        while (event_node) {
-            if (event_node->ctk_event == ctk_event) {
-                prev->next = event_node->next;
-                break;
-            }
-            prev = event_node;
-            event_node = event_node->next;
+    key = CTK_EVENT_TARGET_KEY(NvCtrlGetTargetType(ctrl_target),
+                               NvCtrlGetTargetId(ctrl_target));
+
+    for (event_node = g_hash_table_lookup(event_source->receivers, key);
+         event_node;
+         prev = event_node, event_node = event_node->next) {
+        if (event_node->ctk_event == ctk_event) {
+            break;
         }
     }
 
@@ -604,26 +700,40 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
         return;
     }
 
+    if (prev) {
+        prev->next = event_node->next;
+    } else if (event_node->next) {
+        g_hash_table_insert(event_source->receivers, key, event_node->next);
+    } else {
+        g_hash_table_remove(event_source->receivers, key);
+    }
+
     g_free(event_node);
+    event_source->num_receivers--;
+    ctk_event->registered = FALSE;
 
 
     /* destroy the event source if empty */
 
-    if (event_source->ctk_events == NULL) {
+    if (event_source->num_receivers == 0) {
         GSource *source = (GSource *)event_source;
 
-        if (event_sources == event_source) {
-            event_sources = event_source->next;
+        g_hash_table_remove(event_sources, event_handle);
+        g_hash_table_destroy(event_source->receivers);
+        event_source->receivers = NULL;
+
+        if (event_source->flush_timeout) {
+            g_source_remove(event_source->flush_timeout);
+            event_source->flush_timeout = 0;
         }
-        else {
-            CtkEventSource *cur;
-            for (cur = event_sources; cur; cur = cur->next) {
-                if (cur->next == event_source) {
-                    cur->next = event_source->next;
-                    break;
-                }
-            }
+        if (event_source->settle_timeout) {
+            g_source_remove(event_source->settle_timeout);
+            event_source->settle_timeout = 0;
         }
+        free_pending_events(event_source->pending);
+        event_source->pending = NULL;
+        g_hash_table_destroy(event_source->pending_index);
+        event_source->pending_index = NULL;
 
         NvCtrlCloseEventHandle(event_source->event_handle);
         g_source_remove_poll(source, &(event_source->event_poll_fd));
@@ -670,6 +780,10 @@ void ctk_event_destroy(GObject *object)
 
     ctk_event_unregister_source(ctk_event);
 
+    while (ctk_event->subscriptions) {
+        ctk_event_unsubscribe(ctk_event->subscriptions->data);
+    }
+
     /* Unref the CtkEvent object */
 
     g_object_unref(object);
@@ -718,110 +832,402 @@ static gboolean ctk_event_check(GSource *source)
 
 
 
-#define CTK_EVENT_BROADCAST(ES, SIG, CEVT)             \
-do {                                                   \
-    CtkEventNode *e = (ES)->ctk_events;                \
-    while  (e) {                                       \
-        if (e->target_type == (CEVT)->target_type &&   \
-            e->target_id == (CEVT)->target_id) {       \
-            g_signal_emit(e->ctk_event, SIG, 0, CEVT); \
-        }                                              \
-        e = e->next;                                   \
-    }                                                  \
+/*
+ * Returns the CtkEvents of the event's target, in order, each with a
+ * reference held.  Signal handlers and subscribers may destroy CtkEvents,
+ * which unlinks and frees their CtkEventNodes (and, with the last of them,
+ * the source), so dispatch walks this snapshot rather than the list, and
+ * skips the CtkEvents that were unregistered since it was taken.
+ */
+static GSList *ref_event_receivers(CtkEventSource *event_source,
+                                   const CtrlEvent *event)
+{
+    GSList *receivers = NULL;
+    CtkEventNode *e;
+
+    for (e = find_event_receivers(event_source, event->target_type,
+                                  event->target_id);
+         e; e = e->next) {
+        receivers = g_slist_prepend(receivers, g_object_ref(e->ctk_event));
+    }
+
+    return g_slist_reverse(receivers);
+}
+
+static void unref_event_receivers(GSList *receivers)
+{
+    g_slist_foreach(receivers, (GFunc) g_object_unref, NULL);
+    g_slist_free(receivers);
+}
+
+#define CTK_EVENT_BROADCAST(ES, SIG, CEVT)                        \
+do {                                                              \
+    GSList *receivers = ref_event_receivers((ES), (CEVT));        \
+    GSList *l;                                                    \
+    for (l = receivers; l; l = l->next) {                         \
+        if (CTK_EVENT(l->data)->registered) {                     \
+            g_signal_emit(l->data, SIG, 0, CEVT);                 \
+        }                                                         \
+    }                                                             \
+    unref_event_receivers(receivers);                             \
 } while (0)
 
-static gboolean ctk_event_dispatch(GSource *source,
-                                   GSourceFunc callback,
-                                   gpointer user_data)
+/*
+ * Give a new value of an integer attribute to the subscribers of the given
+ * CtkEvent; subscribers only hear about values that differ from the last
+ * one they were given.
+ */
+static void ctk_event_deliver(CtkEvent *ctk_event, int attrib, int value)
 {
-    ReturnStatus status;
-    CtrlEvent event;
-    CtkEventSource *event_source = (CtkEventSource *) source;
+    GSList *l;
 
-    /*
-     * if ctk_event_dispatch() is called, then either
-     * ctk_event_prepare() or ctk_event_check() returned TRUE, so we
-     * know there is an event pending
-     */
-    status = NvCtrlEventHandleNextEvent(event_source->event_handle, &event);
-    if (status != NvCtrlSuccess) {
-        return FALSE;
+    for (l = ctk_event->subscriptions; l; l = l->next) {
+        CtkEventSubscription *subscription = l->data;
+
+        if (subscription->attrib != attrib ||
+            (subscription->valid && subscription->value == value)) {
+            continue;
+        }
+
+        subscription->valid = TRUE;
+        subscription->value = value;
+        subscription->func(subscription, value, subscription->user_data);
+    }
+}
+
+static void ctk_event_deliver_all(CtkEventSource *event_source,
+                                  const CtrlEvent *event)
+{
+    GSList *receivers = ref_event_receivers(event_source, event);
+    GSList *l;
+
+    for (l = receivers; l; l = l->next) {
+        CtkEvent *ctk_event = l->data;
+
+        if (ctk_event->registered && ctk_event->subscriptions) {
+            ctk_event_deliver(ctk_event, event->int_attr.attribute,
+                              event->int_attr.value);
+        }
     }
 
-    if (event.type != CTRL_EVENT_TYPE_UNKNOWN) {
+    unref_event_receivers(receivers);
+}
+
+/* Mark the CtkEvents of the event's target as having received events */
+static void ctk_event_unsettle(CtkEventSource *event_source,
+                               const CtrlEvent *event)
+{
+    CtkEventNode *e;
+
+    for (e = find_event_receivers(event_source, event->target_type,
+                                  event->target_id);
+         e; e = e->next) {
+        e->ctk_event->unsettled = TRUE;
+    }
+}
+
+/*
+ * ctk_event_handle() - Emit the signal(s) for one event to the CtkEvent
+ * objects of the event's target.
+ */
+static void ctk_event_handle(CtkEventSource *event_source,
+                             const CtrlEvent *event)
+{
+    if (event->type != CTRL_EVENT_TYPE_UNKNOWN) {
+
+        ctk_event_unsettle(event_source, event);
 
         /* 
          * Handle the CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE event
          */
-        if (event.type == CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE) {
+        if (event->type == CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE) {
 
             /* make sure the attribute is in our signal array */
-            if ((event.int_attr.attribute <= NV_CTRL_LAST_ATTRIBUTE) &&
-                (signals[event.int_attr.attribute] != 0)) {
+            if ((event->int_attr.attribute <= NV_CTRL_LAST_ATTRIBUTE) &&
+                (signals[event->int_attr.attribute] != 0)) {
 
                 /*
                  * XXX Is emitting a signal with g_signal_emit() really
                  * the "correct" way of dispatching the event?
                  */
                 CTK_EVENT_BROADCAST(event_source,
-                                    signals[event.int_attr.attribute],
-                                    &event);
+                                    signals[event->int_attr.attribute],
+                                    event);
             }
+
+            ctk_event_deliver_all(event_source, event);
         }
         
         /* 
          * Handle the CTRL_EVENT_TYPE_STRING_ATTRIBUTE event
          */
-        else if (event.type == CTRL_EVENT_TYPE_STRING_ATTRIBUTE) {
+        else if (event->type == CTRL_EVENT_TYPE_STRING_ATTRIBUTE) {
 
             /* make sure the attribute is in our string signal array */
 
-            if ((event.str_attr.attribute <= NV_CTRL_STRING_LAST_ATTRIBUTE) &&
-                (string_signals[event.str_attr.attribute] != 0)) {
+            if ((event->str_attr.attribute <= NV_CTRL_STRING_LAST_ATTRIBUTE) &&
+                (string_signals[event->str_attr.attribute] != 0)) {
 
                 /*
                  * XXX Is emitting a signal with g_signal_emit() really
                  * the "correct" way of dispatching the event
                  */
                 CTK_EVENT_BROADCAST(event_source,
-                                    string_signals[event.str_attr.attribute],
-                                    &event);
+                                    string_signals[event->str_attr.attribute],
+                                    event);
             }
         }
 
         /*
          * Handle the CTRL_EVENT_TYPE_BINARY_ATTRIBUTE event
          */
-        else if (event.type == CTRL_EVENT_TYPE_BINARY_ATTRIBUTE) {
+        else if (event->type == CTRL_EVENT_TYPE_BINARY_ATTRIBUTE) {
 
             /* make sure the attribute is in our binary signal array */
-            if ((event.bin_attr.attribute <= NV_CTRL_BINARY_DATA_LAST_ATTRIBUTE) &&
-                (binary_signals[event.bin_attr.attribute] != 0)) {
+            if ((event->bin_attr.attribute <= NV_CTRL_BINARY_DATA_LAST_ATTRIBUTE) &&
+                (binary_signals[event->bin_attr.attribute] != 0)) {
 
                 /*
                  * XXX Is emitting a signal with g_signal_emit() really
                  * the "correct" way of dispatching the event
                  */
                 CTK_EVENT_BROADCAST(event_source,
-                                    binary_signals[event.bin_attr.attribute],
-                                    &event);
+                                    binary_signals[event->bin_attr.attribute],
+                                    event);
             }
         }
 
         /*
          * Handle the CTRL_EVENT_TYPE_SCREEN_CHANGE event
          */
-        else if (event.type == CTRL_EVENT_TYPE_SCREEN_CHANGE) {
+        else if (event->type == CTRL_EVENT_TYPE_SCREEN_CHANGE) {
 
             /* make sure the target_id is valid */
-            if (event.target_id >= 0) {
+            if (event->target_id >= 0) {
                 CTK_EVENT_BROADCAST(event_source,
                                     signal_RRScreenChangeNotify,
-                                    &event);
+                                    event);
             }
         }
     }
-    
+}
+
+
+
+/*
+ * Collects the CtkEvents of one target that received events since the
+ * last CTK_EVENT_SETTLED signal.
+ */
+static void collect_unsettled(gpointer key, gpointer value, gpointer data)
+{
+    GSList **unsettled = data;
+    CtkEventNode *e;
+
+    for (e = value; e; e = e->next) {
+        if (e->ctk_event->unsettled) {
+            e->ctk_event->unsettled = FALSE;
+            *unsettled = g_slist_prepend(*unsettled,
+                                         g_object_ref(e->ctk_event));
+        }
+    }
+}
+
+static gboolean settle_timeout_cb(gpointer data)
+{
+    CtkEventSource *event_source = data;
+    GSList *unsettled = NULL, *l;
+
+    event_source->settle_timeout = 0;
+
+    /*
+     * Hold a reference on each CtkEvent, as the signal handlers may
+     * destroy CtkEvents (and this source along with the last of them).
+     */
+    g_hash_table_foreach(event_source->receivers, collect_unsettled,
+                         &unsettled);
+
+    for (l = unsettled; l; l = l->next) {
+        if (CTK_EVENT(l->data)->registered) {
+            g_signal_emit(l->data, signal_settled, 0);
+        }
+    }
+    unref_event_receivers(unsettled);
+
+    return FALSE;
+}
+
+/*
+ * (Re)start the countdown to the CTK_EVENT_SETTLED signal, so that it is
+ * only emitted once events stop arriving.
+ */
+static void ctk_event_settle_later(CtkEventSource *event_source)
+{
+    if (event_source->settle_timeout) {
+        g_source_remove(event_source->settle_timeout);
+    }
+    event_source->settle_timeout =
+        g_timeout_add(CTK_EVENT_SETTLE_TIME, settle_timeout_cb, event_source);
+}
+
+
+
+/*
+ * coalesce_key() - Returns the key under which an event is held for
+ * coalescing: events with the same type, target and attribute replace
+ * each other.  Availability changes are not merged with value changes.
+ */
+static gint64 coalesce_key(const CtrlEvent *event)
+{
+    guint64 attribute = 0;
+    guint64 availability = 0;
+
+    switch (event->type) {
+    case CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE:
+        attribute = (guint32) event->int_attr.attribute;
+        availability = event->int_attr.is_availability_changed ? 1 : 0;
+        break;
+    case CTRL_EVENT_TYPE_STRING_ATTRIBUTE:
+        attribute = (guint32) event->str_attr.attribute;
+        break;
+    case CTRL_EVENT_TYPE_BINARY_ATTRIBUTE:
+        attribute = (guint32) event->bin_attr.attribute;
+        break;
+    default:
+        break;
+    }
+
+    return (gint64) (((guint64) event->type << 57) |
+                     (availability << 56) |
+                     ((guint64) (event->target_type & 0xFF) << 48) |
+                     ((guint64) (event->target_id & 0xFFFF) << 32) |
+                     attribute);
+}
+
+static gboolean flush_timeout_cb(gpointer data)
+{
+    CtkEventSource *event_source = data;
+    GSource *source = (GSource *) event_source;
+    GPtrArray *pending = event_source->pending;
+    guint i;
+
+    event_source->flush_timeout = 0;
+
+    /*
+     * Take the pending events for ourselves; the signal handlers may
+     * destroy the source, and with it anything still attached to it.
+     */
+    event_source->pending = g_ptr_array_new();
+    g_hash_table_remove_all(event_source->pending_index);
+
+    g_source_ref(source);
+
+    for (i = 0; i < pending->len; i++) {
+        CtkEventPending *p = g_ptr_array_index(pending, i);
+
+        if (!p) {
+            continue;
+        }
+
+        ctk_event_handle(event_source, &p->event);
+
+        if (g_source_is_destroyed(source)) {
+            break;
+        }
+    }
+
+    if (!g_source_is_destroyed(source)) {
+        ctk_event_settle_later(event_source);
+    }
+
+    free_pending_events(pending);
+    g_source_unref(source);
+
+    return FALSE;
+}
+
+/*
+ * ctk_event_queue() - Hold an event until the coalescing window ends.  An
+ * event that is already pending for the same target and attribute takes
+ * the new event's value and moves to the end of the queue, so that events
+ * are emitted in the order their latest values arrived.
+ */
+static void ctk_event_queue(CtkEventSource *event_source,
+                            const CtrlEvent *event)
+{
+    CtkEventPending *p;
+    gint64 key;
+
+    if (event->type == CTRL_EVENT_TYPE_UNKNOWN) {
+        return;
+    }
+
+    key = coalesce_key(event);
+
+    p = g_hash_table_lookup(event_source->pending_index, &key);
+    if (p) {
+        g_ptr_array_index(event_source->pending, p->index) = NULL;
+    } else {
+        p = g_new(CtkEventPending, 1);
+        p->key = key;
+        g_hash_table_insert(event_source->pending_index, &p->key, p);
+    }
+
+    p->event = *event;
+    p->index = event_source->pending->len;
+    g_ptr_array_add(event_source->pending, p);
+
+    if (!event_source->flush_timeout) {
+        event_source->flush_timeout =
+            g_timeout_add(coalescing_window, flush_timeout_cb, event_source);
+    }
+}
+
+
+
+static gboolean ctk_event_dispatch(GSource *source,
+                                   GSourceFunc callback,
+                                   gpointer user_data)
+{
+    ReturnStatus status;
+    CtrlEvent event;
+    Bool pending;
+    CtkEventSource *event_source = (CtkEventSource *) source;
+
+    /*
+     * if ctk_event_dispatch() is called, then either
+     * ctk_event_prepare() or ctk_event_check() returned TRUE, so we
+     * know there is an event pending.  Handle every pending event
+     * now rather than going back through the main loop for each one.
+     */
+    do {
+        status = NvCtrlEventHandleNextEvent(event_source->event_handle,
+                                            &event);
+        if (status != NvCtrlSuccess) {
+            return FALSE;
+        }
+
+        if (coalescing_window) {
+            ctk_event_queue(event_source, &event);
+        } else {
+            ctk_event_handle(event_source, &event);
+
+            /*
+             * a signal handler may have destroyed the last CtkEvent of
+             * this source, and with it the source and its event handle
+             */
+            if (g_source_is_destroyed(source)) {
+                return FALSE;
+            }
+        }
+
+        status = NvCtrlEventHandlePending(event_source->event_handle,
+                                          &pending);
+    } while (status == NvCtrlSuccess && pending);
+
+    if (!coalescing_window) {
+        ctk_event_settle_later(event_source);
+    }
+
     return TRUE;
 
 } /* ctk_event_dispatch() */
@@ -847,13 +1253,7 @@ void ctk_event_emit(CtkEvent *ctk_event,
 
 
     /* Find the event source */
-    source = event_sources;
-    while (source) {
-        if (source->event_handle == event_handle) {
-            break;
-        }
-        source = source->next;
-    }
+    source = find_event_source(event_handle);
     if (!source) return;
 
 
@@ -867,7 +1267,18 @@ void ctk_event_emit(CtkEvent *ctk_event,
     event.int_attr.attribute = attrib;
     event.int_attr.value     = value;
 
+    g_source_ref((GSource *) source);
+
+    ctk_event_unsettle(source, &event);
+
     CTK_EVENT_BROADCAST(source, signals[attrib], &event);
+    ctk_event_deliver_all(source, &event);
+
+    if (!g_source_is_destroyed((GSource *) source)) {
+        ctk_event_settle_later(source);
+    }
+
+    g_source_unref((GSource *) source);
 
 } /* ctk_event_emit() */
 
@@ -891,13 +1302,7 @@ void ctk_event_emit_string(CtkEvent *ctk_event,
 
 
     /* Find the event source */
-    source = event_sources;
-    while (source) {
-        if (source->event_handle == event_handle) {
-            break;
-        }
-        source = source->next;
-    }
+    source = find_event_source(event_handle);
     if (!source) return;
 
 
@@ -914,3 +1319,136 @@ void ctk_event_emit_string(CtkEvent *ctk_event,
 
 } /* ctk_event_emit_string() */
 
+
+
+/*
+ * ctk_event_set_coalescing_window() - Sets how long (in milliseconds)
+ * NV-CONTROL events are held before being emitted; repeated events for
+ * the same target and attribute within that time are emitted once, with
+ * the latest value.  0 emits each event as soon as it is received.
+ * Events emitted with ctk_event_emit() are never held, but do count
+ * towards CTK_EVENT_SETTLED.
+ */
+void ctk_event_set_coalescing_window(guint milliseconds)
+{
+    coalescing_window = milliseconds;
+
+} /* ctk_event_set_coalescing_window() */
+
+
+
+
+/*
+ * ctk_event_subscribe() - Registers interest in the value of an integer
+ * attribute of the CtkEvent's target.  'func' is called with each new value
+ * of the attribute, whether it comes from an NV-CONTROL event, from
+ * ctk_event_emit() or from ctk_event_subscription_poll(); repeated values
+ * are filtered out, so subscribers only see changes.  Subscriptions must not
+ * be removed from within 'func'.
+ */
+CtkEventSubscription *ctk_event_subscribe(CtkEvent *ctk_event, int attrib,
+                                          CtkEventSubscriptionFunc func,
+                                          gpointer user_data)
+{
+    CtkEventSubscription *subscription;
+
+    if (!ctk_event || !func) {
+        return NULL;
+    }
+
+    subscription = g_new0(CtkEventSubscription, 1);
+    subscription->ctk_event = ctk_event;
+    subscription->attrib = attrib;
+    subscription->func = func;
+    subscription->user_data = user_data;
+
+    ctk_event->subscriptions =
+        g_slist_prepend(ctk_event->subscriptions, subscription);
+
+    return subscription;
+
+} /* ctk_event_subscribe() */
+
+
+
+void ctk_event_unsubscribe(CtkEventSubscription *subscription)
+{
+    CtkEvent *ctk_event;
+
+    if (!subscription) {
+        return;
+    }
+
+    ctk_event = subscription->ctk_event;
+    ctk_event->subscriptions =
+        g_slist_remove(ctk_event->subscriptions, subscription);
+    g_free(subscription);
+
+} /* ctk_event_unsubscribe() */
+
+
+
+/*
+ * ctk_event_subscription_poll() - Queries the subscribed attribute, for
+ * attributes that the driver does not send events for, and calls the
+ * subscriber if the value changed.  If the query fails, the last value is
+ * forgotten so that the next successful query is delivered.
+ */
+ReturnStatus ctk_event_subscription_poll(CtkEventSubscription *subscription,
+                                         gboolean *changed)
+{
+    ReturnStatus ret;
+    int value;
+
+    if (changed) {
+        *changed = FALSE;
+    }
+
+    if (!subscription) {
+        return NvCtrlBadHandle;
+    }
+
+    ret = NvCtrlGetAttribute(subscription->ctk_event->ctrl_target,
+                             subscription->attrib, &value);
+    if (ret != NvCtrlSuccess) {
+        subscription->valid = FALSE;
+        return ret;
+    }
+
+    if (subscription->valid && subscription->value == value) {
+        return NvCtrlSuccess;
+    }
+
+    subscription->valid = TRUE;
+    subscription->value = value;
+
+    if (changed) {
+        *changed = TRUE;
+    }
+
+    subscription->func(subscription, value, subscription->user_data);
+
+    return NvCtrlSuccess;
+
+} /* ctk_event_subscription_poll() */
+
+
+
+/*
+ * ctk_event_subscription_get_value() - Returns the last value delivered to
+ * the subscriber in 'value'; returns FALSE if there is none.
+ */
+gboolean ctk_event_subscription_get_value(CtkEventSubscription *subscription,
+                                          int *value)
+{
+    if (!subscription || !subscription->valid) {
+        return FALSE;
+    }
+
+    if (value) {
+        *value = subscription->value;
+    }
+
+    return TRUE;
+
+} /* ctk_event_subscription_get_value() */
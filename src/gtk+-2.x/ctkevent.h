@@ -44,13 +44,29 @@ G_BEGIN_DECLS
     (G_TYPE_INSTANCE_GET_CLASS ((obj), CTK_TYPE_EVENT, CtkEventClass))
 
 
-typedef struct _CtkEvent       CtkEvent;
-typedef struct _CtkEventClass  CtkEventClass;
+typedef struct _CtkEvent              CtkEvent;
+typedef struct _CtkEventClass         CtkEventClass;
+typedef struct _CtkEventSubscription  CtkEventSubscription;
+
+/*
+ * Called with the new value of a subscribed integer attribute, whenever
+ * it differs from the last value given to the subscriber.
+ */
+typedef void (*CtkEventSubscriptionFunc)(CtkEventSubscription *subscription,
+                                         int value, gpointer user_data);
 
 struct _CtkEvent
 {
     GObject     parent;
     CtrlTarget *ctrl_target;
+
+    GSList     *subscriptions;
+
+    /* events were received since CTK_EVENT_SETTLED was last emitted */
+    gboolean    unsettled;
+
+    /* registered with an event source; cleared by ctk_event_destroy() */
+    gboolean    registered;
 };
 
 struct _CtkEventClass
@@ -67,6 +83,17 @@ void ctk_event_emit(CtkEvent *ctk_event,
 void ctk_event_emit_string(CtkEvent *ctk_event,
                     unsigned int mask, int attrib);
 
+void ctk_event_set_coalescing_window(guint milliseconds);
+
+CtkEventSubscription *ctk_event_subscribe(CtkEvent *ctk_event, int attrib,
+                                          CtkEventSubscriptionFunc func,
+                                          gpointer user_data);
+void ctk_event_unsubscribe(CtkEventSubscription *subscription);
+ReturnStatus ctk_event_subscription_poll(CtkEventSubscription *subscription,
+                                         gboolean *changed);
+gboolean ctk_event_subscription_get_value(CtkEventSubscription *subscription,
+                                          int *value);
+
 #define CTK_EVENT_NAME(x) ("CTK_EVENT_" #x)
 
 
@@ -428,6 +428,10 @@ GtkWidget* ctk_gpu_new(CtrlTarget *ctrl_target,
     ctk_gpu->ctk_event = ctk_event;
     ctk_gpu->pcie_gen_queriable = FALSE;
     ctk_gpu->gpu_memory = gpu_memory;
+    ctk_gpu->last_memory_used = -1;
+    ctk_gpu->last_graphics_utilization = -1;
+    ctk_gpu->last_video_utilization = -1;
+    ctk_gpu->last_pcie_utilization = -1;
 
     /* set container properties of the object */
 
@@ -781,6 +785,7 @@ static gboolean update_gpu_usage(gpointer user_data)
     gint value = 0;
     utilizationEntry entry;
     CtrlTarget *ctrl_target;
+    gboolean changed;
 
     ctk_gpu = CTK_GPU(user_data);
     ctrl_target = ctk_gpu->ctrl_target;
@@ -789,8 +794,9 @@ static gboolean update_gpu_usage(gpointer user_data)
                              &value);
     if (ret != NvCtrlSuccess || value > ctk_gpu->gpu_memory || value < 0) {
         gtk_label_set_text(GTK_LABEL(ctk_gpu->gpu_memory_used_label), "Unknown");
+        ctk_gpu->last_memory_used = -1;
         return FALSE;
-    } else {
+    } else if (value != ctk_gpu->last_memory_used) {
         if (ctk_gpu->gpu_memory > 0) {
             memory_text = g_strdup_printf("%d MB (%.0f%%)", 
                                           value, 
@@ -804,7 +810,10 @@ static gboolean update_gpu_usage(gpointer user_data)
         g_free(memory_text);
     }
 
-    /* GPU utilization */
+    /*
+     * GPU utilization; NV-CONTROL sends no events for it, so it is polled,
+     * and only the labels whose values changed are updated
+     */
     ret = NvCtrlGetStringAttribute(ctrl_target,
                                    NV_CTRL_STRING_GPU_UTILIZATION,
                                    &utilizationStr);
@@ -821,6 +830,9 @@ static gboolean update_gpu_usage(gpointer user_data)
             gtk_label_set_text(GTK_LABEL(ctk_gpu->pcie_utilization_label),
                                "Unknown");
         }
+        ctk_gpu->last_graphics_utilization = -1;
+        ctk_gpu->last_video_utilization = -1;
+        ctk_gpu->last_pcie_utilization = -1;
         return FALSE;
     }
 
@@ -828,6 +840,7 @@ static gboolean update_gpu_usage(gpointer user_data)
     parse_token_value_pairs(utilizationStr, apply_gpu_utilization_token,
                             &entry);
     if ((entry.graphics_specified) &&
+        (entry.graphics != ctk_gpu->last_graphics_utilization) &&
         (ctk_gpu->gpu_utilization_label)) {
         utilization_text = g_strdup_printf("%d %%",
                                            entry.graphics);
@@ -837,6 +850,7 @@ static gboolean update_gpu_usage(gpointer user_data)
         g_free(utilization_text);
     }
     if ((entry.video_specified) &&
+        (entry.video != ctk_gpu->last_video_utilization) &&
         (ctk_gpu->video_utilization_label)) {
         utilization_text = g_strdup_printf("%d %%",
                                            entry.video);
@@ -846,6 +860,7 @@ static gboolean update_gpu_usage(gpointer user_data)
         g_free(utilization_text);
     }
     if ((entry.pcie_specified) &&
+        (entry.pcie != ctk_gpu->last_pcie_utilization) &&
         (ctk_gpu->pcie_utilization_label)) {
         utilization_text = g_strdup_printf("%d %%",
                                            entry.pcie);
@@ -857,6 +872,22 @@ static gboolean update_gpu_usage(gpointer user_data)
 
     free(utilizationStr);
 
+    /* Let the timer scheduler back off while the GPU is idle */
+
+    changed = (value != ctk_gpu->last_memory_used) ||
+              (entry.graphics != ctk_gpu->last_graphics_utilization) ||
+              (entry.video != ctk_gpu->last_video_utilization) ||
+              (entry.pcie != ctk_gpu->last_pcie_utilization);
+
+    ctk_gpu->last_memory_used = value;
+    ctk_gpu->last_graphics_utilization = entry.graphics;
+    ctk_gpu->last_video_utilization = entry.video;
+    ctk_gpu->last_pcie_utilization = entry.pcie;
+
+    ctk_config_report_timer_result(ctk_gpu->ctk_config,
+                                   (GSourceFunc) update_gpu_usage,
+                                   (gpointer) ctk_gpu, changed);
+
     return TRUE;
 }
 
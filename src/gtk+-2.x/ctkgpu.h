@@ -68,6 +68,12 @@ struct _CtkGpu
     gint gpu_uuid;
     gint memory_interface;
     gboolean pcie_gen_queriable;
+
+    /* previous GPU usage sample, to detect idle periods */
+    gint last_memory_used;
+    gint last_graphics_utilization;
+    gint last_video_utilization;
+    gint last_pcie_utilization;
 };
 
 struct _CtkGpuClass
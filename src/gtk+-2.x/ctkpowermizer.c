@@ -62,6 +62,8 @@ static void offset_value_changed_event_received(GObject *object,
                                                 gpointer user_data);
 
 static void update_editable_perf_level_info(CtkPowermizer *ctk_powermizer);
+static void update_perf_mode_table(CtkPowermizer *ctk_powermizer,
+                                   gint perf_level);
 
 static const char *__adaptive_clock_help =
 "The Adaptive Clocking status describes if this feature "
@@ -265,6 +267,18 @@ static void post_set_attribute_offset_value(CtkPowermizer *ctk_powermizer,
                                             gint val)
 {
     const char *str = NULL;
+    gint perf_level;
+
+    /*
+     * The performance level table is otherwise only rebuilt when the
+     * current performance level changes; refresh it for the new clocks
+     */
+
+    if (ctk_powermizer->gpu_clock &&
+        ctk_event_subscription_get_value(ctk_powermizer->performance_level_state,
+                                         &perf_level)) {
+        update_perf_mode_table(ctk_powermizer, perf_level);
+    }
 
     switch (attribute) {
     case NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS:
@@ -991,120 +1005,251 @@ static void update_perf_mode_table(CtkPowermizer *ctk_powermizer,
 
 
 
-static gboolean update_powermizer_info(gpointer user_data)
+static void adaptive_clock_state_changed(CtkEventSubscription *subscription,
+                                         int adaptive_clock,
+                                         gpointer user_data)
 {
-    gint power_source, adaptive_clock, perf_level;
-    gint gpu_clock, memory_transfer_rate;
-
     CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
-    CtrlTarget *ctrl_target = ctk_powermizer->ctrl_target;
-    gint ret;
     gchar *s;
-    char *clock_string = NULL;
-    perfModeEntry pEntry;
 
-    ret = NvCtrlGetAttribute(ctrl_target, NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE,
-                             &adaptive_clock);
-    if (ret == NvCtrlSuccess && ctk_powermizer->adaptive_clock_status) { 
+    if (adaptive_clock == NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE_ENABLED) {
+        s = g_strdup_printf("Enabled");
+    }
+    else if (adaptive_clock == NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE_DISABLED) {
+        s = g_strdup_printf("Disabled");
+    }
+    else {
+        s = g_strdup_printf("Error");
+    }
+
+    gtk_label_set_text(GTK_LABEL(ctk_powermizer->adaptive_clock_status), s);
+    g_free(s);
+}
 
-        if (adaptive_clock == NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE_ENABLED) {
-            s = g_strdup_printf("Enabled");
-        }
-        else if (adaptive_clock == NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE_DISABLED) {
-            s = g_strdup_printf("Disabled");
-        }
-        else {
-            s = g_strdup_printf("Error");
-        }
 
-        gtk_label_set_text(GTK_LABEL(ctk_powermizer->adaptive_clock_status), s);
-        g_free(s);
+
+static void power_source_changed(CtkEventSubscription *subscription,
+                                 int power_source, gpointer user_data)
+{
+    CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
+    gchar *s;
+
+    if (power_source == NV_CTRL_GPU_POWER_SOURCE_AC) {
+        s = g_strdup_printf("AC");
+    }
+    else if (power_source == NV_CTRL_GPU_POWER_SOURCE_BATTERY) {
+        s = g_strdup_printf("Battery");
+    }
+    else {
+        s = g_strdup_printf("Error");
     }
 
-    /* Get the current values of clocks */
+    gtk_label_set_text(GTK_LABEL(ctk_powermizer->power_source), s);
+    g_free(s);
+}
 
-    ret = NvCtrlGetStringAttribute(ctrl_target,
-                                   NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS,
-                                   &clock_string);
 
-    if (ret == NvCtrlSuccess && ctk_powermizer->gpu_clock) {
 
-        /* Invalidate the entries */
-        memset(&pEntry, 0, sizeof(pEntry));
+static void link_width_changed(CtkEventSubscription *subscription,
+                               int width, gpointer user_data)
+{
+    CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
+    gchar *s;
 
-        parse_token_value_pairs(clock_string, apply_perf_mode_token,
-                                &pEntry);
+    s = g_strdup_printf("x%d", width);
+    gtk_label_set_text(GTK_LABEL(ctk_powermizer->link_width), s);
+    g_free(s);
+}
 
-        if (pEntry.nvclock_specified) {
-            gpu_clock = pEntry.nvclock;
-            s = g_strdup_printf("%d Mhz", gpu_clock);
-            gtk_label_set_text(GTK_LABEL(ctk_powermizer->gpu_clock), s);
-            g_free(s);
 
-        }
 
-        if (ctk_powermizer->memory_transfer_rate &&
-            pEntry.memtransferrate_specified) {
-            memory_transfer_rate = pEntry.memtransferrate;
-            s = g_strdup_printf("%d Mhz", memory_transfer_rate);
-            gtk_label_set_text(GTK_LABEL(ctk_powermizer->memory_transfer_rate), s);
-            g_free(s);
-        }
+static void link_speed_changed(CtkEventSubscription *subscription,
+                               int speed, gpointer user_data)
+{
+    CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
+    gchar *s;
 
-        if (ctk_powermizer->processor_clock && pEntry.processorclock_specified) {
-            s = g_strdup_printf("%d Mhz", pEntry.processorclock);
-            gtk_label_set_text(GTK_LABEL(ctk_powermizer->processor_clock), s);
-            g_free(s);
-        }
+    s = g_strdup_printf("%.1f GT/s", speed/1000.0);
+    gtk_label_set_text(GTK_LABEL(ctk_powermizer->link_speed), s);
+    g_free(s);
+}
+
+
+
+static void performance_level_changed(CtkEventSubscription *subscription,
+                                      int perf_level, gpointer user_data)
+{
+    CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
+    gchar *s;
+
+    s = g_strdup_printf("%d", perf_level);
+    gtk_label_set_text(GTK_LABEL(ctk_powermizer->performance_level), s);
+    g_free(s);
+
+    if (ctk_powermizer->gpu_clock) {
+        update_perf_mode_table(ctk_powermizer, perf_level);
     }
-    free(clock_string);
+}
 
-    ret = NvCtrlGetAttribute(ctrl_target, NV_CTRL_GPU_POWER_SOURCE,
-                             &power_source);
-    if (ret == NvCtrlSuccess && ctk_powermizer->power_source) {
 
-        if (power_source == NV_CTRL_GPU_POWER_SOURCE_AC) {
-            s = g_strdup_printf("AC");
-        }
-        else if (power_source == NV_CTRL_GPU_POWER_SOURCE_BATTERY) {
-            s = g_strdup_printf("Battery");
-        }
-        else {
-            s = g_strdup_printf("Error");
+
+/*
+ * subscribe_powermizer_info() - Register for the integer attributes shown
+ * on the page.  The driver does not send events for these, so
+ * update_powermizer_info() polls them; only changed values reach the
+ * widgets.
+ */
+static void subscribe_powermizer_info(CtkPowermizer *ctk_powermizer,
+                                      CtkEvent *ctk_event)
+{
+    if (ctk_powermizer->adaptive_clock_status) {
+        ctk_powermizer->adaptive_clock_state =
+            ctk_event_subscribe(ctk_event, NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE,
+                                adaptive_clock_state_changed,
+                                (gpointer) ctk_powermizer);
+    }
+    if (ctk_powermizer->power_source) {
+        ctk_powermizer->power_source_state =
+            ctk_event_subscribe(ctk_event, NV_CTRL_GPU_POWER_SOURCE,
+                                power_source_changed,
+                                (gpointer) ctk_powermizer);
+    }
+    if (ctk_powermizer->pcie_gen_queriable) {
+        ctk_powermizer->link_width_state =
+            ctk_event_subscribe(ctk_event,
+                                NV_CTRL_GPU_PCIE_CURRENT_LINK_WIDTH,
+                                link_width_changed,
+                                (gpointer) ctk_powermizer);
+        ctk_powermizer->link_speed_state =
+            ctk_event_subscribe(ctk_event,
+                                NV_CTRL_GPU_PCIE_CURRENT_LINK_SPEED,
+                                link_speed_changed,
+                                (gpointer) ctk_powermizer);
+    }
+    if (ctk_powermizer->performance_level) {
+        ctk_powermizer->performance_level_state =
+            ctk_event_subscribe(ctk_event,
+                                NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL,
+                                performance_level_changed,
+                                (gpointer) ctk_powermizer);
+    }
+}
+
+
+
+/*
+ * Poll one of the PCIe link subscriptions; the label shows "Unknown" while
+ * the attribute cannot be queried.
+ */
+static gboolean poll_link_state(CtkEventSubscription *subscription,
+                                GtkWidget *label)
+{
+    gboolean changed;
+
+    if (ctk_event_subscription_poll(subscription, &changed) != NvCtrlSuccess) {
+        if (strcmp(gtk_label_get_text(GTK_LABEL(label)), "Unknown") == 0) {
+            return FALSE;
         }
+        gtk_label_set_text(GTK_LABEL(label), "Unknown");
+        return TRUE;
+    }
+
+    return changed;
+}
+
+
+
+static void update_clock_freqs(CtkPowermizer *ctk_powermizer,
+                               const char *clock_string)
+{
+    perfModeEntry pEntry;
+    gchar *s;
 
-        gtk_label_set_text(GTK_LABEL(ctk_powermizer->power_source), s);
+    /* Invalidate the entries */
+    memset(&pEntry, 0, sizeof(pEntry));
+
+    parse_token_value_pairs(clock_string, apply_perf_mode_token, &pEntry);
+
+    if (pEntry.nvclock_specified) {
+        s = g_strdup_printf("%d Mhz", pEntry.nvclock);
+        gtk_label_set_text(GTK_LABEL(ctk_powermizer->gpu_clock), s);
         g_free(s);
     }
 
-    if (ctk_powermizer->pcie_gen_queriable) {
-        /* NV_CTRL_GPU_PCIE_CURRENT_LINK_WIDTH */
-        s = get_pcie_link_width_string(ctrl_target,
-                                       NV_CTRL_GPU_PCIE_CURRENT_LINK_WIDTH);
-        gtk_label_set_text(GTK_LABEL(ctk_powermizer->link_width), s);
+    if (ctk_powermizer->memory_transfer_rate &&
+        pEntry.memtransferrate_specified) {
+        s = g_strdup_printf("%d Mhz", pEntry.memtransferrate);
+        gtk_label_set_text(GTK_LABEL(ctk_powermizer->memory_transfer_rate), s);
         g_free(s);
+    }
 
-        /* NV_CTRL_GPU_PCIE_MAX_LINK_SPEED */
-        s = get_pcie_link_speed_string(ctrl_target,
-                                       NV_CTRL_GPU_PCIE_CURRENT_LINK_SPEED);
-        gtk_label_set_text(GTK_LABEL(ctk_powermizer->link_speed), s);
+    if (ctk_powermizer->processor_clock && pEntry.processorclock_specified) {
+        s = g_strdup_printf("%d Mhz", pEntry.processorclock);
+        gtk_label_set_text(GTK_LABEL(ctk_powermizer->processor_clock), s);
         g_free(s);
     }
+}
 
-    ret = NvCtrlGetAttribute(ctrl_target,
-                             NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL,
-                             &perf_level);
-    if (ret == NvCtrlSuccess && ctk_powermizer->performance_level) {
-        s = g_strdup_printf("%d", perf_level);
-        gtk_label_set_text(GTK_LABEL(ctk_powermizer->performance_level), s);
-        g_free(s);
+
+
+/*
+ * update_powermizer_info() - Poll the values shown on the page that the
+ * driver does not send events for, and update the widgets of the values
+ * that changed.  The PowerMizer mode menu is kept up to date by
+ * NV_CTRL_GPU_POWER_MIZER_MODE events instead.
+ */
+static gboolean update_powermizer_info(gpointer user_data)
+{
+    CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
+    CtrlTarget *ctrl_target = ctk_powermizer->ctrl_target;
+    gboolean changed = FALSE, sub_changed;
+    char *clock_string = NULL;
+    gint ret;
+
+    ctk_event_subscription_poll(ctk_powermizer->adaptive_clock_state,
+                                &sub_changed);
+    changed |= sub_changed;
+
+    /* Get the current values of clocks */
+
+    if (ctk_powermizer->gpu_clock) {
+        ret = NvCtrlGetStringAttribute(ctrl_target,
+                                       NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS,
+                                       &clock_string);
+
+        if (ret == NvCtrlSuccess &&
+            (!ctk_powermizer->clock_freqs ||
+             strcmp(clock_string, ctk_powermizer->clock_freqs) != 0)) {
+
+            update_clock_freqs(ctk_powermizer, clock_string);
+
+            g_free(ctk_powermizer->clock_freqs);
+            ctk_powermizer->clock_freqs = g_strdup(clock_string);
+            changed = TRUE;
+        }
+        free(clock_string);
     }
 
-    if (ctk_powermizer->performance_level && ctk_powermizer->gpu_clock) {
-        update_perf_mode_table(ctk_powermizer, perf_level);
+    ctk_event_subscription_poll(ctk_powermizer->power_source_state,
+                                &sub_changed);
+    changed |= sub_changed;
+
+    if (ctk_powermizer->pcie_gen_queriable) {
+        changed |= poll_link_state(ctk_powermizer->link_width_state,
+                                   ctk_powermizer->link_width);
+        changed |= poll_link_state(ctk_powermizer->link_speed_state,
+                                   ctk_powermizer->link_speed);
     }
 
-    update_powermizer_menu_info(ctk_powermizer);
+    ctk_event_subscription_poll(ctk_powermizer->performance_level_state,
+                                &sub_changed);
+    changed |= sub_changed;
+
+    /* Let the timer scheduler back off while the clocks are steady */
+
+    ctk_config_report_timer_result(ctk_powermizer->ctk_config,
+                                   (GSourceFunc) update_powermizer_info,
+                                   (gpointer) ctk_powermizer, changed);
 
     return TRUE;
 }
@@ -1727,6 +1872,7 @@ GtkWidget* ctk_powermizer_new(CtrlTarget *ctrl_target,
 
     /* Updating the powermizer page */
 
+    subscribe_powermizer_info(ctk_powermizer, ctk_event);
     update_powermizer_info(ctk_powermizer);
 
     /* Add editable performance level table */
@@ -84,6 +84,13 @@ struct _CtkPowermizer
     GtkWidget *link_width;
     GtkWidget *link_speed;
     gboolean  pcie_gen_queriable;
+
+    CtkEventSubscription *adaptive_clock_state;
+    CtkEventSubscription *power_source_state;
+    CtkEventSubscription *link_width_state;
+    CtkEventSubscription *link_speed_state;
+    CtkEventSubscription *performance_level_state;
+    gchar     *clock_freqs;     /* last NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS */
 };
 
 struct _CtkPowermizerClass
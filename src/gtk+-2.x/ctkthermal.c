@@ -150,15 +150,16 @@ GType ctk_thermal_get_type(void)
 
 
 /*
- * update_cooler_info() - Update all cooler information
+ * update_cooler_info() - Rebuild the cooler information table from the
+ * last values delivered to the cooler subscriptions
  */
 static gboolean update_cooler_info(gpointer user_data)
 {
     int i, speed, level, cooler_type, cooler_target;
     gchar *tmp_str;
     CtkThermal *ctk_thermal;
+    CoolerControlPtr cooler;
     GtkWidget *table, *label, *eventbox;
-    gint ret;
     gint row_idx; /* Where to insert into the cooler info table */
     
     ctk_thermal = CTK_THERMAL(user_data);
@@ -236,10 +237,10 @@ static gboolean update_cooler_info(gpointer user_data)
                          GTK_FILL, GTK_FILL | GTK_EXPAND, 5, 0);
         free(tmp_str);
 
-        ret = NvCtrlGetAttribute(ctk_thermal->cooler_control[i].ctrl_target,
-                                 NV_CTRL_THERMAL_COOLER_SPEED,
-                                 &speed);
-        if (ret == NvCtrlSuccess) {
+        cooler = &ctk_thermal->cooler_control[i];
+
+        if (ctk_event_subscription_get_value(cooler->info[COOLER_INFO_SPEED],
+                                             &speed)) {
             tmp_str = g_strdup_printf("%d", speed);
         }
         else {
@@ -251,10 +252,8 @@ static gboolean update_cooler_info(gpointer user_data)
                          GTK_FILL, GTK_FILL | GTK_EXPAND, 5, 0);
         free(tmp_str);
 
-        ret = NvCtrlGetAttribute(ctk_thermal->cooler_control[i].ctrl_target,
-                                 NV_CTRL_THERMAL_COOLER_LEVEL,
-                                 &level);
-        if (ret != NvCtrlSuccess) {
+        if (!ctk_event_subscription_get_value(cooler->info[COOLER_INFO_LEVEL],
+                                              &level)) {
             /* cooler information no longer available */
             return FALSE;
         }
@@ -265,10 +264,8 @@ static gboolean update_cooler_info(gpointer user_data)
                          GTK_FILL, GTK_FILL | GTK_EXPAND, 5, 0);
         free(tmp_str);
 
-        ret = NvCtrlGetAttribute(ctk_thermal->cooler_control[i].ctrl_target,
-                                 NV_CTRL_THERMAL_COOLER_CONTROL_TYPE,
-                                 &cooler_type);
-        if (ret != NvCtrlSuccess) {
+        if (!ctk_event_subscription_get_value(cooler->info[COOLER_INFO_CONTROL_TYPE],
+                                              &cooler_type)) {
             /* cooler information no longer available */
             return FALSE;
         }
@@ -285,10 +282,8 @@ static gboolean update_cooler_info(gpointer user_data)
                          GTK_FILL, GTK_FILL | GTK_EXPAND, 5, 0);
         free(tmp_str);
 
-        ret = NvCtrlGetAttribute(ctk_thermal->cooler_control[i].ctrl_target,
-                                 NV_CTRL_THERMAL_COOLER_TARGET,
-                                 &cooler_target);
-        if (ret != NvCtrlSuccess) {
+        if (!ctk_event_subscription_get_value(cooler->info[COOLER_INFO_TARGET],
+                                              &cooler_target)) {
             /* cooler information no longer available */
             return FALSE;
         }
@@ -327,73 +322,213 @@ static gboolean update_cooler_info(gpointer user_data)
 
 
 
-static gboolean update_thermal_info(gpointer user_data)
+static void core_temperature_changed(CtkEventSubscription *subscription,
+                                     int core, gpointer user_data)
+{
+    CtkThermal *ctk_thermal = CTK_THERMAL(user_data);
+    gchar *s;
+
+    s = g_strdup_printf(" %d C ", core);
+    gtk_label_set_text(GTK_LABEL(ctk_thermal->core_label), s);
+    g_free(s);
+
+    ctk_gauge_set_current(CTK_GAUGE(ctk_thermal->core_gauge), core);
+    ctk_gauge_draw(CTK_GAUGE(ctk_thermal->core_gauge));
+}
+
+
+
+static void ambient_temperature_changed(CtkEventSubscription *subscription,
+                                        int ambient, gpointer user_data)
 {
-    gint reading, ambient;
     CtkThermal *ctk_thermal = CTK_THERMAL(user_data);
-    gint ret, i, core;
     gchar *s;
 
+    s = g_strdup_printf(" %d C ", ambient);
+    gtk_label_set_text(GTK_LABEL(ctk_thermal->ambient_label), s);
+    g_free(s);
+}
+
+
+
+static void sensor_reading_changed(CtkEventSubscription *subscription,
+                                   int reading, gpointer user_data)
+{
+    SensorInfoPtr sensor = (SensorInfoPtr) user_data;
+    gchar *s;
+
+    sensor->currentTemp = reading;
+
+    if (sensor->temp_label) {
+        s = g_strdup_printf(" %d C ", reading);
+        gtk_label_set_text(GTK_LABEL(sensor->temp_label), s);
+        g_free(s);
+    }
+
+    if (sensor->core_gauge) {
+        ctk_gauge_set_current(CTK_GAUGE(sensor->core_gauge), reading);
+        ctk_gauge_draw(CTK_GAUGE(sensor->core_gauge));
+    }
+}
+
+
+
+static void cooler_info_changed(CtkEventSubscription *subscription,
+                                int value, gpointer user_data)
+{
+    CtkThermal *ctk_thermal = CTK_THERMAL(user_data);
+
+    ctk_thermal->cooler_table_dirty = TRUE;
+}
+
+
+
+/*
+ * subscribe_thermal_info() - Register for the temperatures and cooler
+ * information shown on the page.  None of these are sent as events by the
+ * driver except for the cooler level, so update_thermal_info() polls them;
+ * the subscriptions filter out unchanged values so that the widgets are
+ * only updated when something changed.
+ */
+static void subscribe_thermal_info(CtkThermal *ctk_thermal,
+                                   CtkEvent *ctk_event)
+{
+    static const int cooler_info_attributes[NUM_COOLER_INFO_ATTRIBUTES] = {
+        [COOLER_INFO_SPEED]        = NV_CTRL_THERMAL_COOLER_SPEED,
+        [COOLER_INFO_LEVEL]        = NV_CTRL_THERMAL_COOLER_LEVEL,
+        [COOLER_INFO_CONTROL_TYPE] = NV_CTRL_THERMAL_COOLER_CONTROL_TYPE,
+        [COOLER_INFO_TARGET]       = NV_CTRL_THERMAL_COOLER_TARGET,
+    };
+    int i, j;
+
     if (!ctk_thermal->thermal_sensor_target_type_supported) {
-        CtrlTarget *ctrl_target = ctk_thermal->ctrl_target;
+        ctk_thermal->core_temperature =
+            ctk_event_subscribe(ctk_event, NV_CTRL_GPU_CORE_TEMPERATURE,
+                                core_temperature_changed,
+                                (gpointer) ctk_thermal);
+        if (ctk_thermal->ambient_label) {
+            ctk_thermal->ambient_temperature =
+                ctk_event_subscribe(ctk_event, NV_CTRL_AMBIENT_TEMPERATURE,
+                                    ambient_temperature_changed,
+                                    (gpointer) ctk_thermal);
+        }
+    } else {
+        for (i = 0; i < ctk_thermal->sensor_count; i++) {
+            SensorInfoPtr sensor = &ctk_thermal->sensor_info[i];
 
-        ret = NvCtrlGetAttribute(ctrl_target, NV_CTRL_GPU_CORE_TEMPERATURE,
-                                 &core);
+            if (!sensor->ctrl_target) {
+                continue;
+            }
+            sensor->currentTemp = -1; /* nothing shown yet */
+            sensor->event = CTK_EVENT(ctk_event_new(sensor->ctrl_target));
+            sensor->reading =
+                ctk_event_subscribe(sensor->event,
+                                    NV_CTRL_THERMAL_SENSOR_READING,
+                                    sensor_reading_changed,
+                                    (gpointer) sensor);
+        }
+    }
+
+    for (i = 0; i < ctk_thermal->cooler_count; i++) {
+        CoolerControlPtr cooler = &ctk_thermal->cooler_control[i];
+
+        for (j = 0; j < NUM_COOLER_INFO_ATTRIBUTES; j++) {
+            cooler->info[j] =
+                ctk_event_subscribe(cooler->event, cooler_info_attributes[j],
+                                    cooler_info_changed,
+                                    (gpointer) ctk_thermal);
+        }
+    }
+
+    ctk_thermal->cooler_table_dirty = TRUE;
+}
+
+
+
+/*
+ * poll_cooler_info() - Poll the cooler information and rebuild the cooler
+ * table if any of it changed or became (un)available.  Returns whether the
+ * table was rebuilt.
+ */
+static gboolean poll_cooler_info(CtkThermal *ctk_thermal)
+{
+    int i, j;
+
+    for (i = 0; i < ctk_thermal->cooler_count; i++) {
+        CoolerControlPtr cooler = &ctk_thermal->cooler_control[i];
+
+        for (j = 0; j < NUM_COOLER_INFO_ATTRIBUTES; j++) {
+            gboolean available =
+                (ctk_event_subscription_poll(cooler->info[j], NULL) ==
+                 NvCtrlSuccess);
+
+            if (available != cooler->info_available[j]) {
+                cooler->info_available[j] = available;
+                ctk_thermal->cooler_table_dirty = TRUE;
+            }
+        }
+    }
+
+    if (!ctk_thermal->cooler_table_dirty) {
+        return FALSE;
+    }
+
+    ctk_thermal->cooler_table_dirty = FALSE;
+    update_cooler_info(ctk_thermal);
+
+    return TRUE;
+}
+
+
+
+static gboolean update_thermal_info(gpointer user_data)
+{
+    CtkThermal *ctk_thermal = CTK_THERMAL(user_data);
+    gboolean changed = FALSE, sub_changed;
+    gint ret, i;
+
+    if (!ctk_thermal->thermal_sensor_target_type_supported) {
+        ret = ctk_event_subscription_poll(ctk_thermal->core_temperature,
+                                          &sub_changed);
         if (ret != NvCtrlSuccess) {
             /* thermal information no longer available */
             return FALSE;
         }
+        changed |= sub_changed;
 
-        s = g_strdup_printf(" %d C ", core);
-        gtk_label_set_text(GTK_LABEL(ctk_thermal->core_label), s);
-        g_free(s);
-
-        ctk_gauge_set_current(CTK_GAUGE(ctk_thermal->core_gauge), core);
-        ctk_gauge_draw(CTK_GAUGE(ctk_thermal->core_gauge));
-
-        if (ctk_thermal->ambient_label) {
-            ret = NvCtrlGetAttribute(ctrl_target,
-                                     NV_CTRL_AMBIENT_TEMPERATURE,
-                                     &ambient);
+        if (ctk_thermal->ambient_temperature) {
+            ret = ctk_event_subscription_poll(ctk_thermal->ambient_temperature,
+                                              &sub_changed);
             if (ret != NvCtrlSuccess) {
                 /* thermal information no longer available */
                 return FALSE;
             }
-            s = g_strdup_printf(" %d C ", ambient);
-            gtk_label_set_text(GTK_LABEL(ctk_thermal->ambient_label), s);
-            g_free(s);
+            changed |= sub_changed;
         }
     } else {
         for (i = 0; i < ctk_thermal->sensor_count; i++) {
-            CtrlTarget *ctrl_target = ctk_thermal->sensor_info[i].ctrl_target;
+            SensorInfoPtr sensor = &ctk_thermal->sensor_info[i];
+
+            ret = ctk_event_subscription_poll(sensor->reading, &sub_changed);
 
-            ret = NvCtrlGetAttribute(ctrl_target,
-                                     NV_CTRL_THERMAL_SENSOR_READING,
-                                     &reading);
             /* querying THERMAL_SENSOR_READING failed: assume the temperature is 0 */
-            if (ret != NvCtrlSuccess) {
-                reading = 0;
-            }
-            
-            if (ctk_thermal->sensor_info[i].temp_label) {
-                s = g_strdup_printf(" %d C ", reading);
-                gtk_label_set_text(
-                                   GTK_LABEL(ctk_thermal->sensor_info[i].temp_label), s);
-                g_free(s);
-            }
-            
-            if (ctk_thermal->sensor_info[i].core_gauge) {
-                ctk_gauge_set_current(
-                          CTK_GAUGE(ctk_thermal->sensor_info[i].core_gauge),
-                          reading);
-                ctk_gauge_draw(CTK_GAUGE(ctk_thermal->sensor_info[i].core_gauge));
+            if (ret != NvCtrlSuccess && sensor->currentTemp != 0) {
+                sensor_reading_changed(sensor->reading, 0, sensor);
+                sub_changed = TRUE;
             }
+            changed |= sub_changed;
         }
     }
     if ( ctk_thermal->cooler_count ) {
-        update_cooler_info(ctk_thermal);
+        changed |= poll_cooler_info(ctk_thermal);
     }
-    
+
+    /* Let the timer scheduler back off while the temperatures are steady */
+
+    ctk_config_report_timer_result(ctk_thermal->ctk_config,
+                                   (GSourceFunc) update_thermal_info,
+                                   (gpointer) ctk_thermal, changed);
+
     return TRUE;
 } /* update_thermal_info() */
 
@@ -1577,6 +1712,7 @@ end:
     /* sync GUI to current server settings */
     
     sync_gui_to_modify_cooler_level(ctk_thermal);
+    subscribe_thermal_info(ctk_thermal, ctk_event);
     update_thermal_info(ctk_thermal);
     
     /* Register a timer callback to update the temperatures */
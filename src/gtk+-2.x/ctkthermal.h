@@ -46,6 +46,13 @@ G_BEGIN_DECLS
 typedef struct _CtkThermal       CtkThermal;
 typedef struct _CtkThermalClass  CtkThermalClass;
 
+/* The cooler attributes shown in the cooler information table */
+#define COOLER_INFO_SPEED          0
+#define COOLER_INFO_LEVEL          1
+#define COOLER_INFO_CONTROL_TYPE   2
+#define COOLER_INFO_TARGET         3
+#define NUM_COOLER_INFO_ATTRIBUTES 4
+
 typedef struct _CoolerControl {
     CtrlAttributeValidValues range;
     CtrlTarget *ctrl_target;
@@ -55,6 +62,10 @@ typedef struct _CoolerControl {
     GtkWidget *widget;         /* Cooler level control widget */
     GtkAdjustment *adjustment; /* Track adjustment */
     CtkEvent *event;           /* Receive NV_CONTROL events */
+
+    /* Values shown in the cooler information table */
+    CtkEventSubscription *info[NUM_COOLER_INFO_ATTRIBUTES];
+    gboolean info_available[NUM_COOLER_INFO_ATTRIBUTES];
 } CoolerControlRec, *CoolerControlPtr;
 
 typedef struct {
@@ -72,6 +83,9 @@ typedef struct _SensorInfo {
     GtkWidget *provider_type;
     GtkWidget *temp_label;
     GtkWidget *core_gauge;
+
+    CtkEvent *event;
+    CtkEventSubscription *reading;
 } SensorInfoRec, *SensorInfoPtr;
 
 struct _CtkThermal
@@ -95,6 +109,10 @@ struct _CtkThermal
     GtkWidget *cooler_table_hbox;
     GtkWidget *fan_information_box;
 
+    CtkEventSubscription *core_temperature;
+    CtkEventSubscription *ambient_temperature;
+    gboolean cooler_table_dirty;
+
     gboolean cooler_control_enabled;
     gboolean settings_changed;
     gboolean show_fan_control_frame;
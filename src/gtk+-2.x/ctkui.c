@@ -20,7 +20,9 @@
 #include <gtk/gtk.h>
 #include "ctkui.h"
 #include "ctkwindow.h"
+#include "ctkevent.h"
 #include "ctkutils.h"
+#include "profile.h"
 #include "nvidia_icon.png.h"
 /*
  * This source file provides thin wrappers over the gtk routines, so
@@ -49,7 +51,12 @@ void ctk_main(ParsedAttribute *p,
 
     list = g_list_append (list, CTK_LOAD_PIXBUF(nvidia_icon));
     gtk_window_set_default_icon_list(list);
+
+    ctk_event_set_coalescing_window(conf->event_coalescing_window);
+
+    nv_profile_begin("ctk_window_new");
     window = ctk_window_new(p, conf, system);
+    nv_profile_end();
 
     for (node = system->targets[X_SCREEN_TARGET]; node; node = node->next) {
         if (node->t->h) {
@@ -72,7 +79,9 @@ void ctk_main(ParsedAttribute *p,
         gtk_widget_destroy (dlg);
     }
 
+    nv_profile_begin("ctk_window_set_active_page");
     ctk_window_set_active_page(CTK_WINDOW(window), page);
+    nv_profile_end();
 
     gtk_main();
 }
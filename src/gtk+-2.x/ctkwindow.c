@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <dlfcn.h>
 
 #include "ctkwindow.h"
 
@@ -72,6 +73,7 @@
 #include "msg.h"
 #include "common-utils.h"
 #include "query-assign.h"
+#include "profile.h"
 
 #include "opengl_loading.h"
 
@@ -84,6 +86,7 @@ enum {
     CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN,
     CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
     CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN,
+    CTK_WINDOW_PAGE_BUILDER_COLUMN,
     CTK_WINDOW_NUM_COLUMNS
 };
 
@@ -99,6 +102,9 @@ typedef struct {
     CtkEvent **display_events;
     int num_displays;
 
+    /* the displays changed since the list was last rebuilt */
+    gboolean displays_changed;
+
 } UpdateDisplaysData;
 
 
@@ -106,6 +112,27 @@ typedef void (*config_file_attributes_func_t)(GtkWidget *, ParsedAttribute *);
 typedef void (*select_widget_func_t)(GtkWidget *);
 typedef void (*unselect_widget_func_t)(GtkWidget *);
 
+
+/*
+ * Pages that are expensive to construct, and that neither read nor write
+ * the parsed attribute list, are only constructed when they are first
+ * selected in the tree.  Until then, their row in the tree has no widget,
+ * and holds a PageBuilder that describes how to construct the page.
+ */
+
+typedef struct _PageBuilder PageBuilder;
+
+typedef GtkWidget *(*page_builder_func_t)(PageBuilder *, GtkTextBuffer **);
+
+struct _PageBuilder {
+    page_builder_func_t func;
+    CtrlTarget *target;
+    CtkConfig *ctk_config;
+    CtkEvent *ctk_event;
+    GtkTextTagTable *tag_table;
+    gchar *label;
+};
+
 static void ctk_window_class_init(CtkWindowClass *);
 
 #ifdef CTK_GTK3
@@ -120,6 +147,17 @@ static void add_page(GtkWidget *, GtkTextBuffer *, CtkWindow *,
                      select_widget_func_t load_func,
                      unselect_widget_func_t unload_func);
 
+static void add_lazy_page(page_builder_func_t, CtrlTarget *, CtkEvent *,
+                          GtkTextTagTable *, CtkWindow *, GtkTreeIter *,
+                          const gchar *,
+                          select_widget_func_t load_func,
+                          unselect_widget_func_t unload_func);
+
+static GtkWidget *build_lazy_page(CtkWindow *, GtkTreeIter *,
+                                  GtkTextBuffer **);
+
+static void free_page_builders(CtkWindow *);
+
 static GtkWidget *create_quit_dialog(CtkWindow *ctk_window);
 
 static void quit_response(GtkWidget *, gint, gpointer);
@@ -132,8 +170,10 @@ static void add_display_devices(CtkWindow *ctk_window, GtkTreeIter *iter,
                                 UpdateDisplaysData *data,
                                 ParsedAttribute *p);
 
-static void update_display_devices(GtkWidget *object, CtrlEvent *event,
-                                   gpointer user_data);
+static void display_devices_changed(GtkWidget *object, CtrlEvent *event,
+                                    gpointer user_data);
+
+static void update_display_devices(GtkWidget *object, gpointer user_data);
 
 
 static GObjectClass *parent_class;
@@ -202,13 +242,15 @@ static void ctk_window_class_init(CtkWindowClass *ctk_window_class)
 
 
 /*
- * ctk_window_real_destroy() - quit gtk.  XXX Maybe we should write
- * the configuration file here?
+ * ctk_window_real_destroy() - free the builders of the pages that were
+ * never constructed, and quit gtk.  XXX Maybe we should write the
+ * configuration file here?
  */
 
 #ifdef CTK_GTK3
 static void ctk_window_real_destroy(GtkWidget *object)
 {
+    free_page_builders(CTK_WINDOW(object));
     GTK_WIDGET_CLASS(parent_class)->destroy(object);
     gtk_main_quit();
 
@@ -216,6 +258,7 @@ static void ctk_window_real_destroy(GtkWidget *object)
 #else
 static void ctk_window_real_destroy(GtkObject *object)
 {
+    free_page_builders(CTK_WINDOW(object));
     GTK_OBJECT_CLASS(parent_class)->destroy(object);
     gtk_main_quit();
 
@@ -327,6 +370,14 @@ static void tree_selection_changed(GtkTreeSelection *selection,
     gtk_tree_model_get(model, &iter, CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
                        &select_func, -1);
 
+    /* construct the page now, if its construction was deferred */
+
+    if (!widget) {
+        widget = build_lazy_page(ctk_window, &iter, &help);
+        gtk_tree_model_get(model, &iter, CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
+                           &select_func, -1);
+    }
+
     /*
      * remove the existing widget from the page viewer, if anything is
      * presently there
@@ -410,6 +461,219 @@ static gboolean has_randr_gamma(CtrlTarget *target)
     return ((ret == NvCtrlSuccess) && (val == 1));
 }
 
+
+
+/*
+ * The following checks tell whether pages whose construction is deferred
+ * apply to the target, so that only the rows of applicable pages are added
+ * to the tree.  They mirror the checks done by the page constructors, using
+ * as few queries as possible.
+ */
+
+static gboolean has_xvideo(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int val;
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_ATTR_EXT_XV_TEXTURE_PRESENT,
+                             &val);
+    if ((ret != NvCtrlSuccess) || !val) {
+        ret = NvCtrlGetAttribute(target, NV_CTRL_ATTR_EXT_XV_BLITTER_PRESENT,
+                                 &val);
+        if ((ret != NvCtrlSuccess) || !val) {
+            return FALSE;
+        }
+    }
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_XV_SYNC_TO_DISPLAY_ID, &val);
+
+    return (ret == NvCtrlSuccess);
+}
+
+static gboolean has_vdpau(void)
+{
+    void *handle;
+    gboolean found;
+
+    handle = dlopen("libvdpau.so.1", RTLD_NOW);
+    if (!handle) {
+        return FALSE;
+    }
+
+    found = (dlsym(handle, "vdp_device_create_x11") != NULL);
+    dlclose(handle);
+
+    return found;
+}
+
+static gboolean has_thermal(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int major, minor, val;
+    int *data = NULL;
+    int len;
+    gboolean found = FALSE;
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_ATTR_NV_MAJOR_VERSION, &major);
+    if ((ret != NvCtrlSuccess) ||
+        (NvCtrlGetAttribute(target, NV_CTRL_ATTR_NV_MINOR_VERSION,
+                            &minor) != NvCtrlSuccess) ||
+        ((major == 1) && (minor <= 22)) || (major < 1)) {
+        /* thermal sensor targets are not supported */
+        return NvCtrlGetAttribute(target, NV_CTRL_GPU_CORE_TEMPERATURE,
+                                  &val) == NvCtrlSuccess;
+    }
+
+    ret = NvCtrlGetBinaryAttribute(target, 0,
+                                   NV_CTRL_BINARY_DATA_THERMAL_SENSORS_USED_BY_GPU,
+                                   (unsigned char **)(&data), &len);
+    if (ret == NvCtrlSuccess) {
+        found = (data[0] > 0);
+    }
+    free(data);
+    data = NULL;
+
+    if (!found) {
+        ret = NvCtrlGetBinaryAttribute(target, 0,
+                                       NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU,
+                                       (unsigned char **)(&data), &len);
+        if (ret == NvCtrlSuccess) {
+            found = (data[0] > 0);
+        }
+        free(data);
+    }
+
+    return found;
+}
+
+static gboolean has_powermizer(CtrlTarget *target)
+{
+    int val;
+
+    return (NvCtrlGetAttribute(target, NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL,
+                               &val) == NvCtrlSuccess) ||
+           (NvCtrlGetAttribute(target, NV_CTRL_GPU_POWER_SOURCE,
+                               &val) == NvCtrlSuccess) ||
+           (NvCtrlGetAttribute(target, NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE,
+                               &val) == NvCtrlSuccess) ||
+           (NvCtrlGetAttribute(target, NV_CTRL_GPU_PCIE_GENERATION,
+                               &val) == NvCtrlSuccess);
+}
+
+static gboolean has_ecc(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int val;
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_GPU_ECC_SUPPORTED, &val);
+
+    return ((ret == NvCtrlSuccess) && (val == NV_CTRL_GPU_ECC_SUPPORTED_TRUE));
+}
+
+
+
+/*
+ * Constructors of the pages whose construction is deferred; each returns
+ * the page and its help, or NULL if the page cannot be constructed.
+ */
+
+static GtkWidget *build_server_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_server_new(b->target, b->ctk_config);
+
+    if (page) {
+        *help = ctk_server_create_help(b->tag_table, CTK_SERVER(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_display_config_page(PageBuilder *b,
+                                            GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_display_config_new(b->target, b->ctk_config);
+
+    if (page) {
+        *help = ctk_display_config_create_help(b->tag_table,
+                                               CTK_DISPLAY_CONFIG(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_xvideo_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_xvideo_new(b->target, b->ctk_config, b->ctk_event);
+
+    if (page) {
+        *help = ctk_xvideo_create_help(b->tag_table, CTK_XVIDEO(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_glx_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_glx_new(b->target, b->ctk_config, b->ctk_event);
+
+    if (page) {
+        *help = ctk_glx_create_help(b->tag_table, CTK_GLX(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_vdpau_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_vdpau_new(b->target, b->ctk_config, b->ctk_event);
+
+    if (page) {
+        *help = ctk_vdpau_create_help(b->tag_table, CTK_VDPAU(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_thermal_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_thermal_new(b->target, b->ctk_config, b->ctk_event);
+
+    if (page) {
+        *help = ctk_thermal_create_help(b->tag_table, CTK_THERMAL(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_powermizer_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_powermizer_new(b->target, b->ctk_config,
+                                         b->ctk_event);
+
+    if (page) {
+        *help = ctk_powermizer_create_help(b->tag_table,
+                                           CTK_POWERMIZER(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_ecc_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_ecc_new(b->target, b->ctk_config, b->ctk_event);
+
+    if (page) {
+        *help = ctk_ecc_create_help(b->tag_table, CTK_ECC(page));
+    }
+    return page;
+}
+
+static GtkWidget *build_app_profile_page(PageBuilder *b, GtkTextBuffer **help)
+{
+    GtkWidget *page = ctk_app_profile_new(b->target, b->ctk_config);
+
+    if (page) {
+        *help = ctk_app_profile_create_help(CTK_APP_PROFILE(page),
+                                            b->tag_table);
+    }
+    return page;
+}
+
+
+
 /*
  * ctk_window_new() - create a new CtkWindow widget
  */
@@ -450,6 +714,10 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
     gint column_offset;
     gboolean slimm_page_added; /* XXX Kludge to only show one SLIMM page */
 
+    GTimer *timer;
+
+    timer = g_timer_new();
+
     /* create the new object */
 
     object = g_object_new(CTK_TYPE_WINDOW, NULL);
@@ -555,7 +823,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
                            G_TYPE_POINTER,  /* Help widget */
                            G_TYPE_POINTER,  /* Config file attr func */
                            G_TYPE_POINTER,  /* Load widget func */
-                           G_TYPE_POINTER); /* Unload widget func */
+                           G_TYPE_POINTER,  /* Unload widget func */
+                           G_TYPE_POINTER); /* Page builder */
     model = GTK_TREE_MODEL(ctk_window->tree_store);
 
     /* create the tree view */
@@ -603,8 +872,6 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
     if (system->targets[X_SCREEN_TARGET]) {
 
-        GtkWidget *child;
-
         /*
          * XXX For now, just use the first handle in the list
          *     to communicate with the X server for these two
@@ -616,31 +883,25 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
             /* X Server information */
 
-            child = ctk_server_new(server_target, ctk_config);
-            add_page(child,
-                     ctk_server_create_help(tag_table,
-                                            CTK_SERVER(child)),
-                     ctk_window, NULL, NULL, "X Server Information",
-                     NULL, NULL, NULL);
+            add_lazy_page(build_server_page, server_target, NULL, tag_table,
+                          ctk_window, NULL, "X Server Information",
+                          NULL, NULL);
 
             /* X Server Display Configuration */
 
-            child = ctk_display_config_new(server_target, ctk_config);
-            if (child) {
-                add_page(child,
-                         ctk_display_config_create_help(tag_table,
-                                                        CTK_DISPLAY_CONFIG(child)),
-                         ctk_window, NULL, NULL,
-                         "X Server Display Configuration",
-                         NULL, ctk_display_config_selected,
-                         ctk_display_config_unselected);
-            }
+            add_lazy_page(build_display_config_page, server_target, NULL,
+                          tag_table, ctk_window, NULL,
+                          "X Server Display Configuration",
+                          ctk_display_config_selected,
+                          ctk_display_config_unselected);
         }
     }
 
 
     /* add the per-screen entries into the tree model */
 
+    nv_profile_begin("X screen pages");
+
     slimm_page_added = FALSE;
     for (node = system->targets[X_SCREEN_TARGET]; node; node = node->next) {
 
@@ -713,11 +974,10 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         /* xvideo settings  */
 
-        child = ctk_xvideo_new(screen_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_xvideo_create_help(tag_table, CTK_XVIDEO(child));
-            add_page(child, help, ctk_window, &iter, NULL,
-                     "X Server XVideo Settings", NULL, NULL, NULL);
+        if (has_xvideo(screen_target)) {
+            add_lazy_page(build_xvideo_page, screen_target, ctk_event,
+                          tag_table, ctk_window, &iter,
+                          "X Server XVideo Settings", NULL, NULL);
         }
 
         /* opengl settings */
@@ -732,12 +992,9 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         /* GLX Information */
 
-        child = ctk_glx_new(screen_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_glx_create_help(tag_table, CTK_GLX(child));
-            add_page(child, help, ctk_window, &iter, NULL,
-                     "OpenGL/GLX Information", NULL, ctk_glx_probe_info, NULL);
-        }
+        add_lazy_page(build_glx_page, screen_target, ctk_event, tag_table,
+                      ctk_window, &iter, "OpenGL/GLX Information",
+                      ctk_glx_probe_info, NULL);
 
 
         /* multisample settings */
@@ -752,11 +1009,10 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
 
         /* VDPAU Information */
-        child = ctk_vdpau_new(screen_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_vdpau_create_help(tag_table, CTK_VDPAU(child));
-            add_page(child, help, ctk_window, &iter, NULL, "VDPAU Information",
-                     NULL, NULL, NULL);
+        if (has_vdpau()) {
+            add_lazy_page(build_vdpau_page, screen_target, ctk_event,
+                          tag_table, ctk_window, &iter, "VDPAU Information",
+                          NULL, NULL);
         }
 
         /* gvo (Graphics To Video Out) */
@@ -796,8 +1052,12 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         }
     }
 
+    nv_profile_end();
+
     /* add the per-gpu entries into the tree model */
 
+    nv_profile_begin("GPU pages");
+
     for (node = system->targets[GPU_TARGET]; node; node = node->next) {
 
         gchar *gpu_name;
@@ -845,28 +1105,25 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         /* thermal information */
 
-        child = ctk_thermal_new(gpu_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_thermal_create_help(tag_table, CTK_THERMAL(child));
-            add_page(child, help, ctk_window, &iter, NULL, "Thermal Settings",
-                     NULL, ctk_thermal_start_timer, ctk_thermal_stop_timer);
+        if (has_thermal(gpu_target)) {
+            add_lazy_page(build_thermal_page, gpu_target, ctk_event,
+                          tag_table, ctk_window, &iter, "Thermal Settings",
+                          ctk_thermal_start_timer, ctk_thermal_stop_timer);
         }
 
         /* Powermizer information */
-        child = ctk_powermizer_new(gpu_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_powermizer_create_help(tag_table, CTK_POWERMIZER(child));
-            add_page(child, help, ctk_window, &iter, NULL, "PowerMizer",
-                     NULL, ctk_powermizer_start_timer, 
-                     ctk_powermizer_stop_timer);
+        if (has_powermizer(gpu_target)) {
+            add_lazy_page(build_powermizer_page, gpu_target, ctk_event,
+                          tag_table, ctk_window, &iter, "PowerMizer",
+                          ctk_powermizer_start_timer,
+                          ctk_powermizer_stop_timer);
         }
 
         /* ECC Information */
-        child = ctk_ecc_new(gpu_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_ecc_create_help(tag_table, CTK_ECC(child));
-            add_page(child, help, ctk_window, &iter, NULL, "ECC Settings",
-                     NULL, ctk_ecc_start_timer, ctk_ecc_stop_timer);
+        if (has_ecc(gpu_target)) {
+            add_lazy_page(build_ecc_page, gpu_target, ctk_event,
+                          tag_table, ctk_window, &iter, "ECC Settings",
+                          ctk_ecc_start_timer, ctk_ecc_stop_timer);
         }
 
         /* display devices */
@@ -878,11 +1135,19 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         g_signal_connect(G_OBJECT(ctk_event),
                          CTK_EVENT_NAME(NV_CTRL_PROBE_DISPLAYS),
-                         G_CALLBACK(update_display_devices),
+                         G_CALLBACK(display_devices_changed),
                          (gpointer) data);
 
         g_signal_connect(G_OBJECT(ctk_event),
                          CTK_EVENT_NAME(NV_CTRL_MODE_SET_EVENT),
+                         G_CALLBACK(display_devices_changed),
+                         (gpointer) data);
+
+        /*
+         * Rebuilding the display device pages is expensive; wait for a
+         * hotplug or modeset to finish before doing it.
+         */
+        g_signal_connect(G_OBJECT(ctk_event), "CTK_EVENT_SETTLED",
                          G_CALLBACK(update_display_devices),
                          (gpointer) data);
 
@@ -890,6 +1155,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
                             data, ctk_window->attribute_list);
     }
 
+    nv_profile_end();
+
     /* add the per-vcs (e.g. Quadro Plex) entries into the tree model */
 
     for (node = system->targets[VCS_TARGET]; node; node = node->next) {
@@ -1003,6 +1270,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
      * frame lock
      */
 
+    nv_profile_begin("Frame Lock page");
+
     for (node = system->targets[X_SCREEN_TARGET]; node; node = node->next) {
 
         CtrlTarget *screen_target = node->t;
@@ -1023,6 +1292,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         break;
     }
 
+    nv_profile_end();
+
     /* add NVIDIA 3D VisionPro dongle configuration page */
 
     for (node = system->targets[NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET];
@@ -1050,12 +1321,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
     }
 
     /* app profile configuration */
-    widget = ctk_app_profile_new(server_target, ctk_config);
-    if (widget) {
-        add_page(widget, ctk_app_profile_create_help(CTK_APP_PROFILE(widget), tag_table),
-                 ctk_window, NULL, NULL, "Application Profiles",
-                 NULL, NULL, NULL);
-    }
+    add_lazy_page(build_app_profile_page, server_target, NULL, tag_table,
+                  ctk_window, NULL, "Application Profiles", NULL, NULL);
 
     /* Manage GRID License Information */
     for (node = system->targets[GPU_TARGET]; node; node = node->next) {
@@ -1139,7 +1406,12 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
     g_signal_connect(G_OBJECT(ctk_window), "delete-event",
                      G_CALLBACK(ctk_window_delete_event), (gpointer) ctk_window);
-    
+
+    nv_info_msg(NULL, "Created the main window in %.3f seconds (%d pages "
+                "deferred until first selected).",
+                g_timer_elapsed(timer, NULL), ctk_window->num_lazy_pages);
+    g_timer_destroy(timer);
+
     return GTK_WIDGET(object);
 
 } /* ctk_window_new() */
@@ -1278,6 +1550,168 @@ static void add_page(GtkWidget *widget, GtkTextBuffer *help,
 
 
 
+/*
+ * free_page_builder() - free a PageBuilder allocated by add_lazy_page().
+ */
+
+static void free_page_builder(PageBuilder *builder)
+{
+    g_free(builder->label);
+    nvfree(builder);
+}
+
+
+
+/*
+ * add_lazy_page() - add a new page to ctk_window's tree_store, using
+ * iter as a parent, without constructing it: 'func' is called to
+ * construct the page when it is first selected.
+ */
+
+static void add_lazy_page(page_builder_func_t func, CtrlTarget *target,
+                          CtkEvent *ctk_event, GtkTextTagTable *tag_table,
+                          CtkWindow *ctk_window, GtkTreeIter *iter,
+                          const gchar *label,
+                          select_widget_func_t select_func,
+                          unselect_widget_func_t unselect_func)
+{
+    GtkTreeIter child_iter;
+    PageBuilder *builder;
+
+    if (!target) {
+        return;
+    }
+
+    builder = nvalloc(sizeof(PageBuilder));
+    builder->func = func;
+    builder->target = target;
+    builder->ctk_config = ctk_window->ctk_config;
+    builder->ctk_event = ctk_event;
+    builder->tag_table = tag_table;
+    builder->label = g_strdup(label);
+
+    gtk_tree_store_append(ctk_window->tree_store, &child_iter, iter);
+
+    gtk_tree_store_set(ctk_window->tree_store, &child_iter,
+                       CTK_WINDOW_LABEL_COLUMN, label,
+                       CTK_WINDOW_WIDGET_COLUMN, NULL,
+                       CTK_WINDOW_HELP_COLUMN, NULL,
+                       CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN, NULL,
+                       CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN, select_func,
+                       CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN, unselect_func,
+                       CTK_WINDOW_PAGE_BUILDER_COLUMN, builder,
+                       -1);
+
+    ctk_window->num_lazy_pages++;
+
+} /* add_lazy_page() */
+
+
+
+/*
+ * build_lazy_page() - construct the page of the given row of the tree,
+ * if its construction was deferred by add_lazy_page(), and store it in
+ * the row.  If the page turns out not to be applicable after all, a
+ * placeholder is stored instead.  Returns the page, and its help in
+ * 'help'.
+ */
+
+static GtkWidget *build_lazy_page(CtkWindow *ctk_window, GtkTreeIter *iter,
+                                  GtkTextBuffer **help)
+{
+    GtkTreeModel *model = GTK_TREE_MODEL(ctk_window->tree_store);
+    PageBuilder *builder;
+    GtkWidget *widget;
+    GTimer *timer;
+
+    *help = NULL;
+
+    gtk_tree_model_get(model, iter, CTK_WINDOW_PAGE_BUILDER_COLUMN, &builder,
+                       -1);
+    if (!builder) {
+        return NULL;
+    }
+
+    timer = g_timer_new();
+    nv_profile_begin(builder->label);
+
+    widget = builder->func(builder, help);
+    if (!widget) {
+        widget = gtk_label_new("This page is not available.");
+        *help = NULL;
+        gtk_tree_store_set(ctk_window->tree_store, iter,
+                           CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN, NULL,
+                           CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN, NULL,
+                           -1);
+    }
+
+    /* take ownership of the page, as add_page() does */
+
+    g_object_ref(G_OBJECT(widget));
+    ctk_g_object_ref_sink(G_OBJECT(widget));
+    gtk_widget_show_all(widget);
+
+    gtk_tree_store_set(ctk_window->tree_store, iter,
+                       CTK_WINDOW_WIDGET_COLUMN, widget,
+                       CTK_WINDOW_HELP_COLUMN, *help,
+                       CTK_WINDOW_PAGE_BUILDER_COLUMN, NULL,
+                       -1);
+
+    nv_profile_end();
+    nv_info_msg(NULL, "Created page '%s' in %.3f seconds.", builder->label,
+                g_timer_elapsed(timer, NULL));
+    g_timer_destroy(timer);
+
+    free_page_builder(builder);
+
+    return widget;
+
+} /* build_lazy_page() */
+
+
+
+/*
+ * free_page_builders() - free the PageBuilders left in the tree by
+ * add_lazy_page(), for the pages that were never selected.  The tree
+ * store goes away with the tree view, so this is done when the window
+ * is destroyed, before the tree view is.
+ */
+
+static gboolean free_page_builder_callback(GtkTreeModel *model,
+                                           GtkTreePath *path,
+                                           GtkTreeIter *iter,
+                                           gpointer user_data)
+{
+    PageBuilder *builder;
+
+    gtk_tree_model_get(model, iter, CTK_WINDOW_PAGE_BUILDER_COLUMN, &builder,
+                       -1);
+    if (builder) {
+        gtk_tree_store_set(GTK_TREE_STORE(model), iter,
+                           CTK_WINDOW_PAGE_BUILDER_COLUMN, NULL, -1);
+        free_page_builder(builder);
+    }
+
+    return FALSE; /* keep walking the tree */
+}
+
+static void free_page_builders(CtkWindow *ctk_window)
+{
+    if (!ctk_window->tree_store) {
+        return;
+    }
+
+    gtk_tree_model_foreach(GTK_TREE_MODEL(ctk_window->tree_store),
+                           free_page_builder_callback, NULL);
+
+    /* destroy may run more than once; the store is gone after the first */
+
+    ctk_window->tree_store = NULL;
+
+} /* free_page_builders() */
+
+
+
 /*
  * create_quit_dialog() - create a dialog box to prompt the user
  * whether they really want to quit.
@@ -1588,15 +2022,32 @@ static void select_display_page(UpdateDisplaysData *data, gchar *name)
 }
 
 /*
- * update_display_devices() - Callback handler for the NV_CTRL_PROBE_DISPLAYS
- * NV-CONTROL event.  Updates the list of display devices connected to the
- * GPU for which the event happened.
+ * display_devices_changed() - Callback handler for the NV_CTRL_PROBE_DISPLAYS
+ * and NV_CTRL_MODE_SET_EVENT NV-CONTROL events.  Marks the list of display
+ * devices connected to the GPU as out of date; the list is rebuilt by
+ * update_display_devices() once the GPU's events settle.
+ */
+
+static void display_devices_changed(GtkWidget *object,
+                                    CtrlEvent *event,
+                                    gpointer user_data)
+{
+    UpdateDisplaysData *data = (UpdateDisplaysData *) user_data;
+
+    data->displays_changed = TRUE;
+
+} /* display_devices_changed() */
+
+
+
+/*
+ * update_display_devices() - Callback handler for the CTK_EVENT_SETTLED
+ * signal.  Updates the list of display devices connected to the GPU if
+ * it changed.
  *
  */
 
-static void update_display_devices(GtkWidget *object,
-                                   CtrlEvent *event,
-                                   gpointer user_data)
+static void update_display_devices(GtkWidget *object, gpointer user_data)
 {
     UpdateDisplaysData *data = (UpdateDisplaysData *) user_data;
 
@@ -1612,6 +2063,11 @@ static void update_display_devices(GtkWidget *object,
     gchar *selected_display_name = NULL;
 
 
+    if (!data->displays_changed) {
+        return;
+    }
+    data->displays_changed = FALSE;
+
     /* Keep track if the parent row is expanded */
     parent_path =
         gtk_tree_model_get_path(GTK_TREE_MODEL(ctk_window->tree_store),
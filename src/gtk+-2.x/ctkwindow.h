@@ -78,6 +78,8 @@ struct _CtkWindow
 
     GtkTextTagTable        *help_tag_table;
     GtkTextBuffer          *help_text_buffer;
+
+    int                     num_lazy_pages;
 };
 
 struct _CtkWindowClass
@@ -0,0 +1,363 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * json-writer.c - streaming writer for the machine readable query
+ * output (--output=json|ndjson).
+ *
+ * Each record is assembled in a buffer owned by the writer, which is
+ * reused for every record, and handed to the stdio stream in a single
+ * fwrite(3) once complete; memory use therefore only depends on the
+ * size of the largest record, not on the number of records written.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "json-writer.h"
+#include "common-utils.h"
+
+#define JSON_MAX_DEPTH 16
+
+struct _JsonWriter {
+    FILE *stream;
+    int ndjson;
+    int num_records;
+
+    char *buf;
+    size_t len;
+    size_t size;
+
+    /*
+     * Nesting of the objects and arrays of the current record; first[i]
+     * is true until a value has been added at depth i.
+     */
+    int depth;
+    int first[JSON_MAX_DEPTH];
+};
+
+
+
+static void put(JsonWriter *w, const char *s, size_t n)
+{
+    if (w->len + n > w->size) {
+        w->size = NV_MAX(w->size * 2, w->len + n);
+        w->buf = nvrealloc(w->buf, w->size);
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void put_str(JsonWriter *w, const char *s)
+{
+    put(w, s, strlen(s));
+}
+
+
+
+/*
+ * utf8_length() - returns the length of the well-formed UTF-8 sequence
+ * at 's', or 0 if it is not well-formed (truncated, overlong, a
+ * surrogate, or beyond U+10FFFF).
+ */
+
+static int utf8_length(const unsigned char *s)
+{
+    int len, i;
+    unsigned int cp;
+
+    if (s[0] < 0x80) {
+        return 1;
+    } else if (s[0] >= 0xc2 && s[0] <= 0xdf) {
+        len = 2;
+        cp = s[0] & 0x1f;
+    } else if (s[0] >= 0xe0 && s[0] <= 0xef) {
+        len = 3;
+        cp = s[0] & 0x0f;
+    } else if (s[0] >= 0xf0 && s[0] <= 0xf4) {
+        len = 4;
+        cp = s[0] & 0x07;
+    } else {
+        return 0;
+    }
+
+    for (i = 1; i < len; i++) {
+        if ((s[i] & 0xc0) != 0x80) {
+            return 0;
+        }
+        cp = (cp << 6) | (s[i] & 0x3f);
+    }
+
+    if ((len == 3 && (cp < 0x800 || (cp >= 0xd800 && cp <= 0xdfff))) ||
+        (len == 4 && (cp < 0x10000 || cp > 0x10ffff))) {
+        return 0;
+    }
+
+    return len;
+}
+
+
+
+/*
+ * put_quoted() - append 's' as a JSON string, escaping the characters
+ * that JSON requires to be escaped.  Bytes that are not part of
+ * well-formed UTF-8 are replaced with U+FFFD, so that the output is
+ * always valid JSON.
+ */
+
+static void put_quoted(JsonWriter *w, const char *s)
+{
+    const char *run = s;
+    char esc[8];
+    int len;
+
+    put(w, "\"", 1);
+
+    while (*s) {
+        unsigned char c = (unsigned char) *s;
+
+        if (c >= 0x80) {
+            len = utf8_length((const unsigned char *) s);
+            if (len) {
+                s += len;
+                continue;
+            }
+
+            put(w, run, s - run);
+            put_str(w, "\xef\xbf\xbd");
+            run = ++s;
+            continue;
+        }
+
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            s++;
+            continue;
+        }
+
+        put(w, run, s - run);
+        run = ++s;
+
+        switch (c) {
+        case '"':  put(w, "\\\"", 2); break;
+        case '\\': put(w, "\\\\", 2); break;
+        case '\n': put(w, "\\n", 2); break;
+        case '\r': put(w, "\\r", 2); break;
+        case '\t': put(w, "\\t", 2); break;
+        default:
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            put_str(w, esc);
+            break;
+        }
+    }
+
+    put(w, run, s - run);
+    put(w, "\"", 1);
+}
+
+
+
+/*
+ * begin_value() - write the separator and key that precede a new value
+ * at the current depth.
+ */
+
+static void begin_value(JsonWriter *w, const char *key)
+{
+    if (w->depth > 0 && w->depth <= JSON_MAX_DEPTH) {
+        if (!w->first[w->depth - 1]) {
+            put(w, ",", 1);
+        }
+        w->first[w->depth - 1] = FALSE;
+    }
+
+    if (key) {
+        put_quoted(w, key);
+        put(w, ":", 1);
+    }
+}
+
+static void push(JsonWriter *w, const char *open)
+{
+    put_str(w, open);
+    if (w->depth < JSON_MAX_DEPTH) {
+        w->first[w->depth] = TRUE;
+    }
+    w->depth++;
+}
+
+static void pop(JsonWriter *w, const char *close)
+{
+    w->depth--;
+    put_str(w, close);
+}
+
+
+
+JsonWriter *nv_json_writer_create(FILE *stream, int ndjson)
+{
+    JsonWriter *w = nvalloc(sizeof(JsonWriter));
+
+    w->stream = stream;
+    w->ndjson = ndjson;
+    w->size = 1024;
+    w->buf = nvalloc(w->size);
+
+    if (!ndjson) {
+        fputs("[", stream);
+    }
+
+    return w;
+}
+
+
+
+/*
+ * nv_json_writer_close() - terminate the output and free the writer.
+ */
+
+void nv_json_writer_close(JsonWriter *w)
+{
+    if (!w) {
+        return;
+    }
+
+    if (!w->ndjson) {
+        fputs(w->num_records ? "\n]\n" : "]\n", w->stream);
+    }
+    fflush(w->stream);
+
+    nvfree(w->buf);
+    nvfree(w);
+}
+
+
+
+/*
+ * nv_json_writer_flush() - pass the records written so far on to the
+ * reader, e.g. once all records of a target are written.
+ */
+
+void nv_json_writer_flush(JsonWriter *w)
+{
+    fflush(w->stream);
+}
+
+
+
+void nv_json_begin_record(JsonWriter *w)
+{
+    w->len = 0;
+    w->depth = 0;
+
+    if (!w->ndjson) {
+        put_str(w, w->num_records ? ",\n" : "\n");
+    }
+
+    push(w, "{");
+}
+
+void nv_json_end_record(JsonWriter *w)
+{
+    pop(w, "}");
+
+    if (w->ndjson) {
+        put(w, "\n", 1);
+    }
+
+    fwrite(w->buf, 1, w->len, w->stream);
+    w->num_records++;
+}
+
+
+
+/*
+ * nv_json_add_record_text() - write a record that was already formatted
+ * as JSON text, e.g. one line of another writer's ndjson output.
+ */
+
+void nv_json_add_record_text(JsonWriter *w, const char *text, size_t len)
+{
+    w->len = 0;
+
+    if (!w->ndjson) {
+        put_str(w, w->num_records ? ",\n" : "\n");
+    }
+
+    put(w, text, len);
+
+    if (w->ndjson) {
+        put(w, "\n", 1);
+    }
+
+    fwrite(w->buf, 1, w->len, w->stream);
+    w->num_records++;
+}
+
+
+
+void nv_json_begin_object(JsonWriter *w, const char *key)
+{
+    begin_value(w, key);
+    push(w, "{");
+}
+
+void nv_json_end_object(JsonWriter *w)
+{
+    pop(w, "}");
+}
+
+void nv_json_begin_array(JsonWriter *w, const char *key)
+{
+    begin_value(w, key);
+    push(w, "[");
+}
+
+void nv_json_end_array(JsonWriter *w)
+{
+    pop(w, "]");
+}
+
+
+
+void nv_json_add_string(JsonWriter *w, const char *key, const char *val)
+{
+    begin_value(w, key);
+    if (val) {
+        put_quoted(w, val);
+    } else {
+        put_str(w, "null");
+    }
+}
+
+void nv_json_add_int(JsonWriter *w, const char *key, int64_t val)
+{
+    char str[32];
+
+    begin_value(w, key);
+    snprintf(str, sizeof(str), "%" PRId64, val);
+    put_str(w, str);
+}
+
+void nv_json_add_bool(JsonWriter *w, const char *key, int val)
+{
+    begin_value(w, key);
+    put_str(w, val ? "true" : "false");
+}
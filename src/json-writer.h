@@ -0,0 +1,55 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+#ifndef __JSON_WRITER_H__
+#define __JSON_WRITER_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Writes a stream of JSON objects ("records"), either as the elements
+ * of a single JSON array or as newline-delimited JSON (one object per
+ * line).
+ */
+
+typedef struct _JsonWriter JsonWriter;
+
+JsonWriter *nv_json_writer_create(FILE *stream, int ndjson);
+void nv_json_writer_close(JsonWriter *w);
+void nv_json_writer_flush(JsonWriter *w);
+
+void nv_json_begin_record(JsonWriter *w);
+void nv_json_end_record(JsonWriter *w);
+void nv_json_add_record_text(JsonWriter *w, const char *text, size_t len);
+
+void nv_json_begin_object(JsonWriter *w, const char *key);
+void nv_json_end_object(JsonWriter *w);
+void nv_json_begin_array(JsonWriter *w, const char *key);
+void nv_json_end_array(JsonWriter *w);
+
+/*
+ * Add a member to the current object, or an element to the current
+ * array if 'key' is NULL.
+ */
+void nv_json_add_string(JsonWriter *w, const char *key, const char *val);
+void nv_json_add_int(JsonWriter *w, const char *key, int64_t val);
+void nv_json_add_bool(JsonWriter *w, const char *key, int val);
+
+#endif /* __JSON_WRITER_H__ */
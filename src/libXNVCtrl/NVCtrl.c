@@ -130,8 +130,12 @@ static uintptr_t version_flags(Display *dpy, XExtDisplayInfo *info)
 {
     uintptr_t data = (uintptr_t)info->data;
 
-    /* If necessary, determine the NV-CONTROL version */
-    if (data & NVCTRL_EXT_NEED_CHECK) {
+    /*
+     * If necessary, determine the NV-CONTROL version.  NVCTRL_EXT_NEED_CHECK
+     * has every bit set, so compare rather than mask, or the version would
+     * be queried again on every call.
+     */
+    if (data == NVCTRL_EXT_NEED_CHECK) {
         int major, minor;
         data = 0;
         if (XNVCTRLQueryVersion(dpy, &major, &minor)) {
@@ -439,6 +443,940 @@ Bool XNVCTRLQueryTargetAttribute64 (
 }
 
 
+/*
+ * State shared with QueryAttributesHandler() while the replies to a
+ * batch of pipelined NV-CONTROL attribute queries are collected.
+ */
+
+typedef struct {
+    unsigned long start_seq;
+    unsigned long stop_seq;
+    Bool is_64;
+    void *values;
+    Bool *status;
+} QueryAttributesState;
+
+static Bool QueryAttributesHandler (
+    Display *dpy,
+    xReply *rep,
+    char *buf,
+    int len,
+    XPointer data
+){
+    QueryAttributesState *state = (QueryAttributesState *)data;
+    unsigned long idx;
+    Bool exists;
+
+    if (dpy->last_request_read < state->start_seq ||
+        dpy->last_request_read >= state->stop_seq) {
+        return False;
+    }
+
+    /* Let the regular error handling deal with protocol errors */
+    if (rep->generic.type == X_Error) {
+        return False;
+    }
+
+    idx = dpy->last_request_read - state->start_seq;
+
+    if (state->is_64) {
+        xnvCtrlQueryAttribute64Reply replbuf;
+        xnvCtrlQueryAttribute64Reply *repl;
+
+        repl = (xnvCtrlQueryAttribute64Reply *)
+            _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                            (SIZEOF(xnvCtrlQueryAttribute64Reply) -
+                             SIZEOF(xReply)) >> 2, True);
+        exists = repl->flags;
+        if (exists && state->values) {
+            ((int64_t *)state->values)[idx] = repl->value_64;
+        }
+    } else {
+        xnvCtrlQueryAttributeReply replbuf;
+        xnvCtrlQueryAttributeReply *repl;
+
+        repl = (xnvCtrlQueryAttributeReply *)
+            _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                            (SIZEOF(xnvCtrlQueryAttributeReply) -
+                             SIZEOF(xReply)) >> 2, True);
+        exists = repl->flags;
+        if (exists && state->values) {
+            ((int *)state->values)[idx] = repl->value;
+        }
+    }
+
+    if (state->status) state->status[idx] = exists;
+
+    return True;
+}
+
+/*
+ * Send all n queries before reading any replies; the replies to all but
+ * the last request are consumed by QueryAttributesHandler() as they
+ * arrive, and the last one is waited on with _XReply(), so the whole
+ * batch costs a single round trip.
+ */
+
+static Bool QueryTargetAttributesInternal (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    int n,
+    const unsigned int *attributes,
+    void *values,
+    Bool *status,
+    Bool is_64
+){
+    XExtDisplayInfo *info = find_display (dpy);
+    xnvCtrlQueryAttributeReq *req;
+    QueryAttributesState state;
+    _XAsyncHandler async;
+    Bool exists;
+    int i;
+
+    if (status) {
+        for (i = 0; i < n; i++) {
+            status[i] = False;
+        }
+    }
+
+    if (n <= 0 || !attributes)
+        return False;
+
+    if(!XextHasExtension(info))
+        return False;
+
+    XNVCTRLCheckExtension (dpy, info, False);
+    XNVCTRLCheckTargetData(dpy, info, &target_type, &target_id);
+
+    LockDisplay (dpy);
+
+    state.start_seq = dpy->request + 1;
+    state.stop_seq = state.start_seq + n - 1;
+    state.is_64 = is_64;
+    state.values = values;
+    state.status = status;
+
+    async.next = dpy->async_handlers;
+    async.handler = QueryAttributesHandler;
+    async.data = (XPointer)&state;
+    dpy->async_handlers = &async;
+
+    for (i = 0; i < n; i++) {
+        GetReq (nvCtrlQueryAttribute, req);
+        req->reqType = info->codes->major_opcode;
+        req->nvReqType = is_64 ? X_nvCtrlQueryAttribute64 :
+                                 X_nvCtrlQueryAttribute;
+        req->target_type = target_type;
+        req->target_id = target_id;
+        req->display_mask = display_mask;
+        req->attribute = attributes[i];
+    }
+
+    if (is_64) {
+        xnvCtrlQueryAttribute64Reply rep;
+
+        exists = _XReply (dpy, (xReply *) &rep, 0, xTrue) && rep.flags;
+        if (exists && values) ((int64_t *)values)[n-1] = rep.value_64;
+    } else {
+        xnvCtrlQueryAttributeReply rep;
+
+        exists = _XReply (dpy, (xReply *) &rep, 0, xTrue) && rep.flags;
+        if (exists && values) ((int *)values)[n-1] = rep.value;
+    }
+    if (status) status[n-1] = exists;
+
+    DeqAsyncHandler (dpy, &async);
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return True;
+}
+
+Bool XNVCTRLQueryTargetAttributes (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    int n,
+    const unsigned int *attributes,
+    int *values,
+    Bool *status
+){
+    return QueryTargetAttributesInternal(dpy, target_type, target_id,
+                                         display_mask, n, attributes,
+                                         values, status, False);
+}
+
+Bool XNVCTRLQueryTargetAttributes64 (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    int n,
+    const unsigned int *attributes,
+    int64_t *values,
+    Bool *status
+){
+    return QueryTargetAttributesInternal(dpy, target_type, target_id,
+                                         display_mask, n, attributes,
+                                         values, status, True);
+}
+
+
+/*
+ * State shared with QueryBatchHandler() while the replies to a batch of
+ * pipelined NV-CONTROL queries are collected.
+ */
+
+typedef struct {
+    unsigned long start_seq;
+    unsigned long stop_seq;
+    XNVCTRLQuery *queries;
+} QueryBatchState;
+
+static Bool QueryBatchHandler (
+    Display *dpy,
+    xReply *rep,
+    char *buf,
+    int len,
+    XPointer data
+){
+    QueryBatchState *state = (QueryBatchState *)data;
+    XNVCTRLQuery *query;
+
+    if (dpy->last_request_read < state->start_seq ||
+        dpy->last_request_read >= state->stop_seq) {
+        return False;
+    }
+
+    /* Let the regular error handling deal with protocol errors */
+    if (rep->generic.type == X_Error) {
+        return False;
+    }
+
+    query = &state->queries[dpy->last_request_read - state->start_seq];
+
+    switch (query->type) {
+    case XNVCTRL_QUERY_STRING:
+        {
+            xnvCtrlQueryStringAttributeReply replbuf;
+            xnvCtrlQueryStringAttributeReply *repl;
+            int numbytes;
+
+            repl = (xnvCtrlQueryStringAttributeReply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryStringAttributeReply) -
+                                 SIZEOF(xReply)) >> 2, False);
+            numbytes = repl->n;
+
+            if (repl->flags && numbytes >= 0 &&
+                numbytes <= (int)(repl->length << 2)) {
+                query->string = (char *) Xmalloc(numbytes + 1);
+            }
+
+            if (query->string) {
+                _XGetAsyncData(dpy, query->string, buf, len,
+                               SIZEOF(xnvCtrlQueryStringAttributeReply),
+                               numbytes, repl->length << 2);
+                query->string[numbytes] = '\0';
+                query->exists = True;
+            } else {
+                _XGetAsyncData(dpy, NULL, buf, len,
+                               SIZEOF(xnvCtrlQueryStringAttributeReply),
+                               0, repl->length << 2);
+            }
+        }
+        break;
+
+    case XNVCTRL_QUERY_INTEGER_64:
+        {
+            xnvCtrlQueryAttribute64Reply replbuf;
+            xnvCtrlQueryAttribute64Reply *repl;
+
+            repl = (xnvCtrlQueryAttribute64Reply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryAttribute64Reply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            query->exists = repl->flags;
+            if (query->exists) {
+                query->value = repl->value_64;
+            }
+        }
+        break;
+
+    default:
+        /*
+         * The SetAttributeAndGetStatus reply puts its flags in the same
+         * place as the integer query reply, and leaves value zeroed.
+         */
+        {
+            xnvCtrlQueryAttributeReply replbuf;
+            xnvCtrlQueryAttributeReply *repl;
+
+            repl = (xnvCtrlQueryAttributeReply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryAttributeReply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            query->exists = repl->flags;
+            if (query->exists) {
+                query->value = repl->value;
+            }
+        }
+        break;
+    }
+
+    return True;
+}
+
+/*
+ * Send all n queries, followed by a GetInputFocus request (as XSync()
+ * does), before reading any replies.  The query replies are consumed by
+ * QueryBatchHandler() as they arrive, and the GetInputFocus reply is
+ * waited on with _XReply(), so the whole batch costs a single round trip
+ * no matter how many targets and attributes it covers.
+ */
+
+Bool XNVCTRLQueryBatch (
+    Display *dpy,
+    int n,
+    XNVCTRLQuery *queries
+){
+    XExtDisplayInfo *info = find_display (dpy);
+    QueryBatchState state;
+    _XAsyncHandler async;
+    xGetInputFocusReply rep;
+    xReq *sync_req;
+    Bool swap;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        queries[i].exists = False;
+        queries[i].value = 0;
+        queries[i].string = NULL;
+    }
+
+    if (n <= 0 || !queries)
+        return False;
+
+    if(!XextHasExtension(info))
+        return False;
+
+    XNVCTRLCheckExtension (dpy, info, False);
+
+    /* version_flags() may need a round trip of its own; do it up front */
+    swap = (version_flags(dpy, info) & NVCTRL_EXT_NEED_TARGET_SWAP) != 0;
+
+    LockDisplay (dpy);
+
+    state.start_seq = dpy->request + 1;
+    state.stop_seq = state.start_seq + n;
+    state.queries = queries;
+
+    async.next = dpy->async_handlers;
+    async.handler = QueryBatchHandler;
+    async.data = (XPointer)&state;
+    dpy->async_handlers = &async;
+
+    for (i = 0; i < n; i++) {
+        int target_type = swap ? queries[i].target_id : queries[i].target_type;
+        int target_id = swap ? queries[i].target_type : queries[i].target_id;
+
+        if (queries[i].type == XNVCTRL_QUERY_STRING) {
+            xnvCtrlQueryStringAttributeReq *req;
+
+            GetReq (nvCtrlQueryStringAttribute, req);
+            req->reqType = info->codes->major_opcode;
+            req->nvReqType = X_nvCtrlQueryStringAttribute;
+            req->target_type = target_type;
+            req->target_id = target_id;
+            req->display_mask = queries[i].display_mask;
+            req->attribute = queries[i].attribute;
+        } else {
+            xnvCtrlQueryAttributeReq *req;
+
+            GetReq (nvCtrlQueryAttribute, req);
+            req->reqType = info->codes->major_opcode;
+            req->nvReqType =
+                (queries[i].type == XNVCTRL_QUERY_INTEGER_64) ?
+                X_nvCtrlQueryAttribute64 : X_nvCtrlQueryAttribute;
+            req->target_type = target_type;
+            req->target_id = target_id;
+            req->display_mask = queries[i].display_mask;
+            req->attribute = queries[i].attribute;
+        }
+    }
+
+    GetEmptyReq (GetInputFocus, sync_req);
+    (void) sync_req;
+    (void) _XReply (dpy, (xReply *) &rep, 0, xTrue);
+
+    DeqAsyncHandler (dpy, &async);
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return True;
+}
+
+
+/*
+ * Split-phase queries.  A cookie's async handler stays on the display's
+ * list from the time its request is sent until its reply (or error) is
+ * read, which may happen while Xlib is waiting for any later reply.  The
+ * result is kept in the cookie until the matching XNVCTRLWait*() call.
+ */
+
+#define COOKIE_INTEGER          0
+#define COOKIE_INTEGER_64       1
+#define COOKIE_STRING           2
+#define COOKIE_BINARY           3
+#define COOKIE_VALID_VALUES     4
+#define COOKIE_VALID_VALUES_64  5
+#define COOKIE_SET              6
+#define COOKIE_TARGET_COUNT     7
+
+static const CARD8 cookieReqTypes[] = {
+    [COOKIE_INTEGER]         = X_nvCtrlQueryAttribute,
+    [COOKIE_INTEGER_64]      = X_nvCtrlQueryAttribute64,
+    [COOKIE_STRING]          = X_nvCtrlQueryStringAttribute,
+    [COOKIE_BINARY]          = X_nvCtrlQueryBinaryData,
+    [COOKIE_VALID_VALUES]    = X_nvCtrlQueryValidAttributeValues,
+    [COOKIE_VALID_VALUES_64] = X_nvCtrlQueryValidAttributeValues64,
+    [COOKIE_SET]             = X_nvCtrlSetAttributeAndGetStatus,
+    [COOKIE_TARGET_COUNT]    = X_nvCtrlQueryTargetCount,
+};
+
+struct _XNVCTRLCookieRec {
+    _XAsyncHandler async;
+    unsigned long sequence;
+    int kind;                   /* COOKIE_* */
+    Bool done;
+
+    Bool exists;
+    int64_t value;
+    char *data;
+    int len;
+    NVCTRLAttributeValidValuesRec valid;
+};
+
+/*
+ * Reads the variable length data following a string or binary data
+ * reply into the cookie; the data is NUL terminated so that it can be
+ * returned as a string.
+ */
+
+static void CookieGetData (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    xReply *rep,
+    char *buf,
+    int len
+){
+    xnvCtrlQueryStringAttributeReply replbuf;
+    xnvCtrlQueryStringAttributeReply *repl;
+    int numbytes;
+
+    /* The string and binary data replies share the same layout */
+    repl = (xnvCtrlQueryStringAttributeReply *)
+        _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                        (SIZEOF(xnvCtrlQueryStringAttributeReply) -
+                         SIZEOF(xReply)) >> 2, False);
+    numbytes = repl->n;
+
+    if (repl->flags && numbytes >= 0 &&
+        numbytes <= (int)(repl->length << 2)) {
+        cookie->data = (char *) Xmalloc(numbytes + 1);
+    }
+
+    if (cookie->data) {
+        _XGetAsyncData(dpy, cookie->data, buf, len,
+                       SIZEOF(xnvCtrlQueryStringAttributeReply),
+                       numbytes, repl->length << 2);
+        cookie->data[numbytes] = '\0';
+        cookie->len = numbytes;
+        cookie->exists = True;
+    } else {
+        _XGetAsyncData(dpy, NULL, buf, len,
+                       SIZEOF(xnvCtrlQueryStringAttributeReply),
+                       0, repl->length << 2);
+    }
+}
+
+static Bool CookieHandler (
+    Display *dpy,
+    xReply *rep,
+    char *buf,
+    int len,
+    XPointer data
+){
+    XNVCTRLCookie cookie = (XNVCTRLCookie)data;
+
+    if (dpy->last_request_read != cookie->sequence) {
+        return False;
+    }
+
+    cookie->done = True;
+    DeqAsyncHandler (dpy, &cookie->async);
+
+    /* Let the regular error handling deal with protocol errors */
+    if (rep->generic.type == X_Error) {
+        return False;
+    }
+
+    switch (cookie->kind) {
+    case COOKIE_STRING:
+    case COOKIE_BINARY:
+        CookieGetData(dpy, cookie, rep, buf, len);
+        break;
+
+    case COOKIE_INTEGER_64:
+        {
+            xnvCtrlQueryAttribute64Reply replbuf;
+            xnvCtrlQueryAttribute64Reply *repl;
+
+            repl = (xnvCtrlQueryAttribute64Reply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryAttribute64Reply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            cookie->exists = repl->flags;
+            cookie->value = repl->value_64;
+        }
+        break;
+
+    case COOKIE_VALID_VALUES:
+        {
+            xnvCtrlQueryValidAttributeValuesReply replbuf;
+            xnvCtrlQueryValidAttributeValuesReply *repl;
+
+            repl = (xnvCtrlQueryValidAttributeValuesReply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryValidAttributeValuesReply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            cookie->exists = repl->flags;
+            cookie->valid.type = repl->attr_type;
+            if (repl->attr_type == ATTRIBUTE_TYPE_RANGE) {
+                cookie->valid.u.range.min = repl->min;
+                cookie->valid.u.range.max = repl->max;
+            }
+            if (repl->attr_type == ATTRIBUTE_TYPE_INT_BITS) {
+                cookie->valid.u.bits.ints = repl->bits;
+            }
+            cookie->valid.permissions = repl->perms;
+        }
+        break;
+
+    case COOKIE_VALID_VALUES_64:
+        {
+            xnvCtrlQueryValidAttributeValues64Reply replbuf;
+            xnvCtrlQueryValidAttributeValues64Reply *repl;
+
+            repl = (xnvCtrlQueryValidAttributeValues64Reply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryValidAttributeValues64Reply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            cookie->exists = repl->flags;
+            cookie->valid.type = repl->attr_type;
+            if (repl->attr_type == ATTRIBUTE_TYPE_RANGE) {
+                cookie->valid.u.range.min = repl->min_64;
+                cookie->valid.u.range.max = repl->max_64;
+            }
+            if (repl->attr_type == ATTRIBUTE_TYPE_INT_BITS) {
+                cookie->valid.u.bits.ints = repl->bits_64;
+            }
+            cookie->valid.permissions = repl->perms;
+        }
+        break;
+
+    case COOKIE_TARGET_COUNT:
+        {
+            xnvCtrlQueryTargetCountReply replbuf;
+            xnvCtrlQueryTargetCountReply *repl;
+
+            repl = (xnvCtrlQueryTargetCountReply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryTargetCountReply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            cookie->exists = True;
+            cookie->value = repl->count;
+        }
+        break;
+
+    default:
+        {
+            xnvCtrlQueryAttributeReply replbuf;
+            xnvCtrlQueryAttributeReply *repl;
+
+            repl = (xnvCtrlQueryAttributeReply *)
+                _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+                                (SIZEOF(xnvCtrlQueryAttributeReply) -
+                                 SIZEOF(xReply)) >> 2, True);
+            cookie->exists = repl->flags;
+            cookie->value = repl->value;
+        }
+        break;
+    }
+
+    return True;
+}
+
+/*
+ * Ties the cookie to the request that was just added to the output
+ * buffer, and installs its async reply handler; called with the display
+ * locked.
+ */
+
+static void QueueCookie (
+    Display *dpy,
+    XNVCTRLCookie cookie
+){
+    cookie->sequence = dpy->request;
+    cookie->async.next = dpy->async_handlers;
+    cookie->async.handler = CookieHandler;
+    cookie->async.data = (XPointer)cookie;
+    dpy->async_handlers = &cookie->async;
+}
+
+static XNVCTRLCookie SendQuery (
+    Display *dpy,
+    int kind,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+){
+    XExtDisplayInfo *info = find_display (dpy);
+    xnvCtrlQueryAttributeReq *req;
+    XNVCTRLCookie cookie;
+
+    if(!XextHasExtension(info))
+        return NULL;
+
+    XNVCTRLCheckExtension (dpy, info, NULL);
+    XNVCTRLCheckTargetData(dpy, info, &target_type, &target_id);
+
+    if (kind == COOKIE_VALID_VALUES) {
+        uintptr_t flags = version_flags(dpy, info);
+
+        if (!(flags & NVCTRL_EXT_EXISTS))
+            return NULL;
+
+        if (flags & NVCTRL_EXT_64_BIT_ATTRIBUTES)
+            kind = COOKIE_VALID_VALUES_64;
+    }
+
+    cookie = (XNVCTRLCookie) Xcalloc(1, sizeof(*cookie));
+    if (!cookie)
+        return NULL;
+
+    cookie->kind = kind;
+
+    LockDisplay (dpy);
+
+    /* All of the NV-CONTROL query requests share the same layout */
+    GetReq (nvCtrlQueryAttribute, req);
+    req->reqType = info->codes->major_opcode;
+    req->nvReqType = cookieReqTypes[kind];
+    req->target_type = target_type;
+    req->target_id = target_id;
+    req->display_mask = display_mask;
+    req->attribute = attribute;
+
+    QueueCookie(dpy, cookie);
+
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return cookie;
+}
+
+/*
+ * Waits for the cookie's reply by making a round trip, unless the reply
+ * was already read while waiting for some other reply.  Returns whether
+ * the queried attribute exists; the caller frees the cookie.
+ */
+
+static Bool WaitQuery (
+    Display *dpy,
+    XNVCTRLCookie cookie
+){
+    LockDisplay (dpy);
+
+    if (!cookie->done) {
+        xGetInputFocusReply rep;
+        xReq *sync_req;
+
+        GetEmptyReq (GetInputFocus, sync_req);
+        (void) sync_req;
+        (void) _XReply (dpy, (xReply *) &rep, 0, xTrue);
+
+        /* Should not happen; don't leave a dangling handler behind */
+        if (!cookie->done) {
+            DeqAsyncHandler (dpy, &cookie->async);
+        }
+    }
+
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return cookie->done && cookie->exists;
+}
+
+XNVCTRLCookie XNVCTRLSendQueryTargetCount (
+    Display *dpy,
+    int target_type
+){
+    XExtDisplayInfo *info = find_display (dpy);
+    xnvCtrlQueryTargetCountReq *req;
+    XNVCTRLCookie cookie;
+
+    if(!XextHasExtension(info))
+        return NULL;
+
+    XNVCTRLCheckExtension (dpy, info, NULL);
+
+    cookie = (XNVCTRLCookie) Xcalloc(1, sizeof(*cookie));
+    if (!cookie)
+        return NULL;
+
+    cookie->kind = COOKIE_TARGET_COUNT;
+
+    LockDisplay (dpy);
+    GetReq (nvCtrlQueryTargetCount, req);
+    req->reqType = info->codes->major_opcode;
+    req->nvReqType = cookieReqTypes[COOKIE_TARGET_COUNT];
+    req->target_type = target_type;
+
+    QueueCookie(dpy, cookie);
+
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return cookie;
+}
+
+Bool XNVCTRLWaitQueryTargetCount (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    int *value
+){
+    Bool exists;
+
+    if (!cookie) return False;
+
+    exists = WaitQuery(dpy, cookie);
+    if (exists && value) *value = cookie->value;
+    Xfree(cookie);
+    return exists;
+}
+
+XNVCTRLCookie XNVCTRLSendQueryTargetAttribute (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+){
+    return SendQuery(dpy, COOKIE_INTEGER, target_type, target_id,
+                     display_mask, attribute);
+}
+
+Bool XNVCTRLWaitQueryTargetAttribute (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    int *value
+){
+    Bool exists;
+
+    if (!cookie) return False;
+
+    exists = WaitQuery(dpy, cookie);
+    if (exists && value) *value = cookie->value;
+    Xfree(cookie);
+    return exists;
+}
+
+XNVCTRLCookie XNVCTRLSendQueryTargetAttribute64 (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+){
+    return SendQuery(dpy, COOKIE_INTEGER_64, target_type, target_id,
+                     display_mask, attribute);
+}
+
+Bool XNVCTRLWaitQueryTargetAttribute64 (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    int64_t *value
+){
+    Bool exists;
+
+    if (!cookie) return False;
+
+    exists = WaitQuery(dpy, cookie);
+    if (exists && value) *value = cookie->value;
+    Xfree(cookie);
+    return exists;
+}
+
+XNVCTRLCookie XNVCTRLSendQueryTargetStringAttribute (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+){
+    return SendQuery(dpy, COOKIE_STRING, target_type, target_id,
+                     display_mask, attribute);
+}
+
+Bool XNVCTRLWaitQueryTargetStringAttribute (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    char **ptr
+){
+    Bool exists;
+
+    if (!cookie) return False;
+
+    exists = WaitQuery(dpy, cookie);
+    if (exists && ptr) {
+        *ptr = cookie->data;
+    } else if (cookie->data) {
+        Xfree(cookie->data);
+    }
+    Xfree(cookie);
+    return exists;
+}
+
+XNVCTRLCookie XNVCTRLSendQueryTargetBinaryData (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+){
+    return SendQuery(dpy, COOKIE_BINARY, target_type, target_id,
+                     display_mask, attribute);
+}
+
+Bool XNVCTRLWaitQueryTargetBinaryData (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    unsigned char **ptr,
+    int *len
+){
+    Bool exists;
+
+    if (!cookie) return False;
+
+    exists = WaitQuery(dpy, cookie);
+    if (exists && ptr) {
+        *ptr = (unsigned char *) cookie->data;
+        if (len) *len = cookie->len;
+    } else if (cookie->data) {
+        Xfree(cookie->data);
+    }
+    Xfree(cookie);
+    return exists;
+}
+
+XNVCTRLCookie XNVCTRLSendQueryValidTargetAttributeValues (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+){
+    return SendQuery(dpy, COOKIE_VALID_VALUES, target_type, target_id,
+                     display_mask, attribute);
+}
+
+Bool XNVCTRLWaitQueryValidTargetAttributeValues (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    NVCTRLAttributeValidValuesRec *values
+){
+    Bool exists;
+
+    if (!cookie) return False;
+
+    exists = WaitQuery(dpy, cookie);
+    if (exists && values) *values = cookie->valid;
+    Xfree(cookie);
+    return exists;
+}
+
+
+XNVCTRLCookie XNVCTRLSendSetTargetAttributeAndGetStatus (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute,
+    int value
+){
+    XExtDisplayInfo *info = find_display (dpy);
+    xnvCtrlSetAttributeAndGetStatusReq *req;
+    XNVCTRLCookie cookie;
+    uintptr_t flags;
+
+    if(!XextHasExtension(info))
+        return NULL;
+
+    flags = version_flags(dpy, info);
+
+    if (!(flags & NVCTRL_EXT_EXISTS))
+        return NULL;
+
+    if (!(flags & NVCTRL_EXT_HAS_TARGET_SET_GET) &&
+        target_type != NV_CTRL_TARGET_TYPE_X_SCREEN)
+        return NULL;
+
+    XNVCTRLCheckExtension (dpy, info, NULL);
+
+    cookie = (XNVCTRLCookie) Xcalloc(1, sizeof(*cookie));
+    if (!cookie)
+        return NULL;
+
+    cookie->kind = COOKIE_SET;
+
+    LockDisplay (dpy);
+
+    GetReq (nvCtrlSetAttributeAndGetStatus, req);
+    req->reqType = info->codes->major_opcode;
+    req->nvReqType = cookieReqTypes[COOKIE_SET];
+    req->target_type = target_type;
+    req->target_id = target_id;
+    req->display_mask = display_mask;
+    req->attribute = attribute;
+    req->value = value;
+
+    QueueCookie(dpy, cookie);
+
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return cookie;
+}
+
+Bool XNVCTRLWaitSetTargetAttributeAndGetStatus (
+    Display *dpy,
+    XNVCTRLCookie cookie
+){
+    Bool success;
+
+    if (!cookie) return False;
+
+    success = WaitQuery(dpy, cookie);
+    Xfree(cookie);
+    return success;
+}
+
+
 Bool XNVCTRLQueryTargetStringAttribute (
     Display *dpy,
     int target_type,
@@ -265,6 +265,231 @@ Bool XNVCTRLQueryTargetAttribute64 (
 );
 
 
+/*
+ * XNVCTRLQueryTargetAttributes -
+ *
+ *  Queries the n integer attributes listed in attributes on the given
+ *  target and display_mask.  All n requests are sent before any reply
+ *  is read, so the whole batch costs a single round trip to the X
+ *  server rather than one round trip per attribute.
+ *
+ *  Returns False if the NV-CONTROL extension is not available;
+ *  otherwise returns True, and for each index i sets status[i] to
+ *  whether attributes[i] exists and, if it does, values[i] to its
+ *  value.  Either values or status may be NULL.
+ *
+ *  Possible errors (reported per request through the error handler):
+ *     BadValue - The target doesn't exist.
+ *     BadMatch - The NVIDIA driver does not control the target.
+ */
+
+Bool XNVCTRLQueryTargetAttributes (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    int n,
+    const unsigned int *attributes,
+    int *values,
+    Bool *status
+);
+
+
+/*
+ * XNVCTRLQueryTargetAttributes64 -
+ *
+ *  Like XNVCTRLQueryTargetAttributes(), but supports 64-bit integer
+ *  attributes.
+ */
+
+Bool XNVCTRLQueryTargetAttributes64 (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    int n,
+    const unsigned int *attributes,
+    int64_t *values,
+    Bool *status
+);
+
+
+/*
+ * XNVCTRLQueryBatch -
+ *
+ *  Performs the n queries described in queries, which may be for any
+ *  targets, display masks and mix of integer and string attributes.
+ *  All n requests are sent before any reply is read, so the whole batch
+ *  costs a single round trip to the X server rather than one round trip
+ *  per query.
+ *
+ *  Returns False if the NV-CONTROL extension is not available;
+ *  otherwise returns True, and sets the exists field of each query and,
+ *  if the attribute exists, its value (integer queries) or string
+ *  (string queries).  The strings should be freed with XFree().
+ *
+ *  Possible errors (reported per request through the error handler):
+ *     BadValue - A target doesn't exist.
+ *     BadMatch - The NVIDIA driver does not control a target.
+ */
+
+#define XNVCTRL_QUERY_INTEGER    0
+#define XNVCTRL_QUERY_INTEGER_64 1
+#define XNVCTRL_QUERY_STRING     2
+
+typedef struct {
+    int type;                   /* XNVCTRL_QUERY_* */
+    int target_type;
+    int target_id;
+    unsigned int display_mask;
+    unsigned int attribute;
+
+    Bool exists;                /* set by XNVCTRLQueryBatch() */
+    int64_t value;
+    char *string;
+} XNVCTRLQuery;
+
+Bool XNVCTRLQueryBatch (
+    Display *dpy,
+    int n,
+    XNVCTRLQuery *queries
+);
+
+
+/*
+ * Split-phase queries -
+ *
+ *  Each XNVCTRLSend* function below sends one request and returns a
+ *  cookie for its reply without waiting for the X server.  The matching
+ *  XNVCTRLWait* function waits for the reply (if it has not already been
+ *  received), returns the same result as the corresponding blocking
+ *  query, and frees the cookie.  Any number of requests may be in flight
+ *  at once, so a client can send all of its queries first and then wait
+ *  for them, paying for a single round trip.
+ *
+ *  Every cookie must be passed to its XNVCTRLWait* function exactly once,
+ *  before the display is closed.  The Send functions return NULL if the
+ *  NV-CONTROL extension is not available or memory could not be
+ *  allocated; passing a NULL cookie to a Wait function returns False.
+ *  Result pointers passed to the Wait functions may be NULL if the
+ *  caller is not interested in the value.
+ *
+ *  Possible errors (reported through the error handler when the reply
+ *  is read):
+ *     BadValue - The target doesn't exist.
+ *     BadMatch - The NVIDIA driver does not control the target.
+ */
+
+typedef struct _XNVCTRLCookieRec *XNVCTRLCookie;
+
+XNVCTRLCookie XNVCTRLSendQueryTargetCount (
+    Display *dpy,
+    int target_type
+);
+
+Bool XNVCTRLWaitQueryTargetCount (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    int *value
+);
+
+XNVCTRLCookie XNVCTRLSendQueryTargetAttribute (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+);
+
+Bool XNVCTRLWaitQueryTargetAttribute (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    int *value
+);
+
+XNVCTRLCookie XNVCTRLSendQueryTargetAttribute64 (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+);
+
+Bool XNVCTRLWaitQueryTargetAttribute64 (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    int64_t *value
+);
+
+XNVCTRLCookie XNVCTRLSendQueryTargetStringAttribute (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+);
+
+Bool XNVCTRLWaitQueryTargetStringAttribute (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    char **ptr                  /* free with XFree() */
+);
+
+XNVCTRLCookie XNVCTRLSendQueryTargetBinaryData (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+);
+
+Bool XNVCTRLWaitQueryTargetBinaryData (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    unsigned char **ptr,        /* free with XFree() */
+    int *len
+);
+
+XNVCTRLCookie XNVCTRLSendQueryValidTargetAttributeValues (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute
+);
+
+Bool XNVCTRLWaitQueryValidTargetAttributeValues (
+    Display *dpy,
+    XNVCTRLCookie cookie,
+    NVCTRLAttributeValidValuesRec *values
+);
+
+/*
+ *  XNVCTRLSendSetTargetAttributeAndGetStatus -
+ *  XNVCTRLWaitSetTargetAttributeAndGetStatus -
+ *
+ *  Split-phase version of XNVCTRLSetTargetAttributeAndGetStatus(), for
+ *  sending a burst of assignments and collecting all of their statuses
+ *  with a single round trip.  The Wait function returns True if the
+ *  attribute was set successfully.  The assignments are processed by the
+ *  X server in the order they were sent.
+ */
+
+XNVCTRLCookie XNVCTRLSendSetTargetAttributeAndGetStatus (
+    Display *dpy,
+    int target_type,
+    int target_id,
+    unsigned int display_mask,
+    unsigned int attribute,
+    int value
+);
+
+Bool XNVCTRLWaitSetTargetAttributeAndGetStatus (
+    Display *dpy,
+    XNVCTRLCookie cookie
+);
+
+
 /*
  *  XNVCTRLQueryStringAttribute -
  *
@@ -0,0 +1,2 @@
+const char NV_ID[] = "nvidia id: libXNVCtrl:  version 390.25  (root@vm)  Sat Oct 17 04:03:13 UTC 2026";
+const char *pNV_ID = NV_ID + 11;
@@ -30,7 +30,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <math.h> /* pow(3) */
+#include <float.h>
+#include <math.h>
 
 #include <sys/utsname.h>
 
@@ -196,7 +197,7 @@ NvCtrlAttributeHandle *NvCtrlAttributeInit(CtrlSystem *system,
     /* initialize the NV-CONTROL attributes */
 
     if (subsystems & NV_CTRL_ATTRIBUTES_NV_CONTROL_SUBSYSTEM) {
-        h->nv = NvCtrlInitNvControlAttributes(h);
+        h->nv = NvCtrlInitNvControlAttributes(h, system);
 
         /* Give up if it failed and target needs NV-CONTROL */
         if (!h->nv && TARGET_TYPE_NEEDS_NVCONTROL(target_type)) {
@@ -254,7 +255,7 @@ NvCtrlAttributeHandle *NvCtrlAttributeInit(CtrlSystem *system,
     if ((subsystems & NV_CTRL_ATTRIBUTES_NVML_SUBSYSTEM) &&
         TARGET_TYPE_IS_NVML_COMPATIBLE(target_type)) {
 
-        h->nvml = NvCtrlInitNvmlAttributes(h);
+        h->nvml = NvCtrlInitNvmlAttributes(h, system);
     }
 
     return (NvCtrlAttributeHandle *) h;
@@ -669,10 +670,10 @@ ReturnStatus NvCtrlGetValidAttributeValues(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetValidAttributeValues() */
 
 
-ReturnStatus NvCtrlGetAttributePerms(const CtrlTarget *ctrl_target,
-                                     CtrlAttributeType attr_type,
-                                     int attr,
-                                     CtrlAttributePerms *perms)
+static ReturnStatus get_attribute_perms(const CtrlTarget *ctrl_target,
+                                        CtrlAttributeType attr_type,
+                                        int attr,
+                                        CtrlAttributePerms *perms)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
 
@@ -708,6 +709,37 @@ ReturnStatus NvCtrlGetAttributePerms(const CtrlTarget *ctrl_target,
 }
 
 
+/*
+ * NvCtrlGetAttributePerms() - permissions don't change while the
+ * attribute stays available, so they are served from the target's
+ * attribute cache whenever possible.
+ */
+
+ReturnStatus NvCtrlGetAttributePerms(const CtrlTarget *ctrl_target,
+                                     CtrlAttributeType attr_type,
+                                     int attr,
+                                     CtrlAttributePerms *perms)
+{
+    ReturnStatus status;
+
+    if (perms == NULL) {
+        return NvCtrlBadArgument;
+    }
+
+    if (NvCtrlAttributeCacheLookup(ctrl_target, CTRL_ATTRIBUTE_CACHE_PERMS,
+                                   attr_type, attr, 0, perms, &status)) {
+        return status;
+    }
+
+    status = get_attribute_perms(ctrl_target, attr_type, attr, perms);
+
+    NvCtrlAttributeCacheStore(ctrl_target, CTRL_ATTRIBUTE_CACHE_PERMS,
+                              attr_type, attr, 0, perms, status);
+
+    return status;
+}
+
+
 
 ReturnStatus NvCtrlGetStringAttribute(const CtrlTarget *ctrl_target,
                                       int attr, char **ptr)
@@ -813,9 +845,312 @@ ReturnStatus NvCtrlGetDisplayAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetDisplayAttribute() */
 
 
-ReturnStatus NvCtrlSetDisplayAttribute(CtrlTarget *ctrl_target,
-                                       unsigned int display_mask,
-                                       int attr, int val)
+/*
+ * NvCtrlGetDisplayAttributes() - query the n integer attributes in attrs
+ * for the given display mask, storing each value in vals and the
+ * outcome of each individual query in statuses.  NV-CONTROL attributes
+ * are batched so that they cost a single round trip to the X server;
+ * attributes served by other backends (NVML, RandR, ...) are dispatched
+ * through NvCtrlGetDisplayAttribute64() individually.
+ *
+ * Returns NvCtrlBadHandle if the target is invalid, and NvCtrlSuccess
+ * otherwise; the per-attribute results are in statuses.
+ */
+
+ReturnStatus NvCtrlGetDisplayAttributes(const CtrlTarget *ctrl_target,
+                                        unsigned int display_mask,
+                                        int n, const int *attrs,
+                                        int *vals, ReturnStatus *statuses)
+{
+    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
+    int *batch_attrs;
+    int *batch_idx;
+    int64_t *batch_vals;
+    ReturnStatus *batch_statuses;
+    int64_t value_64;
+    int i, count = 0;
+
+    if (h == NULL) {
+        return NvCtrlBadHandle;
+    }
+
+    batch_attrs = nvalloc(n * sizeof(*batch_attrs));
+    batch_idx = nvalloc(n * sizeof(*batch_idx));
+
+    NvCtrlNvmlBeginGroupedRead(ctrl_target);
+
+    for (i = 0; i < n; i++) {
+        int attr = attrs[i];
+
+        /*
+         * Only core NV-CONTROL attributes can be batched; everything else
+         * goes through the regular dispatch.  As in
+         * NvCtrlGetDisplayAttribute64(), NVML gets the first chance at
+         * answering for the targets it knows about.
+         */
+
+        if (h->nv && (attr >= 0) && (attr <= NV_CTRL_LAST_ATTRIBUTE)) {
+            switch (h->target_type) {
+                case GPU_TARGET:
+                case THERMAL_SENSOR_TARGET:
+                case COOLER_TARGET:
+                    statuses[i] = NvCtrlNvmlGetAttribute(ctrl_target, attr,
+                                                         &value_64);
+                    if ((statuses[i] != NvCtrlMissingExtension) &&
+                        (statuses[i] != NvCtrlBadHandle) &&
+                        (statuses[i] != NvCtrlNotSupported)) {
+                        if (statuses[i] == NvCtrlSuccess) {
+                            vals[i] = value_64;
+                        }
+                        continue;
+                    }
+                    /* Fall through */
+                case DISPLAY_TARGET:
+                case X_SCREEN_TARGET:
+                case FRAMELOCK_TARGET:
+                case VCS_TARGET:
+                case GVI_TARGET:
+                case NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET:
+                    batch_attrs[count] = attr;
+                    batch_idx[count] = i;
+                    count++;
+                    continue;
+                default:
+                    break;
+            }
+        }
+
+        statuses[i] = NvCtrlGetDisplayAttribute64(ctrl_target, display_mask,
+                                                  attr, &value_64);
+        if (statuses[i] == NvCtrlSuccess) {
+            vals[i] = value_64;
+        }
+    }
+
+    if (count > 0) {
+        batch_vals = nvalloc(count * sizeof(*batch_vals));
+        batch_statuses = nvalloc(count * sizeof(*batch_statuses));
+
+        NvCtrlNvControlGetAttributes(h, display_mask, count, batch_attrs,
+                                     batch_vals, batch_statuses);
+
+        for (i = 0; i < count; i++) {
+            int idx = batch_idx[i];
+
+            statuses[idx] = batch_statuses[i];
+            if (statuses[idx] == NvCtrlSuccess) {
+                vals[idx] = batch_vals[i];
+            }
+        }
+
+        nvfree(batch_statuses);
+        nvfree(batch_vals);
+    }
+
+    NvCtrlNvmlEndGroupedRead(ctrl_target);
+
+    nvfree(batch_idx);
+    nvfree(batch_attrs);
+
+    return NvCtrlSuccess;
+
+} /* NvCtrlGetDisplayAttributes() */
+
+
+ReturnStatus NvCtrlGetAttributes(const CtrlTarget *ctrl_target,
+                                 int n, const int *attrs,
+                                 int *vals, ReturnStatus *statuses)
+{
+    return NvCtrlGetDisplayAttributes(ctrl_target, 0, n, attrs, vals,
+                                      statuses);
+
+} /* NvCtrlGetAttributes() */
+
+
+/*
+ * NvCtrlQueryAttributes() - perform the n integer and/or string queries
+ * in queries.  Core NV-CONTROL queries are collected, across targets, into
+ * a single pipelined batch; NVML gets the first chance at answering for
+ * the targets it knows about, as in NvCtrlGetDisplayAttribute64() and
+ * NvCtrlGetStringDisplayAttribute(), and anything else is dispatched
+ * individually.
+ */
+
+void NvCtrlQueryAttributes(CtrlAttributeQuery *queries, int n)
+{
+    CtrlAttributeQuery *batch;
+    int *batch_idx;
+    Display *dpy = NULL;
+    int i, count = 0;
+
+    if (n <= 0) {
+        return;
+    }
+
+    batch = nvalloc(n * sizeof(*batch));
+    batch_idx = nvalloc(n * sizeof(*batch_idx));
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributeQuery *q = &queries[i];
+        const NvCtrlAttributePrivateHandle *h =
+            getPrivateHandleConst(q->target);
+        Bool is_string = (q->type == CTRL_ATTRIBUTE_TYPE_STRING);
+        Bool batchable;
+
+        q->val = 0;
+        q->str = NULL;
+
+        if (h == NULL) {
+            q->status = NvCtrlBadHandle;
+            continue;
+        }
+
+        batchable = h->nv && (!dpy || (dpy == h->dpy)) &&
+            (q->attr >= 0) &&
+            (q->attr <= (is_string ? NV_CTRL_STRING_LAST_ATTRIBUTE :
+                                     NV_CTRL_LAST_ATTRIBUTE));
+
+        if (batchable && TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
+            int64_t value_64;
+
+            if (is_string) {
+                q->status = NvCtrlNvmlGetStringAttribute(q->target, q->attr,
+                                                         &q->str);
+            } else {
+                q->status = NvCtrlNvmlGetAttribute(q->target, q->attr,
+                                                   &value_64);
+                if (q->status == NvCtrlSuccess) {
+                    q->val = value_64;
+                }
+            }
+
+            batchable = (q->status == NvCtrlMissingExtension) ||
+                        (q->status == NvCtrlBadHandle) ||
+                        (q->status == NvCtrlNotSupported);
+            if (!batchable) {
+                continue;
+            }
+        }
+
+        if (batchable) {
+            dpy = h->dpy;
+            batch[count] = *q;
+            batch_idx[count] = i;
+            count++;
+        } else if (is_string) {
+            q->status = NvCtrlGetStringAttribute(q->target, q->attr, &q->str);
+        } else {
+            q->status = NvCtrlGetAttribute(q->target, q->attr, &q->val);
+        }
+    }
+
+    if (count > 0) {
+        NvCtrlNvControlQueryAttributes(batch, count);
+
+        for (i = 0; i < count; i++) {
+            queries[batch_idx[i]] = batch[i];
+        }
+    }
+
+    nvfree(batch_idx);
+    nvfree(batch);
+
+} /* NvCtrlQueryAttributes() */
+
+
+
+/*
+ * NvCtrlSetAttributes() - NVML gets the first chance at the assignments
+ * for the targets it knows about, as in NvCtrlSetDisplayAttribute(); the
+ * core NV-CONTROL assignments are then sent together, in their original
+ * order.  The cached valid values of each target that was successfully
+ * assigned to are flushed, as in NvCtrlSetDisplayAttribute().
+ */
+
+void NvCtrlSetAttributes(CtrlAttributeAssignment *assignments, int n)
+{
+    CtrlAttributeAssignment *batch;
+    int *batch_idx;
+    int i, count = 0;
+
+    if (n <= 0) {
+        return;
+    }
+
+    batch = nvalloc(n * sizeof(*batch));
+    batch_idx = nvalloc(n * sizeof(*batch_idx));
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributeAssignment *s = &assignments[i];
+        NvCtrlAttributePrivateHandle *h = getPrivateHandle(s->target);
+
+        if (h == NULL) {
+            s->status = NvCtrlBadHandle;
+            continue;
+        }
+
+        if ((s->attr < 0) || (s->attr > NV_CTRL_LAST_ATTRIBUTE)) {
+            s->status = NvCtrlNoAttribute;
+            continue;
+        }
+
+        if (TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
+            s->status = NvCtrlNvmlSetAttribute(s->target, s->attr,
+                                               s->display_mask, s->val);
+            if ((s->status != NvCtrlMissingExtension) &&
+                (s->status != NvCtrlBadHandle) &&
+                (s->status != NvCtrlNotSupported)) {
+                if (s->status == NvCtrlSuccess) {
+                    NvCtrlAttributeCacheTargetChanged(s->target);
+                }
+                continue;
+            }
+        }
+
+        switch (h->target_type) {
+            case GPU_TARGET:
+            case THERMAL_SENSOR_TARGET:
+            case COOLER_TARGET:
+            case DISPLAY_TARGET:
+            case X_SCREEN_TARGET:
+            case FRAMELOCK_TARGET:
+            case VCS_TARGET:
+            case GVI_TARGET:
+            case NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET:
+                if (!h->nv) {
+                    s->status = NvCtrlMissingExtension;
+                    continue;
+                }
+                batch[count] = *s;
+                batch_idx[count] = i;
+                count++;
+                break;
+            default:
+                s->status = NvCtrlBadHandle;
+                break;
+        }
+    }
+
+    if (count > 0) {
+        NvCtrlNvControlSetAttributes(batch, count);
+
+        for (i = 0; i < count; i++) {
+            assignments[batch_idx[i]] = batch[i];
+            if (batch[i].status == NvCtrlSuccess) {
+                NvCtrlAttributeCacheTargetChanged(batch[i].target);
+            }
+        }
+    }
+
+    nvfree(batch_idx);
+    nvfree(batch);
+
+} /* NvCtrlSetAttributes() */
+
+
+static ReturnStatus set_display_attribute(CtrlTarget *ctrl_target,
+                                          unsigned int display_mask,
+                                          int attr, int val)
 {
     NvCtrlAttributePrivateHandle *h = getPrivateHandle(ctrl_target);
 
@@ -857,7 +1192,31 @@ ReturnStatus NvCtrlSetDisplayAttribute(CtrlTarget *ctrl_target,
     }
 
     return NvCtrlNoAttribute;
-}
+
+} /* set_display_attribute() */
+
+
+/*
+ * NvCtrlSetDisplayAttribute() - changing an attribute may change the valid
+ * values of others, so the cached valid values of the target, and of the
+ * targets related to it, are flushed after a successful assignment.
+ */
+
+ReturnStatus NvCtrlSetDisplayAttribute(CtrlTarget *ctrl_target,
+                                       unsigned int display_mask,
+                                       int attr, int val)
+{
+    ReturnStatus status;
+
+    status = set_display_attribute(ctrl_target, display_mask, attr, val);
+
+    if (status == NvCtrlSuccess) {
+        NvCtrlAttributeCacheTargetChanged(ctrl_target);
+    }
+
+    return status;
+
+} /* NvCtrlSetDisplayAttribute() */
 
 
 ReturnStatus NvCtrlGetVoidDisplayAttribute(const CtrlTarget *ctrl_target,
@@ -881,10 +1240,10 @@ ReturnStatus NvCtrlGetVoidDisplayAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetVoidDisplayAttribute() */
 
 
-ReturnStatus
-NvCtrlGetValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
-                                     unsigned int display_mask, int attr,
-                                     CtrlAttributeValidValues *val)
+static ReturnStatus
+get_valid_display_attribute_values(const CtrlTarget *ctrl_target,
+                                   unsigned int display_mask, int attr,
+                                   CtrlAttributeValidValues *val)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
 
@@ -927,9 +1286,130 @@ NvCtrlGetValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
 
     return NvCtrlNoAttribute;
     
+} /* get_valid_display_attribute_values() */
+
+
+/*
+ * NvCtrlGetValidDisplayAttributeValues() - valid values are served from
+ * the target's attribute cache when possible; the cache is flushed by
+ * the events that may change them.
+ */
+
+ReturnStatus
+NvCtrlGetValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
+                                     unsigned int display_mask, int attr,
+                                     CtrlAttributeValidValues *val)
+{
+    ReturnStatus status;
+
+    if (NvCtrlAttributeCacheLookup(ctrl_target,
+                                   CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                   CTRL_ATTRIBUTE_TYPE_INTEGER, attr,
+                                   display_mask, val, &status)) {
+        return status;
+    }
+
+    status = get_valid_display_attribute_values(ctrl_target, display_mask,
+                                                attr, val);
+
+    NvCtrlAttributeCacheStore(ctrl_target, CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                              CTRL_ATTRIBUTE_TYPE_INTEGER, attr,
+                              display_mask, val, status);
+
+    return status;
+
 } /* NvCtrlGetValidDisplayAttributeValues() */
 
 
+
+/*
+ * NvCtrlPrefetchValidAttributeValues() - anything that is already cached
+ * is left alone; NVML answers for the targets it knows about, and the
+ * rest is queried from NV-CONTROL in one pipelined pass.
+ */
+
+void NvCtrlPrefetchValidAttributeValues(CtrlAttributeQuery *queries, int n)
+{
+    CtrlAttributeQuery *batch;
+    CtrlAttributeValidValues *vals;
+    int *batch_idx;
+    int i, count = 0;
+
+    if (n <= 0) {
+        return;
+    }
+
+    batch = nvalloc(n * sizeof(*batch));
+    vals = nvalloc(n * sizeof(*vals));
+    batch_idx = nvalloc(n * sizeof(*batch_idx));
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributeQuery *q = &queries[i];
+        const NvCtrlAttributePrivateHandle *h =
+            getPrivateHandleConst(q->target);
+        CtrlAttributeValidValues valid;
+
+        if (NvCtrlAttributeCacheLookup(q->target,
+                                       CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                       CTRL_ATTRIBUTE_TYPE_INTEGER, q->attr,
+                                       0, &valid, &q->status)) {
+            continue;
+        }
+
+        if (h == NULL) {
+            q->status = NvCtrlBadHandle;
+            continue;
+        }
+
+        if ((q->attr < 0) || (q->attr > NV_CTRL_LAST_ATTRIBUTE)) {
+            q->status = NvCtrlNoAttribute;
+            continue;
+        }
+
+        if (TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
+            q->status = NvCtrlNvmlGetValidAttributeValues(q->target, q->attr,
+                                                          &valid);
+            if ((q->status != NvCtrlMissingExtension) &&
+                (q->status != NvCtrlBadHandle) &&
+                (q->status != NvCtrlNotSupported)) {
+                NvCtrlAttributeCacheStore(q->target,
+                                          CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                          CTRL_ATTRIBUTE_TYPE_INTEGER,
+                                          q->attr, 0, &valid, q->status);
+                continue;
+            }
+        }
+
+        if (!h->nv) {
+            q->status = NvCtrlMissingExtension;
+            continue;
+        }
+
+        batch[count] = *q;
+        batch_idx[count] = i;
+        count++;
+    }
+
+    if (count > 0) {
+        NvCtrlNvControlQueryValidAttributeValues(batch, vals, count);
+
+        for (i = 0; i < count; i++) {
+            NvCtrlAttributeCacheStore(batch[i].target,
+                                      CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                      CTRL_ATTRIBUTE_TYPE_INTEGER,
+                                      batch[i].attr, 0, &vals[i],
+                                      batch[i].status);
+            queries[batch_idx[i]].status = batch[i].status;
+        }
+    }
+
+    nvfree(batch_idx);
+    nvfree(vals);
+    nvfree(batch);
+
+} /* NvCtrlPrefetchValidAttributeValues() */
+
+
 /*
  * GetValidStringDisplayAttributeValuesExtraAttr() -fill the
  * CtrlAttributeValidValues strucure for extra string atrributes i.e.
@@ -956,10 +1436,10 @@ GetValidStringDisplayAttributeValuesExtraAttr(CtrlAttributeValidValues *val)
  * CtrlAttributeValidValues structure for String attributes
  */
 
-ReturnStatus
-NvCtrlGetValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
-                                           unsigned int display_mask, int attr,
-                                           CtrlAttributeValidValues *val)
+static ReturnStatus
+get_valid_string_display_attribute_values(const CtrlTarget *ctrl_target,
+                                          unsigned int display_mask, int attr,
+                                          CtrlAttributeValidValues *val)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
 
@@ -1041,6 +1521,33 @@ NvCtrlGetValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
 
     return NvCtrlNoAttribute;
 
+} /* get_valid_string_display_attribute_values() */
+
+
+ReturnStatus
+NvCtrlGetValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
+                                           unsigned int display_mask, int attr,
+                                           CtrlAttributeValidValues *val)
+{
+    ReturnStatus status;
+
+    if (NvCtrlAttributeCacheLookup(ctrl_target,
+                                   CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                   CTRL_ATTRIBUTE_TYPE_STRING, attr,
+                                   display_mask, val, &status)) {
+        return status;
+    }
+
+    status = get_valid_string_display_attribute_values(ctrl_target,
+                                                       display_mask,
+                                                       attr, val);
+
+    NvCtrlAttributeCacheStore(ctrl_target, CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                              CTRL_ATTRIBUTE_TYPE_STRING, attr,
+                              display_mask, val, status);
+
+    return status;
+
 } /* NvCtrlGetValidStringDisplayAttributeValues() */
 
 
@@ -1119,9 +1626,10 @@ ReturnStatus NvCtrlGetStringDisplayAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetStringDisplayAttribute() */
 
 
-ReturnStatus NvCtrlSetStringDisplayAttribute(CtrlTarget *ctrl_target,
-                                             unsigned int display_mask,
-                                             int attr, const char *ptr)
+static ReturnStatus
+set_string_display_attribute(CtrlTarget *ctrl_target,
+                             unsigned int display_mask,
+                             int attr, const char *ptr)
 {
     NvCtrlAttributePrivateHandle *h = getPrivateHandle(ctrl_target);
 
@@ -1160,7 +1668,26 @@ ReturnStatus NvCtrlSetStringDisplayAttribute(CtrlTarget *ctrl_target,
     }
 
     return NvCtrlNoAttribute;
-}
+
+} /* set_string_display_attribute() */
+
+
+ReturnStatus NvCtrlSetStringDisplayAttribute(CtrlTarget *ctrl_target,
+                                             unsigned int display_mask,
+                                             int attr, const char *ptr)
+{
+    ReturnStatus status;
+
+    status = set_string_display_attribute(ctrl_target, display_mask, attr,
+                                          ptr);
+
+    if (status == NvCtrlSuccess) {
+        NvCtrlAttributeCacheTargetChanged(ctrl_target);
+    }
+
+    return status;
+
+} /* NvCtrlSetStringDisplayAttribute() */
 
 
 ReturnStatus NvCtrlGetBinaryAttribute(const CtrlTarget *ctrl_target,
@@ -1203,9 +1730,9 @@ ReturnStatus NvCtrlGetBinaryAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetBinaryAttribute() */
 
 
-ReturnStatus NvCtrlStringOperation(CtrlTarget *ctrl_target,
-                                   unsigned int display_mask, int attr,
-                                   const char *ptrIn, char **ptrOut)
+static ReturnStatus string_operation(CtrlTarget *ctrl_target,
+                                     unsigned int display_mask, int attr,
+                                     const char *ptrIn, char **ptrOut)
 {
     NvCtrlAttributePrivateHandle *h = getPrivateHandle(ctrl_target);
 
@@ -1220,7 +1747,25 @@ ReturnStatus NvCtrlStringOperation(CtrlTarget *ctrl_target,
     }
 
     return NvCtrlNoAttribute;
-}
+
+} /* string_operation() */
+
+
+ReturnStatus NvCtrlStringOperation(CtrlTarget *ctrl_target,
+                                   unsigned int display_mask, int attr,
+                                   const char *ptrIn, char **ptrOut)
+{
+    ReturnStatus status;
+
+    status = string_operation(ctrl_target, display_mask, attr, ptrIn, ptrOut);
+
+    if (status == NvCtrlSuccess) {
+        NvCtrlAttributeCacheTargetChanged(ctrl_target);
+    }
+
+    return status;
+
+} /* NvCtrlStringOperation() */
 
 
 char *NvCtrlAttributesStrError(ReturnStatus status)
@@ -1480,65 +2025,187 @@ void NvCtrlInitGammaInputStruct(NvCtrlGammaInput *pGammaInput)
 }
 
 /*
- * Compute the gammaRamp entry given its index, and the contrast,
- * brightness, and gamma.
+ * GammaPow() - returns x^y for 0 <= x <= 1 and y > 0, computed as
+ * exp2(y * log2(x)) with short polynomials.  The relative error is below
+ * 1e-8, far finer than the 16 bit entries of a gamma ramp, and the cost
+ * is a fraction of that of pow(3).
  */
-static unsigned short ComputeGammaRampVal(int gammaRampSize,
-                                          int i,
-                                          float contrast,
-                                          float brightness,
-                                          float gamma)
+static double GammaPow(double x, double y)
+{
+    union { double d; uint64_t u; } v;
+    double m, s, s2, l, f, p;
+    int e, k;
+
+    if (x < DBL_MIN) {
+        return 0.0;
+    }
+
+    /* split x into m * 2^e, with sqrt(1/2) <= m < sqrt(2) */
+
+    v.d = x;
+    e = (int) ((v.u >> 52) & 0x7ff) - 1023;
+    v.u = (v.u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    m = v.d;
+
+    if (m > M_SQRT2) {
+        m *= 0.5;
+        e++;
+    }
+
+    /* log2(m) = 2 * atanh(s) / ln(2), with |s| <= 0.172 */
+
+    s = (m - 1.0) / (m + 1.0);
+    s2 = s * s;
+    l = (double) e + (2.0 / M_LN2) * s *
+        (1.0 + s2 * (1.0 / 3.0 + s2 * (1.0 / 5.0 + s2 *
+         (1.0 / 7.0 + s2 * (1.0 / 9.0)))));
+
+    /* exp2(y * l) = 2^k * e^f, with |f| <= ln(2) / 2 */
+
+    l *= y;
+    if (l < -1000.0) {
+        return 0.0;
+    }
+
+    k = -(int) (0.5 - l); /* l <= 0: round to nearest, without floor(3) */
+    f = (l - (double) k) * M_LN2;
+    p = 1.0 + f * (1.0 + f * (1.0 / 2.0 + f * (1.0 / 6.0 + f *
+        (1.0 / 24.0 + f * (1.0 / 120.0 + f * (1.0 / 720.0 + f *
+        (1.0 / 5040.0)))))));
+
+    v.u = (uint64_t) (k + 1023) << 52;
+
+    return p * v.d;
+}
+
+/*
+ * Compute a whole gammaRamp given the contrast, brightness, and gamma.
+ *
+ * For each entry i, contrast and brightness map i to an (unclamped)
+ * position j on the ramp with a per-ramp affine function, and gamma is
+ * then applied to j.  The per-ramp constants are computed once, with the
+ * same float and double roundings as the historical per-entry formula,
+ * and the affine part is evaluated over blocks of entries in a branch
+ * free loop that the compiler can vectorize.
+ */
+#define GAMMA_RAMP_BLOCK 64
+
+static void ComputeGammaRamp(int gammaRampSize,
+                             float contrast,
+                             float brightness,
+                             float gamma,
+                             unsigned short *gammaRamp)
 {
-    double j, half, scale;
-    int shift, val, num;
+    double half, factor, scale, num;
+    double j[GAMMA_RAMP_BLOCK];
+    int shift, i, k, n, val;
 
-    num = gammaRampSize - 1;
+    num = (double) (gammaRampSize - 1);
     shift = 16 - (ffs(gammaRampSize) - 1);
 
-    scale = (double) num / 3.0; /* how much brightness and contrast
-                                   affect the value */
-    j = (double) i;
+    scale = num / 3.0; /* how much brightness and contrast
+                          affect the value */
 
     /* contrast */
 
     contrast *= scale;
 
     if (contrast > 0.0) {
-        half = ((double) num / 2.0) - 1.0;
-        j -= half;
-        j *= half / (half - contrast);
-        j += half;
+        half = (num / 2.0) - 1.0;
+        factor = half / (half - contrast);
     } else {
-        half = (double) num / 2.0;
-        j -= half;
-        j *= (half + contrast) / half;
-        j += half;
+        half = num / 2.0;
+        factor = (half + contrast) / half;
     }
 
     /* brightness */
 
     brightness *= scale;
 
-    j += brightness;
-    if (j > (double)num) {
-        j = (double)num;
+    /* gamma */
+
+    gamma = 1.0 / (double) gamma;
+
+    for (i = 0; i < gammaRampSize; i += GAMMA_RAMP_BLOCK) {
+
+        n = NV_MIN(GAMMA_RAMP_BLOCK, gammaRampSize - i);
+
+        for (k = 0; k < n; k++) {
+            double v = (((double) (i + k) - half) * factor + half) +
+                       brightness;
+            v = (v > num) ? num : v;
+            j[k] = (v < 0.0) ? 0.0 : v;
+        }
+
+        if (gamma == 1.0) {
+            for (k = 0; k < n; k++) {
+                val = (int) j[k];
+                gammaRamp[i + k] = (unsigned short) (val << shift);
+            }
+        } else {
+            for (k = 0; k < n; k++) {
+                val = (int) (GammaPow(j[k] / num, gamma) * num + 0.5);
+                gammaRamp[i + k] = (unsigned short) (val << shift);
+            }
+        }
     }
-    if (j < 0.0) {
-        j = 0.0;
+}
+
+/*
+ * Ramps computed recently: the channels of a display, and the CRTCs
+ * driving the displays of an X screen, are commonly set to the same
+ * contrast, brightness, and gamma, and then share one computation.
+ */
+#define GAMMA_RAMP_CACHE_SIZE 4
+
+typedef struct {
+    int size;
+    float contrast;
+    float brightness;
+    float gamma;
+    unsigned short *ramp;
+} GammaRampCacheEntry;
+
+static GammaRampCacheEntry gammaRampCache[GAMMA_RAMP_CACHE_SIZE];
+static int gammaRampCacheNext;
+
+static const unsigned short *GetGammaRamp(int gammaRampSize,
+                                          float contrast,
+                                          float brightness,
+                                          float gamma)
+{
+    GammaRampCacheEntry *c;
+    int i;
+
+    for (i = 0; i < GAMMA_RAMP_CACHE_SIZE; i++) {
+        c = &gammaRampCache[i];
+        if (c->ramp &&
+            c->size == gammaRampSize &&
+            c->contrast == contrast &&
+            c->brightness == brightness &&
+            c->gamma == gamma) {
+            return c->ramp;
+        }
     }
 
-    /* gamma */
+    /* replace the oldest entry */
 
-    gamma = 1.0 / (double) gamma;
+    c = &gammaRampCache[gammaRampCacheNext];
+    gammaRampCacheNext = (gammaRampCacheNext + 1) % GAMMA_RAMP_CACHE_SIZE;
 
-    if (gamma == 1.0) {
-        val = (int) j;
-    } else {
-        val = (int) (pow (j / (double)num, gamma) * (double)num + 0.5);
+    if (c->size != gammaRampSize) {
+        nvfree(c->ramp);
+        c->ramp = nvalloc(gammaRampSize * sizeof(unsigned short));
+        c->size = gammaRampSize;
     }
 
-    val <<= shift;
-    return (unsigned short) val;
+    c->contrast = contrast;
+    c->brightness = brightness;
+    c->gamma = gamma;
+
+    ComputeGammaRamp(gammaRampSize, contrast, brightness, gamma, c->ramp);
+
+    return c->ramp;
 }
 
 void NvCtrlUpdateGammaRamp(const NvCtrlGammaInput *pGammaInput,
@@ -1546,7 +2213,11 @@ void NvCtrlUpdateGammaRamp(const NvCtrlGammaInput *pGammaInput,
                            unsigned short *gammaRamp[3],
                            unsigned int bitmask)
 {
-    int i, ch;
+    int ch;
+
+    if (gammaRampSize <= 0) {
+        return;
+    }
 
     /* update the requested channels within the gammaRamp */
 
@@ -1558,14 +2229,12 @@ void NvCtrlUpdateGammaRamp(const NvCtrlGammaInput *pGammaInput,
             continue;
         }
 
-        for (i = 0; i < gammaRampSize; i++) {
-            gammaRamp[ch][i] =
-                ComputeGammaRampVal(gammaRampSize,
-                                    i,
-                                    pGammaInput->contrast[ch],
-                                    pGammaInput->brightness[ch],
-                                    pGammaInput->gamma[ch]);
-        }
+        memcpy(gammaRamp[ch],
+               GetGammaRamp(gammaRampSize,
+                            pGammaInput->contrast[ch],
+                            pGammaInput->brightness[ch],
+                            pGammaInput->gamma[ch]),
+               gammaRampSize * sizeof(unsigned short));
     }
 }
 
@@ -1646,6 +2315,7 @@ NvCtrlEventHandle *NvCtrlGetEventHandle(const CtrlTarget *ctrl_target)
     if (!evt_h) {
         evt_h = nvalloc(sizeof(*evt_h));
         evt_h->dpy = h->dpy;
+        evt_h->system = ctrl_target->system;
         evt_h->fd = ConnectionNumber(h->dpy);
         evt_h->nvctrl_event_base = (h->nv) ? h->nv->event_base : -1;
         evt_h->xrandr_event_base = (h->xrandr) ? h->xrandr->event_base : -1;
@@ -1770,8 +2440,8 @@ static int get_screen_of_root(Display *dpy, Window root)
     return screen;
 }
 
-ReturnStatus
-NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
+static ReturnStatus
+decode_next_event(NvCtrlEventHandle *handle, CtrlEvent *event)
 {
     NvCtrlEventPrivateHandle *evt_h;
     XEvent xevent;
@@ -1933,3 +2603,23 @@ NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
     return NvCtrlSuccess;
 }
 
+
+/*
+ * NvCtrlEventHandleNextEvent() - decode the next pending event, and
+ * flush any cached attribute metadata it may have made stale.
+ */
+
+ReturnStatus
+NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
+{
+    ReturnStatus status;
+
+    status = decode_next_event(handle, event);
+
+    if (status == NvCtrlSuccess) {
+        NvCtrlEventPrivateHandle *evt_h = (NvCtrlEventPrivateHandle*)handle;
+        NvCtrlAttributeCacheHandleEvent(evt_h->system, event);
+    }
+
+    return status;
+}
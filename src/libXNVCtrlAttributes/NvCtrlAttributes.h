@@ -120,6 +120,15 @@ struct _CtrlTarget {
     } display;
 
     struct _CtrlTargetNode *relations; /* List of associated targets */
+    struct _CtrlTargetNode *relations_tail; /* Last node of 'relations' */
+
+    /* Bitsets of the ids of the associated targets, per target type */
+    struct {
+        unsigned int *bits;
+        int words;
+    } related[MAX_TARGET_TYPES];
+
+    struct _CtrlAttributeCache *cache; /* Cached attribute metadata */
 };
 
 /* Used to keep track of lists of targets */
@@ -141,7 +150,24 @@ struct _CtrlSystem {
 
     CtrlTargetNode *targets[MAX_TARGET_TYPES]; /* Shadows targetTypeTable */
     CtrlTargetNode *physical_screens;
+
+    /*
+     * Index of the targets[] lists, for lookups by target id; the lists
+     * must therefore only be grown through nv_add_target().
+     */
+    struct {
+        CtrlTarget **by_id; /* NULL where there is no target of that id */
+        int size;           /* Number of entries in by_id */
+        int count;          /* Number of targets in the list */
+        CtrlTargetNode *tail; /* Last node of the list */
+    } target_index[MAX_TARGET_TYPES];
+
     CtrlSystemList *system_list; /* pointer to the system list being tracked */
+
+    struct __NvCtrlNvmlContext *nvml; /* NVML state shared by the targets */
+
+    int nvctrl_major; /* NV-CONTROL version, once queried (0 until then) */
+    int nvctrl_minor;
 };
 
 /* Tracks all systems referenced by command line and/or the configuration
@@ -533,6 +559,8 @@ CtrlSystem *NvCtrlConnectToSystem(const char *display, CtrlSystemList *systems);
 CtrlSystem *NvCtrlGetSystem      (const char *display, CtrlSystemList *systems);
 void        NvCtrlFreeAllSystems (CtrlSystemList *systems);
 
+void        NvCtrlSetTopologyCacheEnabled(Bool enabled);
+
 
 int         NvCtrlGetTargetTypeCount    (const CtrlSystem *system,
                                          CtrlTargetType target_type);
@@ -543,6 +571,11 @@ CtrlTarget *NvCtrlGetDefaultTarget      (const CtrlSystem *system);
 CtrlTarget *NvCtrlGetDefaultTargetByType(const CtrlSystem *system,
                                          CtrlTargetType target_type);
 
+Bool NvCtrlTargetIsRelated      (const CtrlTarget *target,
+                                 CtrlTargetType target_type, int target_id);
+int  NvCtrlGetRelatedTargetCount(const CtrlTarget *target,
+                                 CtrlTargetType target_type);
+
 Bool                      NvCtrlIsTargetTypeValid      (CtrlTargetType target_type);
 const CtrlTargetTypeInfo *NvCtrlGetTargetTypeInfo      (CtrlTargetType target_type);
 const CtrlTargetTypeInfo *NvCtrlGetTargetTypeInfoByName(const char *name);
@@ -560,6 +593,9 @@ CtrlTarget *nv_add_target(CtrlSystem *system, CtrlTargetType target_type, int ta
 
 const char *NvCtrlGetDisplayConfigName(const CtrlSystem *system, int target_id);
 
+void NvCtrlGetAttributeCacheStats(const CtrlTarget *ctrl_target,
+                                  unsigned int *hits, unsigned int *misses);
+
 void NvCtrlRebuildSubsystems(CtrlTarget *ctrl_target, unsigned int subsystem);
 
 Display *NvCtrlGetDisplayPtr (CtrlTarget *ctrl_target);
@@ -638,6 +674,72 @@ ReturnStatus NvCtrlSetAttribute(CtrlTarget *ctrl_target, int attr, int val);
 ReturnStatus NvCtrlGetAttribute64(const CtrlTarget *ctrl_target,
                                   int attr, int64_t *val);
 
+/*
+ * NvCtrlGetAttributes() - query the n integer attributes listed in attrs
+ * in one go; vals[i] and statuses[i] receive what NvCtrlGetAttribute()
+ * would have returned for attrs[i].  NV-CONTROL queries are pipelined so
+ * the whole list costs a single round trip to the X server.
+ */
+
+ReturnStatus NvCtrlGetAttributes(const CtrlTarget *ctrl_target,
+                                 int n, const int *attrs,
+                                 int *vals, ReturnStatus *statuses);
+
+
+/*
+ * NvCtrlQueryAttributes() - perform the n integer and/or string queries
+ * described in queries, which may be for different targets of the same
+ * system; each query's status, and val or str, receive what
+ * NvCtrlGetAttribute() or NvCtrlGetStringAttribute() would have returned.
+ * NV-CONTROL queries are pipelined so the whole list costs a single round
+ * trip to the X server.  Strings should be freed with free().
+ */
+
+typedef struct {
+    const CtrlTarget *target;
+    CtrlAttributeType type; /* CTRL_ATTRIBUTE_TYPE_INTEGER or _STRING */
+    int attr;
+
+    ReturnStatus status;    /* set by NvCtrlQueryAttributes() */
+    int val;
+    char *str;
+} CtrlAttributeQuery;
+
+void NvCtrlQueryAttributes(CtrlAttributeQuery *queries, int n);
+
+
+/*
+ * NvCtrlPrefetchValidAttributeValues() - load the valid values of the n
+ * integer attributes in queries (with no display mask) into the
+ * attribute cache, so that the following NvCtrlGetValidAttributeValues()
+ * calls for them don't have to go to the X server.  NV-CONTROL queries
+ * are pipelined as in NvCtrlQueryAttributes(); each query's status
+ * receives what NvCtrlGetValidAttributeValues() would have returned, and
+ * its type and val are ignored.
+ */
+
+void NvCtrlPrefetchValidAttributeValues(CtrlAttributeQuery *queries, int n);
+
+
+/*
+ * NvCtrlSetAttributes() - perform the n integer assignments described in
+ * assignments, which may be for different targets; each assignment's
+ * status receives what NvCtrlSetDisplayAttribute() would have returned.
+ * NV-CONTROL assignments are sent as one burst and their statuses are
+ * collected with a single round trip to each X server.
+ */
+
+typedef struct {
+    CtrlTarget *target;
+    unsigned int display_mask;
+    int attr;
+    int val;
+
+    ReturnStatus status;    /* set by NvCtrlSetAttributes() */
+} CtrlAttributeAssignment;
+
+void NvCtrlSetAttributes(CtrlAttributeAssignment *assignments, int n);
+
 
 /*
  * NvCtrlGetVoidAttribute() - this function works like the
@@ -704,6 +806,11 @@ ReturnStatus NvCtrlGetDisplayAttribute64(const CtrlTarget *ctrl_target,
                                          unsigned int display_mask,
                                          int attr, int64_t *val);
 
+ReturnStatus NvCtrlGetDisplayAttributes(const CtrlTarget *ctrl_target,
+                                        unsigned int display_mask,
+                                        int n, const int *attrs,
+                                        int *vals, ReturnStatus *statuses);
+
 ReturnStatus NvCtrlGetVoidDisplayAttribute(const CtrlTarget *ctrl_target,
                                            unsigned int display_mask,
                                            int attr, void **val);
@@ -24,6 +24,7 @@
 
 #include "common-utils.h"
 #include "msg.h"
+#include "profile.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -32,26 +33,37 @@
  * NvCtrlInitNvControlAttributes() - check for the NV-CONTROL
  * extension and make sure we have an adequate version.  Returns a
  * malloced and initialized NvCtrlNvControlAttributes structure if
- * successful, or NULL otherwise.
+ * successful, or NULL otherwise.  The extension version is only queried
+ * for the first handle of each system.
  */
 
 NvCtrlNvControlAttributes *
-NvCtrlInitNvControlAttributes (NvCtrlAttributePrivateHandle *h)
+NvCtrlInitNvControlAttributes (NvCtrlAttributePrivateHandle *h,
+                               CtrlSystem *system)
 {
     NvCtrlNvControlAttributes *nv;
     int ret, major, minor, event, error;
     const CtrlTargetTypeInfo *targetTypeInfo;
     
+    nv_profile_round_trip();
     ret = XNVCTRLQueryExtension (h->dpy, &event, &error);
     if (ret != True) {
         nv_warning_msg("NV-CONTROL extension not found on this Display.");
         return NULL;
     }
     
-    ret = XNVCTRLQueryVersion (h->dpy, &major, &minor);
-    if (ret != True) {
-        nv_error_msg("Failed to query NV-CONTROL extension version.");
-        return NULL;
+    if (system->nvctrl_major == 0) {
+        nv_profile_round_trip();
+        ret = XNVCTRLQueryVersion (h->dpy, &major, &minor);
+        if (ret != True) {
+            nv_error_msg("Failed to query NV-CONTROL extension version.");
+            return NULL;
+        }
+        system->nvctrl_major = major;
+        system->nvctrl_minor = minor;
+    } else {
+        major = system->nvctrl_major;
+        minor = system->nvctrl_minor;
     }
 
     if (NV_VERSION2(major, minor) < NV_VERSION2(NV_MINMAJOR, NV_MINMINOR)) {
@@ -62,6 +74,7 @@ NvCtrlInitNvControlAttributes (NvCtrlAttributePrivateHandle *h)
     }
 
     if (h->target_type == X_SCREEN_TARGET) {
+        nv_profile_round_trip();
         ret = XNVCTRLIsNvScreen (h->dpy, h->target_id);
         if (ret != True) {
             nv_warning_msg("NV-CONTROL extension not present on screen %d "
@@ -160,6 +173,7 @@ NvCtrlNvControlQueryTargetCount(const NvCtrlAttributePrivateHandle *h,
         return NvCtrlBadArgument;
     }
 
+    nv_profile_round_trip();
     ret = XNVCTRLQueryTargetCount(h->dpy, targetTypeInfo->nvctrl, val);
     return (ret) ? NvCtrlSuccess : NvCtrlError;
 
@@ -184,6 +198,7 @@ ReturnStatus NvCtrlNvControlGetAttribute(const NvCtrlAttributePrivateHandle *h,
             return NvCtrlBadHandle;
         }
 
+        nv_profile_round_trip();
         if (NV_VERSION2(major, minor) > NV_VERSION2(1, 20)) {
             status = XNVCTRLQueryTargetAttribute64(h->dpy,
                                                    targetTypeInfo->nvctrl,
@@ -225,6 +240,159 @@ ReturnStatus NvCtrlNvControlGetAttribute(const NvCtrlAttributePrivateHandle *h,
 } /* NvCtrlNvControlGetAttribute() */
 
 
+/*
+ * NvCtrlNvControlGetAttributes() - query several integer attributes of
+ * the same target and display mask at once.  The core NV-CONTROL
+ * attributes are pipelined through XNVCTRLQueryTargetAttributes{,64}(),
+ * so they cost a single round trip to the X server; anything else is
+ * handed to NvCtrlNvControlGetAttribute() one at a time.
+ */
+
+ReturnStatus NvCtrlNvControlGetAttributes(const NvCtrlAttributePrivateHandle *h,
+                                          unsigned int display_mask,
+                                          int n, const int *attrs,
+                                          int64_t *vals,
+                                          ReturnStatus *statuses)
+{
+    const CtrlTargetTypeInfo *targetTypeInfo;
+    unsigned int *batch_attrs;
+    int *batch_idx;
+    int64_t *values_64;
+    int *values_32 = NULL;
+    Bool *exists;
+    Bool ret;
+    int i, count = 0;
+
+    targetTypeInfo = NvCtrlGetTargetTypeInfo(h->target_type);
+    if (targetTypeInfo == NULL) {
+        return NvCtrlBadHandle;
+    }
+
+    batch_attrs = nvalloc(n * sizeof(*batch_attrs));
+    batch_idx = nvalloc(n * sizeof(*batch_idx));
+    values_64 = nvalloc(n * sizeof(*values_64));
+    exists = nvalloc(n * sizeof(*exists));
+
+    for (i = 0; i < n; i++) {
+        if ((attrs[i] >= 0) && (attrs[i] <= NV_CTRL_LAST_ATTRIBUTE)) {
+            batch_attrs[count] = attrs[i];
+            batch_idx[count] = i;
+            count++;
+        } else {
+            statuses[i] = NvCtrlNvControlGetAttribute(h, display_mask,
+                                                      attrs[i], &vals[i]);
+        }
+    }
+
+    if (count > 0) {
+        nv_profile_round_trip();
+        if (NV_VERSION2(h->nv->major_version, h->nv->minor_version) >
+            NV_VERSION2(1, 20)) {
+            ret = XNVCTRLQueryTargetAttributes64(h->dpy,
+                                                 targetTypeInfo->nvctrl,
+                                                 h->target_id, display_mask,
+                                                 count, batch_attrs,
+                                                 values_64, exists);
+        } else {
+            values_32 = nvalloc(count * sizeof(*values_32));
+            ret = XNVCTRLQueryTargetAttributes(h->dpy,
+                                               targetTypeInfo->nvctrl,
+                                               h->target_id, display_mask,
+                                               count, batch_attrs,
+                                               values_32, exists);
+            for (i = 0; i < count; i++) {
+                values_64[i] = values_32[i];
+            }
+        }
+
+        for (i = 0; i < count; i++) {
+            int idx = batch_idx[i];
+
+            if (ret && exists[i]) {
+                vals[idx] = values_64[i];
+                statuses[idx] = NvCtrlSuccess;
+            } else {
+                statuses[idx] = NvCtrlAttributeNotAvailable;
+            }
+        }
+    }
+
+    nvfree(values_32);
+    nvfree(exists);
+    nvfree(values_64);
+    nvfree(batch_idx);
+    nvfree(batch_attrs);
+
+    return NvCtrlSuccess;
+
+} /* NvCtrlNvControlGetAttributes() */
+
+
+/*
+ * NvCtrlNvControlQueryAttributes() - perform a list of core NV-CONTROL
+ * integer and string queries, possibly for different targets, through a
+ * single XNVCTRLQueryBatch() round trip.  All the targets must have
+ * NV-CONTROL handles on the same X display connection.
+ */
+
+void NvCtrlNvControlQueryAttributes(CtrlAttributeQuery *queries, int n)
+{
+    const NvCtrlAttributePrivateHandle *h;
+    XNVCTRLQuery *batch;
+    Bool ret;
+    int i;
+
+    if (n <= 0) {
+        return;
+    }
+
+    h = getPrivateHandleConst(queries[0].target);
+    batch = nvalloc(n * sizeof(*batch));
+
+    for (i = 0; i < n; i++) {
+        const NvCtrlAttributePrivateHandle *qh =
+            getPrivateHandleConst(queries[i].target);
+        const CtrlTargetTypeInfo *targetTypeInfo =
+            NvCtrlGetTargetTypeInfo(qh->target_type);
+
+        if (queries[i].type == CTRL_ATTRIBUTE_TYPE_STRING) {
+            batch[i].type = XNVCTRL_QUERY_STRING;
+        } else if (NV_VERSION2(qh->nv->major_version,
+                               qh->nv->minor_version) > NV_VERSION2(1, 20)) {
+            batch[i].type = XNVCTRL_QUERY_INTEGER_64;
+        } else {
+            batch[i].type = XNVCTRL_QUERY_INTEGER;
+        }
+        batch[i].target_type = targetTypeInfo->nvctrl;
+        batch[i].target_id = qh->target_id;
+        batch[i].display_mask = 0;
+        batch[i].attribute = queries[i].attr;
+    }
+
+    nv_profile_round_trip();
+    ret = XNVCTRLQueryBatch(h->dpy, n, batch);
+
+    for (i = 0; i < n; i++) {
+        if (!ret || !batch[i].exists) {
+            queries[i].status = NvCtrlAttributeNotAvailable;
+            continue;
+        }
+
+        queries[i].status = NvCtrlSuccess;
+
+        if (queries[i].type == CTRL_ATTRIBUTE_TYPE_STRING) {
+            queries[i].str = strdup(batch[i].string);
+            XFree(batch[i].string);
+        } else {
+            queries[i].val = batch[i].value;
+        }
+    }
+
+    nvfree(batch);
+
+} /* NvCtrlNvControlQueryAttributes() */
+
+
 ReturnStatus NvCtrlNvControlSetAttribute (NvCtrlAttributePrivateHandle *h,
                                           unsigned int display_mask,
                                           int attr, int val)
@@ -238,6 +406,7 @@ ReturnStatus NvCtrlNvControlSetAttribute (NvCtrlAttributePrivateHandle *h,
             return NvCtrlBadHandle;
         }
 
+        nv_profile_round_trip();
         bRet = XNVCTRLSetTargetAttributeAndGetStatus(h->dpy,
                                                      targetTypeInfo->nvctrl,
                                                      h->target_id,
@@ -252,6 +421,72 @@ ReturnStatus NvCtrlNvControlSetAttribute (NvCtrlAttributePrivateHandle *h,
 }
 
 
+/*
+ * NvCtrlNvControlSetAttributes() - perform a list of core NV-CONTROL
+ * integer assignments, possibly for different targets, as one burst of
+ * SetAttributeAndGetStatus requests.  Every request is sent before any
+ * status is read back, so the whole list costs one round trip per X
+ * display connection.  The X server applies the assignments in order.
+ */
+
+void NvCtrlNvControlSetAttributes(CtrlAttributeAssignment *assignments,
+                                  int n)
+{
+    XNVCTRLCookie *cookies;
+    int i;
+
+    if (n <= 0) {
+        return;
+    }
+
+    cookies = nvalloc(n * sizeof(*cookies));
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributeAssignment *s = &assignments[i];
+        const NvCtrlAttributePrivateHandle *h =
+            getPrivateHandleConst(s->target);
+        const CtrlTargetTypeInfo *targetTypeInfo =
+            NvCtrlGetTargetTypeInfo(h->target_type);
+
+        if (s->attr > NV_CTRL_LAST_ATTRIBUTE) {
+            s->status = NvCtrlNoAttribute;
+            continue;
+        }
+        if (targetTypeInfo == NULL) {
+            s->status = NvCtrlBadHandle;
+            continue;
+        }
+
+        cookies[i] =
+            XNVCTRLSendSetTargetAttributeAndGetStatus(h->dpy,
+                                                      targetTypeInfo->nvctrl,
+                                                      h->target_id,
+                                                      s->display_mask,
+                                                      s->attr, s->val);
+        s->status = NvCtrlError;
+    }
+
+    nv_profile_round_trip();
+
+    for (i = 0; i < n; i++) {
+        const NvCtrlAttributePrivateHandle *h;
+
+        if (cookies[i] == NULL) {
+            continue;
+        }
+
+        h = getPrivateHandleConst(assignments[i].target);
+        if (XNVCTRLWaitSetTargetAttributeAndGetStatus(h->dpy, cookies[i])) {
+            assignments[i].status = NvCtrlSuccess;
+        }
+    }
+
+    nvfree(cookies);
+
+} /* NvCtrlNvControlSetAttributes() */
+
+
+
 /*
  * Helper function for converting NV-CONTROL specific permission data into
  * CtrlAttributePerms (API agnostic) permission data that the front-end can use.
@@ -303,6 +538,7 @@ NvCtrlNvControlGetAttributePerms(const NvCtrlAttributePrivateHandle *h,
 {
     NVCTRLAttributePermissionsRec nvctrlPerms;
 
+    nv_profile_round_trip();
     switch (attr_type) {
         case CTRL_ATTRIBUTE_TYPE_INTEGER:
             XNVCTRLQueryAttributePermissions(h->dpy, attr, &nvctrlPerms);
@@ -403,6 +639,7 @@ NvCtrlNvControlGetValidAttributeValues(const NvCtrlAttributePrivateHandle *h,
             return NvCtrlBadHandle;
         }
 
+        nv_profile_round_trip();
         if (XNVCTRLQueryValidTargetAttributeValues(h->dpy,
                                                    targetTypeInfo->nvctrl,
                                                    h->target_id, display_mask,
@@ -421,6 +658,74 @@ NvCtrlNvControlGetValidAttributeValues(const NvCtrlAttributePrivateHandle *h,
 } /* NvCtrlNvControlGetValidAttributeValues() */
 
 
+/*
+ * NvCtrlNvControlQueryValidAttributeValues() - query the valid values of
+ * a list of core NV-CONTROL integer attributes, possibly for different
+ * targets, with all of the requests in flight at once.  vals[i] receives
+ * the valid values for queries[i]; the type and val fields of the
+ * queries are not used.
+ */
+
+void NvCtrlNvControlQueryValidAttributeValues(CtrlAttributeQuery *queries,
+                                              CtrlAttributeValidValues *vals,
+                                              int n)
+{
+    XNVCTRLCookie *cookies;
+    int i;
+
+    if (n <= 0) {
+        return;
+    }
+
+    cookies = nvalloc(n * sizeof(*cookies));
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributeQuery *q = &queries[i];
+        const NvCtrlAttributePrivateHandle *h =
+            getPrivateHandleConst(q->target);
+        const CtrlTargetTypeInfo *targetTypeInfo =
+            NvCtrlGetTargetTypeInfo(h->target_type);
+
+        if (q->attr > NV_CTRL_LAST_ATTRIBUTE) {
+            q->status = NvCtrlNoAttribute;
+            continue;
+        }
+        if (targetTypeInfo == NULL) {
+            q->status = NvCtrlBadHandle;
+            continue;
+        }
+
+        cookies[i] =
+            XNVCTRLSendQueryValidTargetAttributeValues(h->dpy,
+                                                       targetTypeInfo->nvctrl,
+                                                       h->target_id, 0,
+                                                       q->attr);
+        q->status = NvCtrlAttributeNotAvailable;
+    }
+
+    nv_profile_round_trip();
+
+    for (i = 0; i < n; i++) {
+        const NvCtrlAttributePrivateHandle *h;
+        NVCTRLAttributeValidValuesRec valid;
+
+        if (cookies[i] == NULL) {
+            continue;
+        }
+
+        h = getPrivateHandleConst(queries[i].target);
+        if (XNVCTRLWaitQueryValidTargetAttributeValues(h->dpy, cookies[i],
+                                                       &valid)) {
+            convertFromNvCtrlValidValues(&vals[i], &valid);
+            queries[i].status = NvCtrlSuccess;
+        }
+    }
+
+    nvfree(cookies);
+
+} /* NvCtrlNvControlQueryValidAttributeValues() */
+
+
 ReturnStatus
 NvCtrlNvControlGetValidStringDisplayAttributeValues
                                        (const NvCtrlAttributePrivateHandle *h,
@@ -440,6 +745,7 @@ NvCtrlNvControlGetValidStringDisplayAttributeValues
                 return NvCtrlBadHandle;
             }
 
+            nv_profile_round_trip();
             if (XNVCTRLQueryValidTargetStringAttributeValues(h->dpy,
                                                              targetTypeInfo->nvctrl,
                                                              h->target_id,
@@ -499,6 +805,7 @@ NvCtrlNvControlGetStringAttribute(const NvCtrlAttributePrivateHandle *h,
             return NvCtrlBadHandle;
         }
 
+        nv_profile_round_trip();
         if (XNVCTRLQueryTargetStringAttribute(h->dpy,
                                               targetTypeInfo->nvctrl,
                                               h->target_id, display_mask,
@@ -593,6 +900,7 @@ NvCtrlNvControlGetBinaryAttribute(const NvCtrlAttributePrivateHandle *h,
         return NvCtrlBadHandle;
     }
 
+    nv_profile_round_trip();
     ret = XNVCTRLQueryTargetBinaryData(h->dpy,
                                        targetTypeInfo->nvctrl,
                                        h->target_id,
@@ -633,6 +941,7 @@ NvCtrlNvControlStringOperation(NvCtrlAttributePrivateHandle *h,
             return NvCtrlBadHandle;
         }
 
+        nv_profile_round_trip();
         if (XNVCTRLStringOperation(h->dpy, targetTypeInfo->nvctrl,
                                    h->target_id, display_mask,
                                    attr, ptrIn, &tmp)) {
@@ -703,6 +1012,7 @@ ReturnStatus NvCtrlGetGvoColorConversion(const CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
+    nv_profile_round_trip();
     bRet = XNVCTRLQueryGvoColorConversion(h->dpy,
                                           h->target_id,
                                           colorMatrix,
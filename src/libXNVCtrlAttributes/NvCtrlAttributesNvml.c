@@ -31,6 +31,7 @@
 
 #include "msg.h"
 #include "parse.h"
+#include "profile.h"
 
 #include "NVCtrlLib.h"
 
@@ -145,45 +146,45 @@ static Bool NvmlMissing(const CtrlTarget *ctrl_target)
 /*
  * Unload the NVML library if it was successfully loaded.
  */
-static void UnloadNvml(NvCtrlNvmlAttributes *nvml)
+static void UnloadNvml(NvCtrlNvmlContext *ctx)
 {
-    if (nvml == NULL) {
+    if (ctx == NULL) {
         return;
     }
 
-    if (nvml->lib.handle == NULL) {
+    if (ctx->lib.handle == NULL) {
         return;
     }
 
-    if (nvml->lib.shutdown != NULL) {
-        nvmlReturn_t ret = nvml->lib.shutdown();
+    if (ctx->lib.shutdown != NULL) {
+        nvmlReturn_t ret = ctx->lib.shutdown();
         if (ret != NVML_SUCCESS) {
             printNvmlError(ret);
         }
     }
 
-    dlclose(nvml->lib.handle);
+    dlclose(ctx->lib.handle);
 
-    memset(&nvml->lib, 0, sizeof(nvml->lib));
+    memset(&ctx->lib, 0, sizeof(ctx->lib));
 }
 
 /*
  * Load and initializes the NVML library.
  */
-static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
+static Bool LoadNvml(NvCtrlNvmlContext *ctx)
 {
     nvmlReturn_t ret;
 
-    nvml->lib.handle = dlopen("libnvidia-ml.so.1", RTLD_LAZY);
+    ctx->lib.handle = dlopen("libnvidia-ml.so.1", RTLD_LAZY);
 
-    if (nvml->lib.handle == NULL) {
+    if (ctx->lib.handle == NULL) {
         goto fail;
     }
 
-#define GET_SYMBOL_REQUIRED(_proc, _name)             \
-    nvml->lib._proc = dlsym(nvml->lib.handle, _name); \
-    if (nvml->lib._proc == NULL) {                    \
-        goto fail;                                    \
+#define GET_SYMBOL_REQUIRED(_proc, _name)           \
+    ctx->lib._proc = dlsym(ctx->lib.handle, _name); \
+    if (ctx->lib._proc == NULL) {                   \
+        goto fail;                                  \
     }
 
     GET_SYMBOL_REQUIRED(init,                           "nvmlInit");
@@ -204,12 +205,12 @@ static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
     
 /* Do not fail with older drivers */
 #define GET_SYMBOL_OPTIONAL(_proc, _name)             \
-    nvml->lib._proc = dlsym(nvml->lib.handle, _name); 
+    ctx->lib._proc = dlsym(ctx->lib.handle, _name); 
     
     GET_SYMBOL_OPTIONAL(deviceGetGridLicensableFeatures, "nvmlDeviceGetGridLicensableFeatures");
 #undef GET_SYMBOL_OPTIONAL
 
-    ret = nvml->lib.init();
+    ret = ctx->lib.init();
 
     if (ret != NVML_SUCCESS) {
         printNvmlError(ret);
@@ -219,7 +220,7 @@ static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
     return True;
 
 fail:
-    UnloadNvml(nvml);
+    UnloadNvml(ctx);
     return False;
 }
 
@@ -231,7 +232,7 @@ fail:
  * XXX Needed while using NV-CONTROL as fallback during the migration process
  */
 
-static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlAttributes *nvml,
+static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlContext *ctx,
                                    const NvCtrlAttributePrivateHandle *h,
                                    int nvmlGpuCount,
                                    unsigned int **idsDictionary)
@@ -274,12 +275,12 @@ static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlAttributes *nvml,
 
             /* Look for the same UUID through NVML */
             for (j = 0; j < nvmlGpuCount; j++) {
-                if (NVML_SUCCESS != nvml->lib.deviceGetHandleByIndex(j, &device)) {
+                if (NVML_SUCCESS != ctx->lib.deviceGetHandleByIndex(j, &device)) {
                     continue;
                 }
 
-                if (NVML_SUCCESS != nvml->lib.deviceGetUUID(device, nvmlUUID,
-                                                            MAX_NVML_STR_LEN)) {
+                if (NVML_SUCCESS != ctx->lib.deviceGetUUID(device, nvmlUUID,
+                                                           MAX_NVML_STR_LEN)) {
                     continue;
                 }
 
@@ -311,59 +312,178 @@ fail:
 
 
 /*
- * Initializes an NVML private handle to hold some information to be used later
- * on
+ * Get the index of the thermal sensor or cooler 'target_id' among those of
+ * its GPU, or -1 if there is no such sensor or cooler
  */
 
-NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *h)
+static int getThermalCoolerId(const NvCtrlNvmlContext *ctx, int target_id,
+                              unsigned int thermalCoolerCount,
+                              const unsigned int *thermalCoolerCountPerGPU)
 {
-    NvCtrlNvmlAttributes *nvml = NULL;
-    unsigned int count;
-    unsigned int *nvctrlToNvmlId;
-    int i;
+    int i, count;
 
-    /* Check parameters */
-    if (h == NULL || !TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
-        goto fail;
+    if ((target_id < 0) || (target_id >= thermalCoolerCount)) {
+        return -1;
     }
 
-    /* Create storage for NVML attributes */
-    nvml = nvalloc(sizeof(NvCtrlNvmlAttributes));
+    count = 0;
+    for (i = 0; i < ctx->deviceCount; i++) {
+        int tmp = count + thermalCoolerCountPerGPU[i];
+        if (target_id < tmp) {
+            return (target_id - count);
+        }
+        count = tmp;
+    }
 
-    if (!LoadNvml(nvml)) {
-        goto fail;
+    return -1;
+}
+
+
+
+/*
+ * Get the NVML handle of the device, resolving it if it was not resolved
+ * yet or was invalidated by checkNvmlDevice()
+ */
+
+static nvmlReturn_t getNvmlDevice(NvCtrlNvmlAttributes *nvml,
+                                  nvmlDevice_t *device)
+{
+    if (!nvml->deviceValid) {
+        nvmlReturn_t ret = nvml->ctx->lib.deviceGetHandleByIndex(nvml->deviceIdx,
+                                                            &nvml->device);
+        if (ret != NVML_SUCCESS) {
+            return ret;
+        }
+        nvml->deviceValid = True;
     }
 
-    /* Initialize NVML attributes */
-    if (nvml->lib.deviceGetCount(&count) != NVML_SUCCESS) {
+    *device = nvml->device;
+    return NVML_SUCCESS;
+}
+
+
+
+/*
+ * Invalidate the cached device handle, and everything read through it, if
+ * 'ret' indicates that the handle no longer refers to a usable device (e.g.
+ * after a GPU reset or hotplug); the handle is resolved again on next use
+ */
+
+static void checkNvmlDevice(NvCtrlNvmlAttributes *nvml, nvmlReturn_t ret)
+{
+    switch (ret) {
+        case NVML_ERROR_INVALID_ARGUMENT:
+        case NVML_ERROR_NOT_FOUND:
+        case NVML_ERROR_GPU_IS_LOST:
+        case NVML_ERROR_RESET_REQUIRED:
+            nvml->deviceValid = False;
+            nvml->pciValid = False;
+            nvml->memoryValid = False;
+            break;
+        default:
+            break;
+    }
+}
+
+
+
+#ifdef NVML_EXPERIMENTAL
+
+/*
+ * Grouped reads: a single NVML call returns the values of several
+ * attributes.  The PCI information of a device does not change, so it is
+ * read once per device handle; the memory information is only reused
+ * between NvCtrlNvmlBeginGroupedRead() and NvCtrlNvmlEndGroupedRead(),
+ * i.e. for the attributes queried together in one batch.
+ */
+
+static nvmlReturn_t getNvmlPciInfo(NvCtrlNvmlAttributes *nvml,
+                                   nvmlDevice_t device,
+                                   const nvmlPciInfo_t **pci)
+{
+    if (!nvml->pciValid) {
+        nvmlReturn_t ret = nvml->ctx->lib.deviceGetPciInfo(device, &nvml->pci);
+        if (ret != NVML_SUCCESS) {
+            return ret;
+        }
+        nvml->pciValid = True;
+    }
+
+    *pci = &nvml->pci;
+    return NVML_SUCCESS;
+}
+
+static nvmlReturn_t getNvmlMemoryInfo(NvCtrlNvmlAttributes *nvml,
+                                      nvmlDevice_t device,
+                                      const nvmlMemory_t **memory)
+{
+    if (!nvml->memoryValid) {
+        nvmlReturn_t ret = nvml->ctx->lib.deviceGetMemoryInfo(device,
+                                                         &nvml->memory);
+        if (ret != NVML_SUCCESS) {
+            return ret;
+        }
+        nvml->memoryValid = nvml->groupedRead;
+    }
+
+    *memory = &nvml->memory;
+    return NVML_SUCCESS;
+}
+
+#endif // NVML_EXPERIMENTAL
+
+
+
+/*
+ * Builds the NVML context of a system: loads and initializes NVML, matches
+ * the NV-CONTROL GPU IDs with NVML device indexes and finds the thermal
+ * sensors and coolers of every GPU.  On failure, the returned context is
+ * marked as not loaded, so that the work is not attempted again for the
+ * system's other targets.
+ */
+
+static NvCtrlNvmlContext *createNvmlContext(const NvCtrlAttributePrivateHandle *h)
+{
+    NvCtrlNvmlContext *ctx;
+    unsigned int count;
+    int i;
+
+    ctx = nvalloc(sizeof(NvCtrlNvmlContext));
+    ctx->refcount = 1;
+
+    nv_profile_begin("LoadNvml");
+    if (!LoadNvml(ctx)) {
+        nv_profile_end();
+        return ctx;
+    }
+    nv_profile_end();
+
+    if (ctx->lib.deviceGetCount(&count) != NVML_SUCCESS) {
         goto fail;
     }
-    nvml->deviceCount = count;
+    ctx->deviceCount = count;
 
-    nvml->sensorCountPerGPU = nvalloc(count * sizeof(unsigned int));
-    nvml->sensorCount = 0;
-    nvml->coolerCountPerGPU = nvalloc(count * sizeof(unsigned int));
-    nvml->coolerCount = 0;
+    ctx->sensorCountPerGPU = nvalloc(count * sizeof(unsigned int));
+    ctx->sensorDeviceIdx = nvalloc(count * sizeof(unsigned int));
+    ctx->sensorCount = 0;
+    ctx->coolerCountPerGPU = nvalloc(count * sizeof(unsigned int));
+    ctx->coolerDeviceIdx = nvalloc(count * sizeof(unsigned int));
+    ctx->coolerCount = 0;
 
     /* Fill the NV-CONTROL to NVML IDs dictionary */
-    if (!matchNvCtrlWithNvmlIds(nvml, h, count, &nvctrlToNvmlId)) {
+    if (!matchNvCtrlWithNvmlIds(ctx, h, count, &ctx->nvctrlToNvmlId)) {
+        ctx->nvctrlToNvmlId = NULL;
         goto fail;
     }
 
     /*
-     * Fill 'sensorCountPerGPU', 'coolerCountPerGPU' and properly set
-     * 'deviceIdx'
+     * Fill 'sensorCountPerGPU' and 'coolerCountPerGPU', and record the
+     * device of each sensor and cooler
      */
-    nvml->deviceIdx = h->target_id; /* Fallback */
-
-    if (h->target_type == GPU_TARGET) {
-        nvml->deviceIdx = nvctrlToNvmlId[h->target_id];
-    }
-
     for (i = 0; i < count; i++) {
-        int devIdx = nvctrlToNvmlId[i];
+        int devIdx = ctx->nvctrlToNvmlId[i];
         nvmlDevice_t device;
-        nvmlReturn_t ret = nvml->lib.deviceGetHandleByIndex(devIdx, &device);
+        nvmlReturn_t ret = ctx->lib.deviceGetHandleByIndex(devIdx, &device);
         if (ret == NVML_SUCCESS) {
             unsigned int temp;
             unsigned int speed;
@@ -373,17 +493,12 @@ NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *h)
              *     check for nvmlDeviceGetTemperature() success to figure
              *     out if that sensor is available.
              */
-            ret = nvml->lib.deviceGetTemperature(device, NVML_TEMPERATURE_GPU,
-                                                 &temp);
+            ret = ctx->lib.deviceGetTemperature(device, NVML_TEMPERATURE_GPU,
+                                                &temp);
             if (ret == NVML_SUCCESS) {
-                if ((h->target_type == THERMAL_SENSOR_TARGET) &&
-                    (h->target_id == nvml->sensorCount)) {
-
-                    nvml->deviceIdx = devIdx;
-                }
-
-                nvml->sensorCountPerGPU[i] = 1;
-                nvml->sensorCount++;
+                ctx->sensorDeviceIdx[ctx->sensorCount] = devIdx;
+                ctx->sensorCountPerGPU[i] = 1;
+                ctx->sensorCount++;
             }
 
             /*
@@ -391,30 +506,114 @@ NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *h)
              *     nvmlDeviceGetFanSpeed succes to figure out if that fan is
              *     available.
              */
-            ret = nvml->lib.deviceGetFanSpeed(device, &speed);
+            ret = ctx->lib.deviceGetFanSpeed(device, &speed);
             if (ret == NVML_SUCCESS) {
-                if ((h->target_type == COOLER_TARGET) &&
-                    (h->target_id == nvml->coolerCount)) {
-
-                    nvml->deviceIdx = devIdx;
-                }
-
-                nvml->coolerCountPerGPU[i] = 1;
-                nvml->coolerCount++;
+                ctx->coolerDeviceIdx[ctx->coolerCount] = devIdx;
+                ctx->coolerCountPerGPU[i] = 1;
+                ctx->coolerCount++;
             }
         }
     }
 
-    nvfree(nvctrlToNvmlId);
+    ctx->loaded = True;
 
-    return nvml;
+    return ctx;
 
  fail:
-    UnloadNvml(nvml);
-    nvfree(nvml->sensorCountPerGPU);
-    nvfree(nvml->coolerCountPerGPU);
-    nvfree(nvml);
-    return NULL;
+    UnloadNvml(ctx);
+    return ctx;
+}
+
+
+
+/*
+ * Drops a reference to an NVML context, unloading NVML and freeing the
+ * context with the last one
+ */
+
+void NvCtrlNvmlReleaseContext(NvCtrlNvmlContext *ctx)
+{
+    if (ctx == NULL || --ctx->refcount > 0) {
+        return;
+    }
+
+    UnloadNvml(ctx);
+    nvfree(ctx->nvctrlToNvmlId);
+    nvfree(ctx->sensorCountPerGPU);
+    nvfree(ctx->sensorDeviceIdx);
+    nvfree(ctx->coolerCountPerGPU);
+    nvfree(ctx->coolerDeviceIdx);
+    nvfree(ctx);
+}
+
+
+
+/*
+ * Initializes an NVML private handle to hold some information to be used later
+ * on.  The NVML context is shared by all the targets of 'system' and created
+ * along with the first of them; the handle itself only records which device,
+ * sensor or cooler it refers to.
+ */
+
+NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *h,
+                                               CtrlSystem *system)
+{
+    NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlContext *ctx;
+    nvmlDevice_t device;
+
+    /* Check parameters */
+    if (h == NULL || system == NULL ||
+        !TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
+        return NULL;
+    }
+
+    /* The system holds a reference to the context for its lifetime */
+    if (system->nvml == NULL) {
+        system->nvml = createNvmlContext(h);
+    }
+
+    ctx = system->nvml;
+    if (!ctx->loaded) {
+        return NULL;
+    }
+
+    /* Create storage for NVML attributes */
+    nvml = nvalloc(sizeof(NvCtrlNvmlAttributes));
+    nvml->ctx = ctx;
+    ctx->refcount++;
+
+    /* Properly set 'deviceIdx' */
+    nvml->deviceIdx = h->target_id; /* Fallback */
+
+    if ((h->target_type == GPU_TARGET) &&
+        (h->target_id >= 0) && (h->target_id < ctx->deviceCount)) {
+        nvml->deviceIdx = ctx->nvctrlToNvmlId[h->target_id];
+    } else if ((h->target_type == THERMAL_SENSOR_TARGET) &&
+               (h->target_id >= 0) && (h->target_id < ctx->sensorCount)) {
+        nvml->deviceIdx = ctx->sensorDeviceIdx[h->target_id];
+    } else if ((h->target_type == COOLER_TARGET) &&
+               (h->target_id >= 0) && (h->target_id < ctx->coolerCount)) {
+        nvml->deviceIdx = ctx->coolerDeviceIdx[h->target_id];
+    }
+
+    /* Resolve the device handle and sensor or cooler ID once */
+    nvml->sensorId = -1;
+    nvml->coolerId = -1;
+
+    if (h->target_type == THERMAL_SENSOR_TARGET) {
+        nvml->sensorId = getThermalCoolerId(ctx, h->target_id,
+                                            ctx->sensorCount,
+                                            ctx->sensorCountPerGPU);
+    } else if (h->target_type == COOLER_TARGET) {
+        nvml->coolerId = getThermalCoolerId(ctx, h->target_id,
+                                            ctx->coolerCount,
+                                            ctx->coolerCountPerGPU);
+    }
+
+    getNvmlDevice(nvml, &device);
+
+    return nvml;
 }
 
 
@@ -430,15 +629,45 @@ void NvCtrlNvmlAttributesClose(NvCtrlAttributePrivateHandle *h)
         return;
     }
 
-    UnloadNvml(h->nvml);
-    nvfree(h->nvml->sensorCountPerGPU);
-    nvfree(h->nvml->coolerCountPerGPU);
+    NvCtrlNvmlReleaseContext(h->nvml->ctx);
     nvfree(h->nvml);
     h->nvml = NULL;
 }
 
 
 
+/*
+ * Start and end a group of reads (one sampling of several attributes of the
+ * target), during which values returned together by a single NVML call are
+ * read only once
+ */
+
+void NvCtrlNvmlBeginGroupedRead(const CtrlTarget *ctrl_target)
+{
+    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
+
+    if (h == NULL || h->nvml == NULL) {
+        return;
+    }
+
+    h->nvml->groupedRead = True;
+    h->nvml->memoryValid = False;
+}
+
+void NvCtrlNvmlEndGroupedRead(const CtrlTarget *ctrl_target)
+{
+    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
+
+    if (h == NULL || h->nvml == NULL) {
+        return;
+    }
+
+    h->nvml->groupedRead = False;
+    h->nvml->memoryValid = False;
+}
+
+
+
 /*
  * Get the number of 'target_type' targets according to NVML
  */
@@ -465,13 +694,13 @@ ReturnStatus NvCtrlNvmlQueryTargetCount(const CtrlTarget *ctrl_target,
 
     switch (target_type) {
         case GPU_TARGET:
-            *val = (int)(h->nvml->deviceCount);
+            *val = (int)(h->nvml->ctx->deviceCount);
             break;
         case THERMAL_SENSOR_TARGET:
-            *val = (int)(h->nvml->sensorCount);
+            *val = (int)(h->nvml->ctx->sensorCount);
             break;
         case COOLER_TARGET:
-            *val = (int)(h->nvml->coolerCount);
+            *val = (int)(h->nvml->ctx->coolerCount);
             break;
         default:
             return NvCtrlBadArgument;
@@ -493,7 +722,7 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
 {
     char res[MAX_NVML_STR_LEN];
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     nvmlDevice_t device;
     nvmlReturn_t ret;
     *ptr = NULL;
@@ -504,19 +733,19 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
 
     nvml = h->nvml;
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_STRING_PRODUCT_NAME:
-                ret = nvml->lib.deviceGetName(device, res, MAX_NVML_STR_LEN);
+                ret = nvml->ctx->lib.deviceGetName(device, res, MAX_NVML_STR_LEN);
                 break;
 
             case NV_CTRL_STRING_VBIOS_VERSION:
-                ret = nvml->lib.deviceGetVbiosVersion(device, res, MAX_NVML_STR_LEN);
+                ret = nvml->ctx->lib.deviceGetVbiosVersion(device, res, MAX_NVML_STR_LEN);
                 break;
 
             case NV_CTRL_STRING_GPU_UUID:
-                ret = nvml->lib.deviceGetUUID(device, res, MAX_NVML_STR_LEN);
+                ret = nvml->ctx->lib.deviceGetUUID(device, res, MAX_NVML_STR_LEN);
                 break;
 
             case NV_CTRL_STRING_NVIDIA_DRIVER_VERSION:
@@ -547,6 +776,7 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -607,7 +837,7 @@ static ReturnStatus NvCtrlNvmlSetGPUStringAttribute(CtrlTarget *ctrl_target,
                                                     int attr, const char *ptr)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     nvmlDevice_t device;
     nvmlReturn_t ret;
 
@@ -617,7 +847,7 @@ static ReturnStatus NvCtrlNvmlSetGPUStringAttribute(CtrlTarget *ctrl_target,
 
     nvml = h->nvml;
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS:
@@ -641,6 +871,7 @@ static ReturnStatus NvCtrlNvmlSetGPUStringAttribute(CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -701,7 +932,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
 {
     unsigned int res;
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     nvmlDevice_t device;
     nvmlReturn_t ret;
 
@@ -711,22 +942,22 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
 
     nvml = h->nvml;
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
 #ifdef NVML_EXPERIMENTAL
             case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
             case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
                 {
-                    nvmlMemory_t memory;
-                    ret = nvml->lib.deviceGetMemoryInfo(device, &memory);
+                    const nvmlMemory_t *memory;
+                    ret = getNvmlMemoryInfo(nvml, device, &memory);
                     if (ret == NVML_SUCCESS) {
                         switch (attr) {
                             case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
-                                res = memory.total >> 20; // bytes --> MB
+                                res = memory->total >> 20; // bytes --> MB
                                 break;
                             case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
-                                res = memory.used >> 20; // bytes --> MB
+                                res = memory->used >> 20; // bytes --> MB
                                 break;
                         }
                     }
@@ -739,22 +970,22 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_PCI_FUNCTION:
             case NV_CTRL_PCI_ID:
                 {
-                    nvmlPciInfo_t pci;
-                    ret = nvml->lib.deviceGetPciInfo(device, &pci);
+                    const nvmlPciInfo_t *pci;
+                    ret = getNvmlPciInfo(nvml, device, &pci);
                     if (ret == NVML_SUCCESS) {
                         switch (attr) {
                             case NV_CTRL_PCI_DOMAIN:
-                                res = pci.domain;
+                                res = pci->domain;
                                 break;
                             case NV_CTRL_PCI_BUS:
-                                res = pci.bus;
+                                res = pci->bus;
                                 break;
                             case NV_CTRL_PCI_DEVICE:
-                                res = pci.device;
+                                res = pci->device;
                                 break;
                             case NV_CTRL_PCI_FUNCTION:
                                 {
-                                    char *f = strrchr(pci.busId, '.');
+                                    char *f = strrchr(pci->busId, '.');
                                     if (f != NULL) {
                                         res = atoi(f + 1);
                                     }
@@ -764,8 +995,8 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                                 }
                                 break;
                             case NV_CTRL_PCI_ID:
-                                res = ((pci.pciDeviceId << 16) & 0xffff0000) |
-                                      ((pci.pciDeviceId >> 16) & 0x0000ffff);
+                                res = ((pci->pciDeviceId << 16) & 0xffff0000) |
+                                      ((pci->pciDeviceId >> 16) & 0x0000ffff);
                                 break;
                         }
                     }
@@ -773,11 +1004,11 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_PCIE_GENERATION:
-                ret = nvml->lib.deviceGetMaxPcieLinkGeneration(device, &res);
+                ret = nvml->ctx->lib.deviceGetMaxPcieLinkGeneration(device, &res);
                 break;
 
             case NV_CTRL_GPU_PCIE_MAX_LINK_WIDTH:
-                ret = nvml->lib.deviceGetMaxPcieLinkWidth(device, &res);
+                ret = nvml->ctx->lib.deviceGetMaxPcieLinkWidth(device, &res);
                 break;
 #else
             case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
@@ -858,15 +1089,15 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_ATTR_NVML_GPU_VIRTUALIZATION_MODE:
                 {
                     nvmlGpuVirtualizationMode_t mode;
-                    ret = nvml->lib.deviceGetVirtualizationMode(device, &mode);
+                    ret = nvml->ctx->lib.deviceGetVirtualizationMode(device, &mode);
                     res = mode;
                 }
                 break;
 
             case NV_CTRL_ATTR_NVML_GPU_GRID_LICENSE_SUPPORTED:
-                if (nvml->lib.deviceGetGridLicensableFeatures) {
+                if (nvml->ctx->lib.deviceGetGridLicensableFeatures) {
                     nvmlGridLicensableFeatures_t gridLicensableFeatures;
-                    ret = nvml->lib.deviceGetGridLicensableFeatures(device,
+                    ret = nvml->ctx->lib.deviceGetGridLicensableFeatures(device,
                                                           &gridLicensableFeatures);
                     res = !!(gridLicensableFeatures.isGridLicenseSupported);
                 } else {
@@ -891,40 +1122,19 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
 
 #ifdef NVML_EXPERIMENTAL
 
-static int getThermalCoolerId(const NvCtrlAttributePrivateHandle *h,
-                              unsigned int thermalCoolerCount,
-                              const unsigned int *thermalCoolerCountPerGPU)
-{
-    int i, count;
-
-    if ((h->target_id < 0) || (h->target_id >= thermalCoolerCount)) {
-        return -1;
-    }
-
-    count = 0;
-    for (i = 0; i < h->nvml->deviceCount; i++) {
-        int tmp = count + thermalCoolerCountPerGPU[i];
-        if (h->target_id < tmp) {
-            return (h->target_id - count);
-        }
-        count = tmp;
-    }
-
-    return -1;
-}
-
 static ReturnStatus NvCtrlNvmlGetThermalAttribute(const CtrlTarget *ctrl_target,
                                                   int attr, int64_t *val)
 {
     unsigned int res;
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     int sensorId;
     nvmlDevice_t device;
     nvmlReturn_t ret;
@@ -936,18 +1146,17 @@ static ReturnStatus NvCtrlNvmlGetThermalAttribute(const CtrlTarget *ctrl_target,
     nvml = h->nvml;
 
     /* Get the proper device according to the sensor ID */
-    sensorId = getThermalCoolerId(h, nvml->sensorCount,
-                                  nvml->sensorCountPerGPU);
+    sensorId = nvml->sensorId;
     if (sensorId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_SENSOR_READING:
-                ret = nvml->lib.deviceGetTemperature(device,
+                ret = nvml->ctx->lib.deviceGetTemperature(device,
                                                      NVML_TEMPERATURE_GPU,
                                                      &res);
                 break;
@@ -975,6 +1184,7 @@ static ReturnStatus NvCtrlNvmlGetThermalAttribute(const CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -984,7 +1194,7 @@ static ReturnStatus NvCtrlNvmlGetCoolerAttribute(const CtrlTarget *ctrl_target,
 {
     unsigned int res;
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     int coolerId;
     nvmlDevice_t device;
     nvmlReturn_t ret;
@@ -996,18 +1206,17 @@ static ReturnStatus NvCtrlNvmlGetCoolerAttribute(const CtrlTarget *ctrl_target,
     nvml = h->nvml;
 
     /* Get the proper device according to the cooler ID */
-    coolerId = getThermalCoolerId(h, nvml->coolerCount,
-                                  nvml->coolerCountPerGPU);
+    coolerId = nvml->coolerId;
     if (coolerId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_COOLER_LEVEL:
-                ret = nvml->lib.deviceGetFanSpeed(device, &res);
+                ret = nvml->ctx->lib.deviceGetFanSpeed(device, &res);
                 break;
 
             case NV_CTRL_THERMAL_COOLER_SPEED:
@@ -1034,6 +1243,7 @@ static ReturnStatus NvCtrlNvmlGetCoolerAttribute(const CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -1083,7 +1293,7 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
                                               int attr, int index, int val)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     nvmlDevice_t device;
     nvmlReturn_t ret;
 
@@ -1093,7 +1303,7 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
 
     nvml = h->nvml;
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_GPU_CURRENT_CLOCK_FREQS:
@@ -1127,6 +1337,7 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -1135,7 +1346,7 @@ static ReturnStatus NvCtrlNvmlSetCoolerAttribute(CtrlTarget *ctrl_target,
                                                  int attr, int val)
 {
     NvCtrlAttributePrivateHandle *h = getPrivateHandle(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     int coolerId;
     nvmlDevice_t device;
     nvmlReturn_t ret;
@@ -1147,13 +1358,12 @@ static ReturnStatus NvCtrlNvmlSetCoolerAttribute(CtrlTarget *ctrl_target,
     nvml = h->nvml;
 
     /* Get the proper device according to the cooler ID */
-    coolerId = getThermalCoolerId(h, nvml->coolerCount,
-                                  nvml->coolerCountPerGPU);
+    coolerId = nvml->coolerId;
     if (coolerId == -1) {
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_COOLER_LEVEL:
@@ -1178,6 +1388,7 @@ static ReturnStatus NvCtrlNvmlSetCoolerAttribute(CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -1234,7 +1445,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
                                 int attr, unsigned char **data, int *len)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     nvmlDevice_t device;
     nvmlReturn_t ret;
 
@@ -1244,7 +1455,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
 
     nvml = h->nvml;
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_BINARY_DATA_FRAMELOCKS_USED_BY_GPU:
@@ -1275,6 +1486,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -1441,7 +1653,7 @@ NvCtrlNvmlGetGPUValidAttributeValues(const CtrlTarget *ctrl_target, int attr,
                                      CtrlAttributeValidValues *val)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     nvmlDevice_t device;
     nvmlReturn_t ret;
 
@@ -1451,7 +1663,7 @@ NvCtrlNvmlGetGPUValidAttributeValues(const CtrlTarget *ctrl_target, int attr,
 
     nvml = h->nvml;
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_VIDEO_RAM:
@@ -1539,6 +1751,7 @@ NvCtrlNvmlGetGPUValidAttributeValues(const CtrlTarget *ctrl_target, int attr,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -1549,7 +1762,7 @@ NvCtrlNvmlGetThermalValidAttributeValues(const CtrlTarget *ctrl_target,
                                          CtrlAttributeValidValues *val)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     int sensorId;
     nvmlDevice_t device;
     nvmlReturn_t ret;
@@ -1561,14 +1774,13 @@ NvCtrlNvmlGetThermalValidAttributeValues(const CtrlTarget *ctrl_target,
     nvml = h->nvml;
 
     /* Get the proper device and sensor ID according to the target ID */
-    sensorId = getThermalCoolerId(h, nvml->sensorCount,
-                                  nvml->sensorCountPerGPU);
+    sensorId = nvml->sensorId;
     if (sensorId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_SENSOR_READING:
@@ -1591,6 +1803,7 @@ NvCtrlNvmlGetThermalValidAttributeValues(const CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -1601,7 +1814,7 @@ NvCtrlNvmlGetCoolerValidAttributeValues(const CtrlTarget *ctrl_target,
                                         CtrlAttributeValidValues *val)
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
-    const NvCtrlNvmlAttributes *nvml;
+    NvCtrlNvmlAttributes *nvml;
     int coolerId;
     nvmlDevice_t device;
     nvmlReturn_t ret;
@@ -1613,14 +1826,13 @@ NvCtrlNvmlGetCoolerValidAttributeValues(const CtrlTarget *ctrl_target,
     nvml = h->nvml;
 
     /* Get the proper device and cooler ID according to the target ID */
-    coolerId = getThermalCoolerId(h, nvml->coolerCount,
-                                  nvml->coolerCountPerGPU);
+    coolerId = nvml->coolerId;
     if (coolerId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.deviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_COOLER_LEVEL:
@@ -1644,6 +1856,7 @@ NvCtrlNvmlGetCoolerValidAttributeValues(const CtrlTarget *ctrl_target,
     }
 
     /* An NVML error occurred */
+    checkNvmlDevice(nvml, ret);
     printNvmlError(ret);
     return NvCtrlNotSupported;
 }
@@ -116,6 +116,7 @@ typedef struct __NvCtrlXvBlitterAttributes NvCtrlXvBlitterAttributes;
 typedef struct __NvCtrlXvAttribute NvCtrlXvAttribute;
 typedef struct __NvCtrlXrandrAttributes NvCtrlXrandrAttributes;
 typedef struct __NvCtrlNvmlAttributes NvCtrlNvmlAttributes;
+typedef struct __NvCtrlNvmlContext NvCtrlNvmlContext;
 typedef struct __NvCtrlEventPrivateHandle NvCtrlEventPrivateHandle;
 typedef struct __NvCtrlEventPrivateHandleNode NvCtrlEventPrivateHandleNode;
 
@@ -154,12 +155,22 @@ struct __NvCtrlXrandrAttributes {
     int major_version;
     int minor_version;
     Bool gammaAvailable;
+    Bool gammaLoaded;   /* gammaCrtc and pGammaRamp have been looked up */
     RRCrtc gammaCrtc;
     NvCtrlGammaInput gammaInput;
     XRRCrtcGamma *pGammaRamp;
 };
 
-struct __NvCtrlNvmlAttributes {
+/*
+ * NVML state shared by all the targets of a CtrlSystem: the library is
+ * loaded and initialized, and the GPU, thermal sensor and cooler topology
+ * probed, once per system.  Each NvCtrlNvmlAttributes holds a reference.
+ */
+
+struct __NvCtrlNvmlContext {
+    int refcount;
+    Bool loaded;            /* False if NVML could not be used */
+
     struct {
         void *handle;
 
@@ -181,12 +192,33 @@ struct __NvCtrlNvmlAttributes {
 
     } lib;
 
-    unsigned int deviceIdx; /* XXX Needed while using NV-CONTROL as fallback */
     unsigned int deviceCount;
+    unsigned int *nvctrlToNvmlId;     /* NVML index of each NV-CONTROL GPU */
     unsigned int sensorCount;
     unsigned int *sensorCountPerGPU;
+    unsigned int *sensorDeviceIdx;    /* NVML index of each sensor's GPU */
     unsigned int coolerCount;
     unsigned int *coolerCountPerGPU;
+    unsigned int *coolerDeviceIdx;    /* NVML index of each cooler's GPU */
+};
+
+struct __NvCtrlNvmlAttributes {
+    NvCtrlNvmlContext *ctx;
+
+    unsigned int deviceIdx; /* XXX Needed while using NV-CONTROL as fallback */
+
+    /* Resolved once, and again after a GPU reset or hotplug */
+    nvmlDevice_t device;
+    Bool deviceValid;
+    int sensorId;           /* sensor of the device, for thermal targets */
+    int coolerId;           /* cooler of the device, for cooler targets */
+
+    /* Values covering several attributes, see getNvmlPciInfo() */
+    nvmlPciInfo_t pci;
+    Bool pciValid;
+    nvmlMemory_t memory;
+    Bool memoryValid;
+    Bool groupedRead;
 };
 
 struct __NvCtrlAttributePrivateHandle {
@@ -209,6 +241,7 @@ struct __NvCtrlAttributePrivateHandle {
 
 struct __NvCtrlEventPrivateHandle {
     Display *dpy;          /* display connection */
+    CtrlSystem *system;    /* system whose attribute caches events flush */
     int fd;                /* file descriptor to poll for new events */
     int nvctrl_event_base; /* NV-CONTROL base for indexing & identifying evts */
     int xrandr_event_base; /* RandR base for indexing & identifying evts */
@@ -249,7 +282,8 @@ static inline const NvCtrlAttributePrivateHandle
 
 
 NvCtrlNvControlAttributes *
-NvCtrlInitNvControlAttributes (NvCtrlAttributePrivateHandle *);
+NvCtrlInitNvControlAttributes (NvCtrlAttributePrivateHandle *,
+                               CtrlSystem *);
 
 NvCtrlVidModeAttributes *
 NvCtrlInitVidModeAttributes (NvCtrlAttributePrivateHandle *);
@@ -357,10 +391,18 @@ NvCtrlNvControlQueryTargetCount(const NvCtrlAttributePrivateHandle *, int,
 ReturnStatus NvCtrlNvControlGetAttribute(const NvCtrlAttributePrivateHandle *,
                                          unsigned int, int, int64_t *);
 
+ReturnStatus NvCtrlNvControlGetAttributes(const NvCtrlAttributePrivateHandle *,
+                                          unsigned int, int, const int *,
+                                          int64_t *, ReturnStatus *);
+
+void NvCtrlNvControlQueryAttributes(CtrlAttributeQuery *, int);
+
 ReturnStatus
 NvCtrlNvControlSetAttribute (NvCtrlAttributePrivateHandle *, unsigned int,
                              int, int);
 
+void NvCtrlNvControlSetAttributes(CtrlAttributeAssignment *, int);
+
 ReturnStatus
 NvCtrlNvControlSetAttributeWithReply (NvCtrlAttributePrivateHandle *,
                                       unsigned int, int, int);
@@ -375,6 +417,9 @@ NvCtrlNvControlGetValidAttributeValues(const NvCtrlAttributePrivateHandle *,
                                        unsigned int, int,
                                        CtrlAttributeValidValues *);
 
+void NvCtrlNvControlQueryValidAttributeValues(CtrlAttributeQuery *,
+                                              CtrlAttributeValidValues *, int);
+
 ReturnStatus
 NvCtrlNvControlGetValidStringDisplayAttributeValues
                                       (const NvCtrlAttributePrivateHandle *,
@@ -414,10 +459,71 @@ void NvCtrlAssignGammaInput(NvCtrlGammaInput *pGammaInput,
                             const float inGamma[3],
                             const unsigned int bitmask);
 
+/* Attribute metadata cache (NvCtrlAttributesUtils.c) */
+
+typedef enum {
+    CTRL_ATTRIBUTE_CACHE_PERMS = 0,
+    CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+    CTRL_ATTRIBUTE_CACHE_NUM_KINDS,
+} CtrlAttributeCacheKind;
+
+#define CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES -1
+
+Bool NvCtrlAttributeCacheLookup(const CtrlTarget *ctrl_target,
+                                CtrlAttributeCacheKind kind,
+                                CtrlAttributeType attr_type, int attr,
+                                unsigned int display_mask,
+                                void *data, ReturnStatus *status);
+void NvCtrlAttributeCacheStore(const CtrlTarget *ctrl_target,
+                               CtrlAttributeCacheKind kind,
+                               CtrlAttributeType attr_type, int attr,
+                               unsigned int display_mask,
+                               const void *data, ReturnStatus status);
+void NvCtrlAttributeCacheInvalidate(const CtrlTarget *ctrl_target,
+                                    CtrlAttributeCacheKind kind, int attr);
+void NvCtrlAttributeCacheInvalidateSystem(const CtrlSystem *system,
+                                          CtrlAttributeCacheKind kind,
+                                          int attr);
+void NvCtrlAttributeCacheTargetChanged(const CtrlTarget *ctrl_target);
+void NvCtrlAttributeCacheHandleEvent(const CtrlSystem *system,
+                                     const CtrlEvent *event);
+
+/* On-disk topology cache (NvCtrlAttributesTopology.c) */
+
+typedef struct __NvCtrlTopologyCache NvCtrlTopologyCache;
+
+typedef struct {
+    CtrlTargetType target_type;
+    int target_id;
+    Bool physical;   /* a physical X screen, rather than an API target */
+    Bool enabled;    /* display.enabled */
+    Bool connected;  /* display.connected */
+    unsigned int d;
+    unsigned int c;
+    const char *protoNames[NV_PROTO_NAME_MAX];
+    int num_relations;
+    const int32_t *relations; /* indices of the related cached targets */
+} NvCtrlTopologyTarget;
+
+Bool NvCtrlGetTopologyCacheEnabled(void);
+NvCtrlTopologyCache *NvCtrlTopologyCacheOpen(const CtrlSystem *system);
+Bool NvCtrlTopologyCacheIsValid(const NvCtrlTopologyCache *cache);
+int  NvCtrlTopologyCacheTargetCount(const NvCtrlTopologyCache *cache);
+Bool NvCtrlTopologyCacheGetTarget(const NvCtrlTopologyCache *cache, int index,
+                                  NvCtrlTopologyTarget *target);
+void NvCtrlTopologyCacheSave(NvCtrlTopologyCache *cache,
+                             const CtrlSystem *system);
+void NvCtrlTopologyCacheClose(NvCtrlTopologyCache *cache);
+
 /* NVML backend functions */
 
-NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *);
+NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *,
+                                               CtrlSystem *);
 void                  NvCtrlNvmlAttributesClose(NvCtrlAttributePrivateHandle *);
+void                  NvCtrlNvmlReleaseContext(NvCtrlNvmlContext *);
+
+void NvCtrlNvmlBeginGroupedRead(const CtrlTarget *ctrl_target);
+void NvCtrlNvmlEndGroupedRead(const CtrlTarget *ctrl_target);
 
 ReturnStatus NvCtrlNvmlQueryTargetCount(const CtrlTarget *ctrl_target,
                                         int target_type, int *val);
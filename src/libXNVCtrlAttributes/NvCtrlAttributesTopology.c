@@ -0,0 +1,882 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * NvCtrlAttributesTopology.c - on-disk cache of the targets discovered on a
+ * CtrlSystem (X screens, GPUs, display devices, ... along with their names
+ * and relationships), so that later runs against an unchanged X server can
+ * skip most of the NV-CONTROL round trips made during target discovery.
+ *
+ * The cache file lives in $XDG_CACHE_HOME/nvidia-settings (~/.cache by
+ * default), one file per X display and host.  It is only trusted when the
+ * fingerprint stored in it matches one computed from the running X server:
+ * the server vendor and release, the NVIDIA driver version, the number of
+ * targets of each type, the GPU UUIDs, and the display devices present,
+ * connected and enabled on each X screen.
+ *
+ * File layout (host byte order; the cache is never shared between hosts):
+ *
+ *   TopologyHeader
+ *   TopologyRecord[num_targets]
+ *   int32_t        relations[num_relations]  (indices into the records)
+ *   char           strings[strings_size]     (NUL-terminated names)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/utsname.h>
+
+#include <X11/Xlib.h>
+
+#include "NvCtrlAttributes.h"
+#include "NvCtrlAttributesPrivate.h"
+
+#include "NVCtrlLib.h"
+
+#include "common-utils.h"
+#include "msg.h"
+#include "profile.h"
+
+
+#define TOPOLOGY_MAGIC   "NVSTOPO"
+#define TOPOLOGY_VERSION 1
+
+#define TOPOLOGY_FLAG_PHYSICAL  0x1
+#define TOPOLOGY_FLAG_ENABLED   0x2
+#define TOPOLOGY_FLAG_CONNECTED 0x4
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME        1099511628211ULL
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_proto_names;  /* NV_PROTO_NAME_MAX when written */
+    uint64_t fingerprint;
+    uint32_t num_targets;
+    uint32_t num_relations;
+    uint32_t strings_size;
+    uint32_t reserved;
+} TopologyHeader;
+
+typedef struct {
+    int32_t target_type;
+    int32_t target_id;
+    uint32_t flags;
+    uint32_t d;
+    uint32_t c;
+    int32_t proto_names[NV_PROTO_NAME_MAX]; /* string offsets, -1 if NULL */
+    uint32_t first_relation;
+    uint32_t num_relations;
+} TopologyRecord;
+
+struct __NvCtrlTopologyCache {
+    char *path;            /* cache file for this X display */
+    uint64_t fingerprint;  /* of the running X server */
+    Bool have_fingerprint;
+
+    void *map;             /* mapping of a validated cache file, or NULL */
+    size_t map_size;
+    const TopologyHeader *header;
+    const TopologyRecord *records;
+    const int32_t *relations;
+    const char *strings;
+};
+
+static Bool topology_cache_enabled = FALSE;
+
+
+
+void NvCtrlSetTopologyCacheEnabled(Bool enabled)
+{
+    topology_cache_enabled = enabled;
+}
+
+
+
+Bool NvCtrlGetTopologyCacheEnabled(void)
+{
+    return topology_cache_enabled;
+}
+
+
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+
+static uint64_t hash_int(uint64_t hash, int value)
+{
+    return hash_bytes(hash, &value, sizeof(value));
+}
+
+
+
+static uint64_t hash_string(uint64_t hash, const char *str)
+{
+    if (!str) {
+        return hash_int(hash, -1);
+    }
+
+    /* include the terminator so that "ab","c" and "a","bc" differ */
+    return hash_bytes(hash, str, strlen(str) + 1);
+}
+
+
+
+/*
+ * Hash the reply to a binary NV-CONTROL query sent with
+ * XNVCTRLSendQueryTargetBinaryData() into the fingerprint; failures are
+ * hashed too, so that a target appearing or disappearing changes the
+ * fingerprint.
+ */
+
+static uint64_t hash_binary_reply(uint64_t hash, Display *dpy,
+                                  XNVCTRLCookie cookie, Bool *success)
+{
+    unsigned char *data = NULL;
+    int len = 0;
+
+    if (!XNVCTRLWaitQueryTargetBinaryData(dpy, cookie, &data, &len) ||
+        !data) {
+        if (success) {
+            *success = FALSE;
+        }
+        return hash_int(hash, -1);
+    }
+
+    hash = hash_int(hash, len);
+    hash = hash_bytes(hash, data, len);
+    XFree(data);
+
+    if (success) {
+        *success = TRUE;
+    }
+    return hash;
+}
+
+
+
+/*
+ * Hash the reply to a string NV-CONTROL query sent with
+ * XNVCTRLSendQueryTargetStringAttribute() into the fingerprint.
+ */
+
+static uint64_t hash_string_reply(uint64_t hash, Display *dpy,
+                                  XNVCTRLCookie cookie)
+{
+    char *str = NULL;
+
+    if (!XNVCTRLWaitQueryTargetStringAttribute(dpy, cookie, &str)) {
+        return hash_string(hash, NULL);
+    }
+
+    hash = hash_string(hash, str);
+    XFree(str);
+
+    return hash;
+}
+
+
+
+/*
+ * The NV-CONTROL target types whose number of targets is part of the
+ * fingerprint; display devices are covered by the per-GPU and per-screen
+ * display lists instead.
+ */
+
+static const int counted_target_types[] = {
+    NV_CTRL_TARGET_TYPE_X_SCREEN,
+    NV_CTRL_TARGET_TYPE_GPU,
+    NV_CTRL_TARGET_TYPE_FRAMELOCK,
+    NV_CTRL_TARGET_TYPE_VCSC,
+    NV_CTRL_TARGET_TYPE_GVI,
+    NV_CTRL_TARGET_TYPE_COOLER,
+    NV_CTRL_TARGET_TYPE_THERMAL_SENSOR,
+    NV_CTRL_TARGET_TYPE_3D_VISION_PRO_TRANSCEIVER,
+};
+
+
+
+/*
+ * Compute the fingerprint of the X server's current topology.  NV-CONTROL
+ * has no topology generation counter, so the per-screen and per-GPU state
+ * is queried instead; those queries are sent in bursts before any reply
+ * is waited for, so this costs a small constant number of round trips no
+ * matter how many X screens and GPUs there are.
+ */
+
+static Bool compute_fingerprint(Display *dpy, uint64_t *fingerprint)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    int event_base, error_base;
+    int screen, nv_screen = -1;
+    int gpu, gpu_count, count, i;
+    XNVCTRLCookie *cookies;
+    XNVCTRLCookie targets_cookie;
+    XNVCTRLCookie count_cookies[ARRAY_LEN(counted_target_types)];
+
+    if (!XNVCTRLQueryExtension(dpy, &event_base, &error_base)) {
+        return FALSE;
+    }
+
+    hash = hash_string(hash, ServerVendor(dpy));
+    hash = hash_int(hash, VendorRelease(dpy));
+    hash = hash_int(hash, ScreenCount(dpy));
+
+    /* the display devices enabled on each (NVIDIA) X screen */
+
+    cookies = nvalloc(ScreenCount(dpy) * sizeof(XNVCTRLCookie));
+
+    for (screen = 0; screen < ScreenCount(dpy); screen++) {
+        cookies[screen] =
+            XNVCTRLSendQueryTargetBinaryData(dpy, NV_CTRL_TARGET_TYPE_X_SCREEN,
+                                             screen, 0,
+                                             NV_CTRL_BINARY_DATA_DISPLAYS_ENABLED_ON_XSCREEN);
+    }
+
+    nv_profile_round_trip();
+    for (screen = 0; screen < ScreenCount(dpy); screen++) {
+        Bool success;
+
+        hash = hash_binary_reply(hash, dpy, cookies[screen], &success);
+        if (success && (nv_screen < 0)) {
+            nv_screen = screen;
+        }
+    }
+
+    nvfree(cookies);
+
+    /* without an NVIDIA X screen there is nothing worth caching */
+
+    if (nv_screen < 0) {
+        return FALSE;
+    }
+
+    /*
+     * the display targets, and the number of targets of each type that
+     * NvCtrlConnectToSystem() enumerates
+     */
+
+    targets_cookie =
+        XNVCTRLSendQueryTargetBinaryData(dpy, NV_CTRL_TARGET_TYPE_X_SCREEN,
+                                         nv_screen, 0,
+                                         NV_CTRL_BINARY_DATA_DISPLAY_TARGETS);
+
+    for (i = 0; i < ARRAY_LEN(counted_target_types); i++) {
+        count_cookies[i] =
+            XNVCTRLSendQueryTargetCount(dpy, counted_target_types[i]);
+    }
+
+    nv_profile_round_trip();
+    hash = hash_binary_reply(hash, dpy, targets_cookie, NULL);
+
+    gpu_count = -1;
+    for (i = 0; i < ARRAY_LEN(counted_target_types); i++) {
+        if (!XNVCTRLWaitQueryTargetCount(dpy, count_cookies[i], &count)) {
+            count = -1;
+        }
+        if (counted_target_types[i] == NV_CTRL_TARGET_TYPE_GPU) {
+            gpu_count = count;
+        }
+        hash = hash_int(hash, count);
+    }
+
+    if (gpu_count < 0) {
+        return FALSE;
+    }
+
+    /* the driver version, the GPUs and the display devices on each */
+
+    cookies = nvalloc((1 + 2 * gpu_count) * sizeof(XNVCTRLCookie));
+
+    cookies[0] =
+        XNVCTRLSendQueryTargetStringAttribute(dpy, NV_CTRL_TARGET_TYPE_GPU,
+                                              0, 0,
+                                              NV_CTRL_STRING_NVIDIA_DRIVER_VERSION);
+    for (gpu = 0; gpu < gpu_count; gpu++) {
+        cookies[1 + 2 * gpu] =
+            XNVCTRLSendQueryTargetStringAttribute(dpy, NV_CTRL_TARGET_TYPE_GPU,
+                                                  gpu, 0,
+                                                  NV_CTRL_STRING_GPU_UUID);
+        cookies[2 + 2 * gpu] =
+            XNVCTRLSendQueryTargetBinaryData(dpy, NV_CTRL_TARGET_TYPE_GPU,
+                                             gpu, 0,
+                                             NV_CTRL_BINARY_DATA_DISPLAYS_CONNECTED_TO_GPU);
+    }
+
+    nv_profile_round_trip();
+    hash = hash_string_reply(hash, dpy, cookies[0]);
+    for (gpu = 0; gpu < gpu_count; gpu++) {
+        hash = hash_string_reply(hash, dpy, cookies[1 + 2 * gpu]);
+        hash = hash_binary_reply(hash, dpy, cookies[2 + 2 * gpu], NULL);
+    }
+
+    nvfree(cookies);
+
+    *fingerprint = hash;
+
+    return TRUE;
+}
+
+
+
+/*
+ * Build the path of the cache file for the given X display, creating the
+ * cache directory if needed.  The file name is keyed by the display name
+ * and the host name, since the cache directory may be shared between
+ * hosts (e.g. an NFS mounted home directory).
+ */
+
+static char *get_cache_path(Display *dpy, Bool create_dir)
+{
+    const char *base = getenv("XDG_CACHE_HOME");
+    char *cache_home, *dir, *path;
+    struct utsname uts;
+    uint64_t key = FNV_OFFSET_BASIS;
+
+    if (base && base[0] == '/') {
+        cache_home = nvstrdup(base);
+    } else {
+        const char *home = getenv("HOME");
+
+        if (!home || home[0] == '\0') {
+            return NULL;
+        }
+        cache_home = nvstrcat(home, "/.cache", NULL);
+    }
+
+    dir = nvstrcat(cache_home, "/nvidia-settings", NULL);
+
+    if (create_dir) {
+        if ((mkdir(cache_home, 0700) != 0 && errno != EEXIST) ||
+            (mkdir(dir, 0700) != 0 && errno != EEXIST)) {
+            nvfree(cache_home);
+            nvfree(dir);
+            return NULL;
+        }
+    }
+
+    key = hash_string(key, DisplayString(dpy));
+    if (uname(&uts) == 0) {
+        key = hash_string(key, uts.nodename);
+    }
+
+    path = nvasprintf("%s/topology-%016llx", dir, (unsigned long long) key);
+
+    nvfree(cache_home);
+    nvfree(dir);
+
+    return path;
+}
+
+
+
+/*
+ * Check that the mapped cache file is complete and self-consistent, so
+ * that the records can be used without further bounds checking.
+ */
+
+static Bool validate_mapping(NvCtrlTopologyCache *cache)
+{
+    const TopologyHeader *header = cache->map;
+    size_t size = sizeof(*header);
+    uint32_t i;
+    int j;
+
+    if ((cache->map_size < sizeof(*header)) ||
+        (memcmp(header->magic, TOPOLOGY_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != TOPOLOGY_VERSION) ||
+        (header->num_proto_names != NV_PROTO_NAME_MAX) ||
+        (header->fingerprint != cache->fingerprint)) {
+        return FALSE;
+    }
+
+    /* guard the size computation below against overflow */
+
+    if ((header->num_targets > 0xffff) || (header->num_relations > 0xffffff)) {
+        return FALSE;
+    }
+
+    size += (size_t) header->num_targets * sizeof(TopologyRecord);
+    size += (size_t) header->num_relations * sizeof(int32_t);
+    size += header->strings_size;
+
+    if ((size != cache->map_size) || (header->strings_size == 0)) {
+        return FALSE;
+    }
+
+    cache->header = header;
+    cache->records = (const TopologyRecord *)(header + 1);
+    cache->relations =
+        (const int32_t *)(cache->records + header->num_targets);
+    cache->strings = (const char *)(cache->relations + header->num_relations);
+
+    if (cache->strings[header->strings_size - 1] != '\0') {
+        return FALSE;
+    }
+
+    for (i = 0; i < header->num_relations; i++) {
+        if ((cache->relations[i] < 0) ||
+            ((uint32_t) cache->relations[i] >= header->num_targets)) {
+            return FALSE;
+        }
+    }
+
+    for (i = 0; i < header->num_targets; i++) {
+        const TopologyRecord *r = &cache->records[i];
+
+        if (!NvCtrlIsTargetTypeValid(r->target_type) ||
+            (r->first_relation > header->num_relations) ||
+            (r->num_relations > header->num_relations - r->first_relation)) {
+            return FALSE;
+        }
+
+        for (j = 0; j < NV_PROTO_NAME_MAX; j++) {
+            if ((r->proto_names[j] < -1) ||
+                (r->proto_names[j] >= (int32_t) header->strings_size)) {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+
+
+/*!
+ * Compute the topology fingerprint of the given system's X server and map
+ * its cache file, if there is a valid one.
+ *
+ * \param[in]  system  The CtrlSystem, with its X display connection open.
+ *
+ * \return  Return a new NvCtrlTopologyCache, to be released with
+ *          NvCtrlTopologyCacheClose(); NvCtrlTopologyCacheIsValid() tells
+ *          whether cached targets are available.  Returns NULL if the
+ *          topology cannot be cached for this X server.
+ */
+
+NvCtrlTopologyCache *NvCtrlTopologyCacheOpen(const CtrlSystem *system)
+{
+    NvCtrlTopologyCache *cache;
+    struct stat st;
+    int fd;
+
+    if (!system || !system->dpy) {
+        return NULL;
+    }
+
+    cache = nvalloc(sizeof(*cache));
+
+    nv_profile_begin("topology fingerprint");
+    cache->have_fingerprint = compute_fingerprint(system->dpy,
+                                                  &cache->fingerprint);
+    nv_profile_end();
+
+    if (!cache->have_fingerprint) {
+        nvfree(cache);
+        return NULL;
+    }
+
+    cache->path = get_cache_path(system->dpy, FALSE);
+    if (!cache->path) {
+        nvfree(cache);
+        return NULL;
+    }
+
+    fd = open(cache->path, O_RDONLY);
+    if (fd < 0) {
+        return cache;
+    }
+
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+        cache->map_size = st.st_size;
+        cache->map = mmap(NULL, cache->map_size, PROT_READ, MAP_PRIVATE,
+                          fd, 0);
+        if (cache->map == MAP_FAILED) {
+            cache->map = NULL;
+        }
+    }
+
+    close(fd);
+
+    if (cache->map && !validate_mapping(cache)) {
+        nv_info_msg(NULL, "Ignoring stale topology cache '%s'.", cache->path);
+        munmap(cache->map, cache->map_size);
+        cache->map = NULL;
+        cache->header = NULL;
+    }
+
+    return cache;
+}
+
+
+
+Bool NvCtrlTopologyCacheIsValid(const NvCtrlTopologyCache *cache)
+{
+    return cache && cache->header;
+}
+
+
+
+int NvCtrlTopologyCacheTargetCount(const NvCtrlTopologyCache *cache)
+{
+    if (!NvCtrlTopologyCacheIsValid(cache)) {
+        return 0;
+    }
+
+    return cache->header->num_targets;
+}
+
+
+
+/*!
+ * Retrieve a cached target.  The strings and relation indices returned
+ * point into the cache file mapping, and are valid until the cache is
+ * closed.
+ */
+
+Bool NvCtrlTopologyCacheGetTarget(const NvCtrlTopologyCache *cache, int index,
+                                  NvCtrlTopologyTarget *target)
+{
+    const TopologyRecord *r;
+    int i;
+
+    if ((index < 0) || (index >= NvCtrlTopologyCacheTargetCount(cache))) {
+        return FALSE;
+    }
+
+    r = &cache->records[index];
+
+    target->target_type = r->target_type;
+    target->target_id = r->target_id;
+    target->physical = !!(r->flags & TOPOLOGY_FLAG_PHYSICAL);
+    target->enabled = !!(r->flags & TOPOLOGY_FLAG_ENABLED);
+    target->connected = !!(r->flags & TOPOLOGY_FLAG_CONNECTED);
+    target->d = r->d;
+    target->c = r->c;
+
+    for (i = 0; i < NV_PROTO_NAME_MAX; i++) {
+        target->protoNames[i] = (r->proto_names[i] < 0) ? NULL :
+            cache->strings + r->proto_names[i];
+    }
+
+    target->num_relations = r->num_relations;
+    target->relations = cache->relations + r->first_relation;
+
+    return TRUE;
+}
+
+
+
+/*
+ * Flatten the system's target lists (API targets of each type, then the
+ * physical X screens) into a single array, in the order in which they
+ * are recorded in the cache.
+ */
+
+static CtrlTarget **collect_targets(const CtrlSystem *system, int *count,
+                                    int *num_physical)
+{
+    CtrlTarget **targets;
+    CtrlTargetNode *node;
+    int n = 0, i;
+
+    for (i = 0; i < MAX_TARGET_TYPES; i++) {
+        for (node = system->targets[i]; node; node = node->next) {
+            n++;
+        }
+    }
+    for (node = system->physical_screens; node; node = node->next) {
+        n++;
+    }
+
+    targets = nvalloc(sizeof(*targets) * (n ? n : 1));
+
+    n = 0;
+    for (i = 0; i < MAX_TARGET_TYPES; i++) {
+        for (node = system->targets[i]; node; node = node->next) {
+            targets[n++] = node->t;
+        }
+    }
+
+    *num_physical = 0;
+    for (node = system->physical_screens; node; node = node->next) {
+        targets[n++] = node->t;
+        (*num_physical)++;
+    }
+
+    *count = n;
+
+    return targets;
+}
+
+
+
+/*
+ * Map from CtrlTarget pointers to their indices in the array built by
+ * collect_targets(): an open addressing hash table, kept at most half
+ * full, so that the relations of all targets are resolved in linear time.
+ */
+
+typedef struct {
+    const CtrlTarget **keys;
+    int *indices;
+    unsigned int mask;
+} TargetIndexMap;
+
+static unsigned int hash_target(const CtrlTarget *target)
+{
+    uintptr_t h = (uintptr_t) target;
+
+    h ^= h >> 17;
+    h *= 0x9E3779B1u;
+
+    return (unsigned int) (h ^ (h >> 15));
+}
+
+static void build_target_index_map(TargetIndexMap *map,
+                                   CtrlTarget **targets, int count)
+{
+    unsigned int size, slot;
+    int i;
+
+    for (size = 2; size < (unsigned int) count * 2; size <<= 1);
+
+    map->keys = nvalloc(sizeof(*map->keys) * size);
+    map->indices = nvalloc(sizeof(*map->indices) * size);
+    map->mask = size - 1;
+
+    /* the first occurrence of a target wins */
+
+    for (i = 0; i < count; i++) {
+        slot = hash_target(targets[i]) & map->mask;
+        while (map->keys[slot] && map->keys[slot] != targets[i]) {
+            slot = (slot + 1) & map->mask;
+        }
+        if (!map->keys[slot]) {
+            map->keys[slot] = targets[i];
+            map->indices[slot] = i;
+        }
+    }
+}
+
+static int find_target_index(const TargetIndexMap *map,
+                             const CtrlTarget *target)
+{
+    unsigned int slot = hash_target(target) & map->mask;
+
+    while (map->keys[slot]) {
+        if (map->keys[slot] == target) {
+            return map->indices[slot];
+        }
+        slot = (slot + 1) & map->mask;
+    }
+
+    return -1;
+}
+
+static void free_target_index_map(TargetIndexMap *map)
+{
+    nvfree(map->keys);
+    nvfree(map->indices);
+}
+
+
+
+/*!
+ * Write the given system's targets to the cache file, under the
+ * fingerprint computed by NvCtrlTopologyCacheOpen().  The file is written
+ * to a temporary file first and renamed into place, so that concurrent
+ * nvidia-settings processes never see a partially written cache.
+ */
+
+void NvCtrlTopologyCacheSave(NvCtrlTopologyCache *cache,
+                             const CtrlSystem *system)
+{
+    TopologyHeader header;
+    TopologyRecord *records;
+    int32_t *relations = NULL;
+    char *strings = NULL;
+    size_t strings_size = 0, strings_alloc = 0;
+    CtrlTarget **targets;
+    TargetIndexMap index_map;
+    int count, num_physical, num_relations = 0;
+    int i, j, fd;
+    char *path, *tmp_path;
+    Bool ok;
+
+    if (!cache || !cache->have_fingerprint || !system) {
+        return;
+    }
+
+    targets = collect_targets(system, &count, &num_physical);
+    records = nvalloc(sizeof(*records) * (count ? count : 1));
+
+    for (i = 0; i < count; i++) {
+        CtrlTargetNode *node;
+
+        for (node = targets[i]->relations; node; node = node->next) {
+            num_relations++;
+        }
+    }
+    relations = nvalloc(sizeof(*relations) *
+                        (num_relations ? num_relations : 1));
+    num_relations = 0;
+
+    build_target_index_map(&index_map, targets, count);
+
+    for (i = 0; i < count; i++) {
+        const CtrlTarget *t = targets[i];
+        CtrlTargetNode *node;
+        TopologyRecord *r = &records[i];
+
+        r->target_type = NvCtrlGetTargetType(t);
+        r->target_id = NvCtrlGetTargetId(t);
+        r->flags = (i >= count - num_physical) ? TOPOLOGY_FLAG_PHYSICAL : 0;
+        if (t->display.enabled) {
+            r->flags |= TOPOLOGY_FLAG_ENABLED;
+        }
+        if (t->display.connected) {
+            r->flags |= TOPOLOGY_FLAG_CONNECTED;
+        }
+        r->d = t->d;
+        r->c = t->c;
+
+        for (j = 0; j < NV_PROTO_NAME_MAX; j++) {
+            size_t len;
+
+            if (!t->protoNames[j]) {
+                r->proto_names[j] = -1;
+                continue;
+            }
+
+            len = strlen(t->protoNames[j]) + 1;
+            if (strings_size + len > strings_alloc) {
+                strings_alloc = (strings_size + len) * 2;
+                strings = nvrealloc(strings, strings_alloc);
+            }
+            memcpy(strings + strings_size, t->protoNames[j], len);
+            r->proto_names[j] = strings_size;
+            strings_size += len;
+        }
+
+        r->first_relation = num_relations;
+        for (node = t->relations; node; node = node->next) {
+            int index = find_target_index(&index_map, node->t);
+
+            if (index >= 0) {
+                relations[num_relations++] = index;
+            }
+        }
+        r->num_relations = num_relations - r->first_relation;
+    }
+
+    free_target_index_map(&index_map);
+
+    /* always have a non-empty string table; see validate_mapping() */
+
+    strings = nvrealloc(strings, strings_size + 1);
+    strings[strings_size++] = '\0';
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TOPOLOGY_MAGIC, sizeof(header.magic));
+    header.version = TOPOLOGY_VERSION;
+    header.num_proto_names = NV_PROTO_NAME_MAX;
+    header.fingerprint = cache->fingerprint;
+    header.num_targets = count;
+    header.num_relations = num_relations;
+    header.strings_size = strings_size;
+
+    path = get_cache_path(system->dpy, TRUE);
+    if (!path) {
+        goto done;
+    }
+
+    tmp_path = nvstrcat(path, ".XXXXXX", NULL);
+    fd = mkstemp(tmp_path);
+
+    if (fd >= 0) {
+        FILE *fp = fdopen(fd, "w");
+
+        if (fp) {
+            ok = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+                 (!count ||
+                  fwrite(records, sizeof(*records), count, fp) == count) &&
+                 (!num_relations ||
+                  fwrite(relations, sizeof(*relations), num_relations, fp) ==
+                      num_relations) &&
+                 (fwrite(strings, 1, strings_size, fp) == strings_size);
+            ok = (fclose(fp) == 0) && ok;
+        } else {
+            close(fd);
+            ok = FALSE;
+        }
+
+        if (!ok || rename(tmp_path, path) != 0) {
+            nv_warning_msg("Unable to write topology cache '%s'.", path);
+            unlink(tmp_path);
+        }
+    }
+
+    nvfree(tmp_path);
+    nvfree(path);
+
+ done:
+    nvfree(strings);
+    nvfree(relations);
+    nvfree(records);
+    nvfree(targets);
+}
+
+
+
+void NvCtrlTopologyCacheClose(NvCtrlTopologyCache *cache)
+{
+    if (!cache) {
+        return;
+    }
+
+    if (cache->map) {
+        munmap(cache->map, cache->map_size);
+    }
+
+    nvfree(cache->path);
+    nvfree(cache);
+}
@@ -31,34 +31,406 @@
 
 #include "parse.h"
 #include "msg.h"
+#include "profile.h"
 #include "NvCtrlAttributes.h"
 #include "NvCtrlAttributesPrivate.h"
 
 
 
+/*
+ * Per-target cache of attribute metadata (permissions and valid values).
+ * This information almost never changes during a session, yet the
+ * front-end asks for it over and over (query_all(), the GUI page
+ * constructors, ...).  Entries are keyed by (kind, attribute type,
+ * attribute, display mask) and stored in a small chained hash table
+ * that is allocated the first time something is stored for a target.
+ *
+ * Each entry records the generation of its kind at the time it was
+ * stored, so that all entries of a kind can be dropped in O(1) by
+ * bumping the generation; stale entries are reused by the next store.
+ */
+
+#define CTRL_ATTRIBUTE_CACHE_BUCKETS 256
+
+typedef struct _CtrlAttributeCacheEntry CtrlAttributeCacheEntry;
+
+struct _CtrlAttributeCacheEntry {
+    CtrlAttributeCacheEntry *next;
+
+    CtrlAttributeCacheKind kind;
+    CtrlAttributeType attr_type;
+    int attr;
+    unsigned int display_mask;
+    unsigned int generation;
+
+    ReturnStatus status;
+    union {
+        CtrlAttributePerms perms;
+        CtrlAttributeValidValues valid;
+    } data;
+};
+
+struct _CtrlAttributeCache {
+    CtrlAttributeCacheEntry *buckets[CTRL_ATTRIBUTE_CACHE_BUCKETS];
+    unsigned int generation[CTRL_ATTRIBUTE_CACHE_NUM_KINDS];
+    unsigned int hits;
+    unsigned int misses;
+};
+
+
+static unsigned int attribute_cache_hash(CtrlAttributeCacheKind kind,
+                                         CtrlAttributeType attr_type,
+                                         int attr, unsigned int display_mask)
+{
+    unsigned int h = (unsigned int) attr;
+
+    h = (h * 31) + (unsigned int) attr_type;
+    h = (h * 31) + (unsigned int) kind;
+    h = (h * 31) + display_mask;
+
+    return h % CTRL_ATTRIBUTE_CACHE_BUCKETS;
+}
+
+
+static size_t attribute_cache_data_size(CtrlAttributeCacheKind kind)
+{
+    if (kind == CTRL_ATTRIBUTE_CACHE_PERMS) {
+        return sizeof(CtrlAttributePerms);
+    }
+    return sizeof(CtrlAttributeValidValues);
+}
+
+
+/*
+ * The cache is allocated on first use; it is not considered part of the
+ * target's logical state, so this is allowed on const targets.
+ */
+
+static struct _CtrlAttributeCache *
+get_attribute_cache(const CtrlTarget *ctrl_target)
+{
+    CtrlTarget *t = (CtrlTarget *) ctrl_target;
+
+    if (!t->cache) {
+        t->cache = nvalloc(sizeof(*t->cache));
+    }
+
+    return t->cache;
+}
+
+
+static CtrlAttributeCacheEntry *
+find_attribute_cache_entry(const struct _CtrlAttributeCache *cache,
+                           CtrlAttributeCacheKind kind,
+                           CtrlAttributeType attr_type, int attr,
+                           unsigned int display_mask)
+{
+    CtrlAttributeCacheEntry *entry;
+    unsigned int bucket = attribute_cache_hash(kind, attr_type, attr,
+                                               display_mask);
+
+    for (entry = cache->buckets[bucket]; entry; entry = entry->next) {
+        if (entry->kind == kind &&
+            entry->attr_type == attr_type &&
+            entry->attr == attr &&
+            entry->display_mask == display_mask) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+
 /*!
- * Queries the NV-CONTROL string attribute and returns the string as a simple
- * char *.  This is useful to avoid having to track how strings are allocated
- * so we can cleanup all strings via nvfree().
+ * Looks up cached attribute metadata for the given target.
  *
- * \param[in]  t     The CtrlTarget to query the string on.
- * \param[in]  attr  The NV-CONTROL string to query.
+ * \param[in]  ctrl_target   The CtrlTarget the metadata belongs to.
+ * \param[in]  kind          Whether permissions or valid values are wanted.
+ * \param[in]  attr_type     The type of the attribute.
+ * \param[in]  attr          The attribute.
+ * \param[in]  display_mask  The display mask the metadata was queried with.
+ * \param[out] data          Where to copy the cached CtrlAttributePerms or
+ *                           CtrlAttributeValidValues, if cached successfully.
+ * \param[out] status        The status the original query returned.
  *
- * \return  Return a nvalloc()'ed copy of the NV-CONTROL string; else, returns
- *          NULL.
+ * \return  Returns NV_TRUE if the metadata was found in the cache; else,
+ *          returns NV_FALSE.
  */
 
-static char *query_x_name(const CtrlTarget *t, int attr)
+Bool NvCtrlAttributeCacheLookup(const CtrlTarget *ctrl_target,
+                                CtrlAttributeCacheKind kind,
+                                CtrlAttributeType attr_type, int attr,
+                                unsigned int display_mask,
+                                void *data, ReturnStatus *status)
 {
-    ReturnStatus status;
-    char *str = NULL;
+    struct _CtrlAttributeCache *cache;
+    CtrlAttributeCacheEntry *entry;
 
-    status = NvCtrlGetStringAttribute(t, attr, &str);
-    if (status != NvCtrlSuccess) {
-        return NULL;
+    if (!ctrl_target) {
+        return NV_FALSE;
+    }
+
+    cache = get_attribute_cache(ctrl_target);
+
+    entry = find_attribute_cache_entry(cache, kind, attr_type, attr,
+                                       display_mask);
+    if (!entry || entry->generation != cache->generation[kind]) {
+        cache->misses++;
+        return NV_FALSE;
+    }
+
+    cache->hits++;
+
+    if (entry->status == NvCtrlSuccess) {
+        memcpy(data, &entry->data, attribute_cache_data_size(kind));
+    }
+    *status = entry->status;
+
+    return NV_TRUE;
+}
+
+
+
+/*!
+ * Stores the result of an attribute metadata query in the target's cache.
+ * Only results that describe the attribute itself (success, or the
+ * attribute not being there) are cached; transient errors are not.
+ *
+ * \param[in]  ctrl_target   The CtrlTarget the metadata belongs to.
+ * \param[in]  kind          Whether data is permissions or valid values.
+ * \param[in]  attr_type     The type of the attribute.
+ * \param[in]  attr          The attribute.
+ * \param[in]  display_mask  The display mask the metadata was queried with.
+ * \param[in]  data          The CtrlAttributePerms or CtrlAttributeValidValues
+ *                           returned by the query.
+ * \param[in]  status        The status returned by the query.
+ */
+
+void NvCtrlAttributeCacheStore(const CtrlTarget *ctrl_target,
+                               CtrlAttributeCacheKind kind,
+                               CtrlAttributeType attr_type, int attr,
+                               unsigned int display_mask,
+                               const void *data, ReturnStatus status)
+{
+    struct _CtrlAttributeCache *cache;
+    CtrlAttributeCacheEntry *entry;
+    unsigned int bucket;
+
+    if (!ctrl_target) {
+        return;
+    }
+
+    if ((status != NvCtrlSuccess) &&
+        (status != NvCtrlNoAttribute) &&
+        (status != NvCtrlAttributeNotAvailable)) {
+        return;
+    }
+
+    cache = get_attribute_cache(ctrl_target);
+
+    entry = find_attribute_cache_entry(cache, kind, attr_type, attr,
+                                       display_mask);
+    if (!entry) {
+        bucket = attribute_cache_hash(kind, attr_type, attr, display_mask);
+
+        entry = nvalloc(sizeof(*entry));
+        entry->kind = kind;
+        entry->attr_type = attr_type;
+        entry->attr = attr;
+        entry->display_mask = display_mask;
+        entry->next = cache->buckets[bucket];
+        cache->buckets[bucket] = entry;
+    }
+
+    entry->generation = cache->generation[kind];
+    entry->status = status;
+    if (status == NvCtrlSuccess) {
+        memcpy(&entry->data, data, attribute_cache_data_size(kind));
+    }
+}
+
+
+
+/*!
+ * Drops cached attribute metadata of the given kind from a target.
+ *
+ * \param[in]  ctrl_target  The CtrlTarget whose cache should be flushed.
+ * \param[in]  kind         The kind of metadata to drop.
+ * \param[in]  attr         The attribute to drop, or
+ *                          CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES to drop the
+ *                          metadata of that kind for all attributes.
+ */
+
+void NvCtrlAttributeCacheInvalidate(const CtrlTarget *ctrl_target,
+                                    CtrlAttributeCacheKind kind, int attr)
+{
+    int i;
+
+    if (!ctrl_target || !ctrl_target->cache) {
+        return;
+    }
+
+    if (attr == CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES) {
+        ctrl_target->cache->generation[kind]++;
+        return;
+    }
+
+    for (i = 0; i < CTRL_ATTRIBUTE_CACHE_BUCKETS; i++) {
+        CtrlAttributeCacheEntry **prev = &ctrl_target->cache->buckets[i];
+
+        while (*prev) {
+            CtrlAttributeCacheEntry *entry = *prev;
+
+            if (entry->kind == kind && entry->attr == attr) {
+                *prev = entry->next;
+                nvfree(entry);
+            } else {
+                prev = &entry->next;
+            }
+        }
     }
+}
+
 
-    return str;
+
+/*!
+ * Drops cached attribute metadata of the given kind from every target of
+ * a system.
+ *
+ * \param[in]  system  The CtrlSystem whose caches should be flushed.
+ * \param[in]  kind    The kind of metadata to drop.
+ * \param[in]  attr    The attribute to drop, or
+ *                     CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES.
+ */
+
+void NvCtrlAttributeCacheInvalidateSystem(const CtrlSystem *system,
+                                          CtrlAttributeCacheKind kind,
+                                          int attr)
+{
+    int target_type;
+    CtrlTargetNode *node;
+
+    if (!system) {
+        return;
+    }
+
+    for (target_type = 0; target_type < MAX_TARGET_TYPES; target_type++) {
+        for (node = system->targets[target_type]; node; node = node->next) {
+            NvCtrlAttributeCacheInvalidate(node->t, kind, attr);
+        }
+    }
+}
+
+
+
+/*!
+ * Flushes the cached valid values that a successful assignment to one of
+ * the target's attributes may have changed: the valid values of one
+ * attribute may depend on the current value of others on the same target,
+ * and settings of an X screen or GPU carry over to the targets related to
+ * it.  Changes that reach further are reported by the server as events;
+ * see NvCtrlAttributeCacheHandleEvent().  NVML sends no events, so this is
+ * all the invalidation NVML-backed valid values get.
+ *
+ * \param[in]  ctrl_target  The CtrlTarget that was assigned to.
+ */
+
+void NvCtrlAttributeCacheTargetChanged(const CtrlTarget *ctrl_target)
+{
+    CtrlTargetNode *node;
+
+    if (!ctrl_target) {
+        return;
+    }
+
+    NvCtrlAttributeCacheInvalidate(ctrl_target,
+                                   CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                   CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES);
+
+    for (node = ctrl_target->relations; node; node = node->next) {
+        NvCtrlAttributeCacheInvalidate(node->t,
+                                       CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                       CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES);
+    }
+}
+
+
+
+/*!
+ * Flushes the attribute caches affected by an event received from the
+ * server.  Valid values of one attribute may depend on the current value
+ * of others, possibly on other targets, so any event drops the cached
+ * valid values of the whole system; permissions only change when the
+ * availability of an attribute does.
+ *
+ * \param[in]  system  The CtrlSystem the event was received on.
+ * \param[in]  event   The decoded event.
+ */
+
+void NvCtrlAttributeCacheHandleEvent(const CtrlSystem *system,
+                                     const CtrlEvent *event)
+{
+    if (!system || !event || event->type == CTRL_EVENT_TYPE_UNKNOWN) {
+        return;
+    }
+
+    NvCtrlAttributeCacheInvalidateSystem(system,
+                                         CTRL_ATTRIBUTE_CACHE_VALID_VALUES,
+                                         CTRL_ATTRIBUTE_CACHE_ALL_ATTRIBUTES);
+
+    if (event->type == CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE &&
+        event->int_attr.is_availability_changed) {
+        NvCtrlAttributeCacheInvalidateSystem(system,
+                                             CTRL_ATTRIBUTE_CACHE_PERMS,
+                                             event->int_attr.attribute);
+    }
+}
+
+
+
+/*!
+ * Returns the number of metadata lookups that were (and were not) served
+ * from the attribute cache of the given target.
+ *
+ * \param[in]  ctrl_target  The CtrlTarget to get statistics for.
+ * \param[out] hits         The number of cache hits.
+ * \param[out] misses       The number of cache misses.
+ */
+
+void NvCtrlGetAttributeCacheStats(const CtrlTarget *ctrl_target,
+                                  unsigned int *hits, unsigned int *misses)
+{
+    *hits = 0;
+    *misses = 0;
+
+    if (ctrl_target && ctrl_target->cache) {
+        *hits = ctrl_target->cache->hits;
+        *misses = ctrl_target->cache->misses;
+    }
+}
+
+
+
+static void free_attribute_cache(struct _CtrlAttributeCache *cache)
+{
+    int i;
+
+    if (!cache) {
+        return;
+    }
+
+    for (i = 0; i < CTRL_ATTRIBUTE_CACHE_BUCKETS; i++) {
+        while (cache->buckets[i]) {
+            CtrlAttributeCacheEntry *entry = cache->buckets[i];
+
+            cache->buckets[i] = entry->next;
+            nvfree(entry);
+        }
+    }
+
+    nvfree(cache);
 }
 
 
@@ -84,35 +456,26 @@ static void nv_free_ctrl_target(CtrlTarget *target)
 
     NvCtrlTargetListFree(target->relations);
     target->relations = NULL;
+    target->relations_tail = NULL;
+
+    for (i = 0; i < MAX_TARGET_TYPES; i++) {
+        nvfree(target->related[i].bits);
+        target->related[i].bits = NULL;
+        target->related[i].words = 0;
+    }
+
+    free_attribute_cache(target->cache);
+    target->cache = NULL;
 
     nvfree(target);
 }
 
 
 
-static void nv_free_ctrl_system(CtrlSystem *system)
+static void free_system_targets(CtrlSystem *system)
 {
     int target_type;
 
-    if (!system) {
-        return;
-    }
-
-    /* close the X connection */
-
-    if (system->dpy) {
-        /*
-         * XXX It is unfortunate that the display connection needs
-         * to be closed before the backends have had a chance to
-         * tear down their state. If future backends need to send
-         * protocol in this case or perform similar tasks, we'll
-         * have to add e.g. NvCtrlAttributeTearDown(), which would
-         * need to be called before XCloseDisplay().
-         */
-        XCloseDisplay(system->dpy);
-        system->dpy = NULL;
-    }
-
     /* cleanup targets */
 
     for (target_type = 0;
@@ -126,6 +489,10 @@ static void nv_free_ctrl_system(CtrlSystem *system)
             nv_free_ctrl_target(node->t);
             nvfree(node);
         }
+
+        nvfree(system->target_index[target_type].by_id);
+        memset(&system->target_index[target_type], 0,
+               sizeof(system->target_index[target_type]));
     }
 
     /* cleanup physical screens */
@@ -138,6 +505,60 @@ static void nv_free_ctrl_system(CtrlSystem *system)
         nv_free_ctrl_target(node->t);
         nvfree(node);
     }
+}
+
+
+
+static void nv_free_ctrl_system(CtrlSystem *system)
+{
+    int target_type;
+    unsigned int hits = 0, misses = 0;
+
+    if (!system) {
+        return;
+    }
+
+    /* report how well the attribute caches did */
+
+    for (target_type = 0; target_type < MAX_TARGET_TYPES; target_type++) {
+        CtrlTargetNode *node;
+
+        for (node = system->targets[target_type]; node; node = node->next) {
+            unsigned int target_hits, target_misses;
+
+            NvCtrlGetAttributeCacheStats(node->t, &target_hits,
+                                         &target_misses);
+            hits += target_hits;
+            misses += target_misses;
+        }
+    }
+
+    if (hits || misses) {
+        nv_info_msg(NULL, "Attribute cache for '%s': %u hits, %u misses.",
+                    system->display ? system->display : "", hits, misses);
+    }
+
+    /* close the X connection */
+
+    if (system->dpy) {
+        /*
+         * XXX It is unfortunate that the display connection needs
+         * to be closed before the backends have had a chance to
+         * tear down their state. If future backends need to send
+         * protocol in this case or perform similar tasks, we'll
+         * have to add e.g. NvCtrlAttributeTearDown(), which would
+         * need to be called before XCloseDisplay().
+         */
+        XCloseDisplay(system->dpy);
+        system->dpy = NULL;
+    }
+
+    free_system_targets(system);
+
+    /* drop the system's reference to the NVML context */
+
+    NvCtrlNvmlReleaseContext(system->nvml);
+    system->nvml = NULL;
 
     /* cleanup everything else */
 
@@ -168,32 +589,27 @@ void NvCtrlFreeAllSystems(CtrlSystemList *systems)
 
 
 
-/*!
- * Retrieves and adds all the display device names for the given target.
- *
- * \param[in/out]  t  The CtrlTarget to load names for.
+/*
+ * The NV-CONTROL string attributes holding the protocol names of a display
+ * target, by protocol name index.
  */
 
-static void load_display_target_proto_names(CtrlTarget *t)
-{
-    t->protoNames[NV_DPY_PROTO_NAME_TYPE_BASENAME] =
-        query_x_name(t, NV_CTRL_STRING_DISPLAY_NAME_TYPE_BASENAME);
-
-    t->protoNames[NV_DPY_PROTO_NAME_TYPE_ID] =
-        query_x_name(t, NV_CTRL_STRING_DISPLAY_NAME_TYPE_ID);
-
-    t->protoNames[NV_DPY_PROTO_NAME_DP_GUID] =
-        query_x_name(t, NV_CTRL_STRING_DISPLAY_NAME_DP_GUID);
-
-    t->protoNames[NV_DPY_PROTO_NAME_EDID_HASH] =
-        query_x_name(t, NV_CTRL_STRING_DISPLAY_NAME_EDID_HASH);
+static const struct {
+    int proto_idx;
+    int attr;
+} displayProtoNameAttrs[] = {
+    { NV_DPY_PROTO_NAME_TYPE_BASENAME,
+      NV_CTRL_STRING_DISPLAY_NAME_TYPE_BASENAME },
+    { NV_DPY_PROTO_NAME_TYPE_ID,      NV_CTRL_STRING_DISPLAY_NAME_TYPE_ID },
+    { NV_DPY_PROTO_NAME_DP_GUID,      NV_CTRL_STRING_DISPLAY_NAME_DP_GUID },
+    { NV_DPY_PROTO_NAME_EDID_HASH,    NV_CTRL_STRING_DISPLAY_NAME_EDID_HASH },
+    { NV_DPY_PROTO_NAME_TARGET_INDEX,
+      NV_CTRL_STRING_DISPLAY_NAME_TARGET_INDEX },
+    { NV_DPY_PROTO_NAME_RANDR,        NV_CTRL_STRING_DISPLAY_NAME_RANDR },
+};
 
-    t->protoNames[NV_DPY_PROTO_NAME_TARGET_INDEX] =
-        query_x_name(t, NV_CTRL_STRING_DISPLAY_NAME_TARGET_INDEX);
-
-    t->protoNames[NV_DPY_PROTO_NAME_RANDR] =
-        query_x_name(t, NV_CTRL_STRING_DISPLAY_NAME_RANDR);
-}
+#define NUM_DISPLAY_PROTO_NAME_ATTRS \
+    ((int) (sizeof(displayProtoNameAttrs) / sizeof(displayProtoNameAttrs[0])))
 
 
 
@@ -220,62 +636,163 @@ static void load_default_target_proto_name(CtrlTarget *t,
 
 
 
-/*!
- * Adds the GPU names to the given target to the list of protocol names.
- *
- * \param[in/out]  t  The CtrlTarget to load names for.
+/*
+ * What a pending probe query fills in on its target: one of the target's
+ * protocol names (a non-negative proto name index) or one of the display
+ * device states below.
  */
 
-static void load_gpu_target_proto_names(CtrlTarget *t)
-{
-    load_default_target_proto_name(t, NV_GPU_PROTO_NAME_TYPE_ID);
+#define PROBE_DISPLAY_ENABLED     -1
+#define PROBE_ENABLED_DISPLAYS    -2
+#define PROBE_CONNECTED_DISPLAYS  -3
 
-    t->protoNames[NV_GPU_PROTO_NAME_UUID] =
-        query_x_name(t, NV_CTRL_STRING_GPU_UUID);
+#define PROBE_MAX_QUERIES_PER_TARGET (NUM_DISPLAY_PROTO_NAME_ATTRS + 3)
+
+static void add_probe_query(CtrlAttributeQuery *queries, CtrlTarget **owners,
+                            int *slots, int *n, CtrlTarget *t,
+                            CtrlAttributeType type, int attr, int slot)
+{
+    queries[*n].target = t;
+    queries[*n].type = type;
+    queries[*n].attr = attr;
+    owners[*n] = t;
+    slots[*n] = slot;
+    (*n)++;
 }
 
 
 
 /*!
- * Adds the all the appropriate names for the given target to the list of
- * protocol names.
+ * Loads the protocol names, the display enabled state and the enabled and
+ * connected display device masks of the given targets.  The queries for all
+ * of the targets are issued as a single batch, so that the number of round
+ * trips to the X server does not depend on the number of targets.
  *
- * \param[in/out]  t  The CtrlTarget to load names for.
+ * \param[in/out]  targets  The CtrlTargets to probe.
+ * \param[in]      count    The number of targets.
  */
 
-static void load_target_proto_names(CtrlTarget *t)
+static void probe_targets(CtrlTarget **targets, int count)
 {
-    switch (NvCtrlGetTargetType(t)) {
-    case DISPLAY_TARGET:
-        load_display_target_proto_names(t);
-        break;
+    CtrlAttributeQuery *queries;
+    CtrlTarget **owners;
+    int *slots;
+    int i, j, n = 0;
 
-    case GPU_TARGET:
-        load_gpu_target_proto_names(t);
-        break;
+    if (count <= 0) {
+        return;
+    }
 
-    default:
-        load_default_target_proto_name(t, 0);
-        break;
+    queries = nvalloc(count * PROBE_MAX_QUERIES_PER_TARGET * sizeof(*queries));
+    owners = nvalloc(count * PROBE_MAX_QUERIES_PER_TARGET * sizeof(*owners));
+    slots = nvalloc(count * PROBE_MAX_QUERIES_PER_TARGET * sizeof(*slots));
+
+    for (i = 0; i < count; i++) {
+        CtrlTarget *t = targets[i];
+
+        switch (NvCtrlGetTargetType(t)) {
+        case DISPLAY_TARGET:
+            for (j = 0; j < NUM_DISPLAY_PROTO_NAME_ATTRS; j++) {
+                add_probe_query(queries, owners, slots, &n, t,
+                                CTRL_ATTRIBUTE_TYPE_STRING,
+                                displayProtoNameAttrs[j].attr,
+                                displayProtoNameAttrs[j].proto_idx);
+            }
+            add_probe_query(queries, owners, slots, &n, t,
+                            CTRL_ATTRIBUTE_TYPE_INTEGER,
+                            NV_CTRL_DISPLAY_ENABLED, PROBE_DISPLAY_ENABLED);
+            break;
+
+        case GPU_TARGET:
+            load_default_target_proto_name(t, NV_GPU_PROTO_NAME_TYPE_ID);
+            add_probe_query(queries, owners, slots, &n, t,
+                            CTRL_ATTRIBUTE_TYPE_STRING,
+                            NV_CTRL_STRING_GPU_UUID, NV_GPU_PROTO_NAME_UUID);
+            break;
+
+        default:
+            load_default_target_proto_name(t, 0);
+            break;
+        }
+
+        /*
+         * get the enabled display device mask; for X screens and
+         * GPUs we query NV-CONTROL; for anything else
+         * (framelock), we just assign this to 0.
+         */
+
+        t->d = 0;
+        t->c = 0;
+
+        if (t->targetTypeInfo->uses_display_devices) {
+            add_probe_query(queries, owners, slots, &n, t,
+                            CTRL_ATTRIBUTE_TYPE_INTEGER,
+                            NV_CTRL_ENABLED_DISPLAYS,
+                            PROBE_ENABLED_DISPLAYS);
+            add_probe_query(queries, owners, slots, &n, t,
+                            CTRL_ATTRIBUTE_TYPE_INTEGER,
+                            NV_CTRL_CONNECTED_DISPLAYS,
+                            PROBE_CONNECTED_DISPLAYS);
+        }
+    }
+
+    NvCtrlQueryAttributes(queries, n);
+
+    for (i = 0; i < n; i++) {
+        CtrlTarget *t = owners[i];
+        ReturnStatus status = queries[i].status;
+
+        switch (slots[i]) {
+        case PROBE_DISPLAY_ENABLED:
+            if (status != NvCtrlSuccess) {
+                nv_error_msg("Error querying enabled state of display %s %d "
+                             "(%s).", t->targetTypeInfo->name,
+                             NvCtrlGetTargetId(t),
+                             NvCtrlAttributesStrError(status));
+            }
+            t->display.enabled = (status == NvCtrlSuccess &&
+                                  queries[i].val ==
+                                  NV_CTRL_DISPLAY_ENABLED_TRUE) ? 1 : 0;
+            break;
+
+        case PROBE_ENABLED_DISPLAYS:
+        case PROBE_CONNECTED_DISPLAYS:
+            if (status != NvCtrlSuccess) {
+                nv_error_msg("Error querying %s displays on %s %d (%s).",
+                             (slots[i] == PROBE_ENABLED_DISPLAYS) ?
+                             "enabled" : "connected",
+                             t->targetTypeInfo->name, NvCtrlGetTargetId(t),
+                             NvCtrlAttributesStrError(status));
+                break;
+            }
+            if (slots[i] == PROBE_ENABLED_DISPLAYS) {
+                t->d = queries[i].val;
+            } else {
+                t->c = queries[i].val;
+            }
+            break;
+
+        default:
+            t->protoNames[slots[i]] =
+                (status == NvCtrlSuccess) ? queries[i].str : NULL;
+            break;
+        }
     }
+
+    nvfree(slots);
+    nvfree(owners);
+    nvfree(queries);
 }
 
 
 
 int NvCtrlGetTargetTypeCount(const CtrlSystem *system, CtrlTargetType target_type)
 {
-    int count = 0;
-    CtrlTargetNode *node;
-
     if (!system || !NvCtrlIsTargetTypeValid(target_type)) {
         return 0;
     }
 
-    for (node = system->targets[target_type]; node; node = node->next) {
-        count++;
-    }
-
-    return count;
+    return system->target_index[target_type].count;
 }
 
 
@@ -296,22 +813,64 @@ CtrlTarget *NvCtrlGetTarget(const CtrlSystem *system,
                             CtrlTargetType target_type,
                             int target_id)
 {
+    if (!system || !NvCtrlIsTargetTypeValid(target_type) ||
+        (target_id < 0) ||
+        (target_id >= system->target_index[target_type].size)) {
+        return NULL;
+    }
+
+    return system->target_index[target_type].by_id[target_id];
+}
+
+
+
+/*
+ * add_system_target() - Append the target to the system's list of targets
+ * of its type, and index it by its target id.  Returns FALSE, without
+ * adding it, if there already is a target of that type and id.
+ */
+
+static Bool add_system_target(CtrlSystem *system, CtrlTarget *target)
+{
+    int target_type = NvCtrlGetTargetType(target);
+    int target_id = NvCtrlGetTargetId(target);
     CtrlTargetNode *node;
 
-    if (!system || !NvCtrlIsTargetTypeValid(target_type)) {
-        return NULL;
+    if (!NvCtrlIsTargetTypeValid(target_type) || (target_id < 0) ||
+        NvCtrlGetTarget(system, target_type, target_id)) {
+        return FALSE;
     }
 
-    for (node = system->targets[target_type];
-         node;
-         node = node->next) {
-        CtrlTarget *target = node->t;
-        if (NvCtrlGetTargetId(target) == target_id) {
-            return target;
+    if (target_id >= system->target_index[target_type].size) {
+        int old_size = system->target_index[target_type].size;
+        int new_size = old_size ? old_size : 8;
+
+        while (new_size <= target_id) {
+            new_size *= 2;
         }
+
+        system->target_index[target_type].by_id =
+            nvrealloc(system->target_index[target_type].by_id,
+                      sizeof(CtrlTarget *) * new_size);
+        memset(system->target_index[target_type].by_id + old_size, 0,
+               sizeof(CtrlTarget *) * (new_size - old_size));
+        system->target_index[target_type].size = new_size;
     }
 
-    return NULL;
+    node = nvalloc(sizeof(*node));
+    node->t = target;
+
+    if (system->target_index[target_type].tail) {
+        system->target_index[target_type].tail->next = node;
+    } else {
+        system->targets[target_type] = node;
+    }
+
+    system->target_index[target_type].tail = node;
+    system->target_index[target_type].by_id[target_id] = target;
+    system->target_index[target_type].count++;
+
+    return TRUE;
 }
 
 
@@ -462,6 +1021,103 @@ void NvCtrlTargetListFree(CtrlTargetNode *head)
 
 
 
+#define RELATED_BITS_PER_WORD (8 * sizeof(unsigned int))
+
+/*!
+ * Returns whether the target of the given type and id is associated to
+ * 'target'.
+ */
+
+Bool NvCtrlTargetIsRelated(const CtrlTarget *target,
+                           CtrlTargetType target_type, int target_id)
+{
+    int word;
+
+    if (!target || !NvCtrlIsTargetTypeValid(target_type) || (target_id < 0)) {
+        return FALSE;
+    }
+
+    word = target_id / RELATED_BITS_PER_WORD;
+
+    if (word >= target->related[target_type].words) {
+        return FALSE;
+    }
+
+    return (target->related[target_type].bits[word] >>
+            (target_id % RELATED_BITS_PER_WORD)) & 1;
+}
+
+
+
+/*!
+ * Returns the number of targets of the given type associated to 'target'.
+ */
+
+int NvCtrlGetRelatedTargetCount(const CtrlTarget *target,
+                                CtrlTargetType target_type)
+{
+    int i, count = 0;
+
+    if (!target || !NvCtrlIsTargetTypeValid(target_type)) {
+        return 0;
+    }
+
+    for (i = 0; i < target->related[target_type].words; i++) {
+        count += __builtin_popcount(target->related[target_type].bits[i]);
+    }
+
+    return count;
+}
+
+
+
+/*
+ * add_target_relation() - Associate 'other' to 'target': 'other' is
+ * appended to the target's list of relations, unless it is already in it,
+ * which the relationship bitsets tell without walking the list.
+ */
+
+static void add_target_relation(CtrlTarget *target, CtrlTarget *other)
+{
+    int target_type = NvCtrlGetTargetType(other);
+    int target_id = NvCtrlGetTargetId(other);
+    CtrlTargetNode *node;
+    int word;
+
+    if (!NvCtrlIsTargetTypeValid(target_type) || (target_id < 0) ||
+        NvCtrlTargetIsRelated(target, target_type, target_id)) {
+        return;
+    }
+
+    word = target_id / RELATED_BITS_PER_WORD;
+
+    if (word >= target->related[target_type].words) {
+        int old_words = target->related[target_type].words;
+
+        target->related[target_type].bits =
+            nvrealloc(target->related[target_type].bits,
+                      sizeof(unsigned int) * (word + 1));
+        memset(target->related[target_type].bits + old_words, 0,
+               sizeof(unsigned int) * (word + 1 - old_words));
+        target->related[target_type].words = word + 1;
+    }
+
+    target->related[target_type].bits[word] |=
+        1U << (target_id % RELATED_BITS_PER_WORD);
+
+    node = nvalloc(sizeof(*node));
+    node->t = other;
+
+    if (target->relations_tail) {
+        target->relations_tail->next = node;
+    } else {
+        target->relations = node;
+    }
+    target->relations_tail = node;
+}
+
+
+
 /*!
  * Adds all the targets of target type relating to 'target_type' that are
  * known to be associated to 'target' by querying the list of associated targets
@@ -504,7 +1160,7 @@ static void add_target_relationships(CtrlTarget *target,
 
         other = NvCtrlGetTarget(target->system, target_type, target_id);
         if (other) {
-            NvCtrlTargetListAdd(&(target->relations), other, FALSE);
+            add_target_relation(target, other);
 
             /* Track connection state of display devices */
             if (attr == NV_CTRL_BINARY_DATA_DISPLAYS_CONNECTED_TO_GPU) {
@@ -512,7 +1168,7 @@ static void add_target_relationships(CtrlTarget *target,
             }
 
             if (implicit_reciprocal == NV_TRUE) {
-                NvCtrlTargetListAdd(&(other->relations), target, FALSE);
+                add_target_relation(other, target);
             }
         }
     }
@@ -637,20 +1293,20 @@ static void load_target_relationships(CtrlTarget *target)
 
 
 /*
- * nv_alloc_ctrl_target() - Given the Display pointer, create an attribute
- * handle and initialize the handle target.
+ * alloc_ctrl_target_handle() - Given the Display pointer, create an
+ * attribute handle and a named target for it, without querying any of the
+ * target's state.
  */
 
-static CtrlTarget *nv_alloc_ctrl_target(CtrlSystem *system,
-                                        CtrlTargetType target_type,
-                                        int targetId,
-                                        int subsystem)
+static CtrlTarget *alloc_ctrl_target_handle(CtrlSystem *system,
+                                            CtrlTargetType target_type,
+                                            int targetId,
+                                            int subsystem)
 {
     CtrlTarget *t;
     NvCtrlAttributeHandle *handle;
-    ReturnStatus status;
     char *tmp;
-    int len, d, c;
+    int len;
     const CtrlTargetTypeInfo *targetTypeInfo;
 
 
@@ -662,7 +1318,9 @@ static CtrlTarget *nv_alloc_ctrl_target(CtrlSystem *system,
 
     /* allocate the handle */
 
+    nv_profile_begin("NvCtrlAttributeInit");
     handle = NvCtrlAttributeInit(system, target_type, targetId, subsystem);
+    nv_profile_end();
 
     /*
      * silently fail: this might happen if not all X screens
@@ -707,57 +1365,61 @@ static CtrlTarget *nv_alloc_ctrl_target(CtrlSystem *system,
         }
     }
 
-    load_target_proto_names(t);
     t->relations = NULL;
 
-    if (target_type == DISPLAY_TARGET) {
-        status = NvCtrlGetAttribute(t, NV_CTRL_DISPLAY_ENABLED, &d);
-        if (status != NvCtrlSuccess) {
-            nv_error_msg("Error querying enabled state of display %s %d (%s).",
-                         targetTypeInfo->name, targetId,
-                         NvCtrlAttributesStrError(status));
-            d = NV_CTRL_DISPLAY_ENABLED_FALSE;
-        }
-        t->display.enabled = (d == NV_CTRL_DISPLAY_ENABLED_TRUE) ? 1 : 0;
-    }
+    return t;
+}
 
 
-    /*
-     * get the enabled display device mask; for X screens and
-     * GPUs we query NV-CONTROL; for anything else
-     * (framelock), we just assign this to 0.
-     */
 
-    if (targetTypeInfo->uses_display_devices) {
+/*
+ * alloc_ctrl_targets() - Create the attribute handles for the targets of the
+ * given type and ids, and load their names and display device state with a
+ * single batch of queries.  The targets that could be created are stored in
+ * 'targets' (which must have room for 'count' entries); returns how many.
+ */
 
-        status = NvCtrlGetAttribute(t,
-                                    NV_CTRL_ENABLED_DISPLAYS, &d);
+static int alloc_ctrl_targets(CtrlSystem *system,
+                              CtrlTargetType target_type,
+                              const int *targetIds,
+                              int count,
+                              int subsystem,
+                              CtrlTarget **targets)
+{
+    int i, n = 0;
 
-        if (status != NvCtrlSuccess) {
-            nv_error_msg("Error querying enabled displays on "
-                         "%s %d (%s).", targetTypeInfo->name,
-                         targetId,
-                         NvCtrlAttributesStrError(status));
-            d = 0;
+    for (i = 0; i < count; i++) {
+        CtrlTarget *t = alloc_ctrl_target_handle(system, target_type,
+                                                 targetIds[i], subsystem);
+        if (t) {
+            targets[n++] = t;
         }
+    }
 
-        status = NvCtrlGetAttribute(t,
-                                    NV_CTRL_CONNECTED_DISPLAYS, &c);
+    nv_profile_begin("probe_targets");
+    probe_targets(targets, n);
+    nv_profile_end();
 
-        if (status != NvCtrlSuccess) {
-            nv_error_msg("Error querying connected displays on "
-                         "%s %d (%s).", targetTypeInfo->name,
-                         targetId,
-                         NvCtrlAttributesStrError(status));
-            c = 0;
-        }
-    } else {
-        d = 0;
-        c = 0;
-    }
+    return n;
+}
 
-    t->d = d;
-    t->c = c;
+
+/*
+ * nv_alloc_ctrl_target() - Given the Display pointer, create an attribute
+ * handle and initialize the handle target.
+ */
+
+static CtrlTarget *nv_alloc_ctrl_target(CtrlSystem *system,
+                                        CtrlTargetType target_type,
+                                        int targetId,
+                                        int subsystem)
+{
+    CtrlTarget *t;
+
+    if (!alloc_ctrl_targets(system, target_type, &targetId, 1, subsystem,
+                            &t)) {
+        return NULL;
+    }
 
     return t;
 }
@@ -765,20 +1427,30 @@ static CtrlTarget *nv_alloc_ctrl_target(CtrlSystem *system,
 
 /*
  * nv_add_target() - add a CtrlTarget of the given target type to the list of
- * Targets for the given CtrlSystem.
+ * Targets for the given CtrlSystem.  If the system already has a target of
+ * that type and id, that target is returned.
  */
 
 CtrlTarget *nv_add_target(CtrlSystem *system, CtrlTargetType target_type,
                           int target_id)
 {
     CtrlTarget *target;
+
+    target = NvCtrlGetTarget(system, target_type, target_id);
+    if (target) {
+        return target;
+    }
+
     target = nv_alloc_ctrl_target(system, target_type, target_id,
                                   NV_CTRL_ATTRIBUTES_ALL_SUBSYSTEMS);
     if (!target) {
         return NULL;
     }
 
-    NvCtrlTargetListAdd(&(system->targets[target_type]), target, FALSE);
+    if (!add_system_target(system, target)) {
+        nv_free_ctrl_target(target);
+        return NULL;
+    }
 
     return target;
 }
@@ -812,13 +1484,101 @@ static Bool is_nvcontrol_protocol_valid(const CtrlTarget *ctrl_target,
 }
 
 
-static Bool load_system_info(CtrlSystem *system, const char *display)
+/*
+ * load_targets_from_cache() - Recreate the system's targets from the
+ * topology cache: each target still gets its attribute handle, but its
+ * names, display device state and relationships are taken from the cache
+ * rather than queried.  If any cached target can no longer be created, the
+ * targets created so far are freed and FALSE is returned.
+ */
+
+static Bool load_targets_from_cache(CtrlSystem *system,
+                                    const NvCtrlTopologyCache *cache)
+{
+    NvCtrlTopologyTarget cached;
+    CtrlTarget **targets;
+    int count, i, j;
+
+    count = NvCtrlTopologyCacheTargetCount(cache);
+    if (count <= 0) {
+        return FALSE;
+    }
+
+    targets = nvalloc(sizeof(*targets) * count);
+
+    for (i = 0; i < count; i++) {
+        CtrlTarget *t;
+
+        NvCtrlTopologyCacheGetTarget(cache, i, &cached);
+
+        t = alloc_ctrl_target_handle(system, cached.target_type,
+                                     cached.target_id,
+                                     cached.physical ?
+                                     NV_CTRL_ATTRIBUTES_NV_CONTROL_SUBSYSTEM :
+                                     NV_CTRL_ATTRIBUTES_ALL_SUBSYSTEMS);
+        if (!t) {
+            nvfree(targets);
+            free_system_targets(system);
+            return FALSE;
+        }
+
+        for (j = 0; j < NV_PROTO_NAME_MAX; j++) {
+            t->protoNames[j] = cached.protoNames[j] ?
+                strdup(cached.protoNames[j]) : NULL;
+        }
+
+        t->display.enabled = cached.enabled;
+        t->display.connected = cached.connected;
+        t->d = cached.d;
+        t->c = cached.c;
+
+        if (cached.physical) {
+            NvCtrlTargetListAdd(&(system->physical_screens), t, FALSE);
+        } else if (!add_system_target(system, t)) {
+            nv_free_ctrl_target(t);
+            nvfree(targets);
+            free_system_targets(system);
+            return FALSE;
+        }
+
+        targets[i] = t;
+    }
+
+    /* restore the relationships, now that all the targets exist */
+
+    for (i = 0; i < count; i++) {
+        NvCtrlTopologyCacheGetTarget(cache, i, &cached);
+
+        for (j = 0; j < cached.num_relations; j++) {
+            add_target_relation(targets[i], targets[cached.relations[j]]);
+        }
+    }
+
+    nvfree(targets);
+
+    return TRUE;
+}
+
+
+
+/*
+ * load_system_info() - Open the X display connection and discover the
+ * system's targets.  If the topology cache is enabled, 'cache' is set to the
+ * cache opened for this X server (possibly NULL), and 'from_cache' tells
+ * whether the targets, along with their relationships, were restored from
+ * it.
+ */
+
+static Bool load_system_info(CtrlSystem *system, const char *display,
+                             NvCtrlTopologyCache **cache, Bool *from_cache)
 {
     ReturnStatus status;
     CtrlTarget *xscreenQueryTarget = NULL;
     CtrlTarget *nvmlQueryTarget = NULL;
-    int i, target_type, val, len, target_count;
+    CtrlTarget **targets;
+    int i, n, target_type, val, len, target_count;
     int *pData = NULL;
+    int *targetIds;
     const CtrlTargetTypeInfo *targetTypeInfo;
 
     if (!system) {
@@ -839,8 +1599,24 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
         return FALSE;
     }
 
+    /* Reuse the cached topology, if the X server's has not changed */
+
+    if (NvCtrlGetTopologyCacheEnabled()) {
+        *cache = NvCtrlTopologyCacheOpen(system);
+
+        if (NvCtrlTopologyCacheIsValid(*cache)) {
+            nv_profile_begin("load_targets_from_cache");
+            *from_cache = load_targets_from_cache(system, *cache);
+            nv_profile_end();
+
+            if (*from_cache) {
+                return TRUE;
+            }
+        }
+    }
+
     /* Try to initialize the NVML library */
-    nvmlQueryTarget = nv_alloc_ctrl_target(system, GPU_TARGET, 0,
+    nvmlQueryTarget = alloc_ctrl_target_handle(system, GPU_TARGET, 0,
                                    NV_CTRL_ATTRIBUTES_NV_CONTROL_SUBSYSTEM |
                                    NV_CTRL_ATTRIBUTES_NVML_SUBSYSTEM);
 
@@ -940,16 +1716,19 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
             target_count = val;
         }
 
-        /* Add all the targets of this type to the CtrlSystem */
+        /*
+         * Add all the targets of this type to the CtrlSystem; their names and
+         * display device state are queried in one batch
+         */
 
-        for (i = 0; i < target_count; i++) {
-            int targetId;
-            CtrlTarget *target;
+        targetIds = nvalloc(NV_MAX(target_count, 1) * sizeof(int));
+        targets = nvalloc(NV_MAX(target_count, 1) * sizeof(CtrlTarget *));
 
+        for (i = 0; i < target_count; i++) {
             switch (target_type) {
             case DISPLAY_TARGET:
                 /* Grab the target Id from the pData list */
-                targetId = pData[i+1];
+                targetIds[i] = pData[i+1];
                 break;
             case X_SCREEN_TARGET:
             case GPU_TARGET:
@@ -960,10 +1739,20 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
             case THERMAL_SENSOR_TARGET:
             case NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET:
             default:
-                targetId = i;
+                targetIds[i] = i;
             }
+        }
+
+        n = alloc_ctrl_targets(system, target_type, targetIds, target_count,
+                               NV_CTRL_ATTRIBUTES_ALL_SUBSYSTEMS, targets);
+
+        for (i = 0; i < n; i++) {
+            CtrlTarget *target = targets[i];
 
-            target = nv_add_target(system, target_type, targetId);
+            if (!add_system_target(system, target)) {
+                nv_free_ctrl_target(target);
+                continue;
+            }
 
             /*
              * store this handle, if it exists, so that we can use it to
@@ -971,12 +1760,15 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
              */
 
             if (!xscreenQueryTarget && (target_type == X_SCREEN_TARGET) &&
-                target && target->h) {
+                target->h) {
 
                 xscreenQueryTarget = target;
             }
         }
 
+        nvfree(targets);
+        nvfree(targetIds);
+
         free(pData);
         pData = NULL;
     }
@@ -1016,17 +1808,23 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
 
     target_count = val;
 
+    targetIds = nvalloc(NV_MAX(target_count, 1) * sizeof(int));
+    targets = nvalloc(NV_MAX(target_count, 1) * sizeof(CtrlTarget *));
+
     for (i = 0; i < target_count; i++) {
-        CtrlTarget *target;
-        target = nv_alloc_ctrl_target(system, X_SCREEN_TARGET, i,
-                                      NV_CTRL_ATTRIBUTES_NV_CONTROL_SUBSYSTEM);
-        if (!target) {
-            continue;
-        }
+        targetIds[i] = i;
+    }
+
+    n = alloc_ctrl_targets(system, X_SCREEN_TARGET, targetIds, target_count,
+                           NV_CTRL_ATTRIBUTES_NV_CONTROL_SUBSYSTEM, targets);
 
-        NvCtrlTargetListAdd(&(system->physical_screens), target, FALSE);
+    for (i = 0; i < n; i++) {
+        NvCtrlTargetListAdd(&(system->physical_screens), targets[i], FALSE);
     }
 
+    nvfree(targets);
+    nvfree(targetIds);
+
     /* Clean up */
     if (nvmlQueryTarget != NULL) {
         nv_free_ctrl_target(nvmlQueryTarget);
@@ -1045,6 +1843,8 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
 static CtrlSystem *nv_alloc_ctrl_system(const char *display)
 {
     CtrlSystem *system;
+    NvCtrlTopologyCache *cache = NULL;
+    Bool from_cache = FALSE;
     Bool ret;
     int i;
 
@@ -1052,22 +1852,36 @@ static CtrlSystem *nv_alloc_ctrl_system(const char *display)
 
     /* Connect to the system and load target information */
 
-    ret = load_system_info(system, display);
+    nv_profile_begin("load_system_info");
+    ret = load_system_info(system, display, &cache, &from_cache);
+    nv_profile_end();
 
     if (!ret) {
+        NvCtrlTopologyCacheClose(cache);
         nv_free_ctrl_system(system);
         return NULL;
     }
 
-    /* Discover target relationships */
+    if (!from_cache) {
 
-    for (i = 0; i < MAX_TARGET_TYPES; i++) {
-        CtrlTargetNode *node;
-        for (node = system->targets[i]; node; node = node->next) {
-            load_target_relationships(node->t);
+        /* Discover target relationships */
+
+        nv_profile_begin("load_target_relationships");
+        for (i = 0; i < MAX_TARGET_TYPES; i++) {
+            CtrlTargetNode *node;
+            for (node = system->targets[i]; node; node = node->next) {
+                load_target_relationships(node->t);
+            }
         }
+        nv_profile_end();
+
+        /* Remember the discovered topology for the next run */
+
+        NvCtrlTopologyCacheSave(cache, system);
     }
 
+    NvCtrlTopologyCacheClose(cache);
+
     return system;
 
 } /* nv_alloc_ctrl_system() */
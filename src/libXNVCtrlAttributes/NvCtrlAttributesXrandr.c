@@ -188,7 +188,7 @@ static void close_libxrandr(void)
 
 } /* close_libxrandr() */
 
-static RROutput GetRandRCrtcForGamma(NvCtrlAttributePrivateHandle *h,
+static RROutput GetRandRCrtcForGamma(const NvCtrlAttributePrivateHandle *h,
                                      NvCtrlXrandrAttributes *xrandr)
 {
     int64_t output_64;
@@ -265,6 +265,31 @@ static RROutput GetRandRCrtcForGamma(NvCtrlAttributePrivateHandle *h,
     return crtc;
 }
 
+/*
+ * Look up the RandR CRTC of a display target and download its gamma ramp.
+ * This costs a few round trips to the X server per display, so rather
+ * than doing it for every display when the handles are created, it is
+ * deferred until the gamma ramp is first needed.
+ */
+
+static void LoadGammaRamp(const NvCtrlAttributePrivateHandle *h)
+{
+    NvCtrlXrandrAttributes *xrandr = h->xrandr;
+
+    if (xrandr->gammaLoaded) {
+        return;
+    }
+
+    xrandr->gammaLoaded = True;
+    xrandr->gammaCrtc = GetRandRCrtcForGamma(h, xrandr);
+
+    if ((xrandr->gammaCrtc != None) && (__libXrandr->XRRGetCrtcGamma != NULL)) {
+        xrandr->pGammaRamp =
+            __libXrandr->XRRGetCrtcGamma(h->dpy, xrandr->gammaCrtc);
+        NvCtrlInitGammaInputStruct(&xrandr->gammaInput);
+    }
+}
+
 /******************************************************************************
  *
  * Initializes the NvCtrlXrandrAttributes Extension by linking the
@@ -330,19 +355,12 @@ NvCtrlInitXrandrAttributes (NvCtrlAttributePrivateHandle *h)
 
 
     /*
-     * get the RandR CRTC and gamma; the mapping of NV-CONTROL display
-     * device target to RandR CRTC could change at each modeset, so
-     * the frontend needs to reallocate this handle after each modeset
+     * the RandR CRTC and gamma are looked up by LoadGammaRamp() on first
+     * use; the mapping of NV-CONTROL display device target to RandR CRTC
+     * could change at each modeset, so the frontend needs to reallocate
+     * this handle after each modeset
      */
 
-    xrandr->gammaCrtc = GetRandRCrtcForGamma(h, xrandr);
-
-    if ((xrandr->gammaCrtc != None) && (__libXrandr->XRRGetCrtcGamma != NULL)) {
-        xrandr->pGammaRamp =
-            __libXrandr->XRRGetCrtcGamma(h->dpy, xrandr->gammaCrtc);
-        NvCtrlInitGammaInputStruct(&xrandr->gammaInput);
-    }
-
     return xrandr;
 
  fail:
@@ -430,6 +448,7 @@ NvCtrlXrandrGetAttribute(const NvCtrlAttributePrivateHandle *h,
     if (h->target_type == X_SCREEN_TARGET) {
         *val = h->xrandr->gammaAvailable;
     } else {
+        LoadGammaRamp(h);
         *val = (h->xrandr->pGammaRamp != NULL);
     }
 
@@ -445,6 +464,8 @@ ReturnStatus NvCtrlXrandrGetColorAttributes(const NvCtrlAttributePrivateHandle *
 
     if (!h->xrandr) return NvCtrlMissingExtension;
 
+    LoadGammaRamp(h);
+
     for (i = FIRST_COLOR_CHANNEL; i <= LAST_COLOR_CHANNEL; i++) {
         contrast[i]   = h->xrandr->gammaInput.contrast[i];
         brightness[i] = h->xrandr->gammaInput.brightness[i];
@@ -471,6 +492,8 @@ ReturnStatus NvCtrlXrandrSetColorAttributes(NvCtrlAttributePrivateHandle *h,
         return NvCtrlMissingExtension;
     }
 
+    LoadGammaRamp(h);
+
     if (h->xrandr->pGammaRamp == NULL) {
         return NvCtrlMissingExtension;
     }
@@ -511,6 +534,8 @@ ReturnStatus NvCtrlXrandrGetColorRamp(const NvCtrlAttributePrivateHandle *h,
         return NvCtrlMissingExtension;
     }
 
+    LoadGammaRamp(h);
+
     if (h->xrandr->pGammaRamp == NULL) {
         return NvCtrlMissingExtension;
     }
@@ -536,6 +561,11 @@ ReturnStatus NvCtrlXrandrGetColorRamp(const NvCtrlAttributePrivateHandle *h,
 
 ReturnStatus NvCtrlXrandrReloadColorRamp(NvCtrlAttributePrivateHandle *h)
 {
+    if (!h->xrandr->gammaLoaded) {
+        LoadGammaRamp(h);
+        return h->xrandr->pGammaRamp ? NvCtrlSuccess : NvCtrlError;
+    }
+
     if ((h->xrandr->pGammaRamp != NULL) &&
         (__libXrandr->XRRFreeGamma != NULL)) {
         __libXrandr->XRRFreeGamma(h->xrandr->pGammaRamp);
@@ -0,0 +1,547 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * monitor-log.c - binary ring-buffer log of monitor samples
+ * (--monitor-log), and its decoder (--read-log).
+ *
+ * The log file is a fixed-size ring of fixed-size records, written
+ * through a shared mapping of the file so that the samples survive the
+ * process.  All fields are in host byte order:
+ *
+ *   MonitorLogHeader
+ *   MonitorLogAttribute[num_attrs]     the sampled attributes
+ *   MonitorLogTarget[num_targets]      the sampled targets
+ *   (padding to header_size)
+ *   record[capacity]                   the ring
+ *
+ * Each record holds one sample of all targets:
+ *
+ *   int64_t time;                      CLOCK_REALTIME, in nanoseconds
+ *   int32_t values[num_targets][num_attrs];
+ *   uint8_t valid[(num_targets * num_attrs + 7) / 8];
+ *   (padding to record_size)
+ *
+ * Record number 'count' is stored in slot 'count % capacity', and
+ * 'count' in the header is the number of records written so far; the
+ * ring therefore holds records MAX(count - capacity, 0) to count - 1,
+ * oldest first.
+ *
+ * A sample is assembled in a staging record and copied into its slot
+ * with a single memcpy(3), without allocating memory.  As records are
+ * stored in time order, the decoder locates the start of a time range
+ * with a binary search, touching only the pages that hold the records
+ * it looks at.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "NvCtrlAttributes.h"
+
+#include "monitor-log.h"
+#include "msg.h"
+#include "common-utils.h"
+
+
+#define MONITOR_LOG_MAGIC   "NVSMLOG"
+#define MONITOR_LOG_VERSION 1
+
+#define MONITOR_LOG_ATTRIBUTE_NAME_LEN 60
+#define MONITOR_LOG_TARGET_NAME_LEN    32
+
+#define MONITOR_LOG_ALIGN(x) (((x) + 7) & ~((size_t) 7))
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;   /* offset of the first record */
+    uint32_t record_size;
+    uint32_t capacity;      /* number of records in the ring */
+    uint32_t num_attrs;
+    uint32_t num_targets;
+    uint64_t count;         /* number of records written */
+} MonitorLogHeader;
+
+typedef struct {
+    int32_t attr;
+    char name[MONITOR_LOG_ATTRIBUTE_NAME_LEN];
+} MonitorLogAttribute;
+
+typedef struct {
+    char name[MONITOR_LOG_TARGET_NAME_LEN];
+} MonitorLogTarget;
+
+struct _MonitorLog {
+    char *filename;
+    int fd;
+
+    char *map;
+    size_t map_size;
+
+    MonitorLogHeader *header;
+    char *records;
+
+    size_t num_values;
+    size_t valid_offset;
+
+    char *staging;           /* record being assembled */
+};
+
+
+
+/*
+ * Layout helpers, shared by the writer and the decoder.
+ */
+
+static size_t get_header_size(uint32_t num_attrs, uint32_t num_targets)
+{
+    return MONITOR_LOG_ALIGN(sizeof(MonitorLogHeader) +
+                             num_attrs * sizeof(MonitorLogAttribute) +
+                             num_targets * sizeof(MonitorLogTarget));
+}
+
+static size_t get_valid_offset(void)
+{
+    return sizeof(int64_t);
+}
+
+static size_t get_record_size(size_t num_values)
+{
+    return MONITOR_LOG_ALIGN(sizeof(int64_t) +
+                             num_values * sizeof(int32_t) +
+                             (num_values + 7) / 8);
+}
+
+static MonitorLogAttribute *get_attributes(MonitorLogHeader *header)
+{
+    return (MonitorLogAttribute *) (header + 1);
+}
+
+static MonitorLogTarget *get_targets(MonitorLogHeader *header)
+{
+    return (MonitorLogTarget *) (get_attributes(header) + header->num_attrs);
+}
+
+
+
+/*
+ * nv_monitor_log_create() - create the log file 'filename', holding up
+ * to 'capacity' records of the given attributes on the given targets,
+ * and map it into memory.  Returns NULL on failure.
+ */
+
+MonitorLog *nv_monitor_log_create(const char *filename, unsigned int capacity,
+                                  int num_attrs, const int *attrs,
+                                  const char **attr_names,
+                                  int num_targets, const char **target_names)
+{
+    MonitorLog *log;
+    MonitorLogHeader *header;
+    MonitorLogAttribute *a;
+    MonitorLogTarget *t;
+    size_t header_size, record_size;
+    int i;
+
+    log = nvalloc(sizeof(MonitorLog));
+    log->filename = nvstrdup(filename);
+    log->fd = -1;
+    log->map = MAP_FAILED;
+
+    log->num_values = (size_t) num_attrs * num_targets;
+    log->valid_offset = get_valid_offset() +
+        log->num_values * sizeof(int32_t);
+
+    header_size = get_header_size(num_attrs, num_targets);
+    record_size = get_record_size(log->num_values);
+
+    if (capacity == 0 || record_size > UINT32_MAX ||
+        record_size > (SIZE_MAX - header_size) / capacity) {
+        nv_error_msg("Invalid size for monitor log '%s'.", filename);
+        goto fail;
+    }
+
+    log->map_size = header_size + record_size * capacity;
+
+    log->fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (log->fd == -1) {
+        nv_error_msg("Unable to open file '%s' for writing (%s).",
+                     filename, strerror(errno));
+        goto fail;
+    }
+
+    if (ftruncate(log->fd, log->map_size) == -1) {
+        nv_error_msg("Unable to set the size of file '%s' (%s).",
+                     filename, strerror(errno));
+        goto fail;
+    }
+
+    log->map = mmap(0, log->map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    log->fd, 0);
+    if (log->map == MAP_FAILED) {
+        nv_error_msg("Unable to mmap file '%s' for writing (%s).",
+                     filename, strerror(errno));
+        goto fail;
+    }
+
+    /* fill in the header; the file is zero-filled by ftruncate(2) */
+
+    header = log->header = (MonitorLogHeader *) log->map;
+
+    memcpy(header->magic, MONITOR_LOG_MAGIC, sizeof(header->magic));
+    header->version = MONITOR_LOG_VERSION;
+    header->header_size = header_size;
+    header->record_size = record_size;
+    header->capacity = capacity;
+    header->num_attrs = num_attrs;
+    header->num_targets = num_targets;
+    header->count = 0;
+
+    a = get_attributes(header);
+    for (i = 0; i < num_attrs; i++) {
+        a[i].attr = attrs[i];
+        strncpy(a[i].name, attr_names[i], sizeof(a[i].name) - 1);
+    }
+
+    t = get_targets(header);
+    for (i = 0; i < num_targets; i++) {
+        strncpy(t[i].name, target_names[i], sizeof(t[i].name) - 1);
+    }
+
+    log->records = log->map + header_size;
+    log->staging = nvalloc(record_size);
+
+    return log;
+
+ fail:
+    nv_monitor_log_close(log);
+    return NULL;
+
+} /* nv_monitor_log_create() */
+
+
+
+/*
+ * nv_monitor_log_set_value() - store the value of attribute number
+ * 'attr' of target number 'target' in the record being assembled.
+ * Values that are not set before nv_monitor_log_commit() are recorded
+ * as unavailable.
+ */
+
+void nv_monitor_log_set_value(MonitorLog *log, int target, int attr,
+                              int value)
+{
+    size_t i = (size_t) target * log->header->num_attrs + attr;
+    int32_t v = value;
+    uint8_t *valid = (uint8_t *) (log->staging + log->valid_offset);
+
+    memcpy(log->staging + get_valid_offset() + i * sizeof(int32_t),
+           &v, sizeof(v));
+    valid[i / 8] |= 1 << (i % 8);
+}
+
+
+
+/*
+ * nv_monitor_log_commit() - timestamp the record being assembled, copy
+ * it into the next slot of the ring, and start a new record.
+ */
+
+void nv_monitor_log_commit(MonitorLog *log, const struct timespec *now)
+{
+    MonitorLogHeader *header = log->header;
+    int64_t time = (int64_t) now->tv_sec * 1000000000 + now->tv_nsec;
+    char *slot;
+
+    memcpy(log->staging, &time, sizeof(time));
+
+    slot = log->records +
+        (size_t) (header->count % header->capacity) * header->record_size;
+    memcpy(slot, log->staging, header->record_size);
+
+    header->count++;
+
+    memset(log->staging + log->valid_offset, 0, (log->num_values + 7) / 8);
+}
+
+
+
+/*
+ * nv_monitor_log_close() - unmap and close the log file.
+ */
+
+void nv_monitor_log_close(MonitorLog *log)
+{
+    if (!log) {
+        return;
+    }
+
+    if (log->map != MAP_FAILED && munmap(log->map, log->map_size) == -1) {
+        nv_error_msg("Unable to unmap file '%s' (%s).",
+                     log->filename, strerror(errno));
+    }
+
+    if (log->fd != -1) {
+        close(log->fd);
+    }
+
+    nvfree(log->staging);
+    nvfree(log->filename);
+    nvfree(log);
+}
+
+
+
+/*
+ * get_record() - return record number 'i', where record 0 is the oldest
+ * record held by the ring.
+ */
+
+static const char *get_record(const MonitorLogHeader *header,
+                              const char *records, uint64_t first,
+                              uint64_t i)
+{
+    return records +
+        (size_t) ((first + i) % header->capacity) * header->record_size;
+}
+
+static int64_t get_record_time(const char *record)
+{
+    int64_t time;
+
+    memcpy(&time, record, sizeof(time));
+    return time;
+}
+
+
+
+/*
+ * seconds_to_time() - convert seconds since the Epoch to a record
+ * timestamp, clamping out of range values.
+ */
+
+static int64_t seconds_to_time(double seconds)
+{
+    if (seconds * 1e9 >= (double) INT64_MAX) {
+        return INT64_MAX;
+    }
+    if (seconds * 1e9 <= (double) INT64_MIN) {
+        return INT64_MIN;
+    }
+    return (int64_t) (seconds * 1e9);
+}
+
+
+
+/*
+ * validate_header() - check that the header of the log is consistent
+ * with itself and with the size of the file.
+ */
+
+static int validate_header(const MonitorLogHeader *header, size_t length)
+{
+    size_t num_values;
+
+    if (length < sizeof(MonitorLogHeader) ||
+        memcmp(header->magic, MONITOR_LOG_MAGIC, sizeof(header->magic)) != 0) {
+        return NV_FALSE;
+    }
+
+    if (header->version != MONITOR_LOG_VERSION || header->capacity == 0) {
+        return NV_FALSE;
+    }
+
+    num_values = (size_t) header->num_attrs * header->num_targets;
+
+    if (header->header_size != get_header_size(header->num_attrs,
+                                               header->num_targets) ||
+        header->record_size != get_record_size(num_values)) {
+        return NV_FALSE;
+    }
+
+    if (header->header_size > length ||
+        (length - header->header_size) / header->record_size <
+        header->capacity) {
+        return NV_FALSE;
+    }
+
+    return NV_TRUE;
+}
+
+
+
+/*
+ * print_record() - print a record in the format used for text output
+ * by --monitor: one line per target, for the targets that have at least
+ * one value in the record.
+ */
+
+static void print_record(MonitorLogHeader *header, const char *record)
+{
+    MonitorLogAttribute *a = get_attributes(header);
+    MonitorLogTarget *t = get_targets(header);
+    int64_t time = get_record_time(record);
+    const uint8_t *valid;
+    uint32_t i, j;
+    size_t v;
+
+    valid = (const uint8_t *) record + get_valid_offset() +
+        (size_t) header->num_attrs * header->num_targets * sizeof(int32_t);
+
+    for (i = 0, v = 0; i < header->num_targets; i++) {
+        int printed = NV_FALSE;
+
+        for (j = 0; j < header->num_attrs; j++, v++) {
+            int32_t value;
+
+            if (!(valid[v / 8] & (1 << (v % 8)))) {
+                continue;
+            }
+
+            memcpy(&value, record + get_valid_offset() + v * sizeof(int32_t),
+                   sizeof(value));
+
+            if (!printed) {
+                printf("%lld.%03d %.*s", (long long) (time / 1000000000),
+                       (int) ((time % 1000000000) / 1000000),
+                       (int) sizeof(t[i].name), t[i].name);
+                printed = NV_TRUE;
+            }
+
+            printf(" %.*s=%d", (int) sizeof(a[j].name), a[j].name, value);
+        }
+
+        if (printed) {
+            printf("\n");
+        }
+    }
+}
+
+
+
+/*
+ * nv_monitor_log_read() - print the records of the log file 'filename'
+ * that were sampled between 'start' and 'end' (in seconds since the
+ * Epoch, inclusive).  Returns NV_FALSE if the file cannot be read.
+ */
+
+int nv_monitor_log_read(const char *filename, double start, double end)
+{
+    struct stat stat_buf;
+    MonitorLogHeader *header;
+    const char *records;
+    char *map = MAP_FAILED;
+    uint64_t first, num, lo, hi;
+    int64_t start_time, end_time;
+    size_t length = 0;
+    int fd, ret = NV_FALSE;
+
+    fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        nv_error_msg("Unable to open file '%s' for reading (%s).",
+                     filename, strerror(errno));
+        return NV_FALSE;
+    }
+
+    if (fstat(fd, &stat_buf) == -1) {
+        nv_error_msg("Unable to determine size of file '%s' (%s).",
+                     filename, strerror(errno));
+        goto done;
+    }
+
+    length = stat_buf.st_size;
+
+    if (length > 0) {
+        map = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            nv_error_msg("Unable to mmap file '%s' for reading (%s).",
+                         filename, strerror(errno));
+            goto done;
+        }
+    }
+
+    header = (MonitorLogHeader *) map;
+
+    if (map == MAP_FAILED || !validate_header(header, length)) {
+        nv_error_msg("File '%s' is not a valid monitor log.", filename);
+        goto done;
+    }
+
+    records = map + header->header_size;
+
+    num = NV_MIN(header->count, (uint64_t) header->capacity);
+    first = header->count - num;
+
+    start_time = seconds_to_time(start);
+    end_time = seconds_to_time(end);
+
+    /*
+     * print_record() prints times as seconds and milliseconds since the
+     * Epoch; records stamped before it (from a clock that was set wrong)
+     * are skipped
+     */
+
+    if (start_time < 0) {
+        start_time = 0;
+    }
+
+    /* find the first record at or after the start of the range */
+
+    lo = 0;
+    hi = num;
+
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+
+        if (get_record_time(get_record(header, records, first, mid)) <
+            start_time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (; lo < num; lo++) {
+        const char *record = get_record(header, records, first, lo);
+
+        if (get_record_time(record) > end_time) {
+            break;
+        }
+
+        print_record(header, record);
+    }
+
+    ret = NV_TRUE;
+
+ done:
+    if (map != MAP_FAILED) {
+        munmap(map, length);
+    }
+    close(fd);
+
+    return ret;
+
+} /* nv_monitor_log_read() */
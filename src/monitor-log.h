@@ -0,0 +1,40 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+#ifndef __MONITOR_LOG_H__
+#define __MONITOR_LOG_H__
+
+#include <time.h>
+
+#define DEFAULT_MONITOR_LOG_SIZE 3600 /* records */
+
+typedef struct _MonitorLog MonitorLog;
+
+MonitorLog *nv_monitor_log_create(const char *filename, unsigned int capacity,
+                                  int num_attrs, const int *attrs,
+                                  const char **attr_names,
+                                  int num_targets, const char **target_names);
+void nv_monitor_log_set_value(MonitorLog *log, int target, int attr,
+                              int value);
+void nv_monitor_log_commit(MonitorLog *log, const struct timespec *now);
+void nv_monitor_log_close(MonitorLog *log);
+
+int nv_monitor_log_read(const char *filename, double start, double end);
+
+#endif /* __MONITOR_LOG_H__ */
@@ -0,0 +1,460 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * monitor.c - headless sampling of integer attributes (--monitor).
+ *
+ * A fixed set of integer attributes is read from every GPU, thermal
+ * sensor and fan target at a fixed interval, and one compact record per
+ * target and sample is written to stdout or to a file:
+ *
+ *   <seconds>.<milliseconds> <target type>:<target id> <attr>=<value> ...
+ *
+ * Alternatively, or in addition, the samples are stored in a binary
+ * ring-buffer log file (--monitor-log); see monitor-log.c.
+ *
+ * The reads for each target are batched, so that a sample costs one
+ * round trip to the X server per target (NVML backed attributes are
+ * answered locally).  Samples are scheduled against absolute deadlines
+ * on the monotonic clock, so the interval does not drift with the time
+ * spent sampling; deadlines that were missed entirely are skipped rather
+ * than made up for.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+
+#include "NvCtrlAttributes.h"
+
+#include "monitor.h"
+#include "monitor-log.h"
+#include "parse.h"
+#include "msg.h"
+#include "common-utils.h"
+
+
+/* The target types sampled in monitor mode */
+
+static const CtrlTargetType monitorTargetTypes[] = {
+    GPU_TARGET,
+    THERMAL_SENSOR_TARGET,
+    COOLER_TARGET,
+};
+
+typedef struct {
+    CtrlTarget *t;
+    char name[32];
+
+    int num_attrs;
+    int *attrs;
+    const AttributeTableEntry **entries;
+    int *slots;              /* index of each attribute in the --monitor list */
+
+    int *vals;
+    ReturnStatus *statuses;
+} MonitorTarget;
+
+
+static volatile sig_atomic_t __monitor_stop = 0;
+
+static void monitor_signal_handler(int sig)
+{
+    __monitor_stop = 1;
+}
+
+
+
+/*
+ * parse_monitor_attributes() - parse the comma-separated list of
+ * attribute names given to --monitor.  Returns the number of entries
+ * stored in *entries, or -1 if the list is invalid.
+ */
+
+static int parse_monitor_attributes(const char *str,
+                                    const AttributeTableEntry ***entries)
+{
+    char *list, *name, *saveptr = NULL;
+    int n = 0;
+
+    list = nvstrdup(str);
+    *entries = NULL;
+
+    for (name = strtok_r(list, ",", &saveptr); name;
+         name = strtok_r(NULL, ",", &saveptr)) {
+        const AttributeTableEntry *a;
+
+        name = nv_trim_space(name);
+        if (!name[0]) {
+            continue;
+        }
+
+        a = nv_get_attribute_entry_by_name(name);
+        if (!a) {
+            nv_error_msg("Unrecognized attribute name '%s'.", name);
+            goto fail;
+        }
+
+        if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) {
+            nv_error_msg("Attribute '%s' is not an integer attribute, and "
+                         "cannot be monitored.", a->name);
+            goto fail;
+        }
+
+        *entries = nvrealloc(*entries, sizeof(**entries) * (n + 1));
+        (*entries)[n++] = a;
+    }
+
+    nvfree(list);
+
+    if (n == 0) {
+        nv_error_msg("No attributes to monitor were specified.");
+        return -1;
+    }
+
+    return n;
+
+ fail:
+    nvfree(list);
+    nvfree(*entries);
+    *entries = NULL;
+    return -1;
+}
+
+
+
+/*
+ * add_monitor_target() - set up sampling of the given target, for the
+ * attributes that are valid on its target type.  Returns NV_FALSE if
+ * none of the attributes apply to the target.
+ */
+
+static int add_monitor_target(MonitorTarget *mt, CtrlTarget *t,
+                              const AttributeTableEntry **entries, int n)
+{
+    int i;
+
+    memset(mt, 0, sizeof(*mt));
+
+    mt->t = t;
+    snprintf(mt->name, sizeof(mt->name), "%s:%d",
+             t->targetTypeInfo->parsed_name, NvCtrlGetTargetId(t));
+
+    mt->attrs = nvalloc(n * sizeof(*mt->attrs));
+    mt->entries = nvalloc(n * sizeof(*mt->entries));
+    mt->slots = nvalloc(n * sizeof(*mt->slots));
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributePerms perms;
+        ReturnStatus status;
+
+        status = NvCtrlGetAttributePerms(t, entries[i]->type,
+                                         entries[i]->attr, &perms);
+        if (status != NvCtrlSuccess || !perms.read ||
+            !(perms.valid_targets & t->targetTypeInfo->permission_bit)) {
+            continue;
+        }
+
+        mt->attrs[mt->num_attrs] = entries[i]->attr;
+        mt->entries[mt->num_attrs] = entries[i];
+        mt->slots[mt->num_attrs] = i;
+        mt->num_attrs++;
+    }
+
+    if (mt->num_attrs == 0) {
+        nvfree(mt->attrs);
+        nvfree(mt->entries);
+        nvfree(mt->slots);
+        return NV_FALSE;
+    }
+
+    mt->vals = nvalloc(mt->num_attrs * sizeof(*mt->vals));
+    mt->statuses = nvalloc(mt->num_attrs * sizeof(*mt->statuses));
+
+    return NV_TRUE;
+}
+
+
+
+/*
+ * sample_monitor_target() - read all attributes of a target.  Returns
+ * NV_FALSE if none of them could be read.
+ */
+
+static int sample_monitor_target(MonitorTarget *mt)
+{
+    return NvCtrlGetAttributes(mt->t, mt->num_attrs, mt->attrs, mt->vals,
+                               mt->statuses) == NvCtrlSuccess;
+}
+
+
+
+/*
+ * write_monitor_sample() - write the last sample of a target as a line
+ * of text.
+ */
+
+static void write_monitor_sample(FILE *stream, const MonitorTarget *mt,
+                                 const struct timespec *now)
+{
+    int i;
+
+    fprintf(stream, "%lld.%03ld %s", (long long) now->tv_sec,
+            now->tv_nsec / 1000000, mt->name);
+
+    for (i = 0; i < mt->num_attrs; i++) {
+        if (mt->statuses[i] == NvCtrlSuccess) {
+            fprintf(stream, " %s=%d", mt->entries[i]->name, mt->vals[i]);
+        }
+    }
+
+    fprintf(stream, "\n");
+}
+
+
+
+/*
+ * log_monitor_sample() - store the last sample of a target in the
+ * record being assembled for the monitor log.
+ */
+
+static void log_monitor_sample(MonitorLog *log, int target,
+                               const MonitorTarget *mt)
+{
+    int i;
+
+    for (i = 0; i < mt->num_attrs; i++) {
+        if (mt->statuses[i] == NvCtrlSuccess) {
+            nv_monitor_log_set_value(log, target, mt->slots[i], mt->vals[i]);
+        }
+    }
+}
+
+
+
+/*
+ * open_monitor_log() - create the monitor log, described by the list of
+ * attributes given to --monitor and by the sampled targets.
+ */
+
+static MonitorLog *open_monitor_log(const Options *op,
+                                    const AttributeTableEntry **entries,
+                                    int num_entries,
+                                    const MonitorTarget *targets,
+                                    int num_targets)
+{
+    MonitorLog *log;
+    const char **attr_names, **target_names;
+    int *attrs;
+    int i;
+
+    attrs = nvalloc(num_entries * sizeof(*attrs));
+    attr_names = nvalloc(num_entries * sizeof(*attr_names));
+    target_names = nvalloc(num_targets * sizeof(*target_names));
+
+    for (i = 0; i < num_entries; i++) {
+        attrs[i] = entries[i]->attr;
+        attr_names[i] = entries[i]->name;
+    }
+
+    for (i = 0; i < num_targets; i++) {
+        target_names[i] = targets[i].name;
+    }
+
+    log = nv_monitor_log_create(op->monitor_log, op->monitor_log_size,
+                                num_entries, attrs, attr_names,
+                                num_targets, target_names);
+
+    nvfree(attrs);
+    nvfree(attr_names);
+    nvfree(target_names);
+
+    return log;
+}
+
+
+
+/*
+ * nv_monitor() - sample the attributes listed in op->monitor until
+ * interrupted, or until op->monitor_samples samples have been taken.
+ *
+ * Returns NV_FALSE if monitoring could not be set up or the output could
+ * not be written, NV_TRUE otherwise.
+ */
+
+int nv_monitor(const Options *op, CtrlSystemList *systems)
+{
+    const AttributeTableEntry **entries;
+    MonitorTarget *targets = NULL;
+    CtrlSystem *system;
+    FILE *stream = NULL;
+    MonitorLog *log = NULL;
+    struct timespec deadline, interval;
+    struct sigaction sa;
+    int num_entries, num_targets = 0;
+    int i, samples = 0, ret = NV_FALSE;
+
+    num_entries = parse_monitor_attributes(op->monitor, &entries);
+    if (num_entries < 0) {
+        return NV_FALSE;
+    }
+
+    system = NvCtrlConnectToSystem(op->ctrl_display, systems);
+    if (!system) {
+        goto done;
+    }
+
+    for (i = 0; i < ARRAY_LEN(monitorTargetTypes); i++) {
+        CtrlTargetNode *node;
+
+        for (node = system->targets[monitorTargetTypes[i]]; node;
+             node = node->next) {
+
+            if (!node->t->h) continue;
+
+            targets = nvrealloc(targets,
+                                sizeof(*targets) * (num_targets + 1));
+            if (add_monitor_target(&targets[num_targets], node->t,
+                                   entries, num_entries)) {
+                num_targets++;
+            }
+        }
+    }
+
+    if (num_targets == 0) {
+        nv_error_msg("None of the attributes to monitor are available on "
+                     "any GPU, thermal sensor or fan of '%s'.",
+                     op->ctrl_display);
+        goto done;
+    }
+
+    /*
+     * records are written as text to stdout, unless they go to a monitor
+     * log and no text output file was given
+     */
+
+    if (op->monitor_output) {
+        stream = fopen(op->monitor_output, "w");
+        if (!stream) {
+            nv_error_msg("Unable to open file '%s' for writing (%s).",
+                         op->monitor_output, strerror(errno));
+            goto done;
+        }
+    } else if (!op->monitor_log) {
+        stream = stdout;
+    }
+
+    if (op->monitor_log) {
+        log = open_monitor_log(op, entries, num_entries,
+                               targets, num_targets);
+        if (!log) {
+            goto done;
+        }
+    }
+
+    /* stop cleanly, with all records flushed, when interrupted */
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = monitor_signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    interval.tv_sec = op->monitor_interval / 1000;
+    interval.tv_nsec = (op->monitor_interval % 1000) * 1000000L;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (!__monitor_stop) {
+        struct timespec now;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+
+        for (i = 0; i < num_targets; i++) {
+            if (!sample_monitor_target(&targets[i])) {
+                continue;
+            }
+            if (stream) {
+                write_monitor_sample(stream, &targets[i], &now);
+            }
+            if (log) {
+                log_monitor_sample(log, i, &targets[i]);
+            }
+        }
+
+        if (log) {
+            nv_monitor_log_commit(log, &now);
+        }
+
+        if (stream && fflush(stream) != 0) {
+            nv_error_msg("Error writing monitor records (%s).",
+                         strerror(errno));
+            goto done;
+        }
+
+        samples++;
+        if (op->monitor_samples > 0 && samples >= op->monitor_samples) {
+            break;
+        }
+
+        /* advance to the next deadline that is still in the future */
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        do {
+            deadline.tv_sec += interval.tv_sec;
+            deadline.tv_nsec += interval.tv_nsec;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+        } while ((deadline.tv_sec < now.tv_sec) ||
+                 ((deadline.tv_sec == now.tv_sec) &&
+                  (deadline.tv_nsec <= now.tv_nsec)));
+
+        while (!__monitor_stop &&
+               clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                               &deadline, NULL) == EINTR);
+    }
+
+    ret = NV_TRUE;
+
+ done:
+
+    if (stream && stream != stdout) {
+        fclose(stream);
+    }
+    nv_monitor_log_close(log);
+
+    for (i = 0; i < num_targets; i++) {
+        nvfree(targets[i].attrs);
+        nvfree(targets[i].entries);
+        nvfree(targets[i].slots);
+        nvfree(targets[i].vals);
+        nvfree(targets[i].statuses);
+    }
+    nvfree(targets);
+    nvfree(entries);
+
+    return ret;
+
+} /* nv_monitor() */
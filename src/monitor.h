@@ -0,0 +1,30 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+#ifndef __MONITOR_H__
+#define __MONITOR_H__
+
+#include "command-line.h"
+#include "query-assign.h"
+
+#define DEFAULT_MONITOR_INTERVAL 1000 /* milliseconds */
+
+int nv_monitor(const Options *op, CtrlSystemList *systems);
+
+#endif /* __MONITOR_H__ */
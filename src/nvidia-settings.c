@@ -22,6 +22,9 @@
 #include "command-line.h"
 #include "config-file.h"
 #include "query-assign.h"
+#include "monitor.h"
+#include "monitor-log.h"
+#include "profile.h"
 #include "msg.h"
 #include "version.h"
 
@@ -242,13 +245,34 @@ int main(int argc, char **argv)
 
     op = parse_command_line(argc, argv, &systems);
 
+    /* with machine readable output, stdout is reserved for the results */
+
+    if (op->output_format != OUTPUT_FORMAT_TEXT) {
+        nv_set_msg_stream(stderr);
+    }
+
+    if (op->profile_startup) {
+        nv_profile_init(op->profile_trace);
+    }
+
+    NvCtrlSetTopologyCacheEnabled(op->topology_cache);
+
+    /* print the contents of a monitor log, if requested */
+
+    if (op->read_log) {
+        return nv_monitor_log_read(op->read_log, op->log_start,
+                                   op->log_end) ? 0 : 1;
+    }
+
     /*
      * Using the default library names, along with a possible path or name
      * specified by the user, attempt to dlopen the appropriate user interface
      * shared object.
      */
 
+    nv_profile_begin("load_ui_library");
     load_ui_library(&libdata, op);
+    nv_profile_end();
 
     if (libdata.gui_lib_handle) {
         /*
@@ -265,12 +289,14 @@ int main(int argc, char **argv)
 
         remove_flag_from_command_line(&argc, &argv);
 
+        nv_profile_begin("ctk_init_check");
         if (libdata.fn_ctk_init_check(&argc, &argv)) {
             if (!op->ctrl_display) {
                 op->ctrl_display = libdata.fn_ctk_get_display();
             }
             gui = 1;
         }
+        nv_profile_end();
     }
 
     /*
@@ -295,14 +321,28 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    /*
+     * process any query or assignment commandline options; these connect
+     * to the X servers they apply to as needed, so that with --jobs only
+     * the worker processes connect
+     */
+
+    if (!op->monitor && (op->num_assignments || op->num_queries)) {
+        ret = nv_process_assignments_and_queries(op, &systems);
+        NvCtrlFreeAllSystems(&systems);
+        return ret ? 0 : 1;
+    }
+
     /* Allocate handle for ctrl_display */
 
+    nv_profile_begin("NvCtrlConnectToSystem");
     NvCtrlConnectToSystem(op->ctrl_display, &systems);
+    nv_profile_end();
 
-    /* process any query or assignment commandline options */
+    /* sample attributes until interrupted, if requested */
 
-    if (op->num_assignments || op->num_queries) {
-        ret = nv_process_assignments_and_queries(op, &systems);
+    if (op->monitor) {
+        ret = nv_monitor(op, &systems);
         NvCtrlFreeAllSystems(&systems);
         return ret ? 0 : 1;
     }
@@ -337,8 +377,10 @@ int main(int argc, char **argv)
     /* upload the data from the config file */
     
     if (!op->no_load) {
+        nv_profile_begin("nv_read_config_file");
         ret = nv_read_config_file(op, op->config, op->ctrl_display,
                                   p, &conf, &systems);
+        nv_profile_end();
     } else {
         ret = 1;
     }
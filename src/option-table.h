@@ -153,6 +153,107 @@ static const NVGetoptOption __options[] = {
       "as a list of display devices (e.g., \"CRT-0, DFP-0\"), rather than "
       "a hexadecimal bit mask (e.g., 0x00010001)." },
 
+    { "output", OUTPUT_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Print the results of the ^'--query'^ options in the format "
+      "&OUTPUT&: ^'text'^ (the default), ^'json'^ or ^'ndjson'^.  With "
+      "^'json'^, the results of all queries are printed as a single JSON "
+      "array of objects; with ^'ndjson'^, one JSON object is printed per "
+      "line.  There is one object per target and attribute (or, for the "
+      "target list queries such as ^'-q gpus'^, per target), holding the "
+      "current value, the valid values and the permissions of the "
+      "attribute.  Objects are printed as soon as they are queried.  All "
+      "other messages are printed to standard error, so that standard "
+      "output only holds JSON." },
+
+    { "jobs", 'j', NVGETOPT_INTEGER_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Process the '--query' and '--assign' command line options for up to "
+      "&JOBS& X displays in parallel, each over its own connection to its X "
+      "server.  The output is printed once all X displays have been "
+      "processed, in the order in which the options were given.  By "
+      "default, X displays are processed one after another." },
+
+    { "atomic", ATOMIC_OPTION, NVGETOPT_HELP_ALWAYS, NULL,
+      "Make the '--assign' command line options a single transaction.  The "
+      "current values of all the attributes to be assigned are read first, "
+      "and the assignments are then sent together.  If any assignment is "
+      "invalid, none are made; if any assignment fails, the attributes that "
+      "were already assigned are restored to their previous values.  Only "
+      "integer attributes whose current value can be read may be assigned "
+      "this way.  This option implies ^'--jobs=1'^." },
+
+    { "monitor", 'm', NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Sample the comma-separated list of integer attributes &MONITOR& (e.g., "
+      "^'GPUCoreTemp,GPUUtilization'^) on every GPU, thermal sensor and fan "
+      "of the X display at a fixed interval, and print one line per target "
+      "and sample, until interrupted.  Each line holds the time of the "
+      "sample in seconds since the Epoch, the target, and the value of each "
+      "attribute that is available on the target." },
+
+    { "monitor-interval", MONITOR_INTERVAL_OPTION,
+      NVGETOPT_INTEGER_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Sample the attributes given with ^'--monitor'^ every &MONITOR-INTERVAL& "
+      "milliseconds.  The default is 1000 milliseconds." },
+
+    { "monitor-output", MONITOR_OUTPUT_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Write the records produced by ^'--monitor'^ to the file "
+      "&MONITOR-OUTPUT& rather than to standard output." },
+
+    { "monitor-samples", MONITOR_SAMPLES_OPTION,
+      NVGETOPT_INTEGER_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Exit after taking &MONITOR-SAMPLES& samples in ^'--monitor'^ mode.  By "
+      "default, sampling continues until ^nvidia-settings^ is interrupted." },
+
+    { "monitor-log", MONITOR_LOG_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Store the samples taken by ^'--monitor'^ in the binary log file "
+      "&MONITOR-LOG&, rather than printing them (unless ^'--monitor-output'^ "
+      "is also given).  The log is a ring buffer: once it is full, the oldest "
+      "samples are overwritten.  Use ^'--read-log'^ to print its contents." },
+
+    { "monitor-log-size", MONITOR_LOG_SIZE_OPTION,
+      NVGETOPT_INTEGER_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Keep the last &MONITOR-LOG-SIZE& samples in the log file given with "
+      "^'--monitor-log'^.  The default is 3600 samples." },
+
+    { "read-log", READ_LOG_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Print the samples stored in the log file &READ-LOG&, written with "
+      "^'--monitor-log'^, in the format used by ^'--monitor'^, and exit." },
+
+    { "log-start", LOG_START_OPTION,
+      NVGETOPT_DOUBLE_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Only print the samples taken at or after &LOG-START& seconds since "
+      "the Epoch with ^'--read-log'^." },
+
+    { "log-end", LOG_END_OPTION,
+      NVGETOPT_DOUBLE_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Only print the samples taken at or before &LOG-END& seconds since "
+      "the Epoch with ^'--read-log'^." },
+
+    { "profile-startup", PROFILE_STARTUP_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_ARGUMENT_IS_OPTIONAL |
+      NVGETOPT_HELP_ALWAYS, NULL,
+      "Time the startup phases of nvidia-settings (connecting to the X "
+      "server, discovering targets and their relationships, loading NVML "
+      "and the GUI library, and building the GUI pages), and count the "
+      "NV-CONTROL round trips to the X server made in each.  When "
+      "nvidia-settings exits, a report is printed to standard error or, if "
+      "&PROFILE-STARTUP& is given, written to that file in the Chrome trace "
+      "event format (viewable in chrome://tracing or Perfetto)." },
+
+    { "topology-cache", TOPOLOGY_CACHE_OPTION,
+      NVGETOPT_IS_BOOLEAN | NVGETOPT_HELP_ALWAYS, NULL,
+      "Cache the targets found on the X server (X screens, GPUs, display "
+      "devices, etc.), along with their names and relationships, in "
+      "$XDG_CACHE_HOME/nvidia-settings (~/.cache/nvidia-settings by "
+      "default), and reuse them on later runs for as long as the X server's "
+      "configuration (driver version, GPUs and connected and enabled display "
+      "devices) is unchanged.  This avoids most of the requests sent to the X "
+      "server at startup, which makes repeated ^'--query'^ calls faster, "
+      "particularly over remote X connections." },
+
     { "glxinfo", 'g', NVGETOPT_HELP_ALWAYS, NULL,
       "Print GLX Information for the X display and exit." },
 
@@ -405,6 +405,102 @@ const int attributeTableLen = ARRAY_LEN(attributeTable);
 
 
 
+/*
+ * Lookup index over attributeTable[]: for each attribute type, a dense
+ * array of entries indexed by attribute constant, and an open addressing
+ * hash table over the case-folded attribute names.  Both are built from
+ * the (constant) table the first time a lookup is made, so that
+ * nv_get_attribute_entry() and nv_get_attribute_entry_by_name() don't
+ * have to scan the whole table on every call.
+ */
+
+#define ATTRIBUTE_TYPE_COUNT (CTRL_ATTRIBUTE_TYPE_SDI_CSC + 1)
+
+static struct {
+    int initialized;
+
+    struct {
+        const AttributeTableEntry **entries;
+        int len;
+    } by_attr[ATTRIBUTE_TYPE_COUNT];
+
+    const AttributeTableEntry **by_name;
+    unsigned int by_name_mask;
+} attributeIndex;
+
+
+static unsigned int attribute_name_hash(const char *name)
+{
+    unsigned int h = 5381;
+
+    while (*name) {
+        h = (h * 33) ^ (unsigned char) toupper(*name);
+        name++;
+    }
+
+    return h;
+}
+
+
+static void init_attribute_index(void)
+{
+    unsigned int size;
+    int i, type;
+
+    if (attributeIndex.initialized) {
+        return;
+    }
+
+    /* size the dense arrays after the largest attribute of each type */
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+
+        if (a->attr >= attributeIndex.by_attr[a->type].len) {
+            attributeIndex.by_attr[a->type].len = a->attr + 1;
+        }
+    }
+
+    for (type = 0; type < ATTRIBUTE_TYPE_COUNT; type++) {
+        attributeIndex.by_attr[type].entries =
+            nvalloc(attributeIndex.by_attr[type].len *
+                    sizeof(*attributeIndex.by_attr[type].entries));
+    }
+
+    /* keep the name table at most a quarter full */
+
+    for (size = 1; size < (unsigned int) attributeTableLen * 4; size <<= 1);
+
+    attributeIndex.by_name = nvalloc(size * sizeof(*attributeIndex.by_name));
+    attributeIndex.by_name_mask = size - 1;
+
+    /*
+     * The first entry wins in both indices, matching the order in which
+     * the table used to be scanned.
+     */
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+        unsigned int slot;
+
+        if (a->attr >= 0 && !attributeIndex.by_attr[a->type].entries[a->attr]) {
+            attributeIndex.by_attr[a->type].entries[a->attr] = a;
+        }
+
+        slot = attribute_name_hash(a->name) & attributeIndex.by_name_mask;
+        while (attributeIndex.by_name[slot] &&
+               !nv_strcasecmp(attributeIndex.by_name[slot]->name, a->name)) {
+            slot = (slot + 1) & attributeIndex.by_name_mask;
+        }
+        if (!attributeIndex.by_name[slot]) {
+            attributeIndex.by_name[slot] = a;
+        }
+    }
+
+    attributeIndex.initialized = NV_TRUE;
+}
+
+
 /*
  * returns the corresponding attribute entry for the given attribute constant.
  *
@@ -412,16 +508,14 @@ const int attributeTableLen = ARRAY_LEN(attributeTable);
 const AttributeTableEntry *nv_get_attribute_entry(const int attr,
                                                   const CtrlAttributeType type)
 {
-    int i;
+    init_attribute_index();
 
-    for (i = 0; i < attributeTableLen; i++) {
-        const AttributeTableEntry *a = attributeTable + i;
-        if ((a->attr == attr) && (a->type == type)) {
-            return a;
-        }
+    if ((type < 0) || (type >= ATTRIBUTE_TYPE_COUNT) ||
+        (attr < 0) || (attr >= attributeIndex.by_attr[type].len)) {
+        return NULL;
     }
 
-    return NULL;
+    return attributeIndex.by_attr[type].entries[attr];
 }
 
 
@@ -430,15 +524,22 @@ const AttributeTableEntry *nv_get_attribute_entry(const int attr,
  * name.
  *
  */
-static const AttributeTableEntry *nv_get_attribute_entry_by_name(const char *name)
+const AttributeTableEntry *nv_get_attribute_entry_by_name(const char *name)
 {
-    int i;
+    unsigned int slot;
 
-    for (i = 0; i < attributeTableLen; i++) {
-        const AttributeTableEntry *t = attributeTable + i;
-        if (nv_strcasecmp(name, t->name)) {
-            return t;
+    if (!name || !name[0]) {
+        return NULL;
+    }
+
+    init_attribute_index();
+
+    slot = attribute_name_hash(name) & attributeIndex.by_name_mask;
+    while (attributeIndex.by_name[slot]) {
+        if (nv_strcasecmp(name, attributeIndex.by_name[slot]->name)) {
+            return attributeIndex.by_name[slot];
         }
+        slot = (slot + 1) & attributeIndex.by_name_mask;
     }
 
     return NULL;
@@ -556,6 +657,130 @@ static int nv_parse_special_xscreen_target(ParsedAttribute *p,
 
 
 
+/*
+ * ParserArena - strings are carved out of large blocks, which are only
+ * released by nv_parser_arena_free().  The arena also keeps a scratch
+ * buffer for the whitespace-free copy of the string being parsed, so
+ * that parsing a line with an arena allocates nothing in the common
+ * case.
+ */
+
+#define PARSER_ARENA_BLOCK_SIZE 16384
+
+typedef struct _ParserArenaBlock {
+    struct _ParserArenaBlock *next;
+    size_t size;
+    size_t used;
+    char *data;
+} ParserArenaBlock;
+
+struct _ParserArena {
+    ParserArenaBlock *blocks;   /* the current block comes first */
+    char *scratch;
+    size_t scratch_size;
+};
+
+
+
+ParserArena *nv_parser_arena_new(void)
+{
+    return nvalloc(sizeof(ParserArena));
+}
+
+
+
+void nv_parser_arena_free(ParserArena *arena)
+{
+    ParserArenaBlock *b, *next;
+
+    if (!arena) {
+        return;
+    }
+
+    for (b = arena->blocks; b; b = next) {
+        next = b->next;
+        nvfree(b);
+    }
+
+    nvfree(arena->scratch);
+    nvfree(arena);
+}
+
+
+
+/*
+ * parser_strndup() - copy len characters of s into the arena, or onto
+ * the heap (as nvstrndup() does) if arena is NULL.
+ */
+
+static char *parser_strndup(ParserArena *arena, const char *s, size_t len)
+{
+    ParserArenaBlock *b;
+    char *str;
+
+    if (!arena) {
+        return nvstrndup(s, len);
+    }
+
+    b = arena->blocks;
+
+    if (!b || ((b->size - b->used) < (len + 1))) {
+        size_t size = NV_MAX(PARSER_ARENA_BLOCK_SIZE, len + 1);
+
+        b = nvalloc(sizeof(ParserArenaBlock) + size);
+        b->data = (char *) (b + 1);
+        b->size = size;
+        b->next = arena->blocks;
+        arena->blocks = b;
+    }
+
+    str = b->data + b->used;
+    memcpy(str, s, len);
+    str[len] = '\0';
+    b->used += len + 1;
+
+    return str;
+}
+
+
+
+/*
+ * parser_remove_spaces() - remove_spaces(), into the arena's scratch
+ * buffer if there is an arena; the result is only valid until the next
+ * call with the same arena.
+ */
+
+static char *parser_remove_spaces(ParserArena *arena, const char *o)
+{
+    size_t len;
+    char *m;
+
+    if (!arena) {
+        return remove_spaces(o);
+    }
+
+    if (!o) return NULL;
+
+    len = strlen(o);
+
+    if (len >= arena->scratch_size) {
+        arena->scratch_size = NV_MAX(2 * arena->scratch_size, len + 1);
+        nvfree(arena->scratch);
+        arena->scratch = nvalloc(arena->scratch_size);
+    }
+
+    m = arena->scratch;
+    while (*o) {
+        if (!isspace(*o)) { *m++ = *o; }
+        o++;
+    }
+    *m = '\0';
+
+    return arena->scratch;
+}
+
+
+
 /*!
  * Parse the string as one of either: an X Display name, just an X screen, and/
  * or a target specification in which the string can be in one of the following
@@ -581,7 +806,8 @@ static int nv_parse_special_xscreen_target(ParsedAttribute *p,
 
 static int nv_parse_display_and_target(const char *start,
                                        const char *end, /* exclusive */
-                                       ParsedAttribute *p)
+                                       ParsedAttribute *p,
+                                       ParserArena *arena)
 {
     int len;
     const char *s, *pOpen, *pClose;
@@ -640,7 +866,7 @@ static int nv_parse_display_and_target(const char *start,
 
         len = pClose - pOpen - 1;
 
-        p->target_specification = nvstrndup(pOpen + 1, len);
+        p->target_specification = parser_strndup(arena, pOpen + 1, len);
 
         /*
          * The X Display name should end on the opening bracket of the target
@@ -654,8 +880,8 @@ static int nv_parse_display_and_target(const char *start,
 
     if (startDisplayName < endDisplayName) {
 
-        p->display = nvstrndup(startDisplayName,
-                               endDisplayName - startDisplayName);
+        p->display = parser_strndup(arena, startDisplayName,
+                                    endDisplayName - startDisplayName);
         p->parser_flags.has_x_display = NV_TRUE;
 
         /*
@@ -675,14 +901,15 @@ static int nv_parse_display_and_target(const char *start,
  * nv_parse_attribute_string() - see comments in parse.h
  */
 
-int nv_parse_attribute_string(const char *str, int query, ParsedAttribute *p)
+int nv_parse_attribute_string(const char *str, int query, ParsedAttribute *p,
+                              ParserArena *arena)
 {
     char *s, *tmp, *name, *start, *equal_sign, *no_spaces = NULL;
     char tmpname[NV_PARSER_MAX_NAME_LEN];
     int len, ret;
     const AttributeTableEntry *a;
 
-#define stop(x) { if (no_spaces) free(no_spaces); return (x); }
+#define stop(x) { if (no_spaces && !arena) free(no_spaces); return (x); }
 
     if (!p) {
         stop(NV_PARSER_STATUS_BAD_ARGUMENT);
@@ -696,7 +923,7 @@ int nv_parse_attribute_string(const char *str, int query, ParsedAttribute *p)
 
     /* remove any white space from the string, to simplify parsing */
 
-    no_spaces = remove_spaces(str);
+    no_spaces = parser_remove_spaces(arena, str);
     if (!no_spaces) stop(NV_PARSER_STATUS_EMPTY_STRING);
 
     /*
@@ -727,7 +954,7 @@ int nv_parse_attribute_string(const char *str, int query, ParsedAttribute *p)
 
     if ((s) && (s != no_spaces)) {
 
-        ret = nv_parse_display_and_target(no_spaces, s, p);
+        ret = nv_parse_display_and_target(no_spaces, s, p, arena);
 
         if (ret != NV_PARSER_STATUS_SUCCESS) {
             stop(ret);
@@ -774,16 +1001,17 @@ int nv_parse_attribute_string(const char *str, int query, ParsedAttribute *p)
         while (*s && *s != ']') {
             s++;
         }
-        tmp = nvstrndup(start, s - start);
-        mask_str = remove_spaces(tmp);
-        nvfree(tmp);
+        /* no_spaces has no spaces left to remove */
+        mask_str = parser_strndup(arena, start, s - start);
 
         p->display_device_mask = strtoul(mask_str, &tmp, 0);
         if (*mask_str != '\0' &&
             tmp &&
             *tmp == '\0') {
             /* specification given as integer */
-            nvfree(mask_str);
+            if (!arena) {
+                nvfree(mask_str);
+            }
         } else {
             /* specification given as string (list of display names) */
             if (a->flags.hijack_display_device) {
@@ -1224,7 +1452,8 @@ void nv_parsed_attribute_add(ParsedAttribute *head, ParsedAttribute *p)
     t->next                 = nvalloc(sizeof(ParsedAttribute));
 
     t->display              = p->display ? nvstrdup(p->display) : NULL;
-    t->target_specification = p->target_specification;
+    t->target_specification = p->target_specification ?
+                              nvstrdup(p->target_specification) : NULL;
     t->target_type          = p->target_type;
     t->target_id            = p->target_id;
     t->attr_entry           = p->attr_entry;
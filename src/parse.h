@@ -161,6 +161,20 @@ typedef struct _ParsedAttribute {
 
 
 
+/*
+ * ParserArena - allocator for the strings of many ParsedAttributes that
+ * share the same lifetime (e.g., all the lines of a configuration file);
+ * everything allocated from an arena is freed at once by
+ * nv_parser_arena_free().
+ */
+
+typedef struct _ParserArena ParserArena;
+
+ParserArena *nv_parser_arena_new(void);
+void nv_parser_arena_free(ParserArena *arena);
+
+
+
 /*
  * Attribute table; defined in parse.c
  */
@@ -227,9 +241,15 @@ const float * nv_get_sdi_csc_matrix(char *s);
  * assigned in the ParsedAttribute struct, and the
  * NV_PARSER_HAS_X_SERVER and NV_PARSER_HAS_DISPLAY_DEVICE_MASK bits
  * will be set in the flags field.
+ *
+ * If arena is not NULL, the display name, target specification and
+ * display device specification strings of the ParsedAttribute are
+ * allocated from it, rather than on the heap, and must not be freed
+ * individually.
  */
 
-int nv_parse_attribute_string(const char *, int, ParsedAttribute *);
+int nv_parse_attribute_string(const char *, int, ParsedAttribute *,
+                              ParserArena *arena);
 
 
 /*
@@ -294,6 +314,7 @@ void nv_parsed_attribute_clean(ParsedAttribute *p);
 
 const AttributeTableEntry *nv_get_attribute_entry(const int attr,
                                                   const CtrlAttributeType type);
+const AttributeTableEntry *nv_get_attribute_entry_by_name(const char *name);
 
 char *nv_standardize_screen_name(const char *display_name, int screen);
 
@@ -0,0 +1,402 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * profile.c - startup profiler (--profile-startup).
+ *
+ * Every nv_profile_begin()/nv_profile_end() pair records a span: its
+ * name, parent span, start and end times on the monotonic clock, and
+ * the number of X server round trips made while it was open.  Spans are
+ * kept in a fixed-size array so that recording one is cheap and does
+ * not allocate.
+ *
+ * At exit the spans are either summarized as an indented tree (spans
+ * with the same name under the same parent are merged, with a count), or
+ * written to a file in the Chrome trace event format, which can be
+ * loaded in chrome://tracing or Perfetto.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common-utils.h"
+#include "msg.h"
+
+#include "profile.h"
+
+#define MAX_PROFILE_SPANS 4096
+#define MAX_PROFILE_DEPTH 32
+
+#define MAX_PROFILE_NAME  64
+
+typedef struct {
+    char name[MAX_PROFILE_NAME];
+    int parent;             /* index of the enclosing span, or -1 */
+    int64_t start;          /* in nanoseconds */
+    int64_t end;            /* 0 while the span is open */
+    unsigned int round_trips;
+} ProfileSpan;
+
+/*
+ * A node of the report tree: all spans with the same name and the same
+ * (merged) parent.
+ */
+
+typedef struct {
+    const char *name;
+    int parent;
+    int count;
+    int64_t total;
+    unsigned int round_trips;
+} ProfileNode;
+
+static struct {
+    int enabled;
+    const char *trace_file;
+    int64_t origin;
+
+    ProfileSpan spans[MAX_PROFILE_SPANS];
+    int num_spans;
+    int dropped;
+
+    int stack[MAX_PROFILE_DEPTH];
+    int depth;
+
+    unsigned int round_trips;
+} __profile;
+
+
+
+static int64_t profile_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+
+/*
+ * nv_profile_begin() - open a span named 'name' (copied, and truncated to
+ * MAX_PROFILE_NAME - 1 characters).
+ */
+
+void nv_profile_begin(const char *name)
+{
+    ProfileSpan *span;
+
+    if (!__profile.enabled) {
+        return;
+    }
+
+    /*
+     * Spans that do not fit are still pushed (as -1) so that the matching
+     * nv_profile_end() pops the right entry.
+     */
+
+    if (__profile.depth >= MAX_PROFILE_DEPTH) {
+        __profile.dropped++;
+        __profile.depth++;
+        return;
+    }
+
+    if (__profile.num_spans >= MAX_PROFILE_SPANS) {
+        __profile.dropped++;
+        __profile.stack[__profile.depth++] = -1;
+        return;
+    }
+
+    span = &__profile.spans[__profile.num_spans];
+
+    strncpy(span->name, name, MAX_PROFILE_NAME - 1);
+    span->name[MAX_PROFILE_NAME - 1] = '\0';
+    span->parent = (__profile.depth > 0) ?
+        __profile.stack[__profile.depth - 1] : -1;
+    span->round_trips = __profile.round_trips;
+    span->end = 0;
+    span->start = profile_now();
+
+    __profile.stack[__profile.depth++] = __profile.num_spans++;
+}
+
+
+
+/*
+ * nv_profile_end() - close the most recently opened span.
+ */
+
+void nv_profile_end(void)
+{
+    ProfileSpan *span;
+    int index;
+
+    if (!__profile.enabled || __profile.depth == 0) {
+        return;
+    }
+
+    __profile.depth--;
+
+    if (__profile.depth >= MAX_PROFILE_DEPTH) {
+        return;
+    }
+
+    index = __profile.stack[__profile.depth];
+    if (index < 0) {
+        return;
+    }
+
+    span = &__profile.spans[index];
+    span->end = profile_now();
+    span->round_trips = __profile.round_trips - span->round_trips;
+}
+
+
+
+/*
+ * nv_profile_round_trip() - count one request that waits for a reply
+ * from the X server.
+ */
+
+void nv_profile_round_trip(void)
+{
+    __profile.round_trips++;
+}
+
+
+
+/*
+ * close_open_spans() - spans still open at exit (e.g. when exiting
+ * from within a phase) end now.
+ */
+
+static void close_open_spans(void)
+{
+    while (__profile.depth > 0) {
+        nv_profile_end();
+    }
+}
+
+
+
+/*
+ * print_node() - print 'index' and, recursively, its children, in the
+ * order they were first entered.
+ */
+
+static void print_node(const ProfileNode *nodes, int num_nodes, int index,
+                       int indent)
+{
+    const ProfileNode *node = &nodes[index];
+    char label[128];
+    int i;
+
+    if (node->count > 1) {
+        snprintf(label, sizeof(label), "%*s%s (x%d)", indent * 2, "",
+                 node->name, node->count);
+    } else {
+        snprintf(label, sizeof(label), "%*s%s", indent * 2, "", node->name);
+    }
+
+    fprintf(stderr, "  %-56s %10.3f ms %8u\n", label,
+            (double) node->total / 1000000.0, node->round_trips);
+
+    for (i = index + 1; i < num_nodes; i++) {
+        if (nodes[i].parent == index) {
+            print_node(nodes, num_nodes, i, indent + 1);
+        }
+    }
+}
+
+
+
+/*
+ * print_report() - merge the spans into a tree keyed by name and parent,
+ * and print it.  Spans are recorded in the order they were opened, so a
+ * span's parent always precedes it and the nodes end up in pre-order.
+ */
+
+static void print_report(void)
+{
+    ProfileNode *nodes;
+    int *span_node;
+    int num_nodes = 0;
+    int i, j;
+
+    nodes = nvalloc(sizeof(ProfileNode) * (__profile.num_spans + 1));
+    span_node = nvalloc(sizeof(int) * (__profile.num_spans + 1));
+
+    for (i = 0; i < __profile.num_spans; i++) {
+        const ProfileSpan *span = &__profile.spans[i];
+        int parent = (span->parent >= 0) ? span_node[span->parent] : -1;
+
+        for (j = 0; j < num_nodes; j++) {
+            if (nodes[j].parent == parent &&
+                strcmp(nodes[j].name, span->name) == 0) {
+                break;
+            }
+        }
+
+        if (j == num_nodes) {
+            nodes[j].name = span->name;
+            nodes[j].parent = parent;
+            num_nodes++;
+        }
+
+        nodes[j].count++;
+        nodes[j].total += span->end - span->start;
+        nodes[j].round_trips += span->round_trips;
+        span_node[i] = j;
+    }
+
+    fprintf(stderr, "\nStartup profile (%.3f ms total):\n\n",
+            (double) (profile_now() - __profile.origin) / 1000000.0);
+    fprintf(stderr, "  %-56s %13s %8s\n", "Phase", "Time", "X trips");
+
+    for (i = 0; i < num_nodes; i++) {
+        if (nodes[i].parent < 0) {
+            print_node(nodes, num_nodes, i, 0);
+        }
+    }
+
+    fprintf(stderr, "\n  %u X server round trips in total.\n",
+            __profile.round_trips);
+
+    if (__profile.dropped) {
+        fprintf(stderr, "  %d spans were not recorded.\n", __profile.dropped);
+    }
+
+    fprintf(stderr, "\n");
+
+    nvfree(span_node);
+    nvfree(nodes);
+}
+
+
+
+static void write_json_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            fprintf(fp, "\\%c", *str);
+        } else if ((unsigned char) *str < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char) *str);
+        } else {
+            fputc(*str, fp);
+        }
+    }
+
+    fputc('"', fp);
+}
+
+
+
+/*
+ * write_trace() - write the spans as Chrome trace "complete" events;
+ * times are in microseconds relative to nv_profile_init().
+ */
+
+static void write_trace(const char *filename)
+{
+    FILE *fp;
+    int pid = getpid();
+    int i;
+
+    fp = fopen(filename, "w");
+    if (!fp) {
+        nv_error_msg("Unable to open profile trace file '%s' for writing.",
+                     filename);
+        return;
+    }
+
+    fprintf(fp, "{\"traceEvents\":[\n");
+
+    for (i = 0; i < __profile.num_spans; i++) {
+        const ProfileSpan *span = &__profile.spans[i];
+
+        fprintf(fp, "%s{\"name\":", (i > 0) ? ",\n" : "");
+        write_json_string(fp, span->name);
+        fprintf(fp, ",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,"
+                "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"round_trips\":%u}}",
+                pid,
+                (double) (span->start - __profile.origin) / 1000.0,
+                (double) (span->end - span->start) / 1000.0,
+                span->round_trips);
+    }
+
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    if (fclose(fp) != 0) {
+        nv_error_msg("Error writing profile trace file '%s'.", filename);
+        return;
+    }
+
+    nv_msg(NULL, "Startup profile written to '%s'.", filename);
+}
+
+
+
+/*
+ * profile_atexit() - report the profile.  Forked --jobs workers leave
+ * with _exit(), so only the parent process reports.
+ */
+
+static void profile_atexit(void)
+{
+    if (!__profile.enabled) {
+        return;
+    }
+
+    close_open_spans();
+    __profile.enabled = FALSE;
+
+    if (__profile.trace_file) {
+        write_trace(__profile.trace_file);
+    } else {
+        print_report();
+    }
+}
+
+
+
+/*
+ * nv_profile_init() - start profiling; the results are written to
+ * 'trace_file' in the Chrome trace event format, or printed as a tree on
+ * stderr if 'trace_file' is NULL, when the process exits.
+ */
+
+void nv_profile_init(const char *trace_file)
+{
+    if (__profile.enabled) {
+        return;
+    }
+
+    __profile.trace_file = trace_file;
+    __profile.origin = profile_now();
+    __profile.enabled = TRUE;
+
+    atexit(profile_atexit);
+}
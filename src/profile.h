@@ -0,0 +1,38 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+/*
+ * Startup profiling (--profile-startup).
+ *
+ * Phases are bracketed with nv_profile_begin()/nv_profile_end() pairs,
+ * which may nest; the NV-CONTROL backend counts its X server round
+ * trips with nv_profile_round_trip().  All of these return immediately
+ * unless profiling was enabled with nv_profile_init(), which arranges
+ * for the results to be reported when the process exits.
+ */
+
+void nv_profile_init(const char *trace_file);
+void nv_profile_begin(const char *name);
+void nv_profile_end(void);
+void nv_profile_round_trip(void);
+
+#endif /* __PROFILE_H__ */
@@ -29,6 +29,10 @@
 #include <ctype.h>
 #include <string.h>
 #include <inttypes.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include <X11/Xlib.h>
 #include "NVCtrlLib.h"
@@ -36,6 +40,7 @@
 #include "parse.h"
 #include "msg.h"
 #include "query-assign.h"
+#include "json-writer.h"
 #include "common-utils.h"
 
 /* local prototypes */
@@ -50,9 +55,11 @@ static int process_attribute_assignments(const Options *,
                                          int, char**, const char *,
                                          CtrlSystemList *);
 
+static int process_jobs(const Options *);
+
 static int query_all(const Options *, const char *, CtrlSystemList *);
-static int query_all_targets(const char *display_name, const int target_type,
-                             CtrlSystemList *);
+static int query_all_targets(const Options *op, const char *display_name,
+                             const int target_type, CtrlSystemList *);
 
 static void print_valid_values(const Options *op, const AttributeTableEntry *a,
                                CtrlAttributeValidValues valid);
@@ -65,6 +72,40 @@ static void print_additional_info(const char *name,
 static ReturnStatus get_framelock_sync_state(CtrlTarget *target,
                                              int *enabled);
 
+static JsonWriter *create_json_writer(const Options *op);
+
+/*
+ * Integer assignments deferred by nv_process_parsed_attribute() while an
+ * assignment batch is open; see nv_assignment_batch_end().
+ */
+
+typedef struct {
+    CtrlTarget *t;
+    const AttributeTableEntry *a;
+    int val;
+    int verbose;
+    char *whence;
+    char str[32];   /* display device suffix for messages */
+} BatchedAssignment;
+
+static struct {
+    int active;
+    int atomic;     /* all or nothing; see nv_assignment_batch_begin() */
+    int failed;     /* an assignment of an atomic batch was rejected */
+    BatchedAssignment *items;
+    int num_items;
+    int max_items;
+} assignment_batch;
+
+/*
+ * The JSON document (--output=json|ndjson) that all queries of the run
+ * write their records to; NULL for the text output.
+ */
+
+static JsonWriter *json_output;
+
+
+
 /*
  * nv_process_assignments_and_queries() - process any assignments or
  * queries specified on the commandline.  If an error occurs, return
@@ -74,14 +115,23 @@ static ReturnStatus get_framelock_sync_state(CtrlTarget *target,
 int nv_process_assignments_and_queries(const Options *op,
                                        CtrlSystemList *systems)
 {
-    int ret;
+    int ret = NV_TRUE;
+
+    if (op->num_queries) {
+        json_output = create_json_writer(op);
+    }
+
+    if ((op->jobs > 1) && !op->atomic) {
+        ret = process_jobs(op);
+        goto done;
+    }
 
     if (op->num_queries) {
         ret = process_attribute_queries(op,
                                         op->num_queries,
                                         op->queries, op->ctrl_display,
                                         systems);
-        if (!ret) return NV_FALSE;
+        if (!ret) goto done;
     }
 
     if (op->num_assignments) {
@@ -90,10 +140,14 @@ int nv_process_assignments_and_queries(const Options *op,
                                             op->assignments,
                                             op->ctrl_display,
                                             systems);
-        if (!ret) return NV_FALSE;
     }
-    
-    return NV_TRUE;
+
+ done:
+
+    nv_json_writer_close(json_output);
+    json_output = NULL;
+
+    return ret;
 
 } /* nv_process_assignments_and_queries() */
 
@@ -698,6 +752,180 @@ static int resolve_attribute_targets(ParsedAttribute *p, CtrlSystem *system,
 
 
 
+/*
+ * Special queries that list all targets of a given type on the default
+ * display, rather than naming an attribute.
+ */
+
+static const struct {
+    const char *name;
+    CtrlTargetType target_type;
+} target_type_queries[] = {
+    { "screens",        X_SCREEN_TARGET },
+    { "xscreens",       X_SCREEN_TARGET },
+    { "gpus",           GPU_TARGET },
+    { "framelocks",     FRAMELOCK_TARGET },
+    { "vcs",            VCS_TARGET },
+    { "gvis",           GVI_TARGET },
+    { "fans",           COOLER_TARGET },
+    { "thermalsensors", THERMAL_SENSOR_TARGET },
+    { "svps",           NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET },
+    { "dpys",           DISPLAY_TARGET },
+};
+
+
+
+/*
+ * is_special_query() - returns NV_TRUE if the query is "all" or one of
+ * the target type queries, which are not parsed as attribute strings and
+ * always apply to the default display.
+ */
+
+static int is_special_query(const char *query)
+{
+    int i;
+
+    if (nv_strcasecmp(query, "all")) {
+        return NV_TRUE;
+    }
+
+    for (i = 0; i < ARRAY_LEN(target_type_queries); i++) {
+        if (nv_strcasecmp(query, target_type_queries[i].name)) {
+            return NV_TRUE;
+        }
+    }
+
+    return NV_FALSE;
+}
+
+
+
+/*
+ * process_query() - process a single query from the command line.
+ *
+ * If any errors are encountered, an error message is printed and
+ * NV_FALSE is returned.  Otherwise, NV_TRUE is returned.
+ */
+
+static int process_query(const Options *op, char *query,
+                         const char *display_name, CtrlSystemList *systems)
+{
+    int i, ret;
+    ParsedAttribute a;
+    CtrlSystem *system;
+
+    /* special case the "all" query */
+
+    if (nv_strcasecmp(query, "all")) {
+        query_all(op, display_name, systems);
+        return NV_TRUE;
+    }
+
+    /* special case the target type queries */
+
+    for (i = 0; i < ARRAY_LEN(target_type_queries); i++) {
+        if (nv_strcasecmp(query, target_type_queries[i].name)) {
+            query_all_targets(op, display_name,
+                              target_type_queries[i].target_type, systems);
+            return NV_TRUE;
+        }
+    }
+
+    /* call the parser to parse the query */
+
+    ret = nv_parse_attribute_string(query, NV_PARSER_QUERY, &a, NULL);
+    if (ret != NV_PARSER_STATUS_SUCCESS) {
+        nv_error_msg("Error parsing query '%s' (%s).",
+                     query, nv_parse_strerror(ret));
+        return NV_FALSE;
+    }
+
+    /* make sure we have a display */
+
+    nv_assign_default_display(&a, display_name);
+
+    /* connect to all the systems */
+
+    system = NvCtrlConnectToSystem(a.display, systems);
+    if (!system) {
+        return NV_FALSE;
+    }
+
+    /* call the processing engine to process the parsed query */
+
+    ret = nv_process_parsed_attribute(op, &a, system, NV_FALSE, NV_FALSE,
+                                      "in query '%s'", query);
+    if (ret == NV_FALSE) {
+        return NV_FALSE;
+    }
+
+    /* print a newline at the end */
+    if (!op->terse && !json_output) {
+        nv_msg(NULL, "");
+    }
+
+    return NV_TRUE;
+
+} /* process_query() */
+
+
+
+/*
+ * process_assignment() - process a single assignment from the command
+ * line.
+ *
+ * If any errors are encountered, an error message is printed and
+ * NV_FALSE is returned.  Otherwise, NV_TRUE is returned.
+ */
+
+static int process_assignment(const Options *op, char *assignment,
+                              const char *display_name,
+                              CtrlSystemList *systems)
+{
+    int ret;
+    ParsedAttribute a;
+    CtrlSystem *system;
+
+    /* call the parser to parse the assignment */
+
+    ret = nv_parse_attribute_string(assignment, NV_PARSER_ASSIGNMENT, &a,
+                                    NULL);
+
+    if (ret != NV_PARSER_STATUS_SUCCESS) {
+        nv_error_msg("Error parsing assignment '%s' (%s).",
+                     assignment, nv_parse_strerror(ret));
+        return NV_FALSE;
+    }
+
+    /* make sure we have a display */
+
+    nv_assign_default_display(&a, display_name);
+
+    /* allocate the CtrlSystem */
+
+    system = NvCtrlConnectToSystem(a.display, systems);
+    if (!system) {
+        return NV_FALSE;
+    }
+
+    /* call the processing engine to process the parsed assignment */
+
+    ret = nv_process_parsed_attribute(op, &a, system, NV_TRUE, NV_TRUE,
+                                      "in assignment '%s'", assignment);
+    if (ret == NV_FALSE) {
+        return NV_FALSE;
+    }
+
+    /* print a newline at the end */
+
+    nv_msg(NULL, "");
+
+    return NV_TRUE;
+
+} /* process_assignment() */
+
+
+
 /*
  * process_attribute_queries() - parse the list of queries, and call
  * nv_ctrl_process_parsed_attribute() to process each query.
@@ -711,192 +939,518 @@ static int process_attribute_queries(const Options *op,
                                      const char *display_name,
                                      CtrlSystemList *systems)
 {
-    int query, ret, val;
-    ParsedAttribute a;
-    CtrlSystem *system;
+    int query;
 
-    val = NV_FALSE;
-    
     /* print a newline before we begin */
 
-    if (!op->terse) {
+    if (!op->terse && !json_output) {
         nv_msg(NULL, "");
     }
 
     /* loop over each requested query */
 
     for (query = 0; query < num; query++) {
-        
-        /* special case the "all" query */
-
-        if (nv_strcasecmp(queries[query], "all")) {
-            query_all(op, display_name, systems);
-            continue;
+        if (!process_query(op, queries[query], display_name, systems)) {
+            return NV_FALSE;
         }
+    }
 
-        /* special case the target type queries */
-        
-        if (nv_strcasecmp(queries[query], "screens") ||
-            nv_strcasecmp(queries[query], "xscreens")) {
-            query_all_targets(display_name, X_SCREEN_TARGET, systems);
-            continue;
-        }
-        
-        if (nv_strcasecmp(queries[query], "gpus")) {
-            query_all_targets(display_name, GPU_TARGET, systems);
-            continue;
-        }
+    return NV_TRUE;
 
-        if (nv_strcasecmp(queries[query], "framelocks")) {
-            query_all_targets(display_name, FRAMELOCK_TARGET, systems);
-            continue;
-        }
+} /* process_attribute_queries() */
 
-        if (nv_strcasecmp(queries[query], "vcs")) {
-            query_all_targets(display_name, VCS_TARGET, systems);
-            continue;
-        }
 
-        if (nv_strcasecmp(queries[query], "gvis")) {
-            query_all_targets(display_name, GVI_TARGET, systems);
-            continue;
-        }
 
-        if (nv_strcasecmp(queries[query], "fans")) {
-            query_all_targets(display_name, COOLER_TARGET, systems);
-            continue;
-        }
+/*
+ * process_attribute_assignments() - parse the list of
+ * assignments, and call nv_process_parsed_attribute() to process
+ * each assignment.  With --atomic, the assignments are made as one
+ * atomic batch.
+ *
+ * If any errors are encountered, an error message is printed and
+ * NV_FALSE is returned.  Otherwise, NV_TRUE is returned.
+ */
 
-        if (nv_strcasecmp(queries[query], "thermalsensors")) {
-            query_all_targets(display_name, THERMAL_SENSOR_TARGET, systems);
-            continue;
+static int process_attribute_assignments(const Options *op,
+                                         int num, char **assignments,
+                                         const char *display_name,
+                                         CtrlSystemList *systems)
+{
+    int assignment;
+
+    /* print a newline before we begin */
+
+    nv_msg(NULL, "");
+
+    if (op->atomic) {
+        nv_assignment_batch_begin(NV_TRUE);
+    }
+
+    /* loop over each requested assignment */
+
+    for (assignment = 0; assignment < num; assignment++) {
+        if (!process_assignment(op, assignments[assignment], display_name,
+                                systems)) {
+            if (op->atomic) {
+                assignment_batch.failed = NV_TRUE;
+                nv_assignment_batch_end(op);
+            }
+            return NV_FALSE;
         }
+    }
+
+    if (op->atomic) {
+        return nv_assignment_batch_end(op);
+    }
+
+    return NV_TRUE;
+
+} /* process_attribute_assignments() */
+
+
+
+/*
+ * Parallel processing of queries and assignments (--jobs).
+ *
+ * The queries and assignments are grouped by the X display they apply
+ * to, and each group is handled by a worker process with its own
+ * connection to its X server, so that talking to many (possibly remote)
+ * X servers takes about as long as talking to the slowest one.  Workers
+ * are forked rather than spawned as threads: the NvCtrl backends keep
+ * process-wide state (dynamically loaded libraries, event handles) that
+ * is not protected against concurrent use.
+ *
+ * Everything a worker prints is captured in temporary files, along with
+ * the offsets at which the output of each item ends, and replayed by the
+ * parent once all workers are done, in the order the items were given on
+ * the command line.
+ */
+
+typedef struct {
+    char *str;          /* query or assignment string */
+    int is_query;
+    int group;          /* index of the JobGroup handling this item */
+} JobItem;
+
+typedef struct {
+    char *display;      /* X display all items of this group apply to */
+    pid_t pid;
+    int ok;
+
+    FILE *out;          /* captured stdout */
+    FILE *err;          /* captured stderr */
+    FILE *index;        /* (stdout, stderr) end offsets, one pair per item */
+
+    char *out_data;
+    char *err_data;
+    long *offsets;
+    int num_done;       /* number of items with an entry in index */
+} JobGroup;
+
+
+
+/*
+ * standardize_item_display() - returns the name items are grouped by: the
+ * X server's display name with the local hostname filled in and without a
+ * screen number, so that all items for one X server go to the same worker
+ * however the display was spelled, or whether it was given at all.
+ */
+
+static char *standardize_item_display(const char *display)
+{
+    char *name;
+
+    if (!display) {
+        return nvstrdup("");
+    }
+
+    name = nv_standardize_screen_name(display, -2);
+
+    return name ? name : nvstrdup(display);
+}
+
+
+
+/*
+ * get_item_display() - returns the standardized name of the X display the
+ * given query or assignment applies to, or NULL if the string can't be
+ * parsed.
+ */
+
+static char *get_item_display(const char *str, int is_query,
+                              const char *display_name)
+{
+    ParsedAttribute *a;
+    char *display;
+    int ret;
+
+    if (is_query && is_special_query(str)) {
+        return standardize_item_display(display_name);
+    }
+
+    a = nvalloc(sizeof(*a));
+
+    ret = nv_parse_attribute_string(str, is_query ? NV_PARSER_QUERY :
+                                                    NV_PARSER_ASSIGNMENT, a,
+                                    NULL);
+    if (ret != NV_PARSER_STATUS_SUCCESS) {
+        nv_error_msg("Error parsing %s '%s' (%s).",
+                     is_query ? "query" : "assignment", str,
+                     nv_parse_strerror(ret));
+        nv_parsed_attribute_free(a);
+        return NULL;
+    }
+
+    nv_assign_default_display(a, display_name);
+
+    display = standardize_item_display(a->display ? a->display :
+                                                    display_name);
+
+    nv_parsed_attribute_free(a);
+
+    return display;
+}
+
+
+
+/*
+ * run_job_group() - worker side: process all items of the given group in
+ * order, with stdout and stderr redirected to the group's capture files.
+ * Stops at the first item that fails, as the sequential path does.
+ */
+
+static int run_job_group(const Options *op, const JobItem *items,
+                         int num_items, int group, JobGroup *g)
+{
+    CtrlSystemList systems;
+    int i, ok = NV_TRUE;
+
+    systems.n = 0;
+    systems.array = NULL;
+
+    if ((dup2(fileno(g->out), STDOUT_FILENO) < 0) ||
+        (dup2(fileno(g->err), STDERR_FILENO) < 0)) {
+        return NV_FALSE;
+    }
+
+    /*
+     * write one record per line; the parent adds them to its own JSON
+     * document, which it opened before starting the workers
+     */
 
-        if (nv_strcasecmp(queries[query], "svps")) {
-            query_all_targets(display_name, 
-                              NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET, 
-                              systems);
+    if (json_output) {
+        json_output = nv_json_writer_create(stdout, NV_TRUE);
+    }
+
+    for (i = 0; i < num_items && ok; i++) {
+        long offsets[2];
+
+        if (items[i].group != group) {
             continue;
         }
 
-        if (nv_strcasecmp(queries[query], "dpys")) {
-            query_all_targets(display_name, DISPLAY_TARGET, systems);
-            continue;
+        if (items[i].is_query) {
+            ok = process_query(op, items[i].str, op->ctrl_display, &systems);
+        } else {
+            ok = process_assignment(op, items[i].str, op->ctrl_display,
+                                    &systems);
         }
 
-        /* call the parser to parse queries[query] */
+        fflush(stdout);
+        fflush(stderr);
 
-        ret = nv_parse_attribute_string(queries[query], NV_PARSER_QUERY, &a);
-        if (ret != NV_PARSER_STATUS_SUCCESS) {
-            nv_error_msg("Error parsing query '%s' (%s).",
-                         queries[query], nv_parse_strerror(ret));
-            goto done;
+        offsets[0] = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+        offsets[1] = lseek(STDERR_FILENO, 0, SEEK_CUR);
+        fwrite(offsets, sizeof(offsets), 1, g->index);
+    }
+
+    NvCtrlFreeAllSystems(&systems);
+
+    fflush(stdout);
+    fflush(stderr);
+    fflush(g->index);
+
+    return ok;
+}
+
+
+
+/*
+ * read_capture_file() - read back the whole contents of a capture file.
+ */
+
+static char *read_capture_file(FILE *stream, long *len)
+{
+    char *data;
+
+    fflush(stream);
+    fseek(stream, 0, SEEK_END);
+    *len = ftell(stream);
+    rewind(stream);
+
+    if (*len <= 0) {
+        *len = 0;
+        return NULL;
+    }
+
+    data = nvalloc(*len);
+    *len = fread(data, 1, *len, stream);
+
+    return data;
+}
+
+
+
+/*
+ * collect_job_group() - read back everything a finished worker captured.
+ */
+
+static void collect_job_group(JobGroup *g)
+{
+    long out_len, err_len, index_len;
+
+    g->out_data = read_capture_file(g->out, &out_len);
+    g->err_data = read_capture_file(g->err, &err_len);
+    g->offsets = (long *) read_capture_file(g->index, &index_len);
+    g->num_done = index_len / (2 * sizeof(long));
+}
+
+
+
+/*
+ * replay_json_records() - add the records a worker wrote, one per line,
+ * to the run's JSON document.
+ */
+
+static void replay_json_records(const char *data, long len)
+{
+    const char *end = data + len;
+
+    while (data < end) {
+        const char *eol = memchr(data, '\n', end - data);
+
+        if (!eol) {
+            eol = end;
         }
-        
-        /* make sure we have a display */
+        if (eol > data) {
+            nv_json_add_record_text(json_output, data, eol - data);
+        }
+        data = eol + 1;
+    }
+}
 
-        nv_assign_default_display(&a, display_name);
 
-        /* connect to all the systems */
 
-        system = NvCtrlConnectToSystem(a.display, systems);
-        if (!system) {
-            goto done;
+/*
+ * replay_job_items() - print the captured output of the given kind of
+ * items (queries or assignments), in command line order.
+ */
+
+static void replay_job_items(const JobItem *items, int num_items,
+                             JobGroup *groups, int is_query)
+{
+    int *next, i, num_groups = 0;
+
+    for (i = 0; i < num_items; i++) {
+        if (items[i].group >= num_groups) {
+            num_groups = items[i].group + 1;
         }
+    }
 
-        /* call the processing engine to process the parsed query */
+    /* next[g] is the ordinal, within group g, of its next item */
 
-        ret = nv_process_parsed_attribute(op, &a, system, NV_FALSE, NV_FALSE,
-                                          "in query '%s'", queries[query]);
-        if (ret == NV_FALSE) goto done;
+    next = nvalloc(num_groups * sizeof(*next));
 
-        /* print a newline at the end */
-        if (!op->terse) {
-            nv_msg(NULL, "");
+    for (i = 0; i < num_items; i++) {
+        JobGroup *g = &groups[items[i].group];
+        int n = next[items[i].group]++;
+        long out_start, err_start;
+
+        if (items[i].is_query != is_query || n >= g->num_done) {
+            continue;
         }
 
-    } /* query */
+        out_start = (n > 0) ? g->offsets[2 * (n - 1)] : 0;
+        err_start = (n > 0) ? g->offsets[2 * (n - 1) + 1] : 0;
 
-    val = NV_TRUE;
-    
- done:
-    
-    return val;
-    
-} /* process_attribute_queries() */
+        if (json_output) {
+            replay_json_records(g->out_data + out_start,
+                                g->offsets[2 * n] - out_start);
+        } else {
+            fwrite(g->out_data + out_start, 1,
+                   g->offsets[2 * n] - out_start, stdout);
+        }
+        fflush(stdout);
+        fwrite(g->err_data + err_start, 1,
+               g->offsets[2 * n + 1] - err_start, stderr);
+        fflush(stderr);
+    }
+
+    nvfree(next);
+}
 
 
 
 /*
- * process_attribute_assignments() - parse the list of
- * assignments, and call nv_process_parsed_attribute() to process
- * each assignment.
+ * process_jobs() - process all queries and assignments with up to
+ * op->jobs worker processes, one per X display.
  *
  * If any errors are encountered, an error message is printed and
  * NV_FALSE is returned.  Otherwise, NV_TRUE is returned.
  */
 
-static int process_attribute_assignments(const Options *op,
-                                         int num, char **assignments,
-                                         const char *display_name,
-                                         CtrlSystemList *systems)
+static int process_jobs(const Options *op)
 {
-    int assignment, ret, val;
-    ParsedAttribute a;
-    CtrlSystem *system;
+    JobItem *items;
+    JobGroup *groups;
+    int num_items, num_groups = 0;
+    int i, g, next_group, running;
+    int ret = NV_FALSE;
 
-    val = NV_FALSE;
+    num_items = op->num_queries + op->num_assignments;
+    items = nvalloc(num_items * sizeof(*items));
+    groups = nvalloc(num_items * sizeof(*groups));
 
-    /* print a newline before we begin */
+    /*
+     * Queries come before assignments, as in the sequential path; work out
+     * which display each item applies to, and group the items by display.
+     */
 
-    nv_msg(NULL, "");
+    for (i = 0; i < num_items; i++) {
+        char *display;
 
-    /* loop over each requested assignment */
+        items[i].is_query = (i < op->num_queries);
+        items[i].str = items[i].is_query ? op->queries[i] :
+            op->assignments[i - op->num_queries];
 
-    for (assignment = 0; assignment < num; assignment++) {
-        
-        /* call the parser to parse assignments[assignment] */
+        display = get_item_display(items[i].str, items[i].is_query,
+                                   op->ctrl_display);
+        if (!display) {
+            goto done;
+        }
+
+        for (g = 0; g < num_groups; g++) {
+            if (strcmp(groups[g].display, display) == 0) {
+                break;
+            }
+        }
 
-        ret = nv_parse_attribute_string(assignments[assignment],
-                                        NV_PARSER_ASSIGNMENT, &a);
+        if (g == num_groups) {
+            groups[g].display = display;
+            groups[g].out = tmpfile();
+            groups[g].err = tmpfile();
+            groups[g].index = tmpfile();
+            num_groups++;
 
-        if (ret != NV_PARSER_STATUS_SUCCESS) {
-            nv_error_msg("Error parsing assignment '%s' (%s).",
-                         assignments[assignment], nv_parse_strerror(ret));
-            goto done;
+            if (!groups[g].out || !groups[g].err || !groups[g].index) {
+                nv_error_msg("Unable to create temporary files for "
+                             "processing '%s' (%s).", display,
+                             strerror(errno));
+                goto done;
+            }
+        } else {
+            nvfree(display);
         }
-        
-        /* make sure we have a display */
 
-        nv_assign_default_display(&a, display_name);
+        items[i].group = g;
+    }
 
-        /* allocate the CtrlSystem */
+    /* anything still buffered would otherwise be inherited by workers */
 
-        system = NvCtrlConnectToSystem(a.display, systems);
-        if (!system) {
-            goto done;
+    fflush(stdout);
+    fflush(stderr);
+
+    /* run the groups, with at most op->jobs workers at a time */
+
+    next_group = 0;
+    running = 0;
+
+    while (next_group < num_groups || running > 0) {
+
+        if (next_group < num_groups && running < op->jobs) {
+            JobGroup *grp = &groups[next_group];
+
+            grp->pid = fork();
+
+            if (grp->pid == 0) {
+                _exit(run_job_group(op, items, num_items, next_group, grp) ?
+                      0 : 1);
+            }
+
+            if (grp->pid < 0) {
+                nv_error_msg("Unable to start a worker for '%s' (%s).",
+                             grp->display, strerror(errno));
+                grp->ok = NV_FALSE;
+            } else {
+                running++;
+            }
+
+            next_group++;
+
+        } else {
+            int status;
+            pid_t pid = wait(&status);
+
+            if (pid < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            for (g = 0; g < next_group; g++) {
+                if (groups[g].pid == pid) {
+                    groups[g].ok = WIFEXITED(status) &&
+                                   (WEXITSTATUS(status) == 0);
+                    running--;
+                    break;
+                }
+            }
         }
+    }
 
-        /* call the processing engine to process the parsed assignment */
+    /* replay the captured output in command line order */
 
-        ret = nv_process_parsed_attribute(op, &a, system, NV_TRUE, NV_TRUE,
-                                          "in assignment '%s'",
-                                          assignments[assignment]);
-        if (ret == NV_FALSE) goto done;
+    for (g = 0; g < num_groups; g++) {
+        collect_job_group(&groups[g]);
+    }
 
-        /* print a newline at the end */
+    if (op->num_queries) {
+        if (!op->terse && !json_output) {
+            nv_msg(NULL, "");
+        }
+        replay_job_items(items, num_items, groups, NV_TRUE);
+    }
 
+    if (op->num_assignments) {
         nv_msg(NULL, "");
+        replay_job_items(items, num_items, groups, NV_FALSE);
+    }
 
-    } /* assignment */
-
-    val = NV_TRUE;
+    ret = NV_TRUE;
+    for (g = 0; g < num_groups; g++) {
+        if (!groups[g].ok) {
+            ret = NV_FALSE;
+        }
+    }
 
  done:
 
-    return val;
+    for (g = 0; g < num_groups; g++) {
+        if (groups[g].out) fclose(groups[g].out);
+        if (groups[g].err) fclose(groups[g].err);
+        if (groups[g].index) fclose(groups[g].index);
+        nvfree(groups[g].out_data);
+        nvfree(groups[g].err_data);
+        nvfree(groups[g].offsets);
+        nvfree(groups[g].display);
+    }
+    nvfree(groups);
+    nvfree(items);
 
-} /* nv_process_attribute_assignments() */
+    return ret;
+
+} /* process_jobs() */
 
 
 
@@ -1346,16 +1900,225 @@ static void print_additional_info(const char *name,
         print_additional_fsaa_info(name, valid.allowed_ints, indent);
         break;
 
-    case NV_CTRL_STEREO:
-        if (valid.valid_type == CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS) {
-            print_additional_stereo_info(name, valid.allowed_ints, indent);
-        }
-        break;
+    case NV_CTRL_STEREO:
+        if (valid.valid_type == CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS) {
+            print_additional_stereo_info(name, valid.allowed_ints, indent);
+        }
+        break;
+
+    // add more here
+
+    }
+
+}
+
+
+
+/*
+ * prefetch_integer_attributes() - query the current value of every
+ * integer attribute that query_all() is going to visit on the given
+ * target and display mask, using a single batched request.  The value
+ * and status for attributeTable[i] are stored in vals[i] and
+ * statuses[i]; prefetched[i] is set for the entries that were queried.
+ */
+
+static void prefetch_integer_attributes(const CtrlTarget *t,
+                                        unsigned int mask, int *vals,
+                                        ReturnStatus *statuses,
+                                        int *prefetched)
+{
+    int *attrs, *entries;
+    int *batch_vals;
+    ReturnStatus *batch_statuses;
+    int entry, i, count = 0;
+
+    attrs = nvalloc(attributeTableLen * sizeof(*attrs));
+    entries = nvalloc(attributeTableLen * sizeof(*entries));
+
+    for (entry = 0; entry < attributeTableLen; entry++) {
+        const AttributeTableEntry *a = &attributeTable[entry];
+
+        prefetched[entry] = NV_FALSE;
+
+        if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER ||
+            a->flags.no_query_all) {
+            continue;
+        }
+
+        attrs[count] = a->attr;
+        entries[count] = entry;
+        count++;
+    }
+
+    batch_vals = nvalloc(count * sizeof(*batch_vals));
+    batch_statuses = nvalloc(count * sizeof(*batch_statuses));
+
+    if (count > 0 &&
+        NvCtrlGetDisplayAttributes(t, mask, count, attrs, batch_vals,
+                                   batch_statuses) == NvCtrlSuccess) {
+        for (i = 0; i < count; i++) {
+            entry = entries[i];
+            vals[entry] = batch_vals[i];
+            statuses[entry] = batch_statuses[i];
+            prefetched[entry] = NV_TRUE;
+        }
+    }
+
+    nvfree(batch_statuses);
+    nvfree(batch_vals);
+    nvfree(entries);
+    nvfree(attrs);
+
+} /* prefetch_integer_attributes() */
+
+
+
+/*
+ * create_json_writer() - returns a writer for the machine readable
+ * output selected with --output, or NULL for the text output.
+ */
+
+static JsonWriter *create_json_writer(const Options *op)
+{
+    switch (op->output_format) {
+    case OUTPUT_FORMAT_JSON:
+        return nv_json_writer_create(stdout, NV_FALSE);
+    case OUTPUT_FORMAT_NDJSON:
+        return nv_json_writer_create(stdout, NV_TRUE);
+    default:
+        return NULL;
+    }
+}
+
+
+
+/*
+ * json_add_target() - add the members identifying the given target to
+ * the current record.
+ */
+
+static void json_add_target(JsonWriter *w, const CtrlTarget *t)
+{
+    const CtrlTargetTypeInfo *targetTypeInfo =
+        NvCtrlGetTargetTypeInfo(NvCtrlGetTargetType(t));
+
+    nv_json_add_string(w, "target", t->name);
+    nv_json_add_string(w, "target_type", targetTypeInfo->parsed_name);
+    nv_json_add_int(w, "target_id", NvCtrlGetTargetId(t));
+}
+
+
+
+/*
+ * json_add_valid_values() - the JSON counterpart of print_valid_values():
+ * add the valid values and permissions of the given attribute to the
+ * current record.  Packed values are given as queried; "packed" tells
+ * that the upper and lower 16 bits hold separate values.
+ */
+
+static void json_add_valid_values(JsonWriter *w, const AttributeTableEntry *a,
+                                  const CtrlAttributeValidValues *valid)
+{
+    static const char *validTypeNames[] = {
+        [CTRL_ATTRIBUTE_VALID_TYPE_UNKNOWN]          = "unknown",
+        [CTRL_ATTRIBUTE_VALID_TYPE_INTEGER]          = "integer",
+        [CTRL_ATTRIBUTE_VALID_TYPE_BITMASK]          = "bitmask",
+        [CTRL_ATTRIBUTE_VALID_TYPE_BOOL]             = "bool",
+        [CTRL_ATTRIBUTE_VALID_TYPE_RANGE]            = "range",
+        [CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS]         = "int_bits",
+        [CTRL_ATTRIBUTE_VALID_TYPE_64BIT_INTEGER]    = "64bit_integer",
+        [CTRL_ATTRIBUTE_VALID_TYPE_STRING]           = "string",
+        [CTRL_ATTRIBUTE_VALID_TYPE_BINARY_DATA]      = "binary_data",
+        [CTRL_ATTRIBUTE_VALID_TYPE_STRING_OPERATION] = "string_operation",
+    };
+    int i;
+
+    nv_json_begin_object(w, "valid_values");
+
+    if (valid->valid_type < ARRAY_LEN(validTypeNames) &&
+        validTypeNames[valid->valid_type]) {
+        nv_json_add_string(w, "type", validTypeNames[valid->valid_type]);
+    } else {
+        nv_json_add_string(w, "type", "unknown");
+    }
+
+    if (valid->valid_type == CTRL_ATTRIBUTE_VALID_TYPE_RANGE) {
+        nv_json_add_int(w, "min", valid->range.min);
+        nv_json_add_int(w, "max", valid->range.max);
+    } else if (valid->valid_type == CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS) {
+        nv_json_begin_array(w, "values");
+        for (i = 0; i < 32; i++) {
+            if (valid->allowed_ints & (1U << i)) {
+                nv_json_add_int(w, NULL, i);
+            }
+        }
+        nv_json_end_array(w);
+    }
+
+    nv_json_add_bool(w, "packed", (a->type == CTRL_ATTRIBUTE_TYPE_INTEGER) &&
+                                  a->f.int_flags.is_packed);
+
+    nv_json_end_object(w);
+
+    nv_json_begin_object(w, "permissions");
+
+    nv_json_add_bool(w, "read", valid->permissions.read);
+    nv_json_add_bool(w, "write", valid->permissions.write);
+    nv_json_add_bool(w, "display_specific",
+                     !!(valid->permissions.valid_targets &
+                        CTRL_TARGET_PERM_BIT(DISPLAY_TARGET)));
+
+    nv_json_begin_array(w, "target_types");
+    for (i = 0; i < MAX_TARGET_TYPES; i++) {
+        const CtrlTargetTypeInfo *targetTypeInfo =
+            NvCtrlGetTargetTypeInfo(i);
+
+        if (valid->permissions.valid_targets &
+            targetTypeInfo->permission_bit) {
+            nv_json_add_string(w, NULL, targetTypeInfo->parsed_name);
+        }
+    }
+    nv_json_end_array(w);
+
+    nv_json_end_object(w);
+}
+
+
+
+/*
+ * write_json_attribute() - write the record for one attribute queried by
+ * query_all() or by a single query: 'str' holds the value of string
+ * attributes, 'val' that of integer attributes.
+ */
+
+static void write_json_attribute(JsonWriter *w, CtrlTarget *t,
+                                 const AttributeTableEntry *a,
+                                 const CtrlAttributeValidValues *valid,
+                                 uint32 mask, const char *str, int val)
+{
+    nv_json_begin_record(w);
+
+    json_add_target(w, t);
+    nv_json_add_string(w, "attribute", a->name);
+
+    if (a->type == CTRL_ATTRIBUTE_TYPE_STRING) {
+        nv_json_add_string(w, "value", str);
+    } else {
+        nv_json_add_int(w, "value", val);
+    }
 
-    // add more here
+    if ((NvCtrlGetTargetType(t) != DISPLAY_TARGET) &&
+        (valid->permissions.valid_targets &
+         CTRL_TARGET_PERM_BIT(DISPLAY_TARGET))) {
+        char *d_str = display_device_mask_to_display_device_name(mask);
 
+        nv_json_add_string(w, "display_device", d_str);
+        free(d_str);
     }
 
+    json_add_valid_values(w, a, valid);
+
+    nv_json_end_record(w);
 }
 
 
@@ -1364,7 +2127,8 @@ static void print_additional_info(const char *name,
  * query_all() - loop through all target types, and query all attributes
  * for those targets.  The current attribute values for all display
  * devices on all targets are printed, along with the valid values for
- * each attribute.
+ * each attribute.  With --output=json|ndjson, one JSON record is written
+ * per target and attribute instead, as soon as it is queried.
  *
  * If an error occurs, an error message is printed and NV_FALSE is
  * returned; if successful, NV_TRUE is returned.
@@ -1374,16 +2138,26 @@ static int query_all(const Options *op, const char *display_name,
                      CtrlSystemList *systems)
 {
     int bit, entry, val, target_type;
-    uint32 mask;
+    uint32 mask, prefetch_mask;
     ReturnStatus status;
     CtrlAttributeValidValues valid;
     CtrlSystem *system;
+    int *prefetch_vals, *prefetched;
+    ReturnStatus *prefetch_statuses;
+    JsonWriter *json;
 
     system = NvCtrlConnectToSystem(display_name, systems);
     if (!system) {
         return NV_FALSE;
     }
 
+    json = json_output;
+
+    prefetch_vals = nvalloc(attributeTableLen * sizeof(*prefetch_vals));
+    prefetch_statuses =
+        nvalloc(attributeTableLen * sizeof(*prefetch_statuses));
+    prefetched = nvalloc(attributeTableLen * sizeof(*prefetched));
+
 #define INDENT "  "
 
     /*
@@ -1401,12 +2175,28 @@ static int query_all(const Options *op, const char *display_name,
 
             if (!t->h) continue;
 
-            nv_msg(NULL, "Attributes queryable via %s:", t->name);
+            if (!json) {
+                nv_msg(NULL, "Attributes queryable via %s:", t->name);
+
+                if (!op->terse) {
+                    nv_msg(NULL, "");
+                }
+            }
+
+            /*
+             * Fetch the values of all integer attributes for the first
+             * display device bit visited below in one round trip, rather
+             * than one round trip per attribute.
+             */
 
-            if (!op->terse) {
-                nv_msg(NULL, "");
+            prefetch_mask = 1;
+            if (targetTypeInfo->uses_display_devices && t->d) {
+                prefetch_mask = t->d & ~(t->d - 1);
             }
 
+            prefetch_integer_attributes(t, prefetch_mask, prefetch_vals,
+                                        prefetch_statuses, prefetched);
+
             for (entry = 0; entry < attributeTableLen; entry++) {
                 const AttributeTableEntry *a = &attributeTable[entry];
 
@@ -1470,7 +2260,10 @@ static int query_all(const Options *op, const char *display_name,
                             goto exit_bit_loop;
                         }
 
-                        if (op->terse) {
+                        if (json) {
+                            write_json_attribute(json, t, a, &valid, mask,
+                                                 tmp_str, 0);
+                        } else if (op->terse) {
                             nv_msg("  ", "%s: %s", a->name, tmp_str);
                         } else {
                             nv_msg("  ",  "Attribute '%s' (%s%s): %s ",
@@ -1480,6 +2273,20 @@ static int query_all(const Options *op, const char *display_name,
                         tmp_str = NULL;
 
                     } else {
+                        int use_prefetch = (mask == prefetch_mask) &&
+                                           prefetched[entry];
+
+                        /*
+                         * If the batched query already told us this
+                         * attribute is not available, don't bother asking
+                         * for its valid values.
+                         */
+
+                        if (use_prefetch &&
+                            prefetch_statuses[entry] ==
+                            NvCtrlAttributeNotAvailable) {
+                            goto exit_bit_loop;
+                        }
 
                         status = NvCtrlGetValidDisplayAttributeValues(t,
                                                                       mask,
@@ -1498,8 +2305,13 @@ static int query_all(const Options *op, const char *display_name,
                             goto exit_bit_loop;
                         }
 
-                        status = NvCtrlGetDisplayAttribute(t, mask, a->attr,
-                                                           &val);
+                        if (use_prefetch) {
+                            status = prefetch_statuses[entry];
+                            val = prefetch_vals[entry];
+                        } else {
+                            status = NvCtrlGetDisplayAttribute(t, mask,
+                                                               a->attr, &val);
+                        }
 
                         if (status == NvCtrlAttributeNotAvailable) {
                             goto exit_bit_loop;
@@ -1512,16 +2324,24 @@ static int query_all(const Options *op, const char *display_name,
                             goto exit_bit_loop;
                         }
 
-                        print_queried_value(op, t, &valid, val, a, mask,
-                                            INDENT, op->terse ?
-                                            VerboseLevelAbbreviated :
-                                            VerboseLevelVerbose);
+                        if (json) {
+                            write_json_attribute(json, t, a, &valid, mask,
+                                                 NULL, val);
+                        } else {
+                            print_queried_value(op, t, &valid, val, a, mask,
+                                                INDENT, op->terse ?
+                                                VerboseLevelAbbreviated :
+                                                VerboseLevelVerbose);
+                        }
 
                     }
-                    print_valid_values(op, a, valid);
 
-                    if (!op->terse) {
-                        nv_msg(NULL,"");
+                    if (!json) {
+                        print_valid_values(op, a, valid);
+
+                        if (!op->terse) {
+                            nv_msg(NULL,"");
+                        }
                     }
 
                     if ((valid.permissions.valid_targets &
@@ -1540,12 +2360,20 @@ exit_bit_loop:
 
             } /* entry */
 
+            if (json) {
+                nv_json_writer_flush(json);
+            }
+
         } /* j (targets) */
 
     } /* target_type */
 
 #undef INDENT
 
+    nvfree(prefetched);
+    nvfree(prefetch_statuses);
+    nvfree(prefetch_vals);
+
     return NV_TRUE;
 
 } /* query_all() */
@@ -1629,12 +2457,7 @@ static int print_target_connections(CtrlTarget *t,
 
     /* Count how many 'other_target_type' targets are related to 't' */
 
-    count = 0;
-    for (node = t->relations; node; node = node->next) {
-        if (NvCtrlGetTargetType(node->t) == other_target_type) {
-            count++;
-        }
-    }
+    count = NvCtrlGetRelatedTargetCount(t, other_target_type);
 
 
     if (count == 0) {
@@ -1733,13 +2556,56 @@ static int print_target_connections(CtrlTarget *t,
 
 
 
+/*
+ * write_json_target() - write the record for one target listed by
+ * query_all_targets().
+ */
+
+static void write_json_target(JsonWriter *w, CtrlTarget *t, int idx,
+                              const char *product_name, const char *state)
+{
+    CtrlTargetNode *node;
+    int i;
+
+    nv_json_begin_record(w);
+
+    json_add_target(w, t);
+    nv_json_add_int(w, "index", idx);
+    nv_json_add_string(w, "product_name", product_name);
+
+    if (state) {
+        nv_json_add_string(w, "state", state);
+    }
+
+    nv_json_begin_array(w, "names");
+    for (i = 0; i < NV_PROTO_NAME_MAX; i++) {
+        if (t->protoNames[i]) {
+            nv_json_add_string(w, NULL, t->protoNames[i]);
+        }
+    }
+    nv_json_end_array(w);
+
+    nv_json_begin_array(w, "related");
+    for (node = t->relations; node; node = node->next) {
+        if (node->t && node->t->name) {
+            nv_json_add_string(w, NULL, node->t->name);
+        }
+    }
+    nv_json_end_array(w);
+
+    nv_json_end_record(w);
+}
+
+
+
 /*
  * query_all_targets() - print a list of all the targets (of the
- * specified type) accessible via the Display connection.
+ * specified type) accessible via the Display connection.  With
+ * --output=json|ndjson, one JSON record is written per target instead.
  */
 
-static int query_all_targets(const char *display_name, const int target_type,
-                             CtrlSystemList *systems)
+static int query_all_targets(const Options *op, const char *display_name,
+                             const int target_type, CtrlSystemList *systems)
 {
     CtrlSystem *system;
     CtrlTargetNode *node;
@@ -1748,6 +2614,7 @@ static int query_all_targets(const char *display_name, const int target_type,
     const CtrlTargetTypeInfo *targetTypeInfo;
     int target_count;
     int idx;
+    JsonWriter *json;
 
     targetTypeInfo = NvCtrlGetTargetTypeInfo(target_type);
 
@@ -1770,15 +2637,19 @@ static int query_all_targets(const char *display_name, const int target_type,
         return NV_FALSE;
     }
 
+    json = json_output;
+
     /* print how many of the target type we have */
 
-    target_count = NvCtrlGetTargetTypeCount(system, target_type);
-    nv_msg(NULL, "%d %s%s on %s",
-           target_count,
-           targetTypeInfo->name,
-           (target_count > 1) ? "s" : "",
-           str);
-    nv_msg(NULL, "");
+    if (!json) {
+        target_count = NvCtrlGetTargetTypeCount(system, target_type);
+        nv_msg(NULL, "%d %s%s on %s",
+               target_count,
+               targetTypeInfo->name,
+               (target_count > 1) ? "s" : "",
+               str);
+        nv_msg(NULL, "");
+    }
 
     free(str);
 
@@ -1831,6 +2702,18 @@ static int query_all_targets(const char *display_name, const int target_type,
             name = "Not NVIDIA";
         }
 
+        if (json) {
+            write_json_target(json, t, idx, product_name, extra_str);
+
+            if (product_name != buff) {
+                free(product_name);
+            }
+            if (extra_str) {
+                nvfree(extra_str);
+            }
+            continue;
+        }
+
         nv_msg("    ", "[%d] %s (%s)%s%s%s",
                idx,
                name,
@@ -1949,12 +2832,427 @@ static int query_all_targets(const char *display_name, const int target_type,
         }
     }
 
+    if (json) {
+        nv_json_writer_flush(json);
+    }
+
     return NV_TRUE;
 
 } /* query_all_targets() */
 
 
 
+/*
+ * nv_assignment_batch_begin() - start deferring integer assignments.
+ * Instead of being sent right away, each integer assignment that
+ * batch_can_queue() accepts is queued until nv_assignment_batch_end();
+ * any other assignment sends the queued ones before it is made.
+ *
+ * If atomic is TRUE, the batch is a transaction: any other kind of
+ * assignment is rejected, and if any assignment is rejected or fails,
+ * the batch leaves every attribute with the value it had before.
+ */
+
+void nv_assignment_batch_begin(int atomic)
+{
+    assignment_batch.active = NV_TRUE;
+    assignment_batch.atomic = atomic;
+    assignment_batch.failed = NV_FALSE;
+    assignment_batch.num_items = 0;
+
+} /* nv_assignment_batch_begin() */
+
+
+
+/*
+ * batch_can_queue() - returns whether assignments to the given attribute
+ * can be queued: plain integer attributes whose assignment is not checked
+ * against the state of other attributes, as the frame lock and SDI
+ * attributes are by nv_process_parsed_attribute().
+ */
+
+static int batch_can_queue(const AttributeTableEntry *a)
+{
+    return (a->type == CTRL_ATTRIBUTE_TYPE_INTEGER) &&
+           !a->flags.hijack_display_device &&
+           !a->flags.is_framelock_attribute &&
+           !a->flags.is_sdi_attribute;
+
+} /* batch_can_queue() */
+
+
+
+static void queue_batched_assignment(CtrlTarget *t, const ParsedAttribute *p,
+                                     int verbose, const char *whence)
+{
+    BatchedAssignment *b;
+
+    if (assignment_batch.num_items == assignment_batch.max_items) {
+        assignment_batch.max_items =
+            NV_MAX(16, assignment_batch.max_items * 2);
+        assignment_batch.items =
+            nvrealloc(assignment_batch.items,
+                      assignment_batch.max_items * sizeof(BatchedAssignment));
+    }
+
+    b = &assignment_batch.items[assignment_batch.num_items++];
+    b->t = t;
+    b->a = p->attr_entry;
+    b->val = p->val.i;
+    b->verbose = verbose;
+    b->whence = nvstrdup(whence);
+    b->str[0] = '\0';
+
+} /* queue_batched_assignment() */
+
+
+
+static void print_assigned_value(const BatchedAssignment *b)
+{
+    if (!b->verbose) {
+        return;
+    }
+
+    if (b->a->f.int_flags.is_packed) {
+        nv_msg("  ", "Attribute '%s' (%s%s) assigned value %d,%d.",
+               b->a->name, b->t->name, b->str,
+               b->val >> 16, b->val & 0xffff);
+    } else {
+        nv_msg("  ", "Attribute '%s' (%s%s) assigned value %d.",
+               b->a->name, b->t->name, b->str, b->val);
+    }
+
+} /* print_assigned_value() */
+
+
+
+/*
+ * rollback_batched_assignments() - restore the attributes that the
+ * successful sets of a failed atomic batch changed to the values read
+ * before the batch was sent, undoing the latest changes first.
+ */
+
+static void rollback_batched_assignments(const BatchedAssignment *items,
+                                         const CtrlAttributeQuery *queries,
+                                         const CtrlAttributeAssignment *sets,
+                                         const int *set_idx, int num_sets)
+{
+    CtrlAttributeAssignment *restores;
+    int *restore_idx;
+    int i, j, num_restores = 0, num_failed = 0;
+
+    restores = nvalloc(num_sets * sizeof(*restores));
+    restore_idx = nvalloc(num_sets * sizeof(*restore_idx));
+
+    for (j = num_sets - 1; j >= 0; j--) {
+        if (sets[j].status != NvCtrlSuccess) {
+            continue;
+        }
+
+        /* Only restore each attribute once */
+
+        for (i = 0; i < num_restores; i++) {
+            if ((restores[i].target == sets[j].target) &&
+                (restores[i].attr == sets[j].attr)) {
+                break;
+            }
+        }
+        if (i < num_restores) {
+            continue;
+        }
+
+        restores[num_restores] = sets[j];
+        restores[num_restores].val = queries[set_idx[j]].val;
+        restore_idx[num_restores] = set_idx[j];
+        num_restores++;
+    }
+
+    NvCtrlSetAttributes(restores, num_restores);
+
+    for (i = 0; i < num_restores; i++) {
+        const BatchedAssignment *b = &items[restore_idx[i]];
+
+        if (restores[i].status != NvCtrlSuccess) {
+            nv_error_msg("Error restoring attribute '%s' (%s%s) to its "
+                         "previous value %d (%s).",
+                         b->a->name, b->t->name, b->str, restores[i].val,
+                         NvCtrlAttributesStrError(restores[i].status));
+            num_failed++;
+        }
+    }
+
+    if (num_restores > num_failed) {
+        nv_warning_msg("Restored %d attribute%s to %s previous value%s.",
+                       num_restores - num_failed,
+                       (num_restores - num_failed) == 1 ? "" : "s",
+                       (num_restores - num_failed) == 1 ? "its" : "their",
+                       (num_restores - num_failed) == 1 ? "" : "s");
+    }
+
+    nvfree(restore_idx);
+    nvfree(restores);
+
+} /* rollback_batched_assignments() */
+
+
+
+/*
+ * batched_sets_affect() - returns whether any of the given sets is made
+ * to the attribute 'attr' of the target 't', or of a target related to
+ * it, and so may change the value or the valid values of 'attr' on 't'.
+ */
+
+static int batched_sets_affect(const CtrlAttributeAssignment *sets, int num,
+                               const CtrlTarget *t, int attr)
+{
+    int j;
+
+    for (j = 0; j < num; j++) {
+        if ((sets[j].attr == attr) &&
+            ((sets[j].target == t) ||
+             NvCtrlTargetIsRelated(sets[j].target, NvCtrlGetTargetType(t),
+                                   NvCtrlGetTargetId(t)))) {
+            return NV_TRUE;
+        }
+    }
+
+    return NV_FALSE;
+
+} /* batched_sets_affect() */
+
+
+
+/*
+ * send_batched_sets() - send the given sets in one burst, and report any
+ * failure against the whence string of the assignment that caused it.
+ * Returns NV_TRUE if all of the sets were made.
+ */
+
+static int send_batched_sets(const BatchedAssignment *items,
+                             CtrlAttributeAssignment *sets,
+                             const int *set_idx, int num, int atomic)
+{
+    int j, ret = NV_TRUE;
+
+    NvCtrlSetAttributes(sets, num);
+
+    for (j = 0; j < num; j++) {
+        const BatchedAssignment *b = &items[set_idx[j]];
+
+        if (sets[j].status != NvCtrlSuccess) {
+            nv_error_msg("Error assigning value %d to attribute '%s' "
+                         "(%s%s) as specified %s (%s).",
+                         b->val, b->a->name, b->t->name, b->str, b->whence,
+                         NvCtrlAttributesStrError(sets[j].status));
+            ret = NV_FALSE;
+            continue;
+        }
+
+        if (!atomic) {
+            print_assigned_value(b);
+        }
+    }
+
+    return ret;
+
+} /* send_batched_sets() */
+
+
+
+/*
+ * nv_assignment_batch_end() - process the queued assignments and stop
+ * deferring.  The current values and the valid values of all of the
+ * queued attributes are read in one pipelined pass; each assignment is
+ * then validated as nv_process_parsed_attribute() would have, in order,
+ * and dropped if the attribute already has the requested value.  The
+ * remaining assignments are sent as a burst, and any error is reported
+ * against the whence string of the assignment that caused it.
+ *
+ * Before an assignment to an attribute that the unsent assignments of the
+ * burst change (on the same target or on a related one), those are sent,
+ * and the assignment is validated against the values and valid values
+ * read back afterwards; in the common case, where few assignments
+ * change anything, the whole batch still takes a single pass.
+ *
+ * For an atomic batch, nothing more is sent once any assignment was
+ * rejected, either here or by nv_process_parsed_attribute(), or if the
+ * current value of an attribute cannot be read; if any set fails, or an
+ * assignment is rejected after some were sent, the sets that were made
+ * are rolled back.
+ *
+ * Returns NV_TRUE if all of the assignments were made; else, returns
+ * NV_FALSE.
+ */
+
+int nv_assignment_batch_end(const Options *op)
+{
+    BatchedAssignment *items = assignment_batch.items;
+    int n = assignment_batch.num_items;
+    int atomic = assignment_batch.atomic;
+    int failed = assignment_batch.failed;
+    CtrlAttributeQuery *queries;
+    CtrlAttributeAssignment *sets;
+    int *set_idx;
+    int i, j, num_sets = 0, num_sent = 0;
+
+    assignment_batch.active = NV_FALSE;
+    assignment_batch.num_items = 0;
+
+    if (n == 0) {
+        return !failed;
+    }
+
+    queries = nvalloc(n * sizeof(*queries));
+    sets = nvalloc(n * sizeof(*sets));
+    set_idx = nvalloc(n * sizeof(*set_idx));
+
+    if (atomic && failed) {
+        goto done;
+    }
+
+    for (i = 0; i < n; i++) {
+        queries[i].target = items[i].t;
+        queries[i].type = CTRL_ATTRIBUTE_TYPE_INTEGER;
+        queries[i].attr = items[i].a->attr;
+    }
+
+    NvCtrlPrefetchValidAttributeValues(queries, n);
+    NvCtrlQueryAttributes(queries, n);
+
+    for (i = 0; i < n; i++) {
+        BatchedAssignment *b = &items[i];
+        const AttributeTableEntry *a = b->a;
+        CtrlAttributeValidValues valid;
+        ParsedAttribute p;
+        ReturnStatus status;
+        int target_type = NvCtrlGetTargetType(b->t);
+        int reread = NV_FALSE;
+        int current = queries[i].val;
+
+        /* Make the earlier assignments this one may depend on */
+
+        if (!(atomic && failed) &&
+            batched_sets_affect(sets + num_sent, num_sets - num_sent, b->t,
+                               a->attr)) {
+            if (!send_batched_sets(items, sets + num_sent, set_idx + num_sent,
+                                   num_sets - num_sent, atomic)) {
+                failed = NV_TRUE;
+            }
+            num_sent = num_sets;
+            reread = NV_TRUE;
+        }
+
+        status = NvCtrlGetValidDisplayAttributeValues(b->t, 0, a->attr,
+                                                      &valid);
+        if (status != NvCtrlSuccess) {
+            if (status == NvCtrlAttributeNotAvailable) {
+                nv_warning_msg("Attribute '%s' specified %s is not "
+                               "available on %s.",
+                               a->name, b->whence, b->t->name);
+            } else {
+                nv_error_msg("Error querying valid values for attribute "
+                             "'%s' on %s specified %s (%s).",
+                             a->name, b->t->name, b->whence,
+                             NvCtrlAttributesStrError(status));
+            }
+            failed = NV_TRUE;
+            continue;
+        }
+
+        if (!valid.permissions.write) {
+            nv_error_msg("The attribute '%s' specified %s cannot be "
+                         "assigned (it is a read-only attribute).",
+                         a->name, b->whence);
+            failed = NV_TRUE;
+            continue;
+        }
+
+        if ((target_type != DISPLAY_TARGET) &&
+            (valid.permissions.valid_targets &
+             CTRL_TARGET_PERM_BIT(DISPLAY_TARGET))) {
+            char *tmp_d_str = display_device_mask_to_display_device_name(0);
+            sprintf(b->str, ", display device: %s", tmp_d_str);
+            free(tmp_d_str);
+        }
+
+        memset(&p, 0, sizeof(p));
+        p.attr_entry = a;
+        p.val.i = b->val;
+
+        if (!validate_value(op, b->t, &p, 0, target_type, b->whence)) {
+            failed = NV_TRUE;
+            continue;
+        }
+
+        /* The value this attribute has once the earlier sets are made */
+
+        status = queries[i].status;
+        if (reread && (status == NvCtrlSuccess)) {
+            status = NvCtrlGetAttribute(b->t, a->attr, &current);
+        }
+
+        if (!valid.permissions.read || (status != NvCtrlSuccess)) {
+            if (atomic) {
+                nv_error_msg("The attribute '%s' specified %s cannot be "
+                             "assigned atomically (its current value on %s "
+                             "cannot be read).",
+                             a->name, b->whence, b->t->name);
+                failed = NV_TRUE;
+                continue;
+            }
+        } else if (current == b->val) {
+            print_assigned_value(b);
+            continue;
+        }
+
+        sets[num_sets].target = b->t;
+        sets[num_sets].display_mask = 0;
+        sets[num_sets].attr = a->attr;
+        sets[num_sets].val = b->val;
+        set_idx[num_sets] = i;
+        num_sets++;
+    }
+
+    if (!(atomic && failed)) {
+        if (!send_batched_sets(items, sets + num_sent, set_idx + num_sent,
+                               num_sets - num_sent, atomic)) {
+            failed = NV_TRUE;
+        }
+        num_sent = num_sets;
+    }
+
+    if (atomic) {
+        if (failed) {
+            if (num_sent > 0) {
+                rollback_batched_assignments(items, queries, sets, set_idx,
+                                             num_sent);
+            }
+        } else {
+            for (j = 0; j < num_sets; j++) {
+                print_assigned_value(&items[set_idx[j]]);
+            }
+        }
+    }
+
+ done:
+    if (atomic && failed && (num_sent == 0)) {
+        nv_error_msg("No assignments were made.");
+    }
+
+    for (i = 0; i < n; i++) {
+        nvfree(items[i].whence);
+    }
+
+    nvfree(set_idx);
+    nvfree(sets);
+    nvfree(queries);
+
+    return !failed;
+
+} /* nv_assignment_batch_end() */
+
+
+
 /*
  * process_parsed_attribute_internal() - this function does the actual
  * attribute processing for nv_process_parsed_attribute().
@@ -2037,7 +3335,10 @@ static int process_parsed_attribute_internal(const Options *op,
                 return NV_FALSE;
             } else {
 
-                if (op->terse) {
+                if (json_output) {
+                    write_json_attribute(json_output, t, a, &valid, d,
+                                         tmp_str, 0);
+                } else if (op->terse) {
                     nv_msg(NULL, "%s", tmp_str);
                 } else {
                     nv_msg("  ",  "Attribute '%s' (%s%s): %s",
@@ -2060,6 +3361,9 @@ static int process_parsed_attribute_internal(const Options *op,
                              a->name, t->name, str, whence,
                              NvCtrlAttributesStrError(status));
                 return NV_FALSE;
+            } else if (json_output) {
+                write_json_attribute(json_output, t, a, &valid, d, NULL,
+                                     p->val.i);
             } else {
                 print_queried_value(op, t, &valid, p->val.i, a, d,
                                     "  ", op->terse ?
@@ -2132,6 +3436,7 @@ int nv_process_parsed_attribute(const Options *op,
     CtrlAttributeValidValues valid;
     const AttributeTableEntry *a = p->attr_entry;
     int display_id_found = NV_FALSE;
+    int num_checked = 0, num_queued = 0;
 
 
     val = NV_FALSE;
@@ -2177,6 +3482,24 @@ int nv_process_parsed_attribute(const Options *op,
                           *str ? str : "");
         goto done;
     }
+
+    /*
+     * An assignment that the open batch cannot hold is made right away:
+     * an atomic batch can only undo such an assignment, so it is
+     * rejected; otherwise, the batch is sent first, so that assignments
+     * are made in order, and the checks below see the state that the
+     * earlier assignments leave behind.
+     */
+    if (assign && assignment_batch.active && !batch_can_queue(a)) {
+        if (assignment_batch.atomic) {
+            nv_error_msg("The attribute '%s' specified %s cannot be "
+                         "assigned atomically.", a->name, whence);
+            goto done;
+        }
+        nv_assignment_batch_end(op);
+        nv_assignment_batch_begin(NV_FALSE);
+    }
+
     /* Resolve any target specifications against the CtrlSystem that was
      * allocated.
      */
@@ -2231,6 +3554,8 @@ int nv_process_parsed_attribute(const Options *op,
             continue;
         }
 
+        num_checked++;
+
 
         /* special case the color attributes */
 
@@ -2652,6 +3977,14 @@ int nv_process_parsed_attribute(const Options *op,
             mask = 0;
         }
 
+        /* Leave the validation and the assignment to the open batch */
+
+        if (assign && assignment_batch.active) {
+            queue_batched_assignment(t, p, verbose, whence);
+            num_queued++;
+            continue;
+        }
+
         if (a->type == CTRL_ATTRIBUTE_TYPE_STRING) {
             status = NvCtrlGetValidStringDisplayAttributeValues(t,
                                                                 mask,
@@ -2698,6 +4031,16 @@ int nv_process_parsed_attribute(const Options *op,
         }
     } /* done looping over requested targets */
 
+    /*
+     * In an atomic batch, an assignment that was rejected for any of the
+     * targets fails the whole batch
+     */
+
+    if (assign && assignment_batch.atomic && assignment_batch.active &&
+        (num_queued < num_checked)) {
+        assignment_batch.failed = NV_TRUE;
+    }
+
     val = NV_TRUE;
 
  done:
@@ -38,6 +38,9 @@ int nv_process_parsed_attribute(const Options *op,
                                 ParsedAttribute*, CtrlSystem *system,
                                 int, int, char*, ...) NV_ATTRIBUTE_PRINTF(6, 7);
 
+void nv_assignment_batch_begin(int atomic);
+int  nv_assignment_batch_end(const Options *op);
+
 
 
 #endif /* __QUERY_ASSIGN_H__ */
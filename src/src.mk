@@ -21,6 +21,10 @@ SRC_SRC += parse.c
 SRC_SRC += query-assign.c
 SRC_SRC += app-profiles.c
 SRC_SRC += glxinfo.c
+SRC_SRC += monitor.c
+SRC_SRC += monitor-log.c
+SRC_SRC += profile.c
+SRC_SRC += json-writer.c
 
 NVIDIA_SETTINGS_SRC += $(SRC_SRC)
 
@@ -33,6 +37,10 @@ SRC_EXTRA_DIST += parse.h
 SRC_EXTRA_DIST += query-assign.h
 SRC_EXTRA_DIST += app-profiles.h
 SRC_EXTRA_DIST += glxinfo.h
+SRC_EXTRA_DIST += monitor.h
+SRC_EXTRA_DIST += monitor-log.h
+SRC_EXTRA_DIST += profile.h
+SRC_EXTRA_DIST += json-writer.h
 SRC_EXTRA_DIST += gen-manpage-opts.c
 
 NVIDIA_SETTINGS_EXTRA_DIST += $(SRC_EXTRA_DIST)
@@ -97,6 +105,7 @@ LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesGlx.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesXrandr.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesUtils.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesNvml.c
+LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesTopology.c
 
 NVIDIA_SETTINGS_SRC += $(LIB_XNVCTRL_ATTRIBUTES_SRC)
 
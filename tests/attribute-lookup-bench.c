@@ -0,0 +1,261 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * attribute-lookup-bench.c - checks that the indexed attributeTable
+ * lookups in parse.c find the same entries as a linear scan of the
+ * table, then times both, and times nv_parse_attribute_string() over
+ * growing numbers of configuration file style assignments.
+ *
+ * usage: attribute-lookup-bench [-n max-assignments]
+ *
+ * Exits non-zero if an indexed lookup finds a different entry than the
+ * scan, if an assignment fails to parse, or if the indexed lookups are
+ * not faster than the scan.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "parse.h"
+
+#include "common-utils.h"
+
+
+#define LOOKUP_ROUNDS 200
+
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/* the lookups as they were done before attributeTable was indexed */
+
+static const AttributeTableEntry *scan_by_attr(int attr,
+                                               CtrlAttributeType type)
+{
+    int i;
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+        if ((a->attr == attr) && (a->type == type)) {
+            return a;
+        }
+    }
+
+    return NULL;
+}
+
+static const AttributeTableEntry *scan_by_name(const char *name)
+{
+    int i;
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+        if (nv_strcasecmp(name, a->name)) {
+            return a;
+        }
+    }
+
+    return NULL;
+}
+
+
+static int check_lookups(void)
+{
+    char name[256];
+    int i, j, failures = 0;
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+
+        if (nv_get_attribute_entry(a->attr, a->type) !=
+            scan_by_attr(a->attr, a->type)) {
+            fprintf(stderr, "Wrong entry for attribute %d of type %d.\n",
+                    a->attr, a->type);
+            failures++;
+        }
+
+        /* names are matched case-insensitively */
+
+        for (j = 0; a->name[j] && j < sizeof(name) - 1; j++) {
+            name[j] = (j & 1) ? tolower(a->name[j]) : toupper(a->name[j]);
+        }
+        name[j] = '\0';
+
+        if (nv_get_attribute_entry_by_name(name) != scan_by_name(name)) {
+            fprintf(stderr, "Wrong entry for attribute name '%s'.\n", name);
+            failures++;
+        }
+    }
+
+    if (nv_get_attribute_entry_by_name("NoSuchAttribute") ||
+        nv_get_attribute_entry_by_name("") ||
+        nv_get_attribute_entry(-1, CTRL_ATTRIBUTE_TYPE_INTEGER) ||
+        nv_get_attribute_entry(1 << 20, CTRL_ATTRIBUTE_TYPE_INTEGER)) {
+        fprintf(stderr, "Found an entry for an attribute that does not "
+                "exist.\n");
+        failures++;
+    }
+
+    return failures;
+}
+
+
+/*
+ * Returns whether the attribute can be assigned a plain integer; the
+ * packed, display mask and display id attributes take other values.
+ */
+
+static int is_plain_integer(const AttributeTableEntry *a)
+{
+    return (a->type == CTRL_ATTRIBUTE_TYPE_INTEGER) &&
+           !a->f.int_flags.is_packed &&
+           !a->f.int_flags.is_display_mask &&
+           !a->f.int_flags.is_display_id;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const AttributeTableEntry *volatile found;
+    const AttributeTableEntry **entries;
+    ParsedAttribute *parsed;
+    char **lines;
+    double scan_msec, index_msec, t;
+    int max_n = 16000, num_entries = 0, failures = 0;
+    int i, n, c, round;
+
+    while ((c = getopt(argc, argv, "n:")) != -1) {
+        switch (c) {
+        case 'n': max_n = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n max-assignments]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (max_n < 1000) {
+        fprintf(stderr, "Invalid assignment count.\n");
+        return 1;
+    }
+
+    failures += check_lookups();
+
+    /* the entries whose names the assignments use */
+
+    entries = nvalloc(attributeTableLen * sizeof(*entries));
+    for (i = 0; i < attributeTableLen; i++) {
+        if (is_plain_integer(&attributeTable[i])) {
+            entries[num_entries++] = &attributeTable[i];
+        }
+    }
+
+    /* look up every attribute name, by scanning and through the index */
+
+    t = now_msec();
+    for (round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (i = 0; i < attributeTableLen; i++) {
+            found = scan_by_name(attributeTable[i].name);
+            found = scan_by_attr(attributeTable[i].attr,
+                                 attributeTable[i].type);
+        }
+    }
+    scan_msec = now_msec() - t;
+
+    t = now_msec();
+    for (round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (i = 0; i < attributeTableLen; i++) {
+            found = nv_get_attribute_entry_by_name(attributeTable[i].name);
+            found = nv_get_attribute_entry(attributeTable[i].attr,
+                                           attributeTable[i].type);
+        }
+    }
+    index_msec = now_msec() - t;
+
+    (void) found;
+
+    printf("%d attributeTable entries, %d lookups by name and by "
+           "attribute\n\n", attributeTableLen,
+           LOOKUP_ROUNDS * attributeTableLen);
+    printf("%-20s %10s %14s\n", "", "msec", "nsec/lookup");
+    printf("%-20s %10.1f %14.1f\n", "table scan", scan_msec,
+           scan_msec * 1e6 / (2.0 * LOOKUP_ROUNDS * attributeTableLen));
+    printf("%-20s %10.1f %14.1f\n", "index", index_msec,
+           index_msec * 1e6 / (2.0 * LOOKUP_ROUNDS * attributeTableLen));
+
+    if (index_msec >= scan_msec) {
+        fprintf(stderr, "The indexed lookups are not faster than scanning "
+                "the table.\n");
+        failures++;
+    }
+
+    /* parse growing numbers of assignments, as read from a config file */
+
+    lines = nvalloc(max_n * sizeof(*lines));
+    parsed = nvalloc(max_n * sizeof(*parsed));
+
+    for (i = 0; i < max_n; i++) {
+        lines[i] = nvasprintf("[gpu:%d]/%s=%d", i % 4,
+                              entries[i % num_entries]->name, i);
+    }
+
+    printf("\n%-20s %10s %14s\n", "assignments", "msec", "usec/line");
+
+    for (n = 1000; n <= max_n; n *= 4) {
+        ParserArena *arena = nv_parser_arena_new();
+
+        memset(parsed, 0, n * sizeof(*parsed));
+
+        t = now_msec();
+        for (i = 0; i < n; i++) {
+            if (nv_parse_attribute_string(lines[i], NV_PARSER_ASSIGNMENT,
+                                          &parsed[i], arena) !=
+                NV_PARSER_STATUS_SUCCESS ||
+                parsed[i].attr_entry != entries[i % num_entries] ||
+                parsed[i].val.i != i) {
+                fprintf(stderr, "Wrong result parsing '%s'.\n", lines[i]);
+                failures++;
+            }
+        }
+        t = now_msec() - t;
+
+        printf("%-20d %10.1f %14.3f\n", n, t, t * 1000.0 / n);
+
+        nv_parser_arena_free(arena);
+    }
+
+    for (i = 0; i < max_n; i++) {
+        nvfree(lines[i]);
+    }
+    nvfree(lines);
+    nvfree(parsed);
+    nvfree(entries);
+
+    return failures ? 1 : 0;
+}
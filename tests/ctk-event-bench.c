@@ -0,0 +1,539 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * ctk-event-bench.c - times the dispatch of events to CtkEvents by
+ * ctkevent.c, and checks who they are delivered to.
+ *
+ * ctkevent.c is linked against the fake event handle below rather than
+ * the NvCtrlAttributes library: events are injected into its queue, and
+ * the glib main loop dispatches them through the CtkEventSource as it
+ * would events from the X server.
+ *
+ * For 16, 256 and 4096 targets of 4 target types, 4 CtkEvents are
+ * registered per target, and events are injected round robin over those
+ * targets and some targets without CtkEvents.  Each CtkEvent must receive
+ * the events of its own target, and only those.
+ *
+ * Then an event is injected for each target whose handler destroys every
+ * CtkEvent of the target, followed by more events for the same targets.
+ * Only the first CtkEvent to receive the event may see it; the events
+ * after it must not be delivered, and once the last CtkEvent is destroyed
+ * the event handle must be closed and not read again.
+ *
+ * usage: ctk-event-bench [-n events]
+ *
+ * Exits non-zero if any check fails, or if the time per event with the
+ * most targets is more than 4 times that with the fewest.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "ctkevent.h"
+#include "NvCtrlAttributes.h"
+
+
+#define NUM_EVENTS          200000
+#define RECEIVERS_PER_TARGET 4
+#define BATCH_SIZE          256
+
+/* the targets without CtkEvents; one in 5 events is for one of them */
+#define SILENT_FRACTION     4
+
+static const CtrlTargetType target_types[] = {
+    X_SCREEN_TARGET, GPU_TARGET, THERMAL_SENSOR_TARGET, DISPLAY_TARGET,
+};
+
+#define NUM_TARGET_TYPES (sizeof(target_types) / sizeof(target_types[0]))
+
+static const int targets_per_type[] = { 4, 64, 1024 };
+
+#define NUM_SIZES (sizeof(targets_per_type) / sizeof(targets_per_type[0]))
+
+
+/*
+ * A CtrlTarget, with the type and id returned for it by the fake
+ * NvCtrlGetTargetType() and NvCtrlGetTargetId().
+ */
+typedef struct {
+    CtrlTarget ctrl_target;     /* must be first */
+    CtrlTargetType target_type;
+    int target_id;
+    unsigned long expected;     /* events injected for this target */
+} BenchTarget;
+
+typedef struct _Receiver {
+    GObject *ctk_event;
+    BenchTarget *target;
+    struct _Receiver *first;    /* the first Receiver of the target */
+    unsigned long received;
+} Receiver;
+
+static int num_errors;
+
+
+
+/*
+ * The fake event handle: events are read from a queue filled by
+ * inject_event().  Its file descriptor is the read end of a pipe that
+ * nothing is written to, so the main loop only learns of the events
+ * through NvCtrlEventHandlePending().
+ */
+
+static struct {
+    CtrlEvent queue[BATCH_SIZE];
+    int head, tail;
+
+    int fds[2];
+    Bool open;
+    int num_opens, num_closes;
+    int reads_after_close;
+} handle;
+
+NvCtrlEventHandle *NvCtrlGetEventHandle(const CtrlTarget *ctrl_target)
+{
+    if (!handle.open) {
+        handle.open = True;
+        handle.num_opens++;
+    }
+    return &handle;
+}
+
+ReturnStatus NvCtrlCloseEventHandle(NvCtrlEventHandle *event_handle)
+{
+    if (event_handle != &handle || !handle.open) {
+        return NvCtrlBadHandle;
+    }
+    handle.open = False;
+    handle.num_closes++;
+    return NvCtrlSuccess;
+}
+
+ReturnStatus NvCtrlEventHandleGetFD(NvCtrlEventHandle *event_handle, int *fd)
+{
+    *fd = handle.fds[0];
+    return NvCtrlSuccess;
+}
+
+ReturnStatus NvCtrlEventHandlePending(NvCtrlEventHandle *event_handle,
+                                      Bool *pending)
+{
+    if (!handle.open) {
+        handle.reads_after_close++;
+        return NvCtrlBadHandle;
+    }
+    *pending = handle.head != handle.tail;
+    return NvCtrlSuccess;
+}
+
+ReturnStatus NvCtrlEventHandleNextEvent(NvCtrlEventHandle *event_handle,
+                                        CtrlEvent *event)
+{
+    if (!handle.open) {
+        handle.reads_after_close++;
+        return NvCtrlBadHandle;
+    }
+    if (handle.head == handle.tail) {
+        return NvCtrlError;
+    }
+    *event = handle.queue[handle.head++];
+    return NvCtrlSuccess;
+}
+
+int NvCtrlGetTargetType(const CtrlTarget *ctrl_target)
+{
+    return ((const BenchTarget *) ctrl_target)->target_type;
+}
+
+int NvCtrlGetTargetId(const CtrlTarget *ctrl_target)
+{
+    return ((const BenchTarget *) ctrl_target)->target_id;
+}
+
+/* used by ctk_event_subscription_poll(), which is not tested here */
+ReturnStatus NvCtrlGetAttribute(const CtrlTarget *ctrl_target,
+                                int attr, int *val)
+{
+    return NvCtrlNotSupported;
+}
+
+
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/* Dispatches the injected events, and empties the queue */
+
+static void run_main_loop(void)
+{
+    while (g_main_context_iteration(NULL, FALSE)) {
+    }
+    handle.head = handle.tail = 0;
+}
+
+
+static void inject_event(CtrlTargetType target_type, int target_id,
+                         int attribute, int value)
+{
+    CtrlEvent *event;
+
+    if (handle.tail == BATCH_SIZE) {
+        run_main_loop();
+    }
+
+    event = &handle.queue[handle.tail++];
+
+    memset(event, 0, sizeof(*event));
+    event->type = CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE;
+    event->target_type = target_type;
+    event->target_id = target_id;
+    event->int_attr.attribute = attribute;
+    event->int_attr.value = value;
+}
+
+
+
+static void count_event(GObject *object, CtrlEvent *event, gpointer user_data)
+{
+    Receiver *receiver = user_data;
+
+    if (event->target_type != receiver->target->target_type ||
+        event->target_id != receiver->target->target_id) {
+        num_errors++;
+    }
+    receiver->received++;
+}
+
+
+/*
+ * Destroys every CtkEvent of the event's target, starting with the other
+ * ones; the first of them to receive the event destroys them all.
+ */
+static void destroy_target(GObject *object, CtrlEvent *event,
+                           gpointer user_data)
+{
+    Receiver *receiver = user_data;
+    Receiver *first = receiver->first;
+    int i;
+
+    receiver->received++;
+
+    for (i = 0; i < RECEIVERS_PER_TARGET; i++) {
+        if (first[i].ctk_event && first[i].ctk_event != object) {
+            ctk_event_destroy(first[i].ctk_event);
+            first[i].ctk_event = NULL;
+        }
+    }
+
+    ctk_event_destroy(object);
+    receiver->ctk_event = NULL;
+}
+
+
+
+static BenchTarget *create_targets(int num_per_type)
+{
+    BenchTarget *targets = calloc(NUM_TARGET_TYPES * num_per_type,
+                                  sizeof(BenchTarget));
+    int i;
+
+    for (i = 0; targets && i < NUM_TARGET_TYPES * num_per_type; i++) {
+        targets[i].target_type = target_types[i % NUM_TARGET_TYPES];
+        targets[i].target_id = i / NUM_TARGET_TYPES;
+    }
+
+    return targets;
+}
+
+
+static Receiver *create_receivers(BenchTarget *targets, int num_targets,
+                                  const char *signal, GCallback callback)
+{
+    Receiver *receivers = calloc(num_targets * RECEIVERS_PER_TARGET,
+                                 sizeof(Receiver));
+    int i;
+
+    for (i = 0; receivers && i < num_targets * RECEIVERS_PER_TARGET; i++) {
+        Receiver *receiver = &receivers[i];
+
+        receiver->target = &targets[i / RECEIVERS_PER_TARGET];
+        receiver->first = &receivers[i - i % RECEIVERS_PER_TARGET];
+        receiver->ctk_event =
+            ctk_event_new(&receiver->target->ctrl_target);
+        g_signal_connect(G_OBJECT(receiver->ctk_event), signal, callback,
+                         receiver);
+    }
+
+    return receivers;
+}
+
+
+static void destroy_receivers(Receiver *receivers, int num_receivers)
+{
+    int i;
+
+    for (i = 0; i < num_receivers; i++) {
+        if (receivers[i].ctk_event) {
+            ctk_event_destroy(receivers[i].ctk_event);
+        }
+    }
+    free(receivers);
+}
+
+
+
+/*
+ * Injects num_events events round robin over the targets, and those
+ * after them without CtkEvents, and returns the time taken to dispatch
+ * them in milliseconds.
+ */
+
+static double time_dispatch(BenchTarget *targets, int num_per_type,
+                            int num_events)
+{
+    int num_silent = (num_per_type + SILENT_FRACTION - 1) / SILENT_FRACTION;
+    int num_targets = NUM_TARGET_TYPES * num_per_type;
+    int num_keys = num_targets + NUM_TARGET_TYPES * num_silent;
+    double t;
+    int i;
+
+    t = now_msec();
+
+    for (i = 0; i < num_events; i++) {
+        int key = i % num_keys;
+
+        if (key < num_targets) {
+            targets[key].expected++;
+        }
+        inject_event(target_types[key % NUM_TARGET_TYPES],
+                     key / NUM_TARGET_TYPES,
+                     NV_CTRL_DIGITAL_VIBRANCE, i);
+    }
+    run_main_loop();
+
+    return now_msec() - t;
+}
+
+
+static int check_receivers(const Receiver *receivers, int num_receivers)
+{
+    int i, failures = 0;
+
+    for (i = 0; i < num_receivers; i++) {
+        if (receivers[i].received != receivers[i].target->expected) {
+            failures++;
+        }
+    }
+
+    if (failures) {
+        fprintf(stderr, "%d of %d CtkEvents received the wrong number of "
+                "events.\n", failures, num_receivers);
+    }
+
+    return failures;
+}
+
+
+
+/*
+ * Injects an event for each target that destroys its CtkEvents, followed
+ * by one that must not be delivered, and checks that the event handle is
+ * closed with the last CtkEvent, and not read again.
+ */
+
+static int check_destroy_in_handler(int num_per_type)
+{
+    BenchTarget *targets = create_targets(num_per_type);
+    int num_targets = NUM_TARGET_TYPES * num_per_type;
+    int num_receivers = num_targets * RECEIVERS_PER_TARGET;
+    Receiver *receivers;
+    int i, failures = 0, opens = handle.num_opens;
+
+    if (!targets) {
+        return 1;
+    }
+
+    receivers = create_receivers(targets, num_targets,
+                                 CTK_EVENT_NAME(NV_CTRL_DITHERING),
+                                 G_CALLBACK(destroy_target));
+    if (!receivers) {
+        free(targets);
+        return 1;
+    }
+
+    /*
+     * each target's second event follows its first in the queue, so that
+     * an event is still queued when the last CtkEvent is destroyed
+     */
+
+    for (i = 0; i < num_targets; i++) {
+        inject_event(targets[i].target_type, targets[i].target_id,
+                     NV_CTRL_DITHERING, 1);
+        inject_event(targets[i].target_type, targets[i].target_id,
+                     NV_CTRL_DITHERING, 2);
+    }
+    run_main_loop();
+
+    for (i = 0; i < num_targets; i++) {
+        const Receiver *r = &receivers[i * RECEIVERS_PER_TARGET];
+        unsigned long received = 0;
+        int j;
+
+        for (j = 0; j < RECEIVERS_PER_TARGET; j++) {
+            received += r[j].received;
+            if (r[j].ctk_event) {
+                failures++;
+            }
+        }
+        if (received != 1) {
+            failures++;
+        }
+    }
+
+    if (failures) {
+        fprintf(stderr, "%d targets were not left with one delivery and no "
+                "CtkEvents.\n", failures);
+    }
+
+    if (handle.open || handle.num_opens != opens + 1 ||
+        handle.num_closes != handle.num_opens) {
+        fprintf(stderr, "The event handle was not closed with the last "
+                "CtkEvent.\n");
+        failures++;
+    }
+
+    if (handle.reads_after_close) {
+        fprintf(stderr, "The event handle was read %d times after it was "
+                "closed.\n", handle.reads_after_close);
+        failures++;
+    }
+
+    destroy_receivers(receivers, num_receivers);
+    free(targets);
+
+    return failures;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    double first_usec = 0.0;
+    int num_events = NUM_EVENTS, c, size, failures = 0;
+
+    while ((c = getopt(argc, argv, "n:")) != -1) {
+        switch (c) {
+        case 'n': num_events = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n events]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (num_events < BATCH_SIZE) {
+        fprintf(stderr, "Invalid event count.\n");
+        return 1;
+    }
+
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+    g_type_init();
+#endif
+
+    if (pipe(handle.fds) != 0) {
+        fprintf(stderr, "Cannot create a pipe.\n");
+        return 1;
+    }
+
+    printf("%d events, %d CtkEvents per target\n\n", num_events,
+           RECEIVERS_PER_TARGET);
+    printf("%-10s %12s %12s %14s %12s\n", "targets", "CtkEvents", "msec",
+           "events/s", "usec/event");
+
+    for (size = 0; size < NUM_SIZES; size++) {
+        int num_per_type = targets_per_type[size];
+        int num_targets = NUM_TARGET_TYPES * num_per_type;
+        int num_receivers = num_targets * RECEIVERS_PER_TARGET;
+        BenchTarget *targets = create_targets(num_per_type);
+        Receiver *receivers = NULL;
+        double msec, usec;
+
+        if (targets) {
+            receivers = create_receivers(targets, num_targets,
+                                         CTK_EVENT_NAME(NV_CTRL_DIGITAL_VIBRANCE),
+                                         G_CALLBACK(count_event));
+        }
+        if (!receivers) {
+            fprintf(stderr, "Cannot create %d CtkEvents.\n", num_receivers);
+            free(targets);
+            failures++;
+            break;
+        }
+
+        msec = time_dispatch(targets, num_per_type, num_events);
+
+        failures += check_receivers(receivers, num_receivers);
+
+        destroy_receivers(receivers, num_receivers);
+        free(targets);
+
+        usec = msec * 1000.0 / num_events;
+        if (size == 0) {
+            first_usec = usec;
+        }
+
+        printf("%-10d %12d %12.2f %14.0f %12.3f\n", num_targets,
+               num_receivers, msec, num_events * 1000.0 / msec, usec);
+
+        if (usec > 4.0 * first_usec) {
+            fprintf(stderr, "Dispatching to %d targets takes %.1f times as "
+                    "long per event as to %d.\n", num_targets,
+                    usec / first_usec,
+                    (int) NUM_TARGET_TYPES * targets_per_type[0]);
+            failures++;
+        }
+    }
+
+    if (num_errors) {
+        fprintf(stderr, "%d events were delivered to the wrong target.\n",
+                num_errors);
+        failures++;
+    }
+
+    if (handle.open || handle.num_closes != handle.num_opens) {
+        fprintf(stderr, "The event handle was left open.\n");
+        failures++;
+    }
+
+    failures += check_destroy_in_handler(targets_per_type[1]);
+
+    close(handle.fds[0]);
+    close(handle.fds[1]);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * gamma-ramp-bench.c - checks the gamma ramps computed by
+ * NvCtrlUpdateGammaRamp() against the per-entry computation it replaced,
+ * for random contrast, brightness and gamma settings, then times both
+ * for ramps of 256, 1024 and 4096 entries, along with ramps served from
+ * the cache of recently computed ramps.
+ *
+ * usage: gamma-ramp-bench [-n entries-per-size]
+ *
+ * Exits non-zero if an entry differs from the per-entry computation by
+ * more than 1 LSB of the ramp, or if computing whole ramps is not faster
+ * than the per-entry computation.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "NvCtrlAttributes.h"
+#include "NvCtrlAttributesPrivate.h"
+
+#include "common-utils.h"
+
+
+#define CACHED_ROUNDS 1000
+
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/* the computation of one ramp entry as it was done before */
+
+static unsigned short ComputeGammaRampVal(int gammaRampSize,
+                                          int i,
+                                          float contrast,
+                                          float brightness,
+                                          float gamma)
+{
+    double j, half, scale;
+    int shift, val, num;
+
+    num = gammaRampSize - 1;
+    shift = 16 - (ffs(gammaRampSize) - 1);
+
+    scale = (double) num / 3.0; /* how much brightness and contrast
+                                   affect the value */
+    j = (double) i;
+
+    /* contrast */
+
+    contrast *= scale;
+
+    if (contrast > 0.0) {
+        half = ((double) num / 2.0) - 1.0;
+        j -= half;
+        j *= half / (half - contrast);
+        j += half;
+    } else {
+        half = (double) num / 2.0;
+        j -= half;
+        j *= (half + contrast) / half;
+        j += half;
+    }
+
+    /* brightness */
+
+    brightness *= scale;
+
+    j += brightness;
+    if (j > (double)num) {
+        j = (double)num;
+    }
+    if (j < 0.0) {
+        j = 0.0;
+    }
+
+    /* gamma */
+
+    gamma = 1.0 / (double) gamma;
+
+    if (gamma == 1.0) {
+        val = (int) j;
+    } else {
+        val = (int) (pow (j / (double)num, gamma) * (double)num + 0.5);
+    }
+
+    val <<= shift;
+    return (unsigned short) val;
+}
+
+static void compute_ramp_per_entry(const NvCtrlGammaInput *input, int size,
+                                   unsigned short *ramp)
+{
+    int i;
+
+    for (i = 0; i < size; i++) {
+        ramp[i] = ComputeGammaRampVal(size, i,
+                                      input->contrast[RED_CHANNEL_INDEX],
+                                      input->brightness[RED_CHANNEL_INDEX],
+                                      input->gamma[RED_CHANNEL_INDEX]);
+    }
+}
+
+
+/*
+ * Random settings over the whole range of each control; every eighth
+ * setting has a neutral gamma, which takes a different path.
+ */
+
+static void random_input(NvCtrlGammaInput *input, int n)
+{
+    double r = (double) rand() / RAND_MAX;
+    float gamma = (n % 8 == 0) ? 1.0 : GAMMA_MIN * pow(GAMMA_MAX / GAMMA_MIN,
+                                                       r);
+    int ch;
+
+    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+        input->contrast[ch] = CONTRAST_MIN +
+            (CONTRAST_MAX - CONTRAST_MIN) * ((double) rand() / RAND_MAX);
+        input->brightness[ch] = BRIGHTNESS_MIN +
+            (BRIGHTNESS_MAX - BRIGHTNESS_MIN) * ((double) rand() / RAND_MAX);
+        input->gamma[ch] = gamma;
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    NvCtrlGammaInput *inputs;
+    unsigned short *expected, *ramps[3];
+    int entries = 1 << 20, size, n, num, i, c, failures = 0;
+
+    while ((c = getopt(argc, argv, "n:")) != -1) {
+        switch (c) {
+        case 'n': entries = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n entries-per-size]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (entries < 4096) {
+        fprintf(stderr, "Invalid entry count.\n");
+        return 1;
+    }
+
+    printf("%d entries per ramp size, in ramps with random settings\n\n",
+           entries);
+    printf("%-10s %10s %14s %14s %14s\n", "entries", "max diff",
+           "usec/old ramp", "usec/new ramp", "usec/cached");
+
+    for (size = 256; size <= 4096; size *= 4) {
+        double old_msec, new_msec, cached_msec, t;
+        int lsb = 1 << (16 - (ffs(size) - 1));
+        int max_diff = 0;
+
+        srand(size);
+
+        num = entries / size;
+        inputs = nvalloc(num * sizeof(*inputs));
+        expected = nvalloc(size * sizeof(*expected));
+        ramps[RED_CHANNEL_INDEX] = nvalloc(size * sizeof(unsigned short));
+        ramps[GREEN_CHANNEL_INDEX] = nvalloc(size * sizeof(unsigned short));
+        ramps[BLUE_CHANNEL_INDEX] = nvalloc(size * sizeof(unsigned short));
+
+        for (n = 0; n < num; n++) {
+            random_input(&inputs[n], n);
+        }
+
+        /* check every entry of every ramp */
+
+        for (n = 0; n < num; n++) {
+            compute_ramp_per_entry(&inputs[n], size, expected);
+            NvCtrlUpdateGammaRamp(&inputs[n], size, ramps, RED_CHANNEL);
+
+            for (i = 0; i < size; i++) {
+                int diff = abs((int) ramps[RED_CHANNEL_INDEX][i] -
+                               (int) expected[i]) / lsb;
+
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+            }
+        }
+
+        if (max_diff > 1) {
+            fprintf(stderr, "A %d entry ramp differs from the per-entry "
+                    "computation by %d LSB.\n", size, max_diff);
+            failures++;
+        }
+
+        /* time both computations; each setting misses the cache */
+
+        t = now_msec();
+        for (n = 0; n < num; n++) {
+            compute_ramp_per_entry(&inputs[n], size, expected);
+        }
+        old_msec = now_msec() - t;
+
+        t = now_msec();
+        for (n = 0; n < num; n++) {
+            NvCtrlUpdateGammaRamp(&inputs[n], size, ramps, RED_CHANNEL);
+        }
+        new_msec = now_msec() - t;
+
+        /* the three channels of one setting, as a slider change does */
+
+        t = now_msec();
+        for (n = 0; n < CACHED_ROUNDS; n++) {
+            NvCtrlUpdateGammaRamp(&inputs[0], size, ramps, ALL_CHANNELS);
+        }
+        cached_msec = now_msec() - t;
+
+        printf("%-10d %10d %14.2f %14.2f %14.2f\n", size, max_diff,
+               old_msec * 1000.0 / num, new_msec * 1000.0 / num,
+               cached_msec * 1000.0 / (3.0 * CACHED_ROUNDS));
+
+        if (new_msec >= old_msec) {
+            fprintf(stderr, "Computing whole %d entry ramps is not faster "
+                    "than the per-entry computation.\n", size);
+            failures++;
+        }
+
+        nvfree(ramps[RED_CHANNEL_INDEX]);
+        nvfree(ramps[GREEN_CHANNEL_INDEX]);
+        nvfree(ramps[BLUE_CHANNEL_INDEX]);
+        nvfree(expected);
+        nvfree(inputs);
+    }
+
+    return failures ? 1 : 0;
+}
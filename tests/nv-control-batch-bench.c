@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2026 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*
+ * nv-control-batch-bench.c - counts the X round trips needed to query
+ * every integer attribute of every target, one query at a time with
+ * XNVCTRLQueryTargetAttribute(), one batch per target with
+ * XNVCTRLQueryTargetAttributes(), and one batch for the whole system
+ * with XNVCTRLQueryBatch(), against the stub server in nv-control-stub.c.
+ *
+ * usage: nv-control-batch-bench [-l latency-usec] [-d display-targets]
+ *                               [-a attributes]
+ *
+ * Exits non-zero if any query returns a wrong result, or if a batch
+ * takes more round trips than expected.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <X11/Xlib.h>
+
+#include "NVCtrl.h"
+#include "NVCtrlLib.h"
+
+#include "nv-control-stub.h"
+
+
+typedef struct {
+    int type;
+    int id;
+} Target;
+
+typedef struct {
+    const char *name;
+    unsigned long requests;
+    unsigned long round_trips;
+    double msec;
+} Result;
+
+static int num_errors;
+
+static int error_handler(Display *dpy, XErrorEvent *ev)
+{
+    num_errors++;
+    return 0;
+}
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static int check(const Target *t, unsigned int attr, Bool exists, int value)
+{
+    if (exists != STUB_ATTRIBUTE_EXISTS(attr) ||
+        (exists && value != StubAttributeValue(t->type, t->id, attr))) {
+        fprintf(stderr, "Wrong result for attribute %u of target %d:%d.\n",
+                attr, t->type, t->id);
+        return 1;
+    }
+    return 0;
+}
+
+static void begin(Result *r, const char *name)
+{
+    r->name = name;
+    StubResetCounters();
+    r->msec = now_msec();
+}
+
+static void end(Result *r)
+{
+    r->msec = now_msec() - r->msec;
+    StubGetCounters(&r->requests, &r->round_trips);
+}
+
+int main(int argc, char *argv[])
+{
+    StubConfig config;
+    const char *display_name;
+    Display *dpy;
+    Target *targets;
+    XNVCTRLQuery *queries;
+    unsigned int *attrs;
+    int *values;
+    Bool *status;
+    Result results[3];
+    int num_targets, num_attrs = 200, num_displays = 16;
+    int major, minor, i, j, c, failures = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.latencyUsec = 200;
+
+    while ((c = getopt(argc, argv, "l:d:a:")) != -1) {
+        switch (c) {
+        case 'l': config.latencyUsec = atoi(optarg); break;
+        case 'd': num_displays = atoi(optarg); break;
+        case 'a': num_attrs = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-l latency-usec] "
+                    "[-d display-targets] [-a attributes]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (num_displays < 0 || num_displays > STUB_MAX_TARGETS ||
+        num_attrs <= 0 || num_attrs > STUB_MAX_ATTRIBUTE) {
+        fprintf(stderr, "Invalid target or attribute count.\n");
+        return 1;
+    }
+
+    config.targetCount[NV_CTRL_TARGET_TYPE_X_SCREEN] = 1;
+    config.targetCount[NV_CTRL_TARGET_TYPE_GPU] = 1;
+    config.targetCount[NV_CTRL_TARGET_TYPE_DISPLAY] = num_displays;
+
+    display_name = StubStart(&config);
+    if (!display_name) {
+        fprintf(stderr, "Cannot start the stub X server.\n");
+        return 1;
+    }
+
+    dpy = XOpenDisplay(display_name);
+    if (!dpy) {
+        fprintf(stderr, "Cannot open display '%s'.\n", display_name);
+        StubStop();
+        return 1;
+    }
+    XSetErrorHandler(error_handler);
+
+    if (!XNVCTRLQueryVersion(dpy, &major, &minor)) {
+        fprintf(stderr, "The NV-CONTROL X extension does not exist on "
+                "'%s'.\n", display_name);
+        return 1;
+    }
+
+    /* the targets, and the attributes to query on each */
+
+    num_targets = 2 + num_displays;
+    targets = calloc(num_targets, sizeof(*targets));
+    attrs = calloc(num_attrs, sizeof(*attrs));
+    values = calloc(num_attrs, sizeof(*values));
+    status = calloc(num_attrs, sizeof(*status));
+    queries = calloc((size_t) num_targets * num_attrs, sizeof(*queries));
+    if (!targets || !attrs || !values || !status || !queries) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+
+    targets[0].type = NV_CTRL_TARGET_TYPE_X_SCREEN;
+    targets[1].type = NV_CTRL_TARGET_TYPE_GPU;
+    for (i = 0; i < num_displays; i++) {
+        targets[2 + i].type = NV_CTRL_TARGET_TYPE_DISPLAY;
+        targets[2 + i].id = i;
+    }
+
+    for (j = 0; j < num_attrs; j++) {
+        attrs[j] = j;
+    }
+
+    /* one round trip per attribute */
+
+    begin(&results[0], "XNVCTRLQueryTargetAttribute");
+
+    for (i = 0; i < num_targets; i++) {
+        for (j = 0; j < num_attrs; j++) {
+            int value = 0;
+            Bool exists = XNVCTRLQueryTargetAttribute(dpy, targets[i].type,
+                                                      targets[i].id, 0,
+                                                      attrs[j], &value);
+            failures += check(&targets[i], attrs[j], exists, value);
+        }
+    }
+
+    end(&results[0]);
+
+    /* one round trip per target */
+
+    begin(&results[1], "XNVCTRLQueryTargetAttributes");
+
+    for (i = 0; i < num_targets; i++) {
+        if (!XNVCTRLQueryTargetAttributes(dpy, targets[i].type,
+                                          targets[i].id, 0, num_attrs,
+                                          attrs, values, status)) {
+            fprintf(stderr, "XNVCTRLQueryTargetAttributes() failed.\n");
+            failures++;
+            continue;
+        }
+        for (j = 0; j < num_attrs; j++) {
+            failures += check(&targets[i], attrs[j], status[j], values[j]);
+        }
+    }
+
+    end(&results[1]);
+
+    /* one round trip in all */
+
+    for (i = 0; i < num_targets; i++) {
+        for (j = 0; j < num_attrs; j++) {
+            XNVCTRLQuery *q = &queries[i * num_attrs + j];
+
+            q->type = XNVCTRL_QUERY_INTEGER;
+            q->target_type = targets[i].type;
+            q->target_id = targets[i].id;
+            q->attribute = attrs[j];
+        }
+    }
+
+    begin(&results[2], "XNVCTRLQueryBatch");
+
+    if (!XNVCTRLQueryBatch(dpy, num_targets * num_attrs, queries)) {
+        fprintf(stderr, "XNVCTRLQueryBatch() failed.\n");
+        failures++;
+    }
+
+    end(&results[2]);
+
+    for (i = 0; i < num_targets; i++) {
+        for (j = 0; j < num_attrs; j++) {
+            XNVCTRLQuery *q = &queries[i * num_attrs + j];
+            failures += check(&targets[i], attrs[j], q->exists,
+                              (int) q->value);
+        }
+    }
+
+    /* report */
+
+    printf("%d targets x %d attributes, %u usec simulated latency\n\n",
+           num_targets, num_attrs, config.latencyUsec);
+    printf("%-30s %10s %12s %10s\n", "", "requests", "round trips", "msec");
+    for (i = 0; i < 3; i++) {
+        printf("%-30s %10lu %12lu %10.1f\n", results[i].name,
+               results[i].requests, results[i].round_trips, results[i].msec);
+    }
+
+    /*
+     * The unbatched queries need one round trip each; a per-target batch
+     * one per target; XNVCTRLQueryBatch() may be split by Xlib flushing
+     * its output buffer, but each flush sends hundreds of requests.
+     */
+
+    if (results[1].round_trips > (unsigned long) num_targets ||
+        results[2].round_trips > results[2].requests / 256 + 1) {
+        fprintf(stderr, "The batched queries took too many round trips.\n");
+        failures++;
+    }
+
+    if (num_errors) {
+        fprintf(stderr, "%d unexpected X errors.\n", num_errors);
+        failures++;
+    }
+
+    XCloseDisplay(dpy);
+    StubStop();
+
+    free(targets);
+    free(attrs);
+    free(values);
+    free(status);
+    free(queries);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2026 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*
+ * nv-control-split-phase-test.c - tests the XNVCTRLSend and XNVCTRLWait
+ * functions against the stub server in nv-control-stub.c.  Every kind of
+ * split-phase request is sent in one burst, the replies are waited for in
+ * reverse order, with a blocking query in between, and the results are
+ * checked.  Also checks that a request for a target that does not exist
+ * fails through the error handler without disturbing the others, and
+ * that all of this takes the expected number of round trips.
+ *
+ * usage: nv-control-split-phase-test
+ *
+ * Exits non-zero if any check fails.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <X11/Xlib.h>
+
+#include "NVCtrl.h"
+#include "NVCtrlLib.h"
+
+#include "nv-control-stub.h"
+
+
+#define NUM_GPUS        2
+#define NUM_DISPLAYS    8
+
+/* attributes that exist on every target; see STUB_ATTRIBUTE_EXISTS() */
+#define INT_ATTRIBUTE   10
+#define STR_ATTRIBUTE   11
+#define SET_ATTRIBUTE   12
+#define MISSING_ATTRIBUTE 14
+
+typedef enum {
+    KIND_INTEGER,
+    KIND_INTEGER_64,
+    KIND_STRING,
+    KIND_BINARY,
+    KIND_VALID_VALUES,
+    KIND_SET,
+    KIND_TARGET_COUNT,
+    KIND_MISSING,
+    NUM_KINDS
+} Kind;
+
+typedef struct {
+    Kind kind;
+    int type;
+    int id;
+    XNVCTRLCookie cookie;
+} Request;
+
+static int num_errors;
+static int last_error_code;
+
+static int error_handler(Display *dpy, XErrorEvent *ev)
+{
+    num_errors++;
+    last_error_code = ev->error_code;
+    return 0;
+}
+
+static int failed(const char *what, const Request *r)
+{
+    fprintf(stderr, "%s failed for kind %d, target %d:%d.\n", what,
+            r->kind, r->type, r->id);
+    return 1;
+}
+
+static void send_request(Display *dpy, Request *r)
+{
+    switch (r->kind) {
+    case KIND_INTEGER:
+        r->cookie = XNVCTRLSendQueryTargetAttribute(dpy, r->type, r->id, 0,
+                                                    INT_ATTRIBUTE);
+        break;
+    case KIND_INTEGER_64:
+        r->cookie = XNVCTRLSendQueryTargetAttribute64(dpy, r->type, r->id,
+                                                      0, INT_ATTRIBUTE);
+        break;
+    case KIND_STRING:
+        r->cookie = XNVCTRLSendQueryTargetStringAttribute(dpy, r->type,
+                                                          r->id, 0,
+                                                          STR_ATTRIBUTE);
+        break;
+    case KIND_BINARY:
+        r->cookie =
+            XNVCTRLSendQueryTargetBinaryData(dpy, r->type, r->id, 0,
+                                             NV_CTRL_BINARY_DATA_DISPLAYS_ON_GPU);
+        break;
+    case KIND_VALID_VALUES:
+        r->cookie = XNVCTRLSendQueryValidTargetAttributeValues(dpy, r->type,
+                                                               r->id, 0,
+                                                               INT_ATTRIBUTE);
+        break;
+    case KIND_SET:
+        r->cookie = XNVCTRLSendSetTargetAttributeAndGetStatus(dpy, r->type,
+                                                              r->id, 0,
+                                                              SET_ATTRIBUTE,
+                                                              -r->id);
+        break;
+    case KIND_TARGET_COUNT:
+        r->cookie = XNVCTRLSendQueryTargetCount(dpy, r->type);
+        break;
+    case KIND_MISSING:
+        r->cookie = XNVCTRLSendQueryTargetAttribute(dpy, r->type, r->id, 0,
+                                                    MISSING_ATTRIBUTE);
+        break;
+    default:
+        r->cookie = NULL;
+        break;
+    }
+}
+
+static int wait_request(Display *dpy, const Request *r)
+{
+    int64_t expected = StubAttributeValue(r->type, r->id, INT_ATTRIBUTE);
+
+    switch (r->kind) {
+    case KIND_INTEGER:
+        {
+            int value;
+            if (!XNVCTRLWaitQueryTargetAttribute(dpy, r->cookie, &value) ||
+                value != (int) expected) {
+                return failed("XNVCTRLWaitQueryTargetAttribute()", r);
+            }
+        }
+        break;
+    case KIND_INTEGER_64:
+        {
+            int64_t value;
+            if (!XNVCTRLWaitQueryTargetAttribute64(dpy, r->cookie, &value) ||
+                value != expected) {
+                return failed("XNVCTRLWaitQueryTargetAttribute64()", r);
+            }
+        }
+        break;
+    case KIND_STRING:
+        {
+            char *str = NULL, buf[64];
+            int ok;
+
+            StubStringValue(r->type, r->id, STR_ATTRIBUTE, buf, sizeof(buf));
+            ok = XNVCTRLWaitQueryTargetStringAttribute(dpy, r->cookie, &str) &&
+                 str && !strcmp(str, buf);
+            if (str) {
+                XFree(str);
+            }
+            if (!ok) {
+                return failed("XNVCTRLWaitQueryTargetStringAttribute()", r);
+            }
+        }
+        break;
+    case KIND_BINARY:
+        {
+            unsigned char *data = NULL;
+            int ids[1 + STUB_MAX_TARGETS];
+            int len = 0, ok;
+
+            ids[0] = StubRelatedTargets(r->type, r->id,
+                                        NV_CTRL_BINARY_DATA_DISPLAYS_ON_GPU,
+                                        ids + 1, STUB_MAX_TARGETS);
+            ok = XNVCTRLWaitQueryTargetBinaryData(dpy, r->cookie, &data,
+                                                  &len) &&
+                 data && len == (1 + ids[0]) * sizeof(int) &&
+                 !memcmp(data, ids, len);
+            if (data) {
+                XFree(data);
+            }
+            if (!ok) {
+                return failed("XNVCTRLWaitQueryTargetBinaryData()", r);
+            }
+        }
+        break;
+    case KIND_VALID_VALUES:
+        {
+            NVCTRLAttributeValidValuesRec values;
+
+            memset(&values, 0, sizeof(values));
+            if (!XNVCTRLWaitQueryValidTargetAttributeValues(dpy, r->cookie,
+                                                            &values) ||
+                values.type != ATTRIBUTE_TYPE_RANGE ||
+                values.u.range.min != 0 ||
+                values.u.range.max != expected * 2 ||
+                !(values.permissions & ATTRIBUTE_TYPE_WRITE)) {
+                return failed("XNVCTRLWaitQueryValidTargetAttributeValues()",
+                              r);
+            }
+        }
+        break;
+    case KIND_SET:
+        if (!XNVCTRLWaitSetTargetAttributeAndGetStatus(dpy, r->cookie)) {
+            return failed("XNVCTRLWaitSetTargetAttributeAndGetStatus()", r);
+        }
+        break;
+    case KIND_TARGET_COUNT:
+        {
+            int count;
+            if (!XNVCTRLWaitQueryTargetCount(dpy, r->cookie, &count) ||
+                count != (r->type == NV_CTRL_TARGET_TYPE_GPU ? NUM_GPUS :
+                          NUM_DISPLAYS)) {
+                return failed("XNVCTRLWaitQueryTargetCount()", r);
+            }
+        }
+        break;
+    case KIND_MISSING:
+        {
+            int value;
+            if (XNVCTRLWaitQueryTargetAttribute(dpy, r->cookie, &value)) {
+                return failed("Querying a missing attribute", r);
+            }
+        }
+        break;
+    default:
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    StubConfig config;
+    const char *display_name;
+    Display *dpy;
+    Request requests[NUM_KINDS * NUM_GPUS];
+    XNVCTRLCookie bad_cookie;
+    unsigned long num_requests, round_trips;
+    int major, minor, value, i, failures = 0;
+    int num = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.targetCount[NV_CTRL_TARGET_TYPE_X_SCREEN] = 1;
+    config.targetCount[NV_CTRL_TARGET_TYPE_GPU] = NUM_GPUS;
+    config.targetCount[NV_CTRL_TARGET_TYPE_DISPLAY] = NUM_DISPLAYS;
+
+    display_name = StubStart(&config);
+    if (!display_name) {
+        fprintf(stderr, "Cannot start the stub X server.\n");
+        return 1;
+    }
+
+    dpy = XOpenDisplay(display_name);
+    if (!dpy) {
+        fprintf(stderr, "Cannot open display '%s'.\n", display_name);
+        StubStop();
+        return 1;
+    }
+    XSetErrorHandler(error_handler);
+
+    if (!XNVCTRLQueryVersion(dpy, &major, &minor)) {
+        fprintf(stderr, "The NV-CONTROL X extension does not exist on "
+                "'%s'.\n", display_name);
+        return 1;
+    }
+
+    /* one request of each kind for each GPU, in a single burst */
+
+    StubResetCounters();
+
+    for (i = 0; i < NUM_KINDS * NUM_GPUS; i++) {
+        Request *r = &requests[num++];
+
+        r->kind = i % NUM_KINDS;
+        r->type = NV_CTRL_TARGET_TYPE_GPU;
+        r->id = i / NUM_KINDS;
+        if (r->kind == KIND_TARGET_COUNT && r->id > 0) {
+            r->type = NV_CTRL_TARGET_TYPE_DISPLAY;
+        }
+        send_request(dpy, r);
+        if (!r->cookie) {
+            failures += failed("Sending the request", r);
+        }
+    }
+
+    bad_cookie = XNVCTRLSendQueryTargetAttribute(dpy,
+                                                 NV_CTRL_TARGET_TYPE_GPU,
+                                                 NUM_GPUS, 0, INT_ATTRIBUTE);
+
+    /*
+     * Waiting for the last request reads all the replies; a blocking query
+     * in between must not disturb the others.
+     */
+
+    for (i = num - 1; i >= 0; i--) {
+        failures += wait_request(dpy, &requests[i]);
+
+        if (i == num / 2) {
+            if (!XNVCTRLQueryTargetAttribute(dpy, NV_CTRL_TARGET_TYPE_GPU, 0,
+                                             0, INT_ATTRIBUTE, &value) ||
+                value != (int) StubAttributeValue(NV_CTRL_TARGET_TYPE_GPU, 0,
+                                                  INT_ATTRIBUTE)) {
+                fprintf(stderr, "Blocking query in between split-phase "
+                        "queries failed.\n");
+                failures++;
+            }
+        }
+    }
+
+    /* the request for a GPU that does not exist fails with BadValue */
+
+    if (XNVCTRLWaitQueryTargetAttribute(dpy, bad_cookie, &value) ||
+        num_errors != 1 || last_error_code != BadValue) {
+        fprintf(stderr, "Querying a target that does not exist did not fail "
+                "with BadValue.\n");
+        failures++;
+    }
+
+    StubGetCounters(&num_requests, &round_trips);
+
+    /* the burst and the blocking query; Xlib flushes before the latter */
+
+    printf("%lu requests, %lu round trips\n", num_requests, round_trips);
+    if (round_trips > 3) {
+        fprintf(stderr, "The split-phase queries took too many round "
+                "trips.\n");
+        failures++;
+    }
+
+    /* the assignments were made */
+
+    for (i = 0; i < NUM_GPUS; i++) {
+        if (!XNVCTRLQueryTargetAttribute(dpy, NV_CTRL_TARGET_TYPE_GPU, i, 0,
+                                         SET_ATTRIBUTE, &value) ||
+            value != -i) {
+            fprintf(stderr, "The assignment to GPU %d was not made.\n", i);
+            failures++;
+        }
+    }
+
+    if (XNVCTRLWaitQueryTargetAttribute(dpy, NULL, &value)) {
+        fprintf(stderr, "Waiting for a NULL cookie did not fail.\n");
+        failures++;
+    }
+
+    XCloseDisplay(dpy);
+    StubStop();
+
+    return failures ? 1 : 0;
+}
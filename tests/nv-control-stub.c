@@ -0,0 +1,911 @@
+/*
+ * Copyright (c) 2026 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * nv-control-stub.c - a minimal X server with a fake NV-CONTROL
+ * extension; see nv-control-stub.h.
+ *
+ * The server listens on a TCP port on the loopback interface, accepts a
+ * single client connection, and only speaks the byte order of the host.
+ * Core requests other than the few that Xlib needs to open and sync a
+ * display are ignored, as are NV-CONTROL requests without a reply that
+ * are not attribute assignments.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+
+#include "NVCtrl.h"
+#include "nv_control.h"
+
+#include "nv-control-stub.h"
+
+
+#define STUB_FIRST_DISPLAY    50
+#define STUB_LAST_DISPLAY     99
+#define STUB_MAJOR_OPCODE     200
+
+#define STUB_ROOT_WINDOW      0x00000100
+#define STUB_ROOT_COLORMAP    0x00000101
+#define STUB_ROOT_VISUAL      0x00000102
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t size;
+} StubBuffer;
+
+static struct {
+    StubConfig config;
+    char displayName[32];
+
+    int listenFd;
+    int stopPipe[2];
+    pthread_t thread;
+    Bool running;
+
+    pthread_mutex_t lock;
+    unsigned long requests;
+    unsigned long roundTrips;
+
+    /*
+     * the current values of all integer attributes; those of the targets
+     * of each type start at valueBase[type]
+     */
+    int64_t *values;
+    size_t valueBase[STUB_NUM_TARGET_TYPES];
+
+    unsigned int sequence;
+    unsigned int nextAtom;
+} stub = {
+    .listenFd = -1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+
+int64_t StubAttributeValue(int targetType, int targetId,
+                           unsigned int attribute)
+{
+    return (int64_t) attribute * 1000 + targetType * 100 + targetId;
+}
+
+void StubStringValue(int targetType, int targetId, unsigned int attribute,
+                     char *buf, int len)
+{
+    snprintf(buf, len, "stub-%d-%d-%u", targetType, targetId, attribute);
+}
+
+/*
+ * The stub's topology: X screen 0 drives every GPU and every display
+ * device, display devices, coolers and thermal sensors are dealt out to
+ * the GPUs round robin, and every frame lock device and VCS is used by
+ * every GPU.
+ */
+
+static Bool IsRelated(int type, int id, int otherType, int otherId)
+{
+    int numGpus = stub.config.targetCount[NV_CTRL_TARGET_TYPE_GPU];
+
+    switch (type) {
+    case NV_CTRL_TARGET_TYPE_X_SCREEN:
+        return id == 0;
+    case NV_CTRL_TARGET_TYPE_GPU:
+        switch (otherType) {
+        case NV_CTRL_TARGET_TYPE_DISPLAY:
+        case NV_CTRL_TARGET_TYPE_COOLER:
+        case NV_CTRL_TARGET_TYPE_THERMAL_SENSOR:
+            return otherId % numGpus == id;
+        default:
+            return True;
+        }
+    default:
+        return True;
+    }
+}
+
+int StubRelatedTargets(int targetType, int targetId, unsigned int attribute,
+                       int *ids, int maxIds)
+{
+    int otherType, otherId, n = 0;
+
+    switch (attribute) {
+    case NV_CTRL_BINARY_DATA_DISPLAY_TARGETS:
+    case NV_CTRL_BINARY_DATA_DISPLAYS_ASSIGNED_TO_XSCREEN:
+    case NV_CTRL_BINARY_DATA_DISPLAYS_ENABLED_ON_XSCREEN:
+    case NV_CTRL_BINARY_DATA_DISPLAYS_CONNECTED_TO_GPU:
+    case NV_CTRL_BINARY_DATA_DISPLAYS_ON_GPU:
+        otherType = NV_CTRL_TARGET_TYPE_DISPLAY;
+        break;
+    case NV_CTRL_BINARY_DATA_GPUS_USED_BY_LOGICAL_XSCREEN:
+    case NV_CTRL_BINARY_DATA_GPUS_USING_FRAMELOCK:
+    case NV_CTRL_BINARY_DATA_GPUS_USING_VCSC:
+        otherType = NV_CTRL_TARGET_TYPE_GPU;
+        break;
+    case NV_CTRL_BINARY_DATA_FRAMELOCKS_USED_BY_GPU:
+        otherType = NV_CTRL_TARGET_TYPE_FRAMELOCK;
+        break;
+    case NV_CTRL_BINARY_DATA_VCSCS_USED_BY_GPU:
+        otherType = NV_CTRL_TARGET_TYPE_VCSC;
+        break;
+    case NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU:
+        otherType = NV_CTRL_TARGET_TYPE_COOLER;
+        break;
+    case NV_CTRL_BINARY_DATA_THERMAL_SENSORS_USED_BY_GPU:
+        otherType = NV_CTRL_TARGET_TYPE_THERMAL_SENSOR;
+        break;
+    default:
+        return -1;
+    }
+
+    for (otherId = 0; otherId < stub.config.targetCount[otherType];
+         otherId++) {
+        if (IsRelated(targetType, targetId, otherType, otherId)) {
+            if (n < maxIds) {
+                ids[n] = otherId;
+            }
+            n++;
+        }
+    }
+
+    return n;
+}
+
+static int64_t *ValuePtr(int targetType, int targetId, unsigned int attribute)
+{
+    return &stub.values[(stub.valueBase[targetType] + targetId) *
+                        STUB_MAX_ATTRIBUTE + attribute];
+}
+
+static Bool TargetExists(int targetType, int targetId)
+{
+    return targetType >= 0 && targetType < STUB_NUM_TARGET_TYPES &&
+           targetId >= 0 && targetId < stub.config.targetCount[targetType];
+}
+
+
+
+/* output buffer helpers */
+
+static void Append(StubBuffer *b, const void *data, size_t len)
+{
+    if (b->len + len > b->size) {
+        b->size = (b->len + len) * 2;
+        b->data = realloc(b->data, b->size);
+        if (!b->data) {
+            fprintf(stderr, "nv-control-stub: out of memory\n");
+            exit(1);
+        }
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+static void AppendPadded(StubBuffer *b, const void *data, size_t len)
+{
+    static const char pad[4];
+
+    Append(b, data, len);
+    Append(b, pad, (4 - (len & 3)) & 3);
+}
+
+/*
+ * Appends a 32 byte reply, followed by len bytes of extra data; the
+ * caller fills in everything after the length field.
+ */
+static void AppendReply(StubBuffer *b, void *reply, size_t replyLen,
+                        const void *extra, size_t len)
+{
+    xGenericReply *rep = reply;
+
+    rep->type = X_Reply;
+    rep->sequenceNumber = stub.sequence & 0xffff;
+    rep->length = (replyLen - sz_xGenericReply + len + 3) >> 2;
+
+    Append(b, reply, replyLen);
+    if (extra) {
+        AppendPadded(b, extra, len);
+    }
+}
+
+static void AppendError(StubBuffer *b, int code, CARD32 value,
+                        int major, int minor)
+{
+    xError err;
+
+    memset(&err, 0, sizeof(err));
+    err.type = X_Error;
+    err.errorCode = code;
+    err.sequenceNumber = stub.sequence & 0xffff;
+    err.resourceID = value;
+    err.minorCode = minor;
+    err.majorCode = major;
+
+    Append(b, &err, sizeof(err));
+}
+
+
+
+/* request handlers */
+
+static void HandleCoreRequest(const xReq *req, StubBuffer *out)
+{
+    switch (req->reqType) {
+    case X_QueryExtension:
+        {
+            const xQueryExtensionReq *qe = (const xQueryExtensionReq *) req;
+            xQueryExtensionReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            if (qe->nbytes == strlen(NV_CONTROL_NAME) &&
+                !memcmp(qe + 1, NV_CONTROL_NAME, qe->nbytes)) {
+                rep.present = xTrue;
+                rep.major_opcode = STUB_MAJOR_OPCODE;
+                rep.first_event = LASTEvent;
+                rep.first_error = FirstExtensionError;
+            }
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_GetInputFocus:
+        {
+            xGetInputFocusReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.revertTo = RevertToPointerRoot;
+            rep.focus = PointerRoot;
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_GetProperty:
+        {
+            xGetPropertyReply rep;
+
+            /* no window has any properties */
+            memset(&rep, 0, sizeof(rep));
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_InternAtom:
+        {
+            xInternAtomReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.atom = stub.nextAtom++;
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void HandleNvCtrlRequest(const xReq *req, StubBuffer *out)
+{
+    const xnvCtrlQueryAttributeReq *attrReq =
+        (const xnvCtrlQueryAttributeReq *) req;
+    int type = attrReq->target_type;
+    int id = attrReq->target_id;
+    unsigned int attr = attrReq->attribute;
+    Bool exists = STUB_ATTRIBUTE_EXISTS(attr);
+    int nvReqType = req->data;
+
+    switch (nvReqType) {
+    case X_nvCtrlQueryExtension:
+        {
+            xnvCtrlQueryExtensionReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.major = NV_CONTROL_MAJOR;
+            rep.minor = NV_CONTROL_MINOR;
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        return;
+
+    case X_nvCtrlIsNv:
+        {
+            xnvCtrlIsNvReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.isnv = TargetExists(NV_CTRL_TARGET_TYPE_X_SCREEN,
+                                    ((const xnvCtrlIsNvReq *) req)->screen);
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        return;
+
+    case X_nvCtrlQueryTargetCount:
+        {
+            const xnvCtrlQueryTargetCountReq *countReq =
+                (const xnvCtrlQueryTargetCountReq *) req;
+            xnvCtrlQueryTargetCountReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            if (countReq->target_type < STUB_NUM_TARGET_TYPES) {
+                rep.count = stub.config.targetCount[countReq->target_type];
+            }
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        return;
+
+    case X_nvCtrlQueryAttributePermissions:
+    case X_nvCtrlQueryStringAttributePermissions:
+    case X_nvCtrlQueryBinaryDataAttributePermissions:
+    case X_nvCtrlQueryStringOperationAttributePermissions:
+        {
+            /* these requests name an attribute, but no target */
+            const xnvCtrlQueryAttributePermissionsReq *permsReq =
+                (const xnvCtrlQueryAttributePermissionsReq *) req;
+            xnvCtrlQueryAttributePermissionsReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.flags = STUB_ATTRIBUTE_EXISTS(permsReq->attribute);
+            rep.attr_type = ATTRIBUTE_TYPE_RANGE;
+            rep.perms = ATTRIBUTE_TYPE_READ | ATTRIBUTE_TYPE_WRITE;
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        return;
+
+    case X_nvCtrlQueryAttribute:
+    case X_nvCtrlQueryAttribute64:
+    case X_nvCtrlQueryStringAttribute:
+    case X_nvCtrlQueryBinaryData:
+    case X_nvCtrlQueryValidAttributeValues:
+    case X_nvCtrlQueryValidAttributeValues64:
+    case X_nvCtrlSetAttribute:
+    case X_nvCtrlSetAttributeAndGetStatus:
+        break;
+
+    default:
+        return;
+    }
+
+    /* all of the requests below address an attribute of a target */
+
+    if (!TargetExists(type, id)) {
+        if (nvReqType != X_nvCtrlSetAttribute) {
+            AppendError(out, BadValue, id, STUB_MAJOR_OPCODE, nvReqType);
+        }
+        return;
+    }
+
+    switch (nvReqType) {
+    case X_nvCtrlQueryAttribute:
+        {
+            xnvCtrlQueryAttributeReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.flags = exists;
+            if (exists) {
+                rep.value = (INT32) *ValuePtr(type, id, attr);
+            }
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_nvCtrlQueryAttribute64:
+        {
+            xnvCtrlQueryAttribute64Reply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.flags = exists;
+            if (exists) {
+                rep.value_64 = *ValuePtr(type, id, attr);
+            }
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_nvCtrlQueryStringAttribute:
+    case X_nvCtrlQueryBinaryData:
+        {
+            /* the string and binary data replies share the same layout */
+            xnvCtrlQueryStringAttributeReply rep;
+            int ids[1 + STUB_MAX_TARGETS];
+            char str[64];
+            int n = 0;
+
+            memset(&rep, 0, sizeof(rep));
+
+            /* relationships: a count followed by that many target ids */
+
+            if (nvReqType == X_nvCtrlQueryBinaryData) {
+                ids[0] = StubRelatedTargets(type, id, attr, ids + 1,
+                                            STUB_MAX_TARGETS);
+                if (ids[0] >= 0) {
+                    rep.flags = True;
+                    rep.n = (1 + ids[0]) * sizeof(ids[0]);
+                    AppendReply(out, &rep, sizeof(rep), ids, rep.n);
+                    break;
+                }
+            }
+
+            if (exists) {
+                StubStringValue(type, id, attr, str, sizeof(str));
+                n = strlen(str) + (nvReqType == X_nvCtrlQueryStringAttribute);
+            }
+            rep.flags = exists;
+            rep.n = n;
+            AppendReply(out, &rep, sizeof(rep), str, n);
+        }
+        break;
+
+    case X_nvCtrlQueryValidAttributeValues:
+        {
+            xnvCtrlQueryValidAttributeValuesReply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.flags = exists;
+            rep.attr_type = ATTRIBUTE_TYPE_RANGE;
+            rep.min = 0;
+            rep.max = (INT32) StubAttributeValue(type, id, attr) * 2;
+            rep.perms = ATTRIBUTE_TYPE_READ | ATTRIBUTE_TYPE_WRITE;
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_nvCtrlQueryValidAttributeValues64:
+        {
+            xnvCtrlQueryValidAttributeValues64Reply rep;
+
+            memset(&rep, 0, sizeof(rep));
+            rep.flags = exists;
+            rep.attr_type = ATTRIBUTE_TYPE_RANGE;
+            rep.min_64 = 0;
+            rep.max_64 = StubAttributeValue(type, id, attr) * 2;
+            rep.perms = ATTRIBUTE_TYPE_READ | ATTRIBUTE_TYPE_WRITE;
+            AppendReply(out, &rep, sizeof(rep), NULL, 0);
+        }
+        break;
+
+    case X_nvCtrlSetAttribute:
+    case X_nvCtrlSetAttributeAndGetStatus:
+        {
+            const xnvCtrlSetAttributeReq *setReq =
+                (const xnvCtrlSetAttributeReq *) req;
+
+            if (exists) {
+                *ValuePtr(type, id, attr) = setReq->value;
+            }
+
+            if (nvReqType == X_nvCtrlSetAttributeAndGetStatus) {
+                xnvCtrlSetAttributeAndGetStatusReply rep;
+
+                memset(&rep, 0, sizeof(rep));
+                rep.flags = exists;
+                AppendReply(out, &rep, sizeof(rep), NULL, 0);
+            }
+        }
+        break;
+    }
+}
+
+
+
+/* connection handling */
+
+static Bool WriteAll(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return False;
+        }
+        data += n;
+        len -= n;
+    }
+
+    return True;
+}
+
+/*
+ * Reads whatever the client has sent, waiting until at least want bytes
+ * are buffered; returns False when the client goes away or the server is
+ * stopped.
+ */
+static Bool Fill(int fd, StubBuffer *in, size_t want)
+{
+    while (in->len < want) {
+        struct pollfd fds[2] = {
+            { .fd = fd, .events = POLLIN },
+            { .fd = stub.stopPipe[0], .events = POLLIN },
+        };
+        char buf[65536];
+        ssize_t n;
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return False;
+        }
+        if (fds[1].revents) {
+            return False;
+        }
+
+        n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return False;
+        }
+        Append(in, buf, n);
+    }
+
+    return True;
+}
+
+static Bool SendSetup(int fd, StubBuffer *in)
+{
+    static const char vendor[] = "NV-CONTROL stub";
+    const xConnClientPrefix *prefix;
+    xConnSetupPrefix setupPrefix;
+    xConnSetup setup;
+    xPixmapFormat formats[2];
+    xWindowRoot root;
+    xDepth depth;
+    xVisualType visual;
+    StubBuffer out = { 0 };
+    size_t want;
+    Bool ret;
+
+    if (!Fill(fd, in, sz_xConnClientPrefix)) {
+        return False;
+    }
+
+    prefix = (const xConnClientPrefix *) in->data;
+    want = sz_xConnClientPrefix + ((prefix->nbytesAuthProto + 3) & ~3) +
+           ((prefix->nbytesAuthString + 3) & ~3);
+
+    if (!Fill(fd, in, want)) {
+        return False;
+    }
+
+    prefix = (const xConnClientPrefix *) in->data;
+    if (prefix->byteOrder != ((*(const char *) &(int){ 1 }) ? 'l' : 'B')) {
+        fprintf(stderr, "nv-control-stub: unsupported client byte order\n");
+        return False;
+    }
+
+    memmove(in->data, in->data + want, in->len - want);
+    in->len -= want;
+
+    memset(&setup, 0, sizeof(setup));
+    setup.release = 1;
+    setup.ridBase = 0x00200000;
+    setup.ridMask = 0x001fffff;
+    setup.nbytesVendor = strlen(vendor);
+    setup.maxRequestSize = 0xffff;
+    setup.numRoots = 1;
+    setup.numFormats = 2;
+    setup.imageByteOrder = LSBFirst;
+    setup.bitmapBitOrder = LSBFirst;
+    setup.bitmapScanlineUnit = 32;
+    setup.bitmapScanlinePad = 32;
+    setup.minKeyCode = 8;
+    setup.maxKeyCode = 255;
+
+    memset(formats, 0, sizeof(formats));
+    formats[0].depth = 1;
+    formats[0].bitsPerPixel = 1;
+    formats[0].scanLinePad = 32;
+    formats[1].depth = 24;
+    formats[1].bitsPerPixel = 32;
+    formats[1].scanLinePad = 32;
+
+    memset(&root, 0, sizeof(root));
+    root.windowId = STUB_ROOT_WINDOW;
+    root.defaultColormap = STUB_ROOT_COLORMAP;
+    root.whitePixel = 0x00ffffff;
+    root.blackPixel = 0;
+    root.pixWidth = 1920;
+    root.pixHeight = 1080;
+    root.mmWidth = 508;
+    root.mmHeight = 286;
+    root.minInstalledMaps = 1;
+    root.maxInstalledMaps = 1;
+    root.rootVisualID = STUB_ROOT_VISUAL;
+    root.backingStore = NotUseful;
+    root.rootDepth = 24;
+    root.nDepths = 1;
+
+    memset(&depth, 0, sizeof(depth));
+    depth.depth = 24;
+    depth.nVisuals = 1;
+
+    memset(&visual, 0, sizeof(visual));
+    visual.visualID = STUB_ROOT_VISUAL;
+    visual.class = TrueColor;
+    visual.bitsPerRGB = 8;
+    visual.colormapEntries = 256;
+    visual.redMask = 0x00ff0000;
+    visual.greenMask = 0x0000ff00;
+    visual.blueMask = 0x000000ff;
+
+    memset(&setupPrefix, 0, sizeof(setupPrefix));
+    setupPrefix.success = xTrue;
+    setupPrefix.majorVersion = X_PROTOCOL;
+    setupPrefix.minorVersion = X_PROTOCOL_REVISION;
+    setupPrefix.length = (sz_xConnSetup + ((setup.nbytesVendor + 3) & ~3) +
+                          sizeof(formats) + sz_xWindowRoot + sz_xDepth +
+                          sz_xVisualType) >> 2;
+
+    Append(&out, &setupPrefix, sz_xConnSetupPrefix);
+    Append(&out, &setup, sz_xConnSetup);
+    AppendPadded(&out, vendor, setup.nbytesVendor);
+    Append(&out, formats, sizeof(formats));
+    Append(&out, &root, sz_xWindowRoot);
+    Append(&out, &depth, sz_xDepth);
+    Append(&out, &visual, sz_xVisualType);
+
+    ret = WriteAll(fd, out.data, out.len);
+    free(out.data);
+
+    return ret;
+}
+
+static void ServeClient(int fd)
+{
+    StubBuffer in = { 0 }, out = { 0 };
+
+    stub.sequence = 0;
+    stub.nextAtom = 100;
+
+    if (!SendSetup(fd, &in)) {
+        goto done;
+    }
+
+    while (Fill(fd, &in, in.len + 1)) {
+        size_t offset = 0;
+        unsigned long requests = 0;
+
+        /* process every complete request received so far */
+
+        while (in.len - offset >= sz_xReq) {
+            const xReq *req = (const xReq *) (in.data + offset);
+            size_t len = (size_t) req->length << 2;
+
+            if (len < sz_xReq) {
+                fprintf(stderr, "nv-control-stub: unsupported request "
+                        "length\n");
+                goto done;
+            }
+            if (in.len - offset < len) {
+                break;
+            }
+
+            stub.sequence++;
+            requests++;
+
+            if (req->reqType == STUB_MAJOR_OPCODE) {
+                HandleNvCtrlRequest(req, &out);
+            } else {
+                HandleCoreRequest(req, &out);
+            }
+
+            offset += len;
+        }
+
+        memmove(in.data, in.data + offset, in.len - offset);
+        in.len -= offset;
+
+        pthread_mutex_lock(&stub.lock);
+        stub.requests += requests;
+        if (out.len > 0) {
+            stub.roundTrips++;
+        }
+        pthread_mutex_unlock(&stub.lock);
+
+        if (out.len > 0) {
+            if (stub.config.latencyUsec) {
+                usleep(stub.config.latencyUsec);
+            }
+            if (!WriteAll(fd, out.data, out.len)) {
+                goto done;
+            }
+            out.len = 0;
+        }
+    }
+
+done:
+    free(in.data);
+    free(out.data);
+}
+
+static void *ServerThread(void *arg)
+{
+    for (;;) {
+        struct pollfd fds[2] = {
+            { .fd = stub.listenFd, .events = POLLIN },
+            { .fd = stub.stopPipe[0], .events = POLLIN },
+        };
+        int fd, one = 1;
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+
+        fd = accept(stub.listenFd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        ServeClient(fd);
+        close(fd);
+    }
+
+    return NULL;
+}
+
+const char *StubStart(const StubConfig *config)
+{
+    struct sockaddr_in addr;
+    size_t numValues;
+    int type, id, display, one = 1;
+    unsigned int attr;
+
+    if (stub.running) {
+        return NULL;
+    }
+
+    for (type = 0; type < STUB_NUM_TARGET_TYPES; type++) {
+        if (config->targetCount[type] > STUB_MAX_TARGETS) {
+            return NULL;
+        }
+    }
+
+    stub.config = *config;
+
+    numValues = 0;
+    for (type = 0; type < STUB_NUM_TARGET_TYPES; type++) {
+        stub.valueBase[type] = numValues;
+        numValues += config->targetCount[type];
+    }
+    numValues *= STUB_MAX_ATTRIBUTE;
+
+    stub.values = malloc((numValues ? numValues : 1) * sizeof(*stub.values));
+    if (!stub.values) {
+        return NULL;
+    }
+    for (type = 0; type < STUB_NUM_TARGET_TYPES; type++) {
+        for (id = 0; id < config->targetCount[type]; id++) {
+            for (attr = 0; attr < STUB_MAX_ATTRIBUTE; attr++) {
+                *ValuePtr(type, id, attr) = StubAttributeValue(type, id, attr);
+            }
+        }
+    }
+
+    stub.listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (stub.listenFd < 0) {
+        goto fail;
+    }
+    setsockopt(stub.listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    /* find a free display number */
+
+    for (display = STUB_FIRST_DISPLAY; display <= STUB_LAST_DISPLAY;
+         display++) {
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(X_TCP_PORT + display);
+
+        if (bind(stub.listenFd, (struct sockaddr *) &addr,
+                 sizeof(addr)) == 0) {
+            break;
+        }
+    }
+
+    if (display > STUB_LAST_DISPLAY || listen(stub.listenFd, 1) < 0 ||
+        pipe(stub.stopPipe) < 0) {
+        goto fail;
+    }
+
+    if (pthread_create(&stub.thread, NULL, ServerThread, NULL) != 0) {
+        close(stub.stopPipe[0]);
+        close(stub.stopPipe[1]);
+        goto fail;
+    }
+
+    stub.running = True;
+    StubResetCounters();
+
+    snprintf(stub.displayName, sizeof(stub.displayName), "127.0.0.1:%d",
+             display);
+
+    return stub.displayName;
+
+fail:
+    if (stub.listenFd >= 0) {
+        close(stub.listenFd);
+        stub.listenFd = -1;
+    }
+    free(stub.values);
+    stub.values = NULL;
+
+    return NULL;
+}
+
+void StubStop(void)
+{
+    if (!stub.running) {
+        return;
+    }
+
+    if (write(stub.stopPipe[1], "", 1) != 1) {
+        fprintf(stderr, "nv-control-stub: failed to stop the server\n");
+        return;
+    }
+    pthread_join(stub.thread, NULL);
+
+    close(stub.stopPipe[0]);
+    close(stub.stopPipe[1]);
+    close(stub.listenFd);
+    stub.listenFd = -1;
+
+    free(stub.values);
+    stub.values = NULL;
+
+    stub.running = False;
+}
+
+void StubGetCounters(unsigned long *requests, unsigned long *roundTrips)
+{
+    pthread_mutex_lock(&stub.lock);
+    if (requests) *requests = stub.requests;
+    if (roundTrips) *roundTrips = stub.roundTrips;
+    pthread_mutex_unlock(&stub.lock);
+}
+
+void StubResetCounters(void)
+{
+    pthread_mutex_lock(&stub.lock);
+    stub.requests = 0;
+    stub.roundTrips = 0;
+    pthread_mutex_unlock(&stub.lock);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * nv-control-stub.h - a minimal X server, run in a thread of the test
+ * program, that implements enough of the core protocol for XOpenDisplay()
+ * and enough of NV-CONTROL to exercise libXNVCtrl without an NVIDIA X
+ * driver.
+ *
+ * Every integer attribute below STUB_MAX_ATTRIBUTE exists on every target,
+ * except those for which STUB_ATTRIBUTE_EXISTS() is false; their values are
+ * given by StubAttributeValue() until they are set.  Queries on a target
+ * that does not exist fail with BadValue.  Every attribute is readable
+ * and writable.  The binary data attributes
+ * that describe the relationships between targets return the lists given
+ * by StubRelatedTargets().
+ */
+
+#ifndef __NV_CONTROL_STUB_H__
+#define __NV_CONTROL_STUB_H__
+
+#include <stdint.h>
+
+#include "NVCtrl.h"
+
+#define STUB_NUM_TARGET_TYPES (NV_CTRL_TARGET_TYPE_DISPLAY + 1)
+#define STUB_MAX_TARGETS      1024
+#define STUB_MAX_ATTRIBUTE    512
+
+#define STUB_ATTRIBUTE_EXISTS(attr) \
+    ((attr) < STUB_MAX_ATTRIBUTE && ((attr) % 5) != 4)
+
+typedef struct {
+    int targetCount[STUB_NUM_TARGET_TYPES];
+
+    /*
+     * Time the server waits before answering each burst of requests,
+     * to simulate the latency of a remote X server.
+     */
+    unsigned int latencyUsec;
+} StubConfig;
+
+/*
+ * Starts the server and returns the display name to pass to
+ * XOpenDisplay(), or NULL on failure.
+ */
+const char *StubStart(const StubConfig *config);
+void StubStop(void);
+
+/*
+ * The number of requests the server has processed, and the number of
+ * round trips: bursts of requests that the server had to answer before
+ * the client would send more.
+ */
+void StubGetCounters(unsigned long *requests, unsigned long *roundTrips);
+void StubResetCounters(void);
+
+/* The initial value of an integer attribute, and of a string attribute */
+int64_t StubAttributeValue(int targetType, int targetId,
+                           unsigned int attribute);
+void StubStringValue(int targetType, int targetId, unsigned int attribute,
+                     char *buf, int len);
+
+/*
+ * The ids of the targets that the given relationship attribute of the
+ * given target lists; returns their number, of which at most maxIds are
+ * stored, or -1 if the attribute does not describe a relationship.
+ */
+int StubRelatedTargets(int targetType, int targetId, unsigned int attribute,
+                       int *ids, int maxIds);
+
+#endif /* __NV_CONTROL_STUB_H__ */
@@ -0,0 +1,206 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * nvml-context-bench.c - connects to the stub server in nv-control-stub.c
+ * with NvCtrlConnectToSystem(), for 1 to 8 GPUs with a cooler and a
+ * thermal sensor each, with the NVML of nvml-stub.c in place of
+ * libnvidia-ml.so.1.  Counts how many times NVML is opened, initialized
+ * and called while the system's targets are set up, and measures the
+ * resident set size of the process before and after.
+ *
+ * usage: nvml-context-bench [-g max-gpus]
+ *
+ * Exits non-zero if NVML is not opened and initialized exactly once per
+ * system, whatever the number of GPUs, or is not shut down as many times
+ * as it was initialized once the system is freed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "NvCtrlAttributes.h"
+#include "NVCtrl.h"
+
+#include "msg.h"
+
+#include "nv-control-stub.h"
+#include "nvml-stub.h"
+
+
+#define MAX_GPUS 8
+
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/* Returns the resident set size of the process in KiB, or 0 if unknown */
+
+static long rss_kib(void)
+{
+    FILE *stream = fopen("/proc/self/status", "r");
+    char line[256];
+    long kib = 0;
+
+    if (!stream) {
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), stream)) {
+        if (sscanf(line, "VmRSS: %ld kB", &kib) == 1) {
+            break;
+        }
+    }
+
+    fclose(stream);
+
+    return kib;
+}
+
+
+/*
+ * Connects to the stub server with the given number of GPUs, prints the
+ * NVML counts and the resident set size if 'report' is set, and returns
+ * the number of failed checks.
+ */
+
+static int connect_and_count(int num_gpus, int report)
+{
+    StubConfig config;
+    StubNvmlCounters counters;
+    CtrlSystemList systems;
+    CtrlSystem *system;
+    const char *display_name;
+    double connect_msec, t;
+    long rss_before, rss_after;
+    int failures = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.targetCount[NV_CTRL_TARGET_TYPE_X_SCREEN] = 1;
+    config.targetCount[NV_CTRL_TARGET_TYPE_GPU] = num_gpus;
+    config.targetCount[NV_CTRL_TARGET_TYPE_COOLER] = num_gpus;
+    config.targetCount[NV_CTRL_TARGET_TYPE_THERMAL_SENSOR] = num_gpus;
+    config.targetCount[NV_CTRL_TARGET_TYPE_DISPLAY] = num_gpus;
+
+    display_name = StubStart(&config);
+    if (!display_name) {
+        fprintf(stderr, "Cannot start the stub X server.\n");
+        return 1;
+    }
+
+    StubNvmlSetGpuCount(num_gpus);
+    StubNvmlResetCounters();
+
+    memset(&systems, 0, sizeof(systems));
+
+    rss_before = rss_kib();
+
+    t = now_msec();
+    system = NvCtrlConnectToSystem(display_name, &systems);
+    connect_msec = now_msec() - t;
+
+    rss_after = rss_kib();
+
+    StubNvmlGetCounters(&counters);
+
+    if (!system || !system->dpy) {
+        fprintf(stderr, "Cannot connect to '%s'.\n", display_name);
+        StubStop();
+        return 1;
+    }
+
+    if (report) {
+        printf("%-6d %8lu %8lu %10lu %12.1f %12ld %12ld\n", num_gpus,
+               counters.opens, counters.inits, counters.calls, connect_msec,
+               rss_before, rss_after - rss_before);
+    }
+
+    if (counters.opens != 1 || counters.inits != 1) {
+        fprintf(stderr, "NVML was opened %lu and initialized %lu times for "
+                "%d GPUs.\n", counters.opens, counters.inits, num_gpus);
+        failures++;
+    }
+
+    NvCtrlFreeAllSystems(&systems);
+    StubStop();
+
+    StubNvmlGetCounters(&counters);
+
+    if (counters.shutdowns != counters.inits) {
+        fprintf(stderr, "NVML was initialized %lu times but shut down %lu "
+                "times.\n", counters.inits, counters.shutdowns);
+        failures++;
+    }
+
+    return failures;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int max_gpus = MAX_GPUS, num_gpus, c, failures = 0;
+
+    while ((c = getopt(argc, argv, "g:")) != -1) {
+        switch (c) {
+        case 'g': max_gpus = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-g max-gpus]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (max_gpus <= 0 || max_gpus > STUB_MAX_TARGETS) {
+        fprintf(stderr, "Invalid GPU count.\n");
+        return 1;
+    }
+
+    /*
+     * The stub does not implement the other X extensions nvidia-settings
+     * uses, nor all of the attributes queried during target discovery;
+     * the resulting messages are expected.
+     */
+
+    nv_set_verbosity(NV_VERBOSITY_NONE);
+
+    /*
+     * The first connection also pays for the one-time setup of Xlib; make
+     * one before measuring, so that the sizes can be compared.
+     */
+
+    failures += connect_and_count(1, 0);
+
+    printf("a cooler and a thermal sensor per GPU\n\n");
+    printf("%-6s %8s %8s %10s %12s %12s %12s\n", "GPUs", "dlopen",
+           "nvmlInit", "NVML calls", "connect msec", "RSS KiB", "RSS +KiB");
+
+    for (num_gpus = 1; num_gpus <= max_gpus; num_gpus *= 2) {
+        failures += connect_and_count(num_gpus, 1);
+    }
+
+    return failures ? 1 : 0;
+}
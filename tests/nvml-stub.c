@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2026 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * nvml-stub.c - the NVML functions that the NvCtrlAttributes library looks
+ * up in libnvidia-ml.so.1, answering for a fixed number of GPUs; see
+ * nvml-stub.h.
+ */
+
+#define _GNU_SOURCE /* for RTLD_NEXT */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <dlfcn.h>
+
+#include "nvml.h"
+#include "NVCtrl.h"
+
+#include "nv-control-stub.h"
+#include "nvml-stub.h"
+
+/*
+ * nvml.h maps these to their _v2 versions, but the NvCtrlAttributes
+ * library looks up the original names
+ */
+#undef nvmlInit
+#undef nvmlDeviceGetCount
+#undef nvmlDeviceGetHandleByIndex
+#undef nvmlDeviceGetPciInfo
+
+static int gpuCount;
+static StubNvmlCounters counters;
+
+void StubNvmlSetGpuCount(int count)
+{
+    gpuCount = count;
+}
+
+void StubNvmlGetCounters(StubNvmlCounters *c)
+{
+    *c = counters;
+}
+
+void StubNvmlResetCounters(void)
+{
+    memset(&counters, 0, sizeof(counters));
+}
+
+
+
+/*
+ * Opens the test program itself in place of libnvidia-ml.so.1, and any
+ * other library as usual.
+ */
+
+void *dlopen(const char *file, int flags)
+{
+    static void *(*next_dlopen)(const char *, int);
+
+    if (!next_dlopen) {
+        next_dlopen = (void *(*)(const char *, int)) dlsym(RTLD_NEXT, "dlopen");
+    }
+
+    if (file && strcmp(file, "libnvidia-ml.so.1") == 0) {
+        counters.opens++;
+        file = NULL;
+    }
+
+    return next_dlopen(file, flags);
+}
+
+
+
+/* Device handles are the GPU index plus one */
+
+static int DeviceIndex(nvmlDevice_t device)
+{
+    int index = (int) (uintptr_t) device - 1;
+
+    counters.calls++;
+
+    return (index >= 0 && index < gpuCount) ? index : -1;
+}
+
+nvmlReturn_t nvmlInit(void)
+{
+    counters.calls++;
+    counters.inits++;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlShutdown(void)
+{
+    counters.calls++;
+    counters.shutdowns++;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetCount(unsigned int *count)
+{
+    counters.calls++;
+    *count = gpuCount;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetHandleByIndex(unsigned int index,
+                                        nvmlDevice_t *device)
+{
+    counters.calls++;
+    if (index >= gpuCount) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    *device = (nvmlDevice_t) (uintptr_t) (index + 1);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetUUID(nvmlDevice_t device, char *uuid,
+                               unsigned int length)
+{
+    int index = DeviceIndex(device);
+
+    if (index < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    StubStringValue(NV_CTRL_TARGET_TYPE_GPU, index, NV_CTRL_STRING_GPU_UUID,
+                    uuid, length);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetTemperature(nvmlDevice_t device,
+                                      nvmlTemperatureSensors_t sensorType,
+                                      unsigned int *temp)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    *temp = 50;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetFanSpeed(nvmlDevice_t device, unsigned int *speed)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    *speed = 30;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetName(nvmlDevice_t device, char *name,
+                               unsigned int length)
+{
+    int index = DeviceIndex(device);
+
+    if (index < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    snprintf(name, length, "Stub GPU %d", index);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetVbiosVersion(nvmlDevice_t device, char *version,
+                                       unsigned int length)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    snprintf(version, length, "00.00.00.00.00");
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMemoryInfo(nvmlDevice_t device,
+                                     nvmlMemory_t *memory)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    memory->total = 1ULL << 30;
+    memory->free = memory->total;
+    memory->used = 0;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPciInfo(nvmlDevice_t device, nvmlPciInfo_t *pci)
+{
+    int index = DeviceIndex(device);
+
+    if (index < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    memset(pci, 0, sizeof(*pci));
+    pci->bus = index + 1;
+    snprintf(pci->busId, sizeof(pci->busId), "0000:%02x:00.0", pci->bus);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMaxPcieLinkGeneration(nvmlDevice_t device,
+                                                unsigned int *maxLinkGen)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    *maxLinkGen = 3;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMaxPcieLinkWidth(nvmlDevice_t device,
+                                           unsigned int *maxLinkWidth)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    *maxLinkWidth = 16;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetVirtualizationMode(nvmlDevice_t device,
+                                             nvmlGpuVirtualizationMode_t *mode)
+{
+    if (DeviceIndex(device) < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+    *mode = NVML_GPU_VIRTUALIZATION_MODE_NONE;
+    return NVML_SUCCESS;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * nvml-stub.h - a stand-in for libnvidia-ml.so.1, linked into the test
+ * program, so that the NVML code of the NvCtrlAttributes library can run
+ * without an NVIDIA GPU or driver.
+ *
+ * The test program's dlopen() is interposed: opening "libnvidia-ml.so.1"
+ * returns a handle to the test program itself, whose NVML functions then
+ * answer for StubNvmlSetGpuCount() GPUs.  Each GPU has a temperature
+ * sensor and a fan, and the UUID that nv-control-stub.c gives the GPU of
+ * the same id, so that the NVML devices match the stub server's GPUs.
+ *
+ * The test program must be linked with -Wl,--export-dynamic, so that
+ * dlsym() finds the NVML functions in it.
+ */
+
+#ifndef __NVML_STUB_H__
+#define __NVML_STUB_H__
+
+typedef struct {
+    unsigned long opens;        /* dlopen() calls for libnvidia-ml.so.1 */
+    unsigned long inits;        /* nvmlInit() calls */
+    unsigned long shutdowns;    /* nvmlShutdown() calls */
+    unsigned long calls;        /* calls to any NVML function */
+} StubNvmlCounters;
+
+void StubNvmlSetGpuCount(int gpuCount);
+
+void StubNvmlGetCounters(StubNvmlCounters *counters);
+void StubNvmlResetCounters(void);
+
+#endif /* __NVML_STUB_H__ */
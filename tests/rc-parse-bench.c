@@ -0,0 +1,216 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * rc-parse-bench.c - writes rc files of 1000 to 100000 lines, like those
+ * written for video walls with one line per attribute of each display
+ * device, and times reading them with nv_read_config_file() from the stub
+ * server in nv-control-stub.c.
+ *
+ * The stub has no GPUs, so every line is rejected once it is parsed and
+ * its target is looked up; nothing is sent for it, and the time taken is
+ * that of reading the file.
+ *
+ * usage: rc-parse-bench [-n max-lines]
+ *
+ * Exits non-zero if a file cannot be read, or if the time per line for
+ * the largest file is more than 4 times that for the smallest one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "NvCtrlAttributes.h"
+#include "config-file.h"
+#include "command-line.h"
+#include "parse.h"
+
+#include "msg.h"
+
+#include "nv-control-stub.h"
+
+
+#define MIN_LINES 1000
+#define LINES_PER_SIZE 100000
+
+
+static const char *attributes[] = {
+    "DigitalVibrance", "ColorSpace", "ColorRange", "Dithering",
+    "DitheringMode", "DitheringDepth", "ImageSharpening", "OverscanCompensation",
+};
+
+#define NUM_ATTRIBUTES (sizeof(attributes) / sizeof(attributes[0]))
+
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/*
+ * Writes an rc file of the given number of lines: a header, the
+ * properties, and one line per attribute of each display device of
+ * each GPU.
+ */
+
+static int write_rc_file(const char *file, const char *display_name,
+                         int num_lines)
+{
+    FILE *stream = fopen(file, "w");
+    int i;
+
+    if (!stream) {
+        return 0;
+    }
+
+    fprintf(stream, "#\n# %s\n#\n\n# ConfigProperties:\n\n", file);
+    fprintf(stream, "RcFileLocale = C\n");
+    fprintf(stream, "DisplayStatusBar = Yes\n");
+    fprintf(stream, "SliderTextEntries = Yes\n\n");
+    fprintf(stream, "# Attributes:\n\n");
+
+    for (i = 0; i < num_lines; i++) {
+        int dpy = i / NUM_ATTRIBUTES;
+
+        fprintf(stream, "%s[gpu:%d]/%s[DPY-%d]=%d\n", display_name,
+                dpy % 16, attributes[i % NUM_ATTRIBUTES], dpy, i % 64);
+    }
+
+    return fclose(stream) == 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    char file[] = "/tmp/rc-parse-bench-XXXXXX";
+    double first_usec = 0.0;
+    int max_lines = LINES_PER_SIZE, num_lines, c, fd, failures = 0;
+    const char *display_name;
+    StubConfig config;
+    Options op;
+
+    while ((c = getopt(argc, argv, "n:")) != -1) {
+        switch (c) {
+        case 'n': max_lines = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n max-lines]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (max_lines < MIN_LINES) {
+        fprintf(stderr, "Invalid line count.\n");
+        return 1;
+    }
+
+    fd = mkstemp(file);
+    if (fd == -1) {
+        fprintf(stderr, "Cannot create a temporary file.\n");
+        return 1;
+    }
+    close(fd);
+
+    memset(&config, 0, sizeof(config));
+    config.targetCount[NV_CTRL_TARGET_TYPE_X_SCREEN] = 1;
+
+    display_name = StubStart(&config);
+    if (!display_name) {
+        fprintf(stderr, "Cannot start the stub X server.\n");
+        unlink(file);
+        return 1;
+    }
+
+    /* the lines are all rejected; the resulting messages are expected */
+
+    nv_set_verbosity(NV_VERBOSITY_NONE);
+    memset(&op, 0, sizeof(op));
+
+    printf("rc files naming display devices on 16 GPUs\n\n");
+    printf("%-10s %12s %14s %12s %8s\n", "lines", "file msec",
+           "usec/line", "round trips", "rounds");
+
+    for (num_lines = MIN_LINES; num_lines <= max_lines; num_lines *= 10) {
+        int rounds = (LINES_PER_SIZE + num_lines - 1) / num_lines;
+        unsigned long requests, round_trips;
+        double msec = 0.0, t, usec;
+        int round;
+
+        if (!write_rc_file(file, display_name, num_lines)) {
+            fprintf(stderr, "Cannot write '%s'.\n", file);
+            failures++;
+            break;
+        }
+
+        StubResetCounters();
+
+        for (round = 0; round < rounds; round++) {
+            CtrlSystemList systems;
+            ConfigProperties conf;
+            ParsedAttribute *p = nv_parsed_attribute_init();
+            int ret;
+
+            memset(&systems, 0, sizeof(systems));
+            init_config_properties(&conf);
+
+            t = now_msec();
+            ret = nv_read_config_file(&op, file, NULL, p, &conf, &systems);
+            msec += now_msec() - t;
+
+            nv_parsed_attribute_free(p);
+            NvCtrlFreeAllSystems(&systems);
+            free(conf.locale);
+
+            if (!ret) {
+                fprintf(stderr, "Cannot read %d lines from '%s'.\n",
+                        num_lines, file);
+                failures++;
+                break;
+            }
+        }
+
+        StubGetCounters(&requests, &round_trips);
+
+        usec = msec * 1000.0 / ((double) rounds * num_lines);
+        if (num_lines == MIN_LINES) {
+            first_usec = usec;
+        }
+
+        printf("%-10d %12.2f %14.3f %12lu %8d\n", num_lines, msec / rounds,
+               usec, round_trips / rounds, rounds);
+
+        if (usec > 4.0 * first_usec) {
+            fprintf(stderr, "Reading %d lines takes %.1f times as long per "
+                    "line as reading %d lines.\n", num_lines,
+                    usec / first_usec, MIN_LINES);
+            failures++;
+        }
+    }
+
+    StubStop();
+    unlink(file);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+#
+# files in the tests directory of nvidia-settings
+#
+
+TESTS_SRC +=
+
+TESTS_EXTRA_DIST += README
+TESTS_EXTRA_DIST += nv-control-stub.c
+TESTS_EXTRA_DIST += nv-control-stub.h
+TESTS_EXTRA_DIST += nv-control-batch-bench.c
+TESTS_EXTRA_DIST += nv-control-split-phase-test.c
+TESTS_EXTRA_DIST += attribute-lookup-bench.c
+TESTS_EXTRA_DIST += target-registry-bench.c
+TESTS_EXTRA_DIST += gamma-ramp-bench.c
+TESTS_EXTRA_DIST += rc-parse-bench.c
+TESTS_EXTRA_DIST += nvml-stub.c
+TESTS_EXTRA_DIST += nvml-stub.h
+TESTS_EXTRA_DIST += nvml-context-bench.c
+TESTS_EXTRA_DIST += ctk-event-bench.c
+TESTS_EXTRA_DIST += src.mk
+
+TESTS_DIST_FILES := $(TESTS_SRC) $(TESTS_EXTRA_DIST)
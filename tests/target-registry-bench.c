@@ -0,0 +1,259 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * target-registry-bench.c - connects to the stub server in
+ * nv-control-stub.c with NvCtrlConnectToSystem(), for growing numbers of
+ * display devices (as behind MST hubs, or on video walls), checks the
+ * targets and relationships that were discovered against the stub's
+ * topology, and times target discovery, target lookups by id and
+ * relationship tests.
+ *
+ * usage: target-registry-bench [-g gpus] [-d max-display-targets]
+ *
+ * Exits non-zero if a target is missing, or if a relationship is missing
+ * or wrong.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "NvCtrlAttributes.h"
+#include "NVCtrl.h"
+
+#include "msg.h"
+
+#include "nv-control-stub.h"
+
+
+#define LOOKUP_ROUNDS 100
+
+
+static double now_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/*
+ * Checks that the system has exactly the stub's display devices, and that
+ * each GPU is related to the display devices the stub deals out to it, in
+ * both directions.
+ */
+
+static int check_system(const CtrlSystem *system, int num_gpus,
+                        int num_displays)
+{
+    CtrlTarget *screen = NvCtrlGetTarget(system, X_SCREEN_TARGET, 0);
+    CtrlTargetNode *node;
+    int *ids;
+    int gpu, i, n, count = 0, failures = 0;
+
+    for (node = system->targets[DISPLAY_TARGET]; node; node = node->next) {
+        count++;
+    }
+    if (!screen || count != num_displays) {
+        fprintf(stderr, "Found %d display targets, expected %d.\n",
+                count, num_displays);
+        return 1;
+    }
+
+    ids = malloc(STUB_MAX_TARGETS * sizeof(*ids));
+
+    for (gpu = 0; gpu < num_gpus; gpu++) {
+        CtrlTarget *g = NvCtrlGetTarget(system, GPU_TARGET, gpu);
+
+        if (!g) {
+            fprintf(stderr, "GPU %d is missing.\n", gpu);
+            failures++;
+            continue;
+        }
+
+        n = StubRelatedTargets(NV_CTRL_TARGET_TYPE_GPU, gpu,
+                               NV_CTRL_BINARY_DATA_DISPLAYS_ON_GPU,
+                               ids, STUB_MAX_TARGETS);
+
+        if (NvCtrlGetRelatedTargetCount(g, DISPLAY_TARGET) != n) {
+            fprintf(stderr, "GPU %d is related to %d display targets, "
+                    "expected %d.\n", gpu,
+                    NvCtrlGetRelatedTargetCount(g, DISPLAY_TARGET), n);
+            failures++;
+        }
+
+        for (i = 0; i < n; i++) {
+            CtrlTarget *d = NvCtrlGetTarget(system, DISPLAY_TARGET, ids[i]);
+
+            if (!d || !NvCtrlTargetIsRelated(g, DISPLAY_TARGET, ids[i]) ||
+                !NvCtrlTargetIsRelated(d, GPU_TARGET, gpu) ||
+                !NvCtrlTargetIsRelated(d, X_SCREEN_TARGET, 0) ||
+                !d->display.connected) {
+                fprintf(stderr, "Display target %d is missing, or its "
+                        "relationships to GPU %d are wrong.\n",
+                        ids[i], gpu);
+                failures++;
+            }
+        }
+
+        /* the display devices of other GPUs are not related */
+
+        for (i = 0; i < num_displays; i++) {
+            if ((i % num_gpus != gpu) &&
+                NvCtrlTargetIsRelated(g, DISPLAY_TARGET, i)) {
+                fprintf(stderr, "GPU %d is related to display target %d.\n",
+                        gpu, i);
+                failures++;
+            }
+        }
+    }
+
+    if (NvCtrlGetRelatedTargetCount(screen, DISPLAY_TARGET) != num_displays ||
+        NvCtrlGetRelatedTargetCount(screen, GPU_TARGET) != num_gpus) {
+        fprintf(stderr, "X screen 0 is not related to every GPU and display "
+                "target.\n");
+        failures++;
+    }
+
+    free(ids);
+
+    return failures;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int num_gpus = 4, max_displays = STUB_MAX_TARGETS;
+    int num_displays, c, i, round, gpu, failures = 0;
+
+    while ((c = getopt(argc, argv, "g:d:")) != -1) {
+        switch (c) {
+        case 'g': num_gpus = atoi(optarg); break;
+        case 'd': max_displays = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-g gpus] [-d max-display-targets]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (num_gpus <= 0 || num_gpus > STUB_MAX_TARGETS ||
+        max_displays < 64 || max_displays > STUB_MAX_TARGETS) {
+        fprintf(stderr, "Invalid GPU or display target count.\n");
+        return 1;
+    }
+
+    /*
+     * The stub does not implement the other X extensions nvidia-settings
+     * uses, nor all of the attributes queried during target discovery;
+     * the resulting messages are expected.
+     */
+
+    nv_set_verbosity(NV_VERBOSITY_NONE);
+
+    printf("%d GPUs, X screen 0 driving all display targets\n\n", num_gpus);
+    printf("%-10s %12s %12s %14s %14s\n", "displays", "connect msec",
+           "round trips", "nsec/lookup", "nsec/related");
+
+    for (num_displays = 64; num_displays <= max_displays;
+         num_displays *= 4) {
+        StubConfig config;
+        CtrlSystemList systems;
+        CtrlSystem *system;
+        const char *display_name;
+        unsigned long requests, round_trips;
+        double connect_msec, lookup_msec, related_msec, t;
+        int found = 0, related = 0;
+
+        memset(&config, 0, sizeof(config));
+        config.targetCount[NV_CTRL_TARGET_TYPE_X_SCREEN] = 1;
+        config.targetCount[NV_CTRL_TARGET_TYPE_GPU] = num_gpus;
+        config.targetCount[NV_CTRL_TARGET_TYPE_COOLER] = num_gpus;
+        config.targetCount[NV_CTRL_TARGET_TYPE_THERMAL_SENSOR] = num_gpus;
+        config.targetCount[NV_CTRL_TARGET_TYPE_DISPLAY] = num_displays;
+
+        display_name = StubStart(&config);
+        if (!display_name) {
+            fprintf(stderr, "Cannot start the stub X server.\n");
+            return 1;
+        }
+
+        memset(&systems, 0, sizeof(systems));
+
+        t = now_msec();
+        system = NvCtrlConnectToSystem(display_name, &systems);
+        connect_msec = now_msec() - t;
+
+        StubGetCounters(&requests, &round_trips);
+
+        if (!system || !system->dpy) {
+            fprintf(stderr, "Cannot connect to '%s'.\n", display_name);
+            StubStop();
+            return 1;
+        }
+
+        failures += check_system(system, num_gpus, num_displays);
+
+        /* look up every display target by id */
+
+        t = now_msec();
+        for (round = 0; round < LOOKUP_ROUNDS; round++) {
+            for (i = 0; i < num_displays; i++) {
+                found += NvCtrlGetTarget(system, DISPLAY_TARGET, i) != NULL;
+            }
+        }
+        lookup_msec = now_msec() - t;
+
+        /* test every GPU against every display target */
+
+        t = now_msec();
+        for (round = 0; round < LOOKUP_ROUNDS; round++) {
+            for (gpu = 0; gpu < num_gpus; gpu++) {
+                CtrlTarget *g = NvCtrlGetTarget(system, GPU_TARGET, gpu);
+
+                for (i = 0; i < num_displays; i++) {
+                    related += NvCtrlTargetIsRelated(g, DISPLAY_TARGET, i);
+                }
+            }
+        }
+        related_msec = now_msec() - t;
+
+        if (found != LOOKUP_ROUNDS * num_displays ||
+            related != LOOKUP_ROUNDS * num_displays) {
+            fprintf(stderr, "Wrong lookup results for %d display targets.\n",
+                    num_displays);
+            failures++;
+        }
+
+        printf("%-10d %12.1f %12lu %14.1f %14.1f\n", num_displays,
+               connect_msec, round_trips,
+               lookup_msec * 1e6 / (LOOKUP_ROUNDS * num_displays),
+               related_msec * 1e6 /
+               ((double) LOOKUP_ROUNDS * num_gpus * num_displays));
+
+        NvCtrlFreeAllSystems(&systems);
+        StubStop();
+    }
+
+    return failures ? 1 : 0;
+}